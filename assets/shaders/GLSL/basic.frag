@@ -1,8 +1,17 @@
 #version 450
+/* Permutations --> declared in ShaderLibrary, prebuilt per assets/shaders/permutations.txt */
+layout(constant_id = 0) const bool c_Grayscale = false; // GRAYSCALE
+
+#ifdef FLAT_COLOR
+layout(location = 0) flat in vec3 fragColor;
+#else
 layout(location = 0) in vec3 fragColor;
+#endif
 
 layout(location = 0) out vec4 outColor;
 
 void main() {
-    outColor = vec4(fragColor, 1.0);
+    vec3 color = fragColor;
+    if (c_Grayscale) color = vec3(dot(color, vec3(0.2126, 0.7152, 0.0722)));
+    outColor = vec4(color, 1.0);
 }
@@ -1,10 +1,37 @@
 #version 450
-layout(location = 0) in vec2 a_position;
+/* Per frame --> dynamic offset into the UniformRing */
+layout(set = 0, binding = 0) uniform FrameData {
+    mat4 View;
+    mat4 Projection;
+} u_Frame;
+/* Per object --> every draw is instanced over the scene objects, the instance index picks the model */
+struct ObjectData {
+    mat4 Model;
+};
+layout(set = 1, binding = 0) readonly buffer Objects {
+    ObjectData objects[];
+} b_Objects;
+/* Per draw */
+layout(push_constant) uniform DrawData {
+    mat4 Model;
+} u_Draw;
+/* Permutations --> declared in ShaderLibrary, prebuilt per assets/shaders/permutations.txt */
+layout(constant_id = 0) const bool c_InstanceTint = false; // INSTANCE_TINT --> every instance a different shade, shows what culling kept
+
+layout(location = 0) in vec3 a_position;
 layout(location = 1) in vec3 a_color;
 
+#ifdef FLAT_COLOR
+layout(location = 0) flat out vec3 fragColor;
+#else
 layout(location = 0) out vec3 fragColor;
+#endif
 
 void main() {
-    gl_Position = vec4(a_position, 0.0, 1.0);
+    gl_Position = u_Frame.Projection * u_Frame.View * u_Draw.Model * b_Objects.objects[gl_InstanceIndex].Model * vec4(a_position, 1.0);
     fragColor = a_color;
+    if (c_InstanceTint) {
+        uint hash = uint(gl_InstanceIndex) * 2654435761u;
+        fragColor *= vec3(hash & 255u, (hash >> 8) & 255u, (hash >> 16) & 255u) / 255.0 * 0.5 + 0.5;
+    }
 }
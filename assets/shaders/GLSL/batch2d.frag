@@ -0,0 +1,21 @@
+#version 450
+/* Bound per run of quads sharing a texture */
+layout(set = 0, binding = 0) uniform sampler2D u_Texture;
+
+layout(location = 0) in vec2 v_texCoord;
+layout(location = 1) in vec4 v_color;
+layout(location = 2) flat in uint v_mode;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    vec4 texel = texture(u_Texture, v_texCoord);
+    if (v_mode == 1u) {
+        /* Signed distance in red, 0.5 on the edge --> antialiased over about one screen pixel at any size */
+        float distance = texel.r;
+        float width = max(fwidth(distance) * 0.5, 1e-4);
+        outColor = vec4(v_color.rgb, v_color.a * smoothstep(0.5 - width, 0.5 + width, distance));
+    } else {
+        outColor = v_color * texel;
+    }
+}
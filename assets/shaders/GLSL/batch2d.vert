@@ -0,0 +1,21 @@
+#version 450
+/* Pixels with the origin top left --> clip space */
+layout(push_constant) uniform BatchData {
+    vec2 Scale; // 2 / extent
+} u_Batch;
+
+layout(location = 0) in vec2 a_position;
+layout(location = 1) in vec2 a_texCoord;
+layout(location = 2) in vec4 a_color;
+layout(location = 3) in uint a_mode;
+
+layout(location = 0) out vec2 v_texCoord;
+layout(location = 1) out vec4 v_color;
+layout(location = 2) flat out uint v_mode;
+
+void main() {
+    gl_Position = vec4(a_position * u_Batch.Scale - 1.0, 0.0, 1.0);
+    v_texCoord = a_texCoord;
+    v_color = a_color;
+    v_mode = a_mode;
+}
@@ -0,0 +1,29 @@
+#version 450
+/* Scene target --> only the top left RenderExtent part holds this frame */
+layout(set = 0, binding = 0) uniform sampler2D u_Scene;
+layout(push_constant) uniform UpscaleData {
+    vec2 UvScale; // render extent / target extent
+    vec2 UvMax; // last texel center inside the render extent --> no bleed from stale texels
+    vec2 TexelSize; // 1 / target extent
+    float Sharpness; // 0 = plain bilinear
+} u_Upscale;
+
+layout(location = 0) in vec2 v_uv;
+
+layout(location = 0) out vec4 outColor;
+
+vec3 Fetch(vec2 uv) {
+    return texture(u_Scene, min(uv, u_Upscale.UvMax)).rgb;
+}
+
+void main() {
+    vec2 uv = v_uv * u_Upscale.UvScale;
+    vec3 color = Fetch(uv);
+    if (u_Upscale.Sharpness > 0.0) {
+        /* Unsharp mask over the 4 neighbours --> restores some of the edge contrast bilinear filtering loses */
+        vec3 neighbours = Fetch(uv + vec2(u_Upscale.TexelSize.x, 0.0)) + Fetch(uv - vec2(u_Upscale.TexelSize.x, 0.0)) +
+            Fetch(uv + vec2(0.0, u_Upscale.TexelSize.y)) + Fetch(uv - vec2(0.0, u_Upscale.TexelSize.y));
+        color = clamp(color + (color * 4.0 - neighbours) * (u_Upscale.Sharpness * 0.25), 0.0, 1.0);
+    }
+    outColor = vec4(color, 1.0);
+}
@@ -0,0 +1,9 @@
+#version 450
+/* Fullscreen triangle from the vertex index --> no vertex buffer */
+layout(location = 0) out vec2 v_uv;
+
+void main() {
+    vec2 position = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    v_uv = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -1,21 +1,39 @@
 #include "Application.h"
+#include "Hash.h"
+#include "VulkanUtils.h"
+#include <charconv>
+#include <cstring>
 
 /* TODO: Remove glm later --> abstraction */
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/vec4.hpp>
 #include <glm/mat4x4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 
 namespace VulkanPractice {
     Application::Application(const ApplicationConfig& config)
-        : m_ApplicationName(config.ApplicationName), m_ApplicationEngineName(config.ApplicationEngineName)
+        : m_VkAllocator(config.TrackHostAllocations ? m_HostAllocator.GetCallbacks() : nullptr), m_ApplicationName(config.ApplicationName), m_ApplicationEngineName(config.ApplicationEngineName), m_MeshPath(config.MeshPath), m_AssetResidencyBudget(config.AssetResidencyBudget), m_UniformBytesPerFrame(config.UniformBytesPerFrame), m_CacheCommandBuffers(config.CacheCommandBuffers), m_OcclusionCulling(config.OcclusionCulling), m_SceneGridSize(config.SceneGridSize), m_ShaderFeatures(config.ShaderFeatures), m_ShaderManifestPath(config.ShaderManifestPath), m_StatsOverlay(config.StatsOverlay), m_FramePacer(config.Pacing), m_ExtraWindowConfigs(config.ExtraWindows), m_MetricsServerConfig(config.Metrics)
     {
         if(s_Instance != nullptr) {
             throw std::runtime_error("An Application already exists");
         }
-        m_Window = std::make_unique<Window>(config.WindowWidth, config.WindowHeight, config.WindowTitle);
+        m_Window = m_InitProfiler.Measure("Create window", [&config] {
+            return std::make_unique<Window>(config.WindowWidth, config.WindowHeight, config.WindowTitle);
+        });
         /* TODO: Move this to window class --> add event handler */
         glfwSetFramebufferSizeCallback(m_Window->GetNativeWindow(), FramebufferResizeCallback);
+        /* Every event that can change what is on screen marks the frame dirty for the pacer */
+        glfwSetWindowFocusCallback(m_Window->GetNativeWindow(), WindowFocusCallback);
+        glfwSetWindowIconifyCallback(m_Window->GetNativeWindow(), WindowIconifyCallback);
+        glfwSetWindowRefreshCallback(m_Window->GetNativeWindow(), WindowRefreshCallback);
+        glfwSetKeyCallback(m_Window->GetNativeWindow(), KeyCallback);
+        glfwSetMouseButtonCallback(m_Window->GetNativeWindow(), MouseButtonCallback);
+        glfwSetCursorPosCallback(m_Window->GetNativeWindow(), CursorPosCallback);
+        glfwSetScrollCallback(m_Window->GetNativeWindow(), ScrollCallback);
+        m_FrameCaptureConfig.Directory = config.CaptureDirectory;
+        m_FrameCaptureConfig.Format = config.CaptureFormat;
+        m_ResolutionConfig = config.Resolution;
         Log::Init();
         InitVulkan();
         /* Print Extensions Info */
@@ -48,12 +66,8 @@ namespace VulkanPractice {
                 }
             }
             {
-                uint32_t extensionCount;
-                vkEnumerateDeviceExtensionProperties(m_VkPhysicalDevice, nullptr, &extensionCount, nullptr);
-                std::vector<VkExtensionProperties> extensions(extensionCount);
-                vkEnumerateDeviceExtensionProperties(m_VkPhysicalDevice, nullptr, &extensionCount, extensions.data());
                 LOG_INFO("Available Physical Device Extensions");
-                for (const auto& ext : extensions) {
+                for (const auto& ext : m_PhysicalDeviceInfo.Extensions) {
                     std::cout << "Name: \033[32m" << ext.extensionName 
                     << "\033[0m, Spec version: \033[32m" << ext.specVersion
                     << "\n\033[0m";
@@ -65,6 +79,32 @@ namespace VulkanPractice {
     /* TODO: Move this to window class --> add event handler */
     void Application::FramebufferResizeCallback(GLFWwindow* window, int width, int height) {
         Application::GetInstance()->m_FramebufferResized = true;
+        Application::GetInstance()->m_FramePacer.MarkDirty();
+    }
+    void Application::WindowFocusCallback(GLFWwindow*, int focused) {
+        Application::GetInstance()->m_FramePacer.SetFocused(focused == GLFW_TRUE);
+    }
+    void Application::WindowIconifyCallback(GLFWwindow*, int iconified) {
+        Application::GetInstance()->m_FramePacer.SetIconified(iconified == GLFW_TRUE);
+    }
+    void Application::WindowRefreshCallback(GLFWwindow*) {
+        Application::GetInstance()->m_FramePacer.MarkDirty();
+    }
+    void Application::KeyCallback(GLFWwindow*, int, int, int, int) {
+        Application::GetInstance()->m_FramePacer.MarkDirty();
+    }
+    void Application::MouseButtonCallback(GLFWwindow*, int, int, int) {
+        Application::GetInstance()->m_FramePacer.MarkDirty();
+    }
+    void Application::CursorPosCallback(GLFWwindow*, double, double) {
+        Application::GetInstance()->m_FramePacer.MarkDirty();
+    }
+    void Application::ScrollCallback(GLFWwindow*, double, double) {
+        Application::GetInstance()->m_FramePacer.MarkDirty();
+    }
+    void Application::ExtraWindowResizeCallback(GLFWwindow* window, int, int) {
+        static_cast<SwapchainTarget*>(glfwGetWindowUserPointer(window))->MarkResized();
+        Application::GetInstance()->m_FramePacer.MarkDirty();
     }
 
     Application::~Application() {
@@ -72,66 +112,149 @@ namespace VulkanPractice {
         s_Instance = nullptr;
     }
     void Application::Run() {
-        while(!glfwWindowShouldClose(m_Window->GetNativeWindow())) {
+        /* Blocks in the event loop while nothing changed --> a static frame costs neither a core nor the GPU */
+        while (m_FramePacer.WaitForFrame(m_Window->GetNativeWindow(), [this] { return HasPendingWork(); })) {
             DrawFrame();
-            glfwPollEvents();
         }
         vkDeviceWaitIdle(m_VkDevice); // wait to finish operations before calling destructor
+        m_FramePacer.Report();
     }
 
     void Application::InitVulkan() {
+        /* Startup runs as a small dependency graph -->
+           shader compile (per stage) -----------------------------------------------+
+           mesh file read (streamer threads) ---------------------------------------+|
+           instance -> surface -> physical device -> logical device -> render pass -> pipeline layout -> pipeline (worker)
+                                                                  \-> swapchain -> image views -> depth buffer -> framebuffers -> command pool/buffers -> sync
+           and the pipeline is joined last, so its compile overlaps the whole swapchain side */
+
+        /* Shaders */ // GLSL --> SPIR-V needs no device --> starts before the instance exists
+        m_InitProfiler.Measure("Load shader manifest", [this] { LoadShaderLibrary(); });
+        m_BasicPipelineDesc.Shaders = {
+            m_ShaderLibrary.Get("basic.vert", m_ShaderFeatures),
+            m_ShaderLibrary.Get("basic.frag", m_ShaderFeatures)
+        };
+        /* Every listed permutation, not only the enabled one --> switching features later never waits on shaderc */
+        std::vector<ShaderStageDesc> prebuiltStages = m_ShaderLibrary.GetPrebuiltStages();
+        std::vector<std::future<PipelineCache::ShaderCode>> shaderCode;
+        for (const auto& stage : prebuiltStages) {
+            shaderCode.push_back(std::async(std::launch::async, [this, stage] {
+                return m_InitProfiler.Measure("Compile " + stage.Path, [&stage] { return PipelineCache::CompileShader(stage); });
+            }));
+        }
+        /* Stream Geometry */ // file read runs on the streamer threads, the upload waits for the first DrawFrame
+        m_InitProfiler.Measure("Request mesh", [this] { LoadMesh(); });
+
         /* Create Vulkan Instance */
-        CreateInstance();
+        m_InitProfiler.Measure("Create instance", [this] { CreateInstance(); });
         /* Setup Debug Messenger only for Debug */
 #ifdef INCLUDE_DEBUG_INFO
-        SetupDebugMessenger();
+        m_InitProfiler.Measure("Setup debug messenger", [this] { SetupDebugMessenger(); });
 #endif
         /* Create Surface KHR */
-        CreateSurface();
+        m_InitProfiler.Measure("Create surface", [this] { CreateSurface(); });
         /* Pick Physical Device */
-        PickPhysicalDevice();
+        m_InitProfiler.Measure("Pick physical device", [this] { PickPhysicalDevice(); });
         /* Create Logical Device */
-        CreateLogicalDevice();
+        m_InitProfiler.Measure("Create logical device", [this] { CreateLogicalDevice(); });
+        m_InitProfiler.Measure("Create memory budget", [this] { CreateMemoryBudget(); });
+        m_InitProfiler.Measure("Create metrics", [this] { CreateMetrics(); });
+        /* Create Render Pass */ // only needs the surface format, not the swapchain
+        m_InitProfiler.Measure("Create render pass", [this] { CreateRenderPass(); });
+        /* Create Uniform Ring */
+        m_InitProfiler.Measure("Create uniform ring", [this] { CreateUniformRing(); });
+        m_InitProfiler.Measure("Create scene objects", [this] { CreateSceneObjects(); });
+        /* Create Graphics Pipeline */ // layout and description here, the compile itself on a worker
+        m_InitProfiler.Measure("Create pipeline layout", [this] { CreateGraphicsPipeline(); });
+        std::future<VkPipeline> graphicsPipeline = std::async(std::launch::async, [this, &shaderCode, &prebuiltStages] {
+            for (size_t i = 0; i < shaderCode.size(); i++) {
+                m_PipelineCache->AddShaderCode(prebuiltStages[i], shaderCode[i].get());
+            }
+            /* Compiled up front --> doubles as the fallback while other descriptions compile on the cache worker */
+            return m_InitProfiler.Measure("Create graphics pipeline", [this] { return m_PipelineCache->GetBlocking(m_BasicPipelineDesc); });
+        });
         /* Create Swap Chain */
-        CreateSwapChain();
+        m_InitProfiler.Measure("Create swapchain", [this] { CreateSwapChain(); });
         /* Create Image Views */
-        CreateImageViews();
-        /* Create Render Pass */
-        CreateRenderPass();
-        /* Create Graphics Pipeline */
-        CreateGraphicsPipeline();
+        m_InitProfiler.Measure("Create image views", [this] { CreateImageViews(); });
+        m_InitProfiler.Measure("Create depth buffer", [this] { CreateDepthResources(); });
         /* Create Frame Buffers */
-        CreateFramebuffers();
+        m_InitProfiler.Measure("Create framebuffers", [this] { CreateFramebuffers(); });
         /* Create Command Pool */
-        CreateCommandPool();
+        m_InitProfiler.Measure("Create command pool", [this] { CreateCommandPool(); });
         /* Create Command Buffer */
-        CreateCommandBuffers();
+        m_InitProfiler.Measure("Create command buffers", [this] { CreateCommandBuffers(); });
         /* Create Semaphores and Fences */
-        CreateSyncObjects();
+        m_InitProfiler.Measure("Create sync objects", [this] { CreateSyncObjects(); });
+        m_InitProfiler.Measure("Create extra windows", [this] { CreateExtraWindows(); });
+        m_InitProfiler.Measure("Create frame capture", [this] { CreateFrameCapture(); });
+        m_InitProfiler.Measure("Create GPU timer", [this] { CreateGpuTimer(); });
+        m_InitProfiler.Measure("Create dynamic resolution", [this] { CreateDynamicResolution(); });
+        m_InitProfiler.Measure("Create occlusion culler", [this] { CreateOcclusionCuller(); });
+        m_InitProfiler.Measure("Create 2D renderer", [this] { CreateRenderer2D(); });
+        /* Join */
+        m_VkGraphicsPipeline = m_InitProfiler.Measure("Wait for graphics pipeline", [&graphicsPipeline] { return graphicsPipeline.get(); });
+        m_InitProfiler.Report("Vulkan initialization");
     }
     void Application::CleanupVulkan() {
+        m_MetricsServer.reset(); // stop scrapes before anything they report on goes away
+        m_ExtraWindows.clear(); // their surfaces go before the instance
         for(size_t i = 0; i < m_MaxFramesInFlight; i++) {
-            vkDestroySemaphore(m_VkDevice, m_VkImageAvailableSemaphores[i], nullptr);
-            vkDestroySemaphore(m_VkDevice, m_VkRenderFinishedSemaphores[i], nullptr);
-            vkDestroyFence(m_VkDevice, m_VkInFlightFences[i], nullptr);
+            vkDestroySemaphore(m_VkDevice, m_VkImageAvailableSemaphores[i], m_VkAllocator);
+            vkDestroySemaphore(m_VkDevice, m_VkRenderFinishedSemaphores[i], m_VkAllocator);
+            vkDestroyFence(m_VkDevice, m_VkInFlightFences[i], m_VkAllocator);
         }
-        vkDestroyCommandPool(m_VkDevice, m_VkCommandPool, nullptr); // automatically frees command buffers
+        m_FrameCapture.reset(); // writes out the last captured frames
+        m_GpuTimer.reset();
+        m_Renderer2D.reset(); // before the sampler and pipeline caches it borrows from
+        m_OcclusionCuller.reset(); // reads the depth buffer of the dynamic resolution target
+        m_DynamicResolution.reset(); // before the sampler and pipeline caches it borrows from
+        m_MemoryBudget.reset(); // its callbacks reach into the streamer
+        m_AssetStreamer.reset(); // joins I/O threads and frees every resident asset
+        m_SamplerCache.reset();
+        if (m_CommandBufferCache) {
+#ifdef INCLUDE_DEBUG_INFO
+            LOG_INFO("Command buffer cache: {} replays, {} recordings", m_CommandBufferCache->GetReplayCount(), m_CommandBufferCache->GetRecordCount());
+#endif
+            m_CommandBufferCache.reset();
+        }
+        vkDestroyCommandPool(m_VkDevice, m_VkCommandPool, m_VkAllocator); // automatically frees command buffers
         for (auto framebuffer : m_VkSwapChainFramebuffers) {
-            vkDestroyFramebuffer(m_VkDevice, framebuffer, nullptr);
+            vkDestroyFramebuffer(m_VkDevice, framebuffer, m_VkAllocator);
         }
-        vkDestroyPipeline(m_VkDevice, m_VkGraphicsPipeline, nullptr);
-        vkDestroyPipelineLayout(m_VkDevice, m_VkPipelineLayout, nullptr);
-        vkDestroyRenderPass(m_VkDevice, m_VkRenderPass, nullptr);
+        vkDestroyImageView(m_VkDevice, m_VkDepthImageView, m_VkAllocator);
+        vkDestroyImage(m_VkDevice, m_VkDepthImage, m_VkAllocator);
+        vkFreeMemory(m_VkDevice, m_VkDepthImageMemory, m_VkAllocator);
+        m_PipelineCache.reset(); // owns every pipeline including the fallback
+        vkDestroyPipelineLayout(m_VkDevice, m_VkPipelineLayout, m_VkAllocator);
+        m_SceneObjects.reset();
+        m_UniformRing.reset();
+        vkDestroyRenderPass(m_VkDevice, m_VkOverlayRenderPass, m_VkAllocator);
+        vkDestroyRenderPass(m_VkDevice, m_VkSecondPhaseRenderPass, m_VkAllocator);
+        vkDestroyRenderPass(m_VkDevice, m_VkFirstPhaseRenderPass, m_VkAllocator);
+        vkDestroyRenderPass(m_VkDevice, m_VkRenderPass, m_VkAllocator);
         for (auto imageView : m_VkSwapChainImageViews) {
-            vkDestroyImageView(m_VkDevice, imageView, nullptr);
+            vkDestroyImageView(m_VkDevice, imageView, m_VkAllocator);
         }
-        vkDestroySwapchainKHR(m_VkDevice, m_VkSwapchainKHR, nullptr);
-        vkDestroyDevice(m_VkDevice, nullptr);
-        vkDestroySurfaceKHR(m_VkInstance, m_VkSurfaceKHR, nullptr);
+        vkDestroySwapchainKHR(m_VkDevice, m_VkSwapchainKHR, m_VkAllocator);
+        vkDestroyDevice(m_VkDevice, m_VkAllocator);
+        vkDestroySurfaceKHR(m_VkInstance, m_VkSurfaceKHR, m_VkAllocator);
+#ifdef INCLUDE_DEBUG_INFO
+        m_InstanceDispatch.DestroyDebugUtilsMessengerEXT(m_VkInstance, m_VkDebugUtilsMessengerEXT, m_VkAllocator);
+#endif
+        vkDestroyInstance(m_VkInstance, m_VkAllocator);
 #ifdef INCLUDE_DEBUG_INFO
-        DestroyDebugUtilsMessengerEXT(m_VkInstance, m_VkDebugUtilsMessengerEXT, nullptr);
+        if (m_VkAllocator) {
+            HostAllocationStats total = m_HostAllocator.GetTotalStats();
+            if (m_FrameNumber > 1) {
+                LOG_INFO("Steady state: {:.2f} host allocations per frame", static_cast<double>(total.Allocations - m_FirstFrameAllocations) / static_cast<double>(m_FrameNumber - 1));
+            }
+            m_HostAllocator.Report("Driver host allocations");
+        }
+        if (m_HeapCheckedFrames > 0) {
+            LOG_INFO("Steady state: {:.2f} render thread heap allocations per frame over {} frames", static_cast<double>(m_SteadyHeapAllocations) / static_cast<double>(m_HeapCheckedFrames), m_HeapCheckedFrames);
+        }
 #endif
-        vkDestroyInstance(m_VkInstance, nullptr);
     }
 
     void Application::CreateInstance() {
@@ -160,6 +283,9 @@ namespace VulkanPractice {
         if(!CheckInstanceExtensionSupport(m_InstanceExtensions)) {
             throw std::runtime_error("Instance extensions requested, yet not available!");
         }
+        for (const char* extension : m_OptionalInstanceExtensions) {
+            if (CheckInstanceExtensionSupport({ extension })) m_InstanceExtensions.push_back(extension);
+        }
         createInfo.enabledExtensionCount = static_cast<uint32_t>(m_InstanceExtensions.size());
         createInfo.ppEnabledExtensionNames = m_InstanceExtensions.data();
 
@@ -180,9 +306,10 @@ namespace VulkanPractice {
         debugCreateInfo.pNext = (VkDebugUtilsMessengerCreateInfoEXT*) &debugCreateInfo;
 #endif
 
-        if (vkCreateInstance(&createInfo, nullptr, &m_VkInstance) != VK_SUCCESS) {
+        if (vkCreateInstance(&createInfo, m_VkAllocator, &m_VkInstance) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create Vkinstance!");
         }
+        m_InstanceDispatch.Load(m_VkInstance);
     }
 #ifdef INCLUDE_DEBUG_INFO
     void Application::SetupDebugMessenger() {
@@ -192,13 +319,14 @@ namespace VulkanPractice {
         createInfo.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
         createInfo.pfnUserCallback = DebugCallback;
         createInfo.pUserData = nullptr; // Optional
-        if (CreateDebugUtilsMessengerEXT(m_VkInstance, &createInfo, nullptr, &m_VkDebugUtilsMessengerEXT) != VK_SUCCESS) {
+        if (m_InstanceDispatch.CreateDebugUtilsMessengerEXT == nullptr ||
+            m_InstanceDispatch.CreateDebugUtilsMessengerEXT(m_VkInstance, &createInfo, m_VkAllocator, &m_VkDebugUtilsMessengerEXT) != VK_SUCCESS) {
             throw std::runtime_error("Failed to set up debug messenger!");
         }
     }
 #endif
     void Application::CreateSurface() {
-        if (glfwCreateWindowSurface(m_VkInstance, m_Window->GetNativeWindow(), nullptr, &m_VkSurfaceKHR) != VK_SUCCESS) {
+        if (glfwCreateWindowSurface(m_VkInstance, m_Window->GetNativeWindow(), m_VkAllocator, &m_VkSurfaceKHR) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create window surface!");
         }
     }
@@ -212,17 +340,21 @@ namespace VulkanPractice {
         std::vector<VkPhysicalDevice> devices(deviceCount);
         vkEnumeratePhysicalDevices(m_VkInstance, &deviceCount, devices.data());
         for(const auto& device: devices) {
-            if(IsPhysicalDeviceSuitable(device, m_VkSurfaceKHR, m_DeviceExtensions)) {
+            PhysicalDeviceInfo info = QueryPhysicalDevice(device, m_VkSurfaceKHR);
+            if(IsPhysicalDeviceSuitable(info, m_DeviceExtensions)) {
                 m_VkPhysicalDevice = device;
+                m_PhysicalDeviceInfo = std::move(info);
                 break; // We are using the first device match, however multiple devices can be used
             }
         }
         if (m_VkPhysicalDevice == VK_NULL_HANDLE) {
             throw std::runtime_error("Failed to find a suitable GPU!");
         }
+        /* Surface formats never change --> picked here so the render pass and pipeline do not wait on the swapchain */
+        m_VkSwapChainImageFormat = ChooseSwapSurfaceFormat(m_PhysicalDeviceInfo.SwapChainSupport.Formats).format;
     }
     void Application::CreateLogicalDevice() {
-        QueueFamilyIndices indices = FindQueueFamilies(m_VkPhysicalDevice, m_VkSurfaceKHR);
+        const QueueFamilyIndices& indices = m_PhysicalDeviceInfo.QueueFamilies;
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
         std::set<uint32_t> uniqueQueueFamilies = {
             indices.GraphicsFamily.value(),
@@ -237,26 +369,91 @@ namespace VulkanPractice {
             queueCreateInfo.pQueuePriorities = &queuePriority;
             queueCreateInfos.push_back(queueCreateInfo);
         }
-        VkPhysicalDeviceFeatures deviceFeatures{}; // simply define --> enable features for future fancier use
+        /* Only turn on what the device has --> textures check these before picking a compressed format */
+        const VkPhysicalDeviceFeatures& supportedFeatures = m_PhysicalDeviceInfo.Features;
+        VkPhysicalDeviceFeatures deviceFeatures{};
+        deviceFeatures.samplerAnisotropy = supportedFeatures.samplerAnisotropy;
+        deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+        deviceFeatures.textureCompressionETC2 = supportedFeatures.textureCompressionETC2;
+        deviceFeatures.textureCompressionASTC_LDR = supportedFeatures.textureCompressionASTC_LDR;
+        /* Culled draws come from GPU written commands whose first instance is the object index --> batched into one call where multi draw exists */
+        m_OcclusionCullingEnabled = m_OcclusionCulling && supportedFeatures.drawIndirectFirstInstance;
+        deviceFeatures.drawIndirectFirstInstance = m_OcclusionCullingEnabled ? VK_TRUE : VK_FALSE;
+        deviceFeatures.multiDrawIndirect = m_OcclusionCullingEnabled ? supportedFeatures.multiDrawIndirect : VK_FALSE;
 
         VkDeviceCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
         createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
         createInfo.pQueueCreateInfos = queueCreateInfos.data();
         createInfo.pEnabledFeatures = &deviceFeatures;
-        createInfo.enabledExtensionCount = static_cast<uint32_t>(m_DeviceExtensions.size());
-        createInfo.ppEnabledExtensionNames = m_DeviceExtensions.data();
+        /* Budget queries go through vkGetPhysicalDeviceMemoryProperties2KHR --> only useful with the instance extension loaded */
+        std::vector<const char*> enabledExtensions = m_DeviceExtensions;
+        bool hasProperties2 = std::any_of(m_InstanceExtensions.begin(), m_InstanceExtensions.end(),
+            [](const char* extension) { return std::strcmp(extension, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) == 0; });
+        m_MemoryBudgetEnabled = hasProperties2 && m_InstanceDispatch.GetPhysicalDeviceMemoryProperties2KHR != nullptr &&
+            CheckDeviceExtensionSupport(m_PhysicalDeviceInfo.Extensions, { VK_EXT_MEMORY_BUDGET_EXTENSION_NAME });
+        if (m_MemoryBudgetEnabled) enabledExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+        createInfo.ppEnabledExtensionNames = enabledExtensions.data();
         createInfo.enabledLayerCount = 0;
-        if (vkCreateDevice(m_VkPhysicalDevice, &createInfo, nullptr, &m_VkDevice) != VK_SUCCESS) {
+        if (vkCreateDevice(m_VkPhysicalDevice, &createInfo, m_VkAllocator, &m_VkDevice) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create logical device!");
         }
+        m_DeviceDispatch.Load(m_InstanceDispatch, m_VkDevice);
         // Get Graphics Queue Handle
         vkGetDeviceQueue(m_VkDevice, indices.GraphicsFamily.value(), 0, &m_VkGraphicsQueue);
         vkGetDeviceQueue(m_VkDevice, indices.PresentFamily.value(), 0, &m_VkPresentQueue);
 
+        m_DeviceContext.PhysicalDevice = m_VkPhysicalDevice;
+        m_DeviceContext.Device = m_VkDevice;
+        m_DeviceContext.GraphicsQueue = m_VkGraphicsQueue;
+        m_DeviceContext.Dispatch = &m_DeviceDispatch;
+        m_DeviceContext.Allocator = m_VkAllocator;
+        m_DeviceContext.EnabledFeatures = deviceFeatures;
+        m_DeviceContext.Limits = m_PhysicalDeviceInfo.Properties.limits;
+        m_PipelineCache = std::make_unique<PipelineCache>(m_DeviceContext, 1, &m_Metrics);
+    }
+    void Application::CreateMemoryBudget() {
+        m_MemoryBudget = std::make_unique<MemoryBudget>(m_DeviceContext, m_MemoryBudgetEnabled ? m_InstanceDispatch.GetPhysicalDeviceMemoryProperties2KHR : nullptr);
+        /* Streamed assets reload from disk on their next use --> the first thing to go when device memory runs short */
+        m_MemoryBudget->AddPressureCallback(0, [this](const HeapBudget& heap, uint64_t bytesOver) -> uint64_t {
+            if (!(heap.Flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)) return 0;
+            uint64_t released = m_AssetStreamer->Trim(bytesOver);
+            /* Hold the streamer where it is now so the next uploads do not refill the heap straight away */
+            m_AssetStreamer->SetResidencyBudget(std::min(m_AssetStreamer->GetResidencyBudget(), m_AssetStreamer->GetResidentBytes()));
+            return released;
+        });
+    }
+    void Application::CreateMetrics() {
+        std::vector<double> frameBuckets = MetricsRegistry::ExponentialBuckets(0.25, 2.0, 10); // 0.25 ms .. 128 ms
+        std::vector<double> waitBuckets = MetricsRegistry::ExponentialBuckets(0.05, 2.0, 12); // 50 us .. 102 ms
+        m_FrameMetrics.Frames = &m_Metrics.Counter("frames_total", "Frames submitted and presented");
+        m_FrameMetrics.SwapchainRecreations = &m_Metrics.Counter("swapchain_recreations_total", "Main window swapchain recreations");
+        m_FrameMetrics.CpuTime = &m_Metrics.Histogram("frame_cpu_milliseconds", "Render thread time of one presented frame", frameBuckets);
+        m_FrameMetrics.GpuTime = &m_Metrics.Histogram("frame_gpu_milliseconds", "GPU time of one frame from timestamp queries", frameBuckets);
+        m_FrameMetrics.FenceWait = &m_Metrics.Histogram("frame_fence_wait_milliseconds", "Render thread wait for the frame slot fence", waitBuckets);
+        m_FrameMetrics.Acquire = &m_Metrics.Histogram("frame_acquire_milliseconds", "vkAcquireNextImageKHR of the main window", waitBuckets);
+        m_FrameMetrics.Submit = &m_Metrics.Histogram("frame_submit_milliseconds", "vkQueueSubmit of every window", waitBuckets);
+        m_FrameMetrics.Present = &m_Metrics.Histogram("frame_present_milliseconds", "vkQueuePresentKHR of every window", waitBuckets);
+        m_FrameMetrics.HostBytes = &m_Metrics.Gauge("host_allocated_bytes", "Driver host allocations live through HostAllocator");
+        m_FrameMetrics.ResidentBytes = &m_Metrics.Gauge("asset_resident_bytes", "Streamed asset bytes resident on the device");
+        m_FrameMetrics.TimeToFirstFrame = &m_Metrics.Gauge("startup_first_frame_milliseconds", "Construction start to the first presented frame");
+        for (const HeapBudget& heap : m_MemoryBudget->GetHeaps()) {
+            std::string label = "heap=\"" + std::to_string(heap.Index) + "\"";
+            m_FrameMetrics.HeapUsage.push_back(&m_Metrics.Gauge("memory_heap_usage_bytes", "Device memory heap usage of this process", label));
+            m_FrameMetrics.HeapBudget.push_back(&m_Metrics.Gauge("memory_heap_budget_bytes", "Device memory heap budget reported by the driver", label));
+        }
+        if (!MetricsServer::IsEnabled(m_MetricsServerConfig)) return;
+        /* Metrics are diagnostics --> a taken port must not stop the application */
+        try {
+            m_MetricsServer = std::make_unique<MetricsServer>(m_Metrics, m_MetricsServerConfig);
+        } catch (const std::runtime_error& error) {
+            LOG_WARN("Metrics export disabled --> {}", error.what());
+        }
     }
     void Application::CreateSwapChain() {
-        SwapChainSupportDetails swapChainSupport = QuerySwapChainSupport(m_VkPhysicalDevice, m_VkSurfaceKHR);
+        SwapChainSupportDetails& swapChainSupport = m_PhysicalDeviceInfo.SwapChainSupport;
+        m_InstanceDispatch.GetPhysicalDeviceSurfaceCapabilitiesKHR(m_VkPhysicalDevice, m_VkSurfaceKHR, &swapChainSupport.Capabilities); // current extent follows the window
         VkSurfaceFormatKHR surfaceFormat = ChooseSwapSurfaceFormat(swapChainSupport.Formats);
         VkPresentModeKHR presentMode = ChooseSwapPresentMode(swapChainSupport.PresentModes);
         VkExtent2D extent = ChooseSwapExtent(swapChainSupport.Capabilities, m_Window);
@@ -273,8 +470,11 @@ namespace VulkanPractice {
         createInfo.imageExtent = extent;
         createInfo.imageArrayLayers = 1;
         createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT; // for now direct attachment
+        if (!m_FrameCaptureConfig.Directory.empty() && (swapChainSupport.Capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)) {
+            createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT; // copied out by FrameCapture
+        }
 
-        QueueFamilyIndices indices = FindQueueFamilies(m_VkPhysicalDevice, m_VkSurfaceKHR);
+        const QueueFamilyIndices& indices = m_PhysicalDeviceInfo.QueueFamilies;
         uint32_t queueFamilyIndices[] = {
             indices.GraphicsFamily.value(), indices.PresentFamily.value()
         };
@@ -294,7 +494,7 @@ namespace VulkanPractice {
         createInfo.presentMode = presentMode;
         createInfo.clipped = VK_TRUE; // This part meddles when other windows are in front of current window clipping the pixels --> If vulkan is used for compute shaders then might want to set this VK_FALSE
         createInfo.oldSwapchain = VK_NULL_HANDLE; // This is about window resizing --> This would be handled in the future
-        if (vkCreateSwapchainKHR(m_VkDevice, &createInfo, nullptr, &m_VkSwapchainKHR) != VK_SUCCESS) {
+        if (vkCreateSwapchainKHR(m_VkDevice, &createInfo, m_VkAllocator, &m_VkSwapchainKHR) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create swap chain!");
         }
         // Get Swapchain images handle
@@ -324,287 +524,213 @@ namespace VulkanPractice {
             createInfo.subresourceRange.levelCount = 1;
             createInfo.subresourceRange.baseArrayLayer = 0;
             createInfo.subresourceRange.layerCount = 1;
-            if (vkCreateImageView(m_VkDevice, &createInfo, nullptr, &m_VkSwapChainImageViews[i]) != VK_SUCCESS) {
+            if (vkCreateImageView(m_VkDevice, &createInfo, m_VkAllocator, &m_VkSwapChainImageViews[i]) != VK_SUCCESS) {
                 throw std::runtime_error("Failed to create image views!");
             }
         }
     }
-    /* TODO: Abstract Shader Functionalities */
-    static std::vector<char> ReadFile(const std::string& filename) {
-        std::ifstream file(filename, std::ios::ate | std::ios::binary);
-
-        if (!file.is_open()) {
-            throw std::runtime_error("Failed to open file!");
+    void Application::CreateUniformRing() {
+        /* Sized for the frame-in-flight cap since the swapchain image count is not final yet */
+        uint32_t persistentBlocks = m_CacheCommandBuffers ? s_MaxCachedImages : 0;
+        m_UniformRing = std::make_unique<UniformRing>(m_DeviceContext, m_UniformBytesPerFrame, s_FramesInFlightLimit, 256, persistentBlocks);
+        for (uint32_t i = 0; i < persistentBlocks; i++) {
+            m_CachedFrameUniforms.push_back(m_UniformRing->AllocatePersistent());
         }
-        size_t fileSize = (size_t) file.tellg();
-        std::vector<char> buffer(fileSize);
-        file.seekg(0);
-        file.read(buffer.data(), fileSize);
-        file.close();
-        return buffer;
     }
-    void Application::CreateGraphicsPipeline() {
-        /* Shaders */
-        auto vertShaderCode = ReadFile(std::string(SHADER_DIR) + "/SPRIV/vert.spv");
-        auto fragShaderCode = ReadFile(std::string(SHADER_DIR) + "/SPRIV/frag.spv");
-        VkShaderModule vertShaderModule, fragShaderModule;
-        {
-            VkShaderModuleCreateInfo createInfo{};
-            createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-            createInfo.codeSize = vertShaderCode.size();
-            createInfo.pCode = reinterpret_cast<const uint32_t*>(vertShaderCode.data());
-            if (vkCreateShaderModule(m_VkDevice, &createInfo, nullptr, &vertShaderModule) != VK_SUCCESS) {
-                throw std::runtime_error("Failed to create vertex shader module!");
+    void Application::CreateSceneObjects() {
+        /* A grid of small instances in the back and a few large ones in front hiding part of it --> see the depth range in GatherFrameContent */
+        uint32_t gridSize = std::max(m_SceneGridSize, 1U);
+        float spacing = 2.0f / static_cast<float>(gridSize);
+        TransformSystem::NodeId grid = m_SceneTransforms.Add(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -0.5f)));
+        TransformSystem::NodeId occluders = m_SceneTransforms.Add(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.5f)));
+        for (uint32_t y = 0; y < gridSize; y++) {
+            for (uint32_t x = 0; x < gridSize; x++) {
+                glm::vec3 position(-1.0f + spacing * (x + 0.5f), -1.0f + spacing * (y + 0.5f), 0.0f);
+                m_SceneNodes.push_back(m_SceneTransforms.Add(glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(spacing * 0.8f)), grid));
             }
         }
-        {
-            VkShaderModuleCreateInfo createInfo{};
-            createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-            createInfo.codeSize = fragShaderCode.size();
-            createInfo.pCode = reinterpret_cast<const uint32_t*>(fragShaderCode.data());
-            if (vkCreateShaderModule(m_VkDevice, &createInfo, nullptr, &fragShaderModule) != VK_SUCCESS) {
-                throw std::runtime_error("Failed to create fragment shader module!");
-            }
+        for (int i = -1; i <= 1; i++) {
+            glm::vec3 position(0.9f * static_cast<float>(i), 0.0f, 0.0f);
+            m_SceneNodes.push_back(m_SceneTransforms.Add(glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(1.2f)), occluders));
         }
-        VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
-        vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-        vertShaderStageInfo.module = vertShaderModule;
-        vertShaderStageInfo.pName = "main";
-        vertShaderStageInfo.pSpecializationInfo = nullptr; // initial values i can set
-        VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
-        fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-        fragShaderStageInfo.module = fragShaderModule;
-        fragShaderStageInfo.pName = "main";
-        fragShaderStageInfo.pSpecializationInfo = nullptr; // initial values i can set
-        VkPipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo, fragShaderStageInfo };
-
-        struct Vertex {
-            glm::vec2 Position;
-            glm::vec3 Color;
-            static VkVertexInputBindingDescription getBindingDescription() {
-                VkVertexInputBindingDescription bindingDescription{};
-                bindingDescription.binding = 0;
-                bindingDescription.stride = sizeof(Vertex);
-                bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-                return bindingDescription;
-            }
-        };
-        std::vector<Vertex> vertices = {
-            {{  0.0f, -0.5f }, { 1.0f, 0.0f, 0.0f }},
-            {{  0.5f,  0.5f }, { 0.0f, 1.0f, 0.0f }},
-            {{ -0.5f,  0.5f }, { 0.0f, 0.0f, 1.0f }},
-        };
-
-        /* Vertex Input */ // Currently referencing no data
-        VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInputInfo.vertexBindingDescriptionCount = 0;
-        vertexInputInfo.pVertexBindingDescriptions = nullptr; // Optional
-        vertexInputInfo.vertexAttributeDescriptionCount = 0;
-        vertexInputInfo.pVertexAttributeDescriptions = nullptr; // Optional
-
-        /* Input Assembly */
-        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-        inputAssembly.primitiveRestartEnable = VK_FALSE; // splitting
-
-        /* Dynamics States setup requiring these stages to be setup on drawing time not pipeline setup */
-        std::vector<VkDynamicState> dynamicStates = {
-            VK_DYNAMIC_STATE_VIEWPORT,
-            VK_DYNAMIC_STATE_SCISSOR
-        };
-        VkPipelineDynamicStateCreateInfo dynamicState{};
-        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
-        dynamicState.pDynamicStates = dynamicStates.data();
-
-        VkPipelineViewportStateCreateInfo viewportState{}; // since it is dynamic only specify count
-        viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-        viewportState.viewportCount = 1;
-        viewportState.scissorCount = 1;
-
-        /* Raserizer */
-        VkPipelineRasterizationStateCreateInfo rasterizer{};
-        rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-        rasterizer.depthClampEnable = VK_FALSE; // might be used for shadows --> Requires GPU Feature
-        rasterizer.rasterizerDiscardEnable = VK_FALSE; // if true blocks any output to framebuffer
-        rasterizer.polygonMode = VK_POLYGON_MODE_FILL; // VK_POLYGON_MODE_FILL or VK_POLYGON_MODE_LINE or VK_POLYGON_MODE_POINT possible // any other than fill requires GPU Feature
-        rasterizer.lineWidth = 1.0f;
-        rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-        rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
-
-        rasterizer.depthBiasEnable = VK_FALSE; // alter depth values
-        rasterizer.depthBiasConstantFactor = 0.0f; // Optional
-        rasterizer.depthBiasClamp = 0.0f; // Optional
-        rasterizer.depthBiasSlopeFactor = 0.0f; // Optional
-
-        /* Multisampling */
-        VkPipelineMultisampleStateCreateInfo multisampling{}; // Allows to store multiple samples per pixel (smoother) --> Requires GPU Feature
-        multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-        multisampling.sampleShadingEnable = VK_FALSE;
-        multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-        multisampling.minSampleShading = 1.0f; // Optional
-        multisampling.pSampleMask = nullptr; // Optional
-        multisampling.alphaToCoverageEnable = VK_FALSE; // Optional
-        multisampling.alphaToOneEnable = VK_FALSE; // Optional
-
-        /* Blending */
-        VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-        colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-        colorBlendAttachment.blendEnable = VK_FALSE;
-        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE; // Optional
-        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO; // Optional
-        colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD; // Optional
-        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE; // Optional
-        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO; // Optional
-        colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD; // Optional
+        m_SceneTransforms.Update();
+#ifdef INCLUDE_DEBUG_INFO
+        LOG_INFO("Scene transforms --> {} nodes, {} kernels", m_SceneTransforms.GetCount(), m_SceneTransforms.GetKernels().Name);
+#endif
 
-        // // In case of Blending
-        // colorBlendAttachment.blendEnable = VK_TRUE;
-        // colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-        // colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-        // colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
-        // colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-        // colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-        // colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
-
-        VkPipelineColorBlendStateCreateInfo colorBlending{};
-        colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-        colorBlending.logicOpEnable = VK_FALSE;
-        colorBlending.logicOp = VK_LOGIC_OP_COPY; // Optional
-        colorBlending.attachmentCount = 1;
-        colorBlending.pAttachments = &colorBlendAttachment;
-        colorBlending.blendConstants[0] = 0.0f; // Optional
-        colorBlending.blendConstants[1] = 0.0f; // Optional
-        colorBlending.blendConstants[2] = 0.0f; // Optional
-        colorBlending.blendConstants[3] = 0.0f; // Optional
-
-        /* Regards Uniforms */
+        std::vector<ObjectData> objects;
+        for (uint32_t object = 0; object < m_SceneNodes.size(); object++) {
+            objects.push_back({ m_SceneTransforms.GetWorld(m_SceneNodes[object]) });
+        }
+        m_SceneObjects = std::make_unique<SceneObjects>(m_DeviceContext, objects);
+    }
+    void Application::LoadShaderLibrary() {
+        m_ShaderLibrary.Declare("basic.vert", VK_SHADER_STAGE_VERTEX_BIT, std::string(SHADER_DIR) + "/GLSL/basic.vert", {
+            { "INSTANCE_TINT", ShaderFeatureKind::Specialization, 0 },
+            { "FLAT_COLOR", ShaderFeatureKind::Define } // interpolation qualifiers cannot be specialized
+        });
+        m_ShaderLibrary.Declare("basic.frag", VK_SHADER_STAGE_FRAGMENT_BIT, std::string(SHADER_DIR) + "/GLSL/basic.frag", {
+            { "GRAYSCALE", ShaderFeatureKind::Specialization, 0 },
+            { "FLAT_COLOR", ShaderFeatureKind::Define }
+        });
+        m_ShaderLibrary.LoadManifest(m_ShaderManifestPath);
+    }
+    void Application::CreateGraphicsPipeline() {
+        /* Regards Uniforms */ // set 0 = per frame ring, set 1 = scene objects, push constants = per draw
+        VkDescriptorSetLayout setLayouts[] = { m_UniformRing->GetDescriptorSetLayout(), m_SceneObjects->GetDescriptorSetLayout() };
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(DrawPushConstants);
         VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
         pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pipelineLayoutInfo.setLayoutCount = 0; // Optional
-        pipelineLayoutInfo.pSetLayouts = nullptr; // Optional
-        pipelineLayoutInfo.pushConstantRangeCount = 0; // Optional
-        pipelineLayoutInfo.pPushConstantRanges = nullptr; // Optional
-        if (vkCreatePipelineLayout(m_VkDevice, &pipelineLayoutInfo, nullptr, &m_VkPipelineLayout) != VK_SUCCESS) {
+        pipelineLayoutInfo.setLayoutCount = 2;
+        pipelineLayoutInfo.pSetLayouts = setLayouts;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+        if (vkCreatePipelineLayout(m_VkDevice, &pipelineLayoutInfo, m_VkAllocator, &m_VkPipelineLayout) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create pipeline layout!");
         }
 
-        VkGraphicsPipelineCreateInfo pipelineInfo{};
-        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        pipelineInfo.stageCount = 2; // vertex and fragment
-        pipelineInfo.pStages = shaderStages;
-        pipelineInfo.pVertexInputState = &vertexInputInfo;
-        pipelineInfo.pInputAssemblyState = &inputAssembly;
-        pipelineInfo.pViewportState = &viewportState;
-        pipelineInfo.pRasterizationState = &rasterizer;
-        pipelineInfo.pMultisampleState = &multisampling;
-        pipelineInfo.pDepthStencilState = nullptr; // Optional
-        pipelineInfo.pColorBlendState = &colorBlending;
-        pipelineInfo.pDynamicState = &dynamicState;
-        pipelineInfo.layout = m_VkPipelineLayout;
-        pipelineInfo.renderPass = m_VkRenderPass;
-        pipelineInfo.subpass = 0;
-        pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
-        pipelineInfo.basePipelineIndex = -1; // Optional
+        /* Shaders */ // set and compiled at the start of InitVulkan
+        /* Vertex Input */ // Packed layout from MeshFormat
+        auto attributeDescriptions = Mesh::GetAttributeDescriptions();
+        m_BasicPipelineDesc.VertexBindings = { Mesh::GetBindingDescription() };
+        m_BasicPipelineDesc.VertexAttributes.assign(attributeDescriptions.begin(), attributeDescriptions.end());
+        /* Raserizer */
+        m_BasicPipelineDesc.CullMode = VK_CULL_MODE_BACK_BIT;
+        m_BasicPipelineDesc.FrontFace = VK_FRONT_FACE_CLOCKWISE;
+        /* Depth */
+        m_BasicPipelineDesc.DepthTestEnable = true;
+        m_BasicPipelineDesc.DepthWriteEnable = true;
+        /* Render Targets */
+        m_BasicPipelineDesc.ColorFormats = { m_VkSwapChainImageFormat };
+        m_BasicPipelineDesc.DepthFormat = m_DepthFormat;
+        m_BasicPipelineDesc.Layout = m_VkPipelineLayout;
+        m_BasicPipelineDesc.RenderPass = m_VkRenderPass;
 
-        if (vkCreateGraphicsPipelines(m_VkDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_VkGraphicsPipeline) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to create graphics pipeline!");
+        // // In case of Blending
+        // m_BasicPipelineDesc.ColorBlend[0].BlendEnable = true;
+        // m_BasicPipelineDesc.ColorBlend[0].SrcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        // m_BasicPipelineDesc.ColorBlend[0].DstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    }
+    void Application::CreateRenderPass() {
+        /* The Hi-Z build samples depth --> culling needs a format that allows it, everything else only needs an attachment */
+        if (m_OcclusionCullingEnabled) {
+            m_DepthFormat = VulkanUtils::FindDepthFormat(m_VkPhysicalDevice, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
+            m_OcclusionCullingEnabled = m_DepthFormat != VK_FORMAT_UNDEFINED;
+        }
+        if (!m_OcclusionCullingEnabled) m_DepthFormat = VulkanUtils::FindDepthFormat(m_VkPhysicalDevice);
+        if (m_DepthFormat == VK_FORMAT_UNDEFINED) {
+            throw std::runtime_error("Failed to find a depth format!");
         }
 
-        vkDestroyShaderModule(m_VkDevice, fragShaderModule, nullptr);
-        vkDestroyShaderModule(m_VkDevice, vertShaderModule, nullptr);
+        RenderPassDesc desc;
+        desc.ColorFormat = m_VkSwapChainImageFormat;
+        desc.ColorInitialLayout = VK_IMAGE_LAYOUT_UNDEFINED; // I don't care what layout it was in before
+        desc.ColorFinalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR; // I am going to present to screen
+        desc.DepthFormat = m_DepthFormat;
+        m_VkRenderPass = VulkanUtils::CreateRenderPass(m_DeviceContext, desc);
+        if (!m_OcclusionCullingEnabled) return;
+        /* Same pass split around the Hi-Z build --> the first leaves depth readable, the second continues on both attachments */
+        RenderPassDesc firstPhase = desc;
+        firstPhase.ColorFinalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        firstPhase.DepthFinalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        firstPhase.StoreDepth = true;
+        m_VkFirstPhaseRenderPass = VulkanUtils::CreateRenderPass(m_DeviceContext, firstPhase);
+        RenderPassDesc secondPhase = desc;
+        secondPhase.ColorInitialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        secondPhase.DepthInitialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        secondPhase.Load = true;
+        m_VkSecondPhaseRenderPass = VulkanUtils::CreateRenderPass(m_DeviceContext, secondPhase);
+        /* Culled frames end presentable --> the overlay picks both attachments up from there */
+        RenderPassDesc overlay = desc;
+        overlay.ColorInitialLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        overlay.DepthInitialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        overlay.Load = true;
+        m_VkOverlayRenderPass = VulkanUtils::CreateRenderPass(m_DeviceContext, overlay);
     }
-    void Application::CreateRenderPass() {
-        // Currently only color attachment --> depth testing disabled
-        VkAttachmentDescription colorAttachment{};
-        colorAttachment.format = m_VkSwapChainImageFormat;
-        colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT; // regarding multisampling --> currently only one sample per pixel
-        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR; // Clear any previous attatchments left
-        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE; // Keep current stored for later on presenting
-        colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED; // I don't care what layout it was in before
-        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR; // I am going to present to screen
-
-        VkAttachmentReference colorAttachmentRef{};
-        colorAttachmentRef.attachment = 0; // the location=0 of fragment shader
-        colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-        
-        VkSubpassDescription subpass{};
-        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        subpass.colorAttachmentCount = 1;
-        subpass.pColorAttachments = &colorAttachmentRef;
-        VkRenderPassCreateInfo renderPassInfo{};
-
-        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        renderPassInfo.attachmentCount = 1;
-        renderPassInfo.pAttachments = &colorAttachment;
-        renderPassInfo.subpassCount = 1;
-        renderPassInfo.pSubpasses = &subpass;
-
-        VkSubpassDependency dependency{};
-        dependency.srcSubpass = VK_SUBPASS_EXTERNAL; // previous stage external
-        dependency.dstSubpass = 0; // we are configuring the 0th one
-        dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dependency.srcAccessMask = 0;
-        dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
-        renderPassInfo.dependencyCount = 1;
-        renderPassInfo.pDependencies = &dependency;
-
-
-        if (vkCreateRenderPass(m_VkDevice, &renderPassInfo, nullptr, &m_VkRenderPass) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create render pass!");
-        } 
+    void Application::CreateDepthResources() {
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = m_DepthFormat;
+        imageInfo.extent = { m_VkSwapChainExtent.width, m_VkSwapChainExtent.height, 1 };
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | (m_OcclusionCullingEnabled ? VK_IMAGE_USAGE_SAMPLED_BIT : 0);
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VulkanUtils::CreateImage(m_DeviceContext, imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_VkDepthImage, m_VkDepthImageMemory);
+        m_VkDepthImageView = VulkanUtils::CreateImageView(m_DeviceContext, m_VkDepthImage, m_DepthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, 1);
     }
     void Application::CreateFramebuffers() {
         m_VkSwapChainFramebuffers.resize(m_VkSwapChainImageViews.size());
         for (size_t i = 0; i < m_VkSwapChainImageViews.size(); i++) {
             VkImageView attachments[] = {
-                m_VkSwapChainImageViews[i]
+                m_VkSwapChainImageViews[i],
+                m_VkDepthImageView
             };
 
             VkFramebufferCreateInfo framebufferInfo{};
             framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
             framebufferInfo.renderPass = m_VkRenderPass;
-            framebufferInfo.attachmentCount = 1;
+            framebufferInfo.attachmentCount = 2;
             framebufferInfo.pAttachments = attachments;
             framebufferInfo.width = m_VkSwapChainExtent.width;
             framebufferInfo.height = m_VkSwapChainExtent.height;
             framebufferInfo.layers = 1;
 
-            if (vkCreateFramebuffer(m_VkDevice, &framebufferInfo, nullptr, &m_VkSwapChainFramebuffers[i]) != VK_SUCCESS) {
+            if (vkCreateFramebuffer(m_VkDevice, &framebufferInfo, m_VkAllocator, &m_VkSwapChainFramebuffers[i]) != VK_SUCCESS) {
                 throw std::runtime_error("Failed to create framebuffer!");
             }
         }
     }
     void Application::CreateCommandPool() {
-        QueueFamilyIndices queueFamilyIndices = FindQueueFamilies(m_VkPhysicalDevice, m_VkSurfaceKHR);
+        const QueueFamilyIndices& queueFamilyIndices = m_PhysicalDeviceInfo.QueueFamilies;
 
         VkCommandPoolCreateInfo poolInfo{};
         poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
         poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
         poolInfo.queueFamilyIndex = queueFamilyIndices.GraphicsFamily.value();
-        if (vkCreateCommandPool(m_VkDevice, &poolInfo, nullptr, &m_VkCommandPool) != VK_SUCCESS) {
+        if (vkCreateCommandPool(m_VkDevice, &poolInfo, m_VkAllocator, &m_VkCommandPool) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create command pool!");
         }
+        m_DeviceContext.GraphicsQueueFamily = queueFamilyIndices.GraphicsFamily.value();
+        m_DeviceContext.CommandPool = m_VkCommandPool;
+        m_SamplerCache = std::make_unique<SamplerCache>(m_DeviceContext);
+    }
+    void Application::LoadMesh() {
+        AssetStreamerConfig config;
+        config.ResidencyBudget = m_AssetResidencyBudget;
+        config.FramesInFlight = s_FramesInFlightLimit; // requested before the swapchain exists --> upper bound
+        m_AssetStreamer = std::make_unique<AssetStreamer>(config);
+        /* File is read off the render thread --> only recording the GPU upload happens inside DrawFrame, its fence is polled on later frames */
+        m_MeshHandle = m_AssetStreamer->Request(m_MeshPath, AssetPriority::Critical,
+            [this](const std::vector<uint8_t>& data, const std::string& path, uint64_t& residentBytes) {
+                auto mesh = std::make_shared<Mesh>(m_DeviceContext, data.data(), data.size(), path);
+                residentBytes = mesh->GetResidentBytes();
+                return std::static_pointer_cast<void>(mesh);
+            },
+            [](void* mesh) { return static_cast<Mesh*>(mesh)->IsUploadComplete(); });
     }
     void Application::CreateCommandBuffers() {
-        m_MaxFramesInFlight = std::min(3U, static_cast<uint32_t>(m_VkSwapChainImageViews.size())); // This line added to grap image count
+        m_MaxFramesInFlight = std::min(s_FramesInFlightLimit, static_cast<uint32_t>(m_VkSwapChainImageViews.size())); // This line added to grap image count
         VkCommandBufferAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
         allocInfo.commandPool = m_VkCommandPool;
         allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
         allocInfo.commandBufferCount = m_MaxFramesInFlight; // Allocate one per frame
         m_VkCommandBuffers.resize(m_MaxFramesInFlight);
+        m_FrameArenas.resize(m_MaxFramesInFlight);
         if (vkAllocateCommandBuffers(m_VkDevice, &allocInfo, m_VkCommandBuffers.data()) != VK_SUCCESS) {
             throw std::runtime_error("Failed to allocate command buffers!");
         }
+        if (m_CacheCommandBuffers) {
+            m_CommandBufferCache = std::make_unique<CommandBufferCache>(m_DeviceContext, static_cast<uint32_t>(m_SwapChainImages.size()));
+        }
     }
     void Application::CreateSyncObjects() {
         VkSemaphoreCreateInfo semaphoreInfo{};
@@ -616,24 +742,274 @@ namespace VulkanPractice {
         m_VkRenderFinishedSemaphores.resize(m_MaxFramesInFlight);
         m_VkInFlightFences.resize(m_MaxFramesInFlight);
         for (size_t i = 0; i < m_MaxFramesInFlight; i++) {
-            if (vkCreateSemaphore(m_VkDevice, &semaphoreInfo, nullptr, &m_VkImageAvailableSemaphores[i]) != VK_SUCCESS ||
-                vkCreateSemaphore(m_VkDevice, &semaphoreInfo, nullptr, &m_VkRenderFinishedSemaphores[i]) != VK_SUCCESS ||
-                vkCreateFence(m_VkDevice, &fenceInfo, nullptr, &m_VkInFlightFences[i]) != VK_SUCCESS) {
+            if (vkCreateSemaphore(m_VkDevice, &semaphoreInfo, m_VkAllocator, &m_VkImageAvailableSemaphores[i]) != VK_SUCCESS ||
+                vkCreateSemaphore(m_VkDevice, &semaphoreInfo, m_VkAllocator, &m_VkRenderFinishedSemaphores[i]) != VK_SUCCESS ||
+                vkCreateFence(m_VkDevice, &fenceInfo, m_VkAllocator, &m_VkInFlightFences[i]) != VK_SUCCESS) {
                 throw std::runtime_error("Failed to create semaphores and fences!");
             }
         }
+        m_ImagesInFlight.assign(m_SwapChainImages.size(), VK_NULL_HANDLE);
     }
 
-    void Application::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
+    void Application::CreateExtraWindows() {
+        for (const WindowConfig& config : m_ExtraWindowConfigs) {
+            auto window = std::make_unique<Window>(config.Width, config.Height, config.Title);
+            VkSurfaceKHR surface;
+            if (glfwCreateWindowSurface(m_VkInstance, window->GetNativeWindow(), m_VkAllocator, &surface) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create window surface!");
+            }
+            /* Same render pass and pipelines as the main window --> the surface has to take its color format */
+            SwapChainSupportDetails support = QuerySwapChainSupport(m_VkPhysicalDevice, surface);
+            VkBool32 presentSupport = VK_FALSE;
+            vkGetPhysicalDeviceSurfaceSupportKHR(m_VkPhysicalDevice, m_PhysicalDeviceInfo.QueueFamilies.PresentFamily.value(), surface, &presentSupport);
+            auto format = std::find_if(support.Formats.begin(), support.Formats.end(), [this](const VkSurfaceFormatKHR& available) {
+                return available.format == m_VkSwapChainImageFormat;
+            });
+            if (!presentSupport || format == support.Formats.end()) {
+                vkDestroySurfaceKHR(m_VkInstance, surface, m_VkAllocator);
+                throw std::runtime_error("Failed to present an extra window with the main window's device and format!");
+            }
+            SwapchainTargetDesc desc;
+            desc.SurfaceFormat = *format;
+            desc.PresentMode = ChooseSwapPresentMode(support.PresentModes);
+            desc.DepthFormat = m_DepthFormat;
+            desc.RenderPass = m_VkRenderPass;
+            desc.FramesInFlight = m_MaxFramesInFlight;
+            desc.PresentQueueFamily = m_PhysicalDeviceInfo.QueueFamilies.PresentFamily.value();
+            GLFWwindow* nativeWindow = window->GetNativeWindow();
+            auto extraWindow = std::make_unique<ExtraWindow>();
+            extraWindow->Target = std::make_unique<SwapchainTarget>(m_DeviceContext, m_VkInstance, std::move(window), surface, desc);
+            glfwSetWindowUserPointer(nativeWindow, extraWindow->Target.get());
+            glfwSetFramebufferSizeCallback(nativeWindow, ExtraWindowResizeCallback);
+            glfwSetWindowFocusCallback(nativeWindow, WindowFocusCallback); // focus moving between our windows keeps the pacer focused
+            glfwSetWindowRefreshCallback(nativeWindow, WindowRefreshCallback);
+            glfwSetKeyCallback(nativeWindow, KeyCallback);
+            glfwSetMouseButtonCallback(nativeWindow, MouseButtonCallback);
+            glfwSetCursorPosCallback(nativeWindow, CursorPosCallback);
+            glfwSetScrollCallback(nativeWindow, ScrollCallback);
+            m_ExtraWindows.push_back(std::move(extraWindow));
+        }
+    }
+    void Application::CreateFrameCapture() {
+        if (m_FrameCaptureConfig.Directory.empty()) return;
+        if (!(m_PhysicalDeviceInfo.SwapChainSupport.Capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) ||
+            !FrameCapture::IsFormatSupported(m_VkSwapChainImageFormat)) {
+            LOG_WARN("Frame capture disabled --> swapchain images cannot be copied out in a supported format");
+            return;
+        }
+        m_FrameCapture = std::make_unique<FrameCapture>(m_DeviceContext, m_FrameCaptureConfig, m_VkSwapChainImageFormat, m_VkSwapChainExtent, m_MaxFramesInFlight);
+    }
+    void Application::CreateGpuTimer() {
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(m_VkPhysicalDevice, &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(m_VkPhysicalDevice, &queueFamilyCount, queueFamilies.data());
+        uint32_t timestampValidBits = queueFamilies[m_DeviceContext.GraphicsQueueFamily].timestampValidBits;
+        if (!GpuTimer::IsSupported(timestampValidBits)) return;
+        /* Frame time feeds dynamic resolution and the pacer's utilization report */
+        m_GpuTimer = std::make_unique<GpuTimer>(m_DeviceContext, static_cast<uint32_t>(m_SwapChainImages.size()), timestampValidBits);
+    }
+    void Application::CreateDynamicResolution() {
+        if (!m_ResolutionConfig.Enabled) return;
+        /* The controller is only as good as its measurements --> no timestamps, no scaling */
+        if (!m_GpuTimer || !DynamicResolution::IsFormatSupported(m_VkPhysicalDevice, m_VkSwapChainImageFormat)) {
+            LOG_WARN("Dynamic resolution disabled --> graphics queue has no timestamps or the swapchain format cannot be sampled");
+            return;
+        }
+        SamplerDesc samplerDesc;
+        samplerDesc.MipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerDesc.AddressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerDesc.AddressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerDesc.AddressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerDesc.MaxAnisotropy = 1.0f;
+        samplerDesc.MaxLod = 0.0f;
+        m_DynamicResolution = std::make_unique<DynamicResolution>(m_DeviceContext, m_ResolutionConfig, m_VkSwapChainImageFormat, m_DepthFormat,
+            m_OcclusionCullingEnabled, m_VkRenderPass, m_VkSwapChainExtent, *m_PipelineCache, m_SamplerCache->Get(samplerDesc));
+    }
+    void Application::CreateOcclusionCuller() {
+        if (!m_OcclusionCulling) return;
+        if (!m_OcclusionCullingEnabled) {
+            LOG_WARN("Occlusion culling disabled --> device has no indirect first instance or no depth format that can be sampled");
+            return;
+        }
+        /* The pyramid is read texel by texel --> no filtering across depths */
+        SamplerDesc samplerDesc;
+        samplerDesc.MagFilter = VK_FILTER_NEAREST;
+        samplerDesc.MinFilter = VK_FILTER_NEAREST;
+        samplerDesc.MipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerDesc.AddressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerDesc.AddressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerDesc.AddressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerDesc.MaxAnisotropy = 1.0f;
+        /* Scene depth lives in the scaled target when dynamic resolution is on */
+        VkImageView depthView = m_DynamicResolution ? m_DynamicResolution->GetDepthImageView() : m_VkDepthImageView;
+        VkExtent2D depthExtent = m_DynamicResolution ? m_DynamicResolution->GetTargetExtent() : m_VkSwapChainExtent;
+        m_OcclusionCuller = std::make_unique<OcclusionCuller>(m_DeviceContext, m_SceneObjects->GetBuffer(), m_SceneObjects->GetSize(), m_SceneObjects->GetCount(),
+            static_cast<uint32_t>(m_SwapChainImages.size()), depthView, depthExtent, *m_PipelineCache, m_SamplerCache->Get(samplerDesc));
+    }
+    void Application::CreateRenderer2D() {
+        if (!m_StatsOverlay) return;
+        /* Glyph distances are interpolated --> linear filtering, clamped so cells never bleed into their neighbours */
+        SamplerDesc samplerDesc;
+        samplerDesc.MipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerDesc.AddressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerDesc.AddressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerDesc.AddressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerDesc.MaxAnisotropy = 1.0f;
+        samplerDesc.MaxLod = 0.0f;
+        /* One vertex region per swapchain image --> a cached buffer keeps reading the vertices it was recorded with */
+        m_Renderer2D = std::make_unique<Renderer2D>(m_DeviceContext, *m_PipelineCache, m_SamplerCache->Get(samplerDesc), m_VkRenderPass,
+            m_VkSwapChainImageFormat, m_DepthFormat, static_cast<uint32_t>(m_SwapChainImages.size()));
+    }
+    Application::FrameContent Application::GatherFrameContent() {
+        FrameContent content;
+        content.Pipeline = m_PipelineCache->Get(m_BasicPipelineDesc, m_VkGraphicsPipeline); // changes once the real pipeline finishes compiling
+        content.DrawMesh = m_AssetStreamer->Get<Mesh>(m_MeshHandle); // also marks the mesh used for this frame
+        content.MeshHandle = m_MeshHandle;
+        content.MeshGeneration = m_AssetStreamer->GetGeneration(m_MeshHandle);
+        /* aspect-correct so the mesh keeps its shape on resize */
+        float aspect = static_cast<float>(m_VkSwapChainExtent.width) / static_cast<float>(m_VkSwapChainExtent.height);
+        content.Frame.View = glm::mat4(1.0f);
+        content.Frame.Projection = glm::ortho(-aspect, aspect, -1.0f, 1.0f, -1.0f, 1.0f);
+        content.Draw.Model = glm::mat4(1.0f);
+        content.RenderExtent = m_DynamicResolution ? m_DynamicResolution->GetRenderExtent() : m_VkSwapChainExtent;
+        CullScene(content);
+        content.Overlay = 0;
+        if (m_Renderer2D) {
+            DrawStatsOverlay();
+            content.Overlay = m_Renderer2D->Hash();
+        }
+        return content;
+    }
+    void Application::CullScene(const FrameContent& content) {
+        m_VisibleRanges.clear();
+        /* The GPU culler sees every object itself --> only frames without it are culled here */
+        if (m_OcclusionCuller || !content.DrawMesh) {
+            m_VisibleRanges.push_back({ 0, m_SceneObjects->GetCount() });
+            return;
+        }
+        if (m_SceneBoundsMesh != content.DrawMesh) {
+            /* Every object draws the same mesh --> its bounds are the local bounds of every renderable node */
+            glm::vec3 boundsMin(content.DrawMesh->GetBoundsMin()[0], content.DrawMesh->GetBoundsMin()[1], content.DrawMesh->GetBoundsMin()[2]);
+            glm::vec3 boundsMax(content.DrawMesh->GetBoundsMax()[0], content.DrawMesh->GetBoundsMax()[1], content.DrawMesh->GetBoundsMax()[2]);
+            glm::vec3 extent = (boundsMax - boundsMin) * 0.5f;
+            for (TransformSystem::NodeId node : m_SceneNodes) {
+                m_SceneTransforms.SetBounds(node, (boundsMin + boundsMax) * 0.5f, extent, glm::length(extent));
+            }
+            m_SceneTransforms.Update();
+            /* First bounds build the tree at once, later mesh switches move every item and leave it to refits and rebuilds */
+            bool build = m_SceneBoundsMesh == nullptr;
+            for (uint32_t object = 0; object < m_SceneNodes.size(); object++) {
+                glm::vec3 worldMin, worldMax;
+                m_SceneTransforms.GetWorldBounds(m_SceneNodes[object], worldMin, worldMax);
+                if (build) m_SceneBvh.Insert(worldMin, worldMax);
+                else m_SceneBvh.Update(object, worldMin, worldMax);
+            }
+            if (build) m_SceneBvh.Rebuild();
+            m_SceneBoundsMesh = content.DrawMesh;
+        }
+        m_SceneBvh.Maintain();
+        CullObjects(content.Frame.Projection * content.Frame.View * content.Draw.Model, m_VisibleObjects, m_VisibleRanges);
+    }
+    void Application::CullObjects(const glm::mat4& viewProjection, std::vector<SceneBvh::ItemId>& objects, std::vector<InstanceRange>& ranges) const {
+        m_SceneBvh.QueryFrustum(TransformSystem::ExtractFrustum(viewProjection), objects);
+        /* Back to object order, neighbours merged --> one instanced draw per run of visible objects */
+        std::sort(objects.begin(), objects.end());
+        ranges.clear();
+        for (uint32_t object : objects) {
+            if (!ranges.empty() && ranges.back().First + ranges.back().Count == object) {
+                ranges.back().Count++;
+            } else {
+                ranges.push_back({ object, 1 });
+            }
+        }
+    }
+    /* std::to_string without the temporary --> appends into any string type, arena backed ones included */
+    template<typename String>
+    static void AppendNumber(String& text, uint64_t value) {
+        char digits[20];
+        text.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr);
+    }
+    void Application::DrawStatsOverlay() {
+        m_Renderer2D->Begin(m_VkSwapChainExtent);
+        /* Counts only change when a frame is recorded --> replayed frames keep their key and stay cached */
+        const Renderer2DStats& stats = m_Renderer2D->GetStats();
+        FrameAllocator<char> allocator(m_FrameArenas[m_CurrentFrame]);
+        FrameString lines[] = { FrameString("SCENE: ", allocator), FrameString("2D: ", allocator) };
+        AppendNumber(lines[0], m_OcclusionCuller ? m_SceneObjects->GetCount() : m_VisibleObjects.size());
+        lines[0] += " OBJECTS, ";
+        AppendNumber(lines[0], m_VisibleRanges.size()); // the GPU culler draws everything in one indirect call
+        lines[0] += " DRAWS";
+        AppendNumber(lines[1], stats.DrawCalls);
+        lines[1] += " DRAWS, ";
+        AppendNumber(lines[1], stats.Vertices);
+        lines[1] += " VERTICES, ";
+        AppendNumber(lines[1], stats.TextureBinds);
+        lines[1] += " BINDS";
+        const float lineHeight = 14.0f, margin = 8.0f;
+        float width = 0.0f;
+        for (const FrameString& line : lines) width = std::max(width, m_Renderer2D->MeasureText(line, lineHeight));
+        m_Renderer2D->DrawQuad(glm::vec2(margin), glm::vec2(width + 2.0f * margin, std::size(lines) * lineHeight * 1.5f + margin), glm::vec4(0.0f, 0.0f, 0.0f, 0.6f));
+        glm::vec2 pen(2.0f * margin);
+        for (const FrameString& line : lines) {
+            m_Renderer2D->DrawText(pen, line, lineHeight, glm::vec4(1.0f), 1);
+            pen.y += lineHeight * 1.5f;
+        }
+    }
+    uint64_t Application::FrameContent::Hash() const {
+        /* Swapchain handles are not part of the key --> RecreateSwapChain drops every cached buffer instead */
+        Fnv1a hasher;
+        hasher.Add(&Pipeline, sizeof(Pipeline));
+        hasher.Add(MeshHandle);
+        hasher.Add(MeshGeneration);
+        hasher.Add(&Frame, sizeof(Frame)); // plain float matrices --> no padding
+        hasher.Add(&Draw, sizeof(Draw));
+        hasher.Add(RenderExtent.width);
+        hasher.Add(RenderExtent.height);
+        hasher.Add(Overlay);
+        return hasher.Get();
+    }
+    void Application::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, const FrameContent& content, uint32_t frameUniformOffset) {
         VkCommandBufferBeginInfo beginInfo{};
         beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
         beginInfo.flags = 0; // Optional
         beginInfo.pInheritanceInfo = nullptr; // Optional
 
-        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+        if (m_DeviceDispatch.BeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
             throw std::runtime_error("Failed to begin recording command buffer!");
         }
-        {
+        if (m_GpuTimer) m_GpuTimer->Begin(commandBuffer, imageIndex);
+        /* Culled frames draw in two passes around the Hi-Z build --> only once there is a mesh to draw */
+        bool culled = m_OcclusionCuller && content.DrawMesh;
+        glm::mat4 viewProjection = content.Frame.Projection * content.Frame.View * content.Draw.Model;
+        auto bindScene = [&](VkCommandBuffer sceneCommandBuffer) { BindScene(sceneCommandBuffer, content, frameUniformOffset); };
+        /* Scene first into the scaled target when dynamic resolution is on */
+        if (m_DynamicResolution && culled) {
+            m_DynamicResolution->AcquireScene(commandBuffer);
+            OcclusionCuller::Target target{ m_DynamicResolution->GetFirstPhasePass(), m_DynamicResolution->GetSecondPhasePass(),
+                m_DynamicResolution->GetSceneFramebuffer(), content.RenderExtent };
+            m_OcclusionCuller->Record(commandBuffer, imageIndex, target, viewProjection, *content.DrawMesh, bindScene);
+            m_DynamicResolution->ReleaseScene(commandBuffer);
+        } else if (m_DynamicResolution) {
+            m_DynamicResolution->BeginScene(commandBuffer, content.RenderExtent);
+            RecordScene(commandBuffer, content, frameUniformOffset, m_VisibleRanges);
+            m_DynamicResolution->EndScene(commandBuffer);
+        }
+        if (culled && !m_DynamicResolution) {
+            OcclusionCuller::Target target{ m_VkFirstPhaseRenderPass, m_VkSecondPhaseRenderPass, m_VkSwapChainFramebuffers[imageIndex], m_VkSwapChainExtent };
+            m_OcclusionCuller->Record(commandBuffer, imageIndex, target, viewProjection, *content.DrawMesh, bindScene);
+            if (m_Renderer2D) {
+                VkRenderPassBeginInfo overlayPassInfo{};
+                overlayPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+                overlayPassInfo.renderPass = m_VkOverlayRenderPass;
+                overlayPassInfo.framebuffer = m_VkSwapChainFramebuffers[imageIndex];
+                overlayPassInfo.renderArea.offset = { 0, 0 };
+                overlayPassInfo.renderArea.extent = m_VkSwapChainExtent;
+                m_DeviceDispatch.CmdBeginRenderPass(commandBuffer, &overlayPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+                m_Renderer2D->Record(commandBuffer, imageIndex);
+                m_DeviceDispatch.CmdEndRenderPass(commandBuffer);
+            }
+        } else {
             VkRenderPassBeginInfo renderPassInfo{};
             renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
             renderPassInfo.renderPass = m_VkRenderPass;
@@ -641,52 +1017,173 @@ namespace VulkanPractice {
             renderPassInfo.renderArea.offset = { 0, 0 };
             renderPassInfo.renderArea.extent = m_VkSwapChainExtent;
     
-            VkClearValue clearColor = {{{ 0.0f, 0.0f, 0.0f, 1.0f }}};
-            renderPassInfo.clearValueCount = 1;
-            renderPassInfo.pClearValues = &clearColor;
+            VkClearValue clearValues[2]{};
+            clearValues[0].color = {{ 0.0f, 0.0f, 0.0f, 1.0f }};
+            clearValues[1].depthStencil = { 1.0f, 0 }; // far plane
+            renderPassInfo.clearValueCount = 2;
+            renderPassInfo.pClearValues = clearValues;
     
-            vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-            {
-                vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_VkGraphicsPipeline);
-                VkViewport viewport{};
-                viewport.x = 0.0f;
-                viewport.y = 0.0f;
-                viewport.width = static_cast<float>(m_VkSwapChainExtent.width);
-                viewport.height = static_cast<float>(m_VkSwapChainExtent.height);
-                viewport.minDepth = 0.0f;
-                viewport.maxDepth = 1.0f;
-                vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-        
-                VkRect2D scissor{};
-                scissor.offset = {0, 0};
-                scissor.extent = m_VkSwapChainExtent;
-                vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-
-                /* Draw */
-                vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+            m_DeviceDispatch.CmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+            if (m_DynamicResolution) {
+                m_DynamicResolution->RecordUpscale(commandBuffer, content.RenderExtent);
+            } else {
+                RecordScene(commandBuffer, content, frameUniformOffset, m_VisibleRanges);
             }
-            vkCmdEndRenderPass(commandBuffer);
+            if (m_Renderer2D) m_Renderer2D->Record(commandBuffer, imageIndex);
+            m_DeviceDispatch.CmdEndRenderPass(commandBuffer);
         }
-        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+        if (m_GpuTimer) m_GpuTimer->End(commandBuffer, imageIndex);
+        if (m_DeviceDispatch.EndCommandBuffer(commandBuffer) != VK_SUCCESS) {
             throw std::runtime_error("Failed to record command buffer!");
         }
     }
+    void Application::RecordScene(VkCommandBuffer commandBuffer, const FrameContent& content, uint32_t frameUniformOffset, const std::vector<InstanceRange>& ranges) {
+        BindScene(commandBuffer, content, frameUniformOffset);
+        /* Draw */ // skipped until the streamer has made the mesh resident, one instance per visible scene object
+        if (!content.DrawMesh) return;
+        for (const InstanceRange& range : ranges) content.DrawMesh->Draw(commandBuffer, range.Count, range.First);
+    }
+    void Application::RecordExtraWindow(ExtraWindow& window, uint32_t frame, const FrameContent& content, uint32_t frameUniformOffset) {
+        /* The BVH only exists once CullScene built it --> without it, or behind the GPU culler, everything is drawn */
+        if (content.DrawMesh && m_SceneBoundsMesh == content.DrawMesh) {
+            CullObjects(content.Frame.Projection * content.Frame.View * content.Draw.Model, window.VisibleObjects, window.VisibleRanges);
+        } else {
+            window.VisibleRanges.assign(1, { 0, m_SceneObjects->GetCount() });
+        }
+        VkCommandBuffer commandBuffer = window.Target->GetCommandBuffer(frame);
+        m_DeviceDispatch.ResetCommandBuffer(commandBuffer, 0);
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        if (m_DeviceDispatch.BeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to begin recording command buffer!");
+        }
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = m_VkRenderPass;
+        renderPassInfo.framebuffer = window.Target->GetFramebuffer();
+        renderPassInfo.renderArea.offset = { 0, 0 };
+        renderPassInfo.renderArea.extent = window.Target->GetExtent();
+        VkClearValue clearValues[2]{};
+        clearValues[0].color = {{ 0.0f, 0.0f, 0.0f, 1.0f }};
+        clearValues[1].depthStencil = { 1.0f, 0 }; // far plane
+        renderPassInfo.clearValueCount = 2;
+        renderPassInfo.pClearValues = clearValues;
+        m_DeviceDispatch.CmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        RecordScene(commandBuffer, content, frameUniformOffset, window.VisibleRanges);
+        m_DeviceDispatch.CmdEndRenderPass(commandBuffer);
+        if (m_DeviceDispatch.EndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to record command buffer!");
+        }
+    }
+    void Application::BindScene(VkCommandBuffer commandBuffer, const FrameContent& content, uint32_t frameUniformOffset) {
+        m_DeviceDispatch.CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, content.Pipeline);
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = static_cast<float>(content.RenderExtent.width);
+        viewport.height = static_cast<float>(content.RenderExtent.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        m_DeviceDispatch.CmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+        VkRect2D scissor{};
+        scissor.offset = {0, 0};
+        scissor.extent = content.RenderExtent;
+        m_DeviceDispatch.CmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+        /* Per Frame Data + Scene Objects */
+        VkDescriptorSet sets[] = { m_UniformRing->GetDescriptorSet(), m_SceneObjects->GetDescriptorSet() };
+        m_DeviceDispatch.CmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_VkPipelineLayout, 0, 2, sets, 1, &frameUniformOffset);
+
+        if (content.DrawMesh) {
+            m_DeviceDispatch.CmdPushConstants(commandBuffer, m_VkPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(content.Draw), &content.Draw);
+            content.DrawMesh->Bind(commandBuffer);
+        }
+    }
     void Application::DrawFrame() {
-        vkWaitForFences(m_VkDevice, 1, &m_VkInFlightFences[m_CurrentFrame], VK_TRUE, UINT64_MAX);
+#ifdef INCLUDE_DEBUG_INFO
+        uint64_t heapAllocations = HeapCounter::GetThreadAllocations();
+#endif
+        Timer frameTimer, stepTimer;
+        m_DeviceDispatch.WaitForFences(m_VkDevice, 1, &m_VkInFlightFences[m_CurrentFrame], VK_TRUE, UINT64_MAX);
+        m_FrameMetrics.FenceWait->Observe(stepTimer.GetElapsedMilliseconds());
+        m_FrameArenas[m_CurrentFrame].Reset(); // the slot's previous frame is done with everything it allocated
+        /* Closed extra windows leave between frames --> other slots may still render to them */
+        for (size_t i = 0; i < m_ExtraWindows.size();) {
+            if (!m_ExtraWindows[i]->Target->ShouldClose()) {
+                i++;
+                continue;
+            }
+            vkDeviceWaitIdle(m_VkDevice);
+            m_ExtraWindows.erase(m_ExtraWindows.begin() + i);
+        }
+        if (m_FrameCapture) m_FrameCapture->Collect(static_cast<uint32_t>(m_CurrentFrame));
+        m_AssetStreamer->Update(m_FrameNumber);
+        UpdateMemoryBudget();
+        m_UniformRing->BeginFrame(static_cast<uint32_t>(m_CurrentFrame));
         uint32_t imageIndex;
-        VkResult result = vkAcquireNextImageKHR(m_VkDevice, m_VkSwapchainKHR, UINT64_MAX, m_VkImageAvailableSemaphores[m_CurrentFrame], VK_NULL_HANDLE, &imageIndex);
+        stepTimer.Reset();
+        VkResult result = m_DeviceDispatch.AcquireNextImageKHR(m_VkDevice, m_VkSwapchainKHR, UINT64_MAX, m_VkImageAvailableSemaphores[m_CurrentFrame], VK_NULL_HANDLE, &imageIndex);
+        m_FrameMetrics.Acquire->Observe(stepTimer.GetElapsedMilliseconds());
         
         if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_FramebufferResized) {
             m_FramebufferResized = false;
             RecreateSwapChain();
+            m_FramePacer.FrameDrawn(0, false);
             return; // Important so that invalid imageIndex in no further used
         } else if (result != VK_SUCCESS) {
             throw std::runtime_error("Failed to present swap chain image!");
         }
         
-        vkResetFences(m_VkDevice, 1, &m_VkInFlightFences[m_CurrentFrame]);
-        vkResetCommandBuffer(m_VkCommandBuffers[m_CurrentFrame], 0);
-        RecordCommandBuffer(m_VkCommandBuffers[m_CurrentFrame], imageIndex);
+        /* The image may still be rendered by a frame slot other than this one --> wait on it before reusing its cached buffer */
+        if (m_ImagesInFlight[imageIndex] != VK_NULL_HANDLE) {
+            m_DeviceDispatch.WaitForFences(m_VkDevice, 1, &m_ImagesInFlight[imageIndex], VK_TRUE, UINT64_MAX);
+        }
+        /* That wait also means the image's last timestamps are written */
+        double gpuMilliseconds;
+        if (m_GpuTimer && m_GpuTimer->Read(imageIndex, gpuMilliseconds)) {
+            m_FramePacer.ReportGpuTime(gpuMilliseconds);
+            m_FrameMetrics.GpuTime->Observe(gpuMilliseconds);
+            if (m_DynamicResolution) m_DynamicResolution->ReportGpuTime(gpuMilliseconds);
+        }
+        if (m_OcclusionCuller) m_OcclusionCuller->ReadCounters(imageIndex);
+        m_ImagesInFlight[imageIndex] = m_VkInFlightFences[m_CurrentFrame];
+        /* Only once the main window holds an image --> an acquired extra image is always submitted and presented */
+        for (auto& window : m_ExtraWindows) window->Acquired = window->Target->Acquire(static_cast<uint32_t>(m_CurrentFrame));
+        m_DeviceDispatch.ResetFences(m_VkDevice, 1, &m_VkInFlightFences[m_CurrentFrame]);
+
+        FrameContent content = GatherFrameContent();
+        uint64_t contentHash = content.Hash();
+        /* Extra windows record on their own threads and pools while this thread records the main window */
+        m_WindowRecordings.clear();
+        for (auto& window : m_ExtraWindows) {
+            if (!window->Acquired) continue;
+            VkExtent2D extent = window->Target->GetExtent();
+            FrameContent windowContent = content;
+            float aspect = static_cast<float>(extent.width) / static_cast<float>(extent.height);
+            windowContent.Frame.Projection = glm::ortho(-aspect, aspect, -1.0f, 1.0f, -1.0f, 1.0f);
+            windowContent.RenderExtent = extent;
+            uint32_t frameUniformOffset = m_UniformRing->Push(windowContent.Frame); // the ring is not thread safe --> pushed here
+            uint32_t frame = static_cast<uint32_t>(m_CurrentFrame);
+            ExtraWindow* extraWindow = window.get();
+            m_WindowRecordings.push_back(std::async(std::launch::async, [this, extraWindow, frame, windowContent, frameUniformOffset] {
+                RecordExtraWindow(*extraWindow, frame, windowContent, frameUniformOffset);
+            }));
+        }
+        VkCommandBuffer commandBuffer;
+        if (m_CommandBufferCache && imageIndex < m_CachedFrameUniforms.size()) {
+            /* Unchanged content --> resubmit the buffer recorded for this image, no CPU recording at all */
+            commandBuffer = m_CommandBufferCache->Get(imageIndex, contentHash, [&](VkCommandBuffer cachedCommandBuffer) {
+                const UniformRing::Allocation& frameUniforms = m_CachedFrameUniforms[imageIndex];
+                std::memcpy(frameUniforms.Data, &content.Frame, sizeof(content.Frame));
+                RecordCommandBuffer(cachedCommandBuffer, imageIndex, content, frameUniforms.Offset);
+            });
+        } else {
+            commandBuffer = m_VkCommandBuffers[m_CurrentFrame];
+            m_DeviceDispatch.ResetCommandBuffer(commandBuffer, 0);
+            RecordCommandBuffer(commandBuffer, imageIndex, content, m_UniformRing->Push(content.Frame));
+        }
+        for (auto& recording : m_WindowRecordings) recording.get(); // rethrows recording errors
 
         /* Submitting */
         VkSubmitInfo submitInfo{};
@@ -696,56 +1193,141 @@ namespace VulkanPractice {
         submitInfo.waitSemaphoreCount = 1;
         submitInfo.pWaitSemaphores = waitSemaphores;
         submitInfo.pWaitDstStageMask = waitStages;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &m_VkCommandBuffers[m_CurrentFrame];
+        /* Capture copy goes in the same batch after the draw --> still finished before the present waits are signalled */
+        VkCommandBuffer commandBuffers[] = { commandBuffer, VK_NULL_HANDLE };
+        if (m_FrameCapture) {
+            commandBuffers[1] = m_FrameCapture->Record(static_cast<uint32_t>(m_CurrentFrame), m_FrameNumber, m_SwapChainImages[imageIndex], m_VkSwapChainExtent);
+        }
+        submitInfo.commandBufferCount = commandBuffers[1] != VK_NULL_HANDLE ? 2 : 1;
+        submitInfo.pCommandBuffers = commandBuffers;
 
         VkSemaphore signalSemaphores[] = { m_VkRenderFinishedSemaphores[m_CurrentFrame] };
         submitInfo.signalSemaphoreCount = 1;
         submitInfo.pSignalSemaphores = signalSemaphores;
-        if (vkQueueSubmit(m_VkGraphicsQueue, 1, &submitInfo, m_VkInFlightFences[m_CurrentFrame]) != VK_SUCCESS) {
+        /* One batch per window, one call --> the slot fence signals once every window has rendered */
+        m_SubmitInfos.assign(1, submitInfo);
+        m_PresentSwapchains.assign(1, m_VkSwapchainKHR);
+        m_PresentImageIndices.assign(1, imageIndex);
+        m_PresentWaitSemaphores.assign(1, signalSemaphores[0]);
+        for (auto& window : m_ExtraWindows) {
+            if (!window->Acquired) continue;
+            VkSubmitInfo windowSubmitInfo{};
+            windowSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            windowSubmitInfo.waitSemaphoreCount = 1;
+            windowSubmitInfo.pWaitSemaphores = &window->Target->GetImageAvailableSemaphore(static_cast<uint32_t>(m_CurrentFrame));
+            windowSubmitInfo.pWaitDstStageMask = waitStages;
+            windowSubmitInfo.commandBufferCount = 1;
+            windowSubmitInfo.pCommandBuffers = &window->Target->GetCommandBuffer(static_cast<uint32_t>(m_CurrentFrame));
+            windowSubmitInfo.signalSemaphoreCount = 1;
+            windowSubmitInfo.pSignalSemaphores = &window->Target->GetRenderFinishedSemaphore(static_cast<uint32_t>(m_CurrentFrame));
+            m_SubmitInfos.push_back(windowSubmitInfo);
+            m_PresentSwapchains.push_back(window->Target->GetSwapchain());
+            m_PresentImageIndices.push_back(window->Target->GetImageIndex());
+            m_PresentWaitSemaphores.push_back(window->Target->GetRenderFinishedSemaphore(static_cast<uint32_t>(m_CurrentFrame)));
+        }
+        stepTimer.Reset();
+        if (m_DeviceDispatch.QueueSubmit(m_VkGraphicsQueue, static_cast<uint32_t>(m_SubmitInfos.size()), m_SubmitInfos.data(), m_VkInFlightFences[m_CurrentFrame]) != VK_SUCCESS) {
             throw std::runtime_error("Failed to submit draw command buffer!");
         }
+        m_FrameMetrics.Submit->Observe(stepTimer.GetElapsedMilliseconds());
 
         VkPresentInfoKHR presentInfo{};
         presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-        presentInfo.waitSemaphoreCount = 1;
-        presentInfo.pWaitSemaphores = signalSemaphores;
-        VkSwapchainKHR swapChains[] = { m_VkSwapchainKHR };
-        presentInfo.swapchainCount = 1;
-        presentInfo.pSwapchains = swapChains;
-        presentInfo.pImageIndices = &imageIndex;
-        presentInfo.pResults = nullptr; // Optional
-        
-        result = vkQueuePresentKHR(m_VkPresentQueue, &presentInfo);
+        presentInfo.waitSemaphoreCount = static_cast<uint32_t>(m_PresentWaitSemaphores.size());
+        presentInfo.pWaitSemaphores = m_PresentWaitSemaphores.data();
+        presentInfo.swapchainCount = static_cast<uint32_t>(m_PresentSwapchains.size());
+        presentInfo.pSwapchains = m_PresentSwapchains.data();
+        presentInfo.pImageIndices = m_PresentImageIndices.data();
+        m_PresentResults.assign(m_PresentSwapchains.size(), VK_SUCCESS);
+        presentInfo.pResults = m_PresentResults.data(); // per swapchain --> one window going out of date leaves the others presented
+
+        stepTimer.Reset();
+        m_DeviceDispatch.QueuePresentKHR(m_VkPresentQueue, &presentInfo);
+        m_FrameMetrics.Present->Observe(stepTimer.GetElapsedMilliseconds());
+        result = m_PresentResults[0];
         if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
             RecreateSwapChain();
         } else if (result != VK_SUCCESS) {
             throw std::runtime_error("Failed to present swap chain image!");
         }
+        size_t presentEntry = 1;
+        for (auto& window : m_ExtraWindows) {
+            if (window->Acquired) window->Target->HandlePresentResult(m_PresentResults[presentEntry++]);
+        }
+
+        if (!m_FirstFramePresented) {
+            m_FirstFramePresented = true;
+            double timeToFirstFrame = m_InitProfiler.GetElapsedMilliseconds();
+            LOG_INFO("Time to first frame: {:.2f} ms", timeToFirstFrame);
+            m_FrameMetrics.TimeToFirstFrame->Set(timeToFirstFrame);
+            m_FirstFrameAllocations = m_HostAllocator.GetTotalStats().Allocations; // baseline for per frame churn
+        }
+
+        m_FramePacer.FrameDrawn(contentHash, true);
+        m_FrameMetrics.Frames->Add();
+        m_FrameMetrics.CpuTime->Observe(frameTimer.GetElapsedMilliseconds());
+#ifdef INCLUDE_DEBUG_INFO
+        CheckFrameHeapAllocations(HeapCounter::GetThreadAllocations() - heapAllocations);
+#endif
 
         /* Rotation of frames */
         m_CurrentFrame = (m_CurrentFrame + 1) % m_MaxFramesInFlight;
+        m_FrameNumber++;
+    }
+#ifdef INCLUDE_DEBUG_INFO
+    void Application::CheckFrameHeapAllocations(uint64_t allocations) {
+        /* Streaming and compiles change what a frame touches, std::async shares state through the heap --> only quiet single window frames count */
+        if (m_FrameNumber < m_HeapCheckFrom || !m_ExtraWindows.empty() || HasPendingWork()) return;
+        m_HeapCheckedFrames++;
+        m_SteadyHeapAllocations += allocations;
+        if (allocations > 0 && !m_HeapCheckWarned) {
+            m_HeapCheckWarned = true;
+            LOG_WARN("Frame {} made {} heap allocations on the render thread --> transient data belongs in the frame arena", m_FrameNumber, allocations);
+        }
+    }
+#endif
+    bool Application::HasPendingWork() {
+        AssetState meshState = m_AssetStreamer->GetState(m_MeshHandle);
+        return m_PipelineCache->GetPendingCount() > 0 || meshState == AssetState::Queued || meshState == AssetState::Uploading || meshState == AssetState::Evicted || m_SceneBvh.IsRebuilding();
+    }
+    void Application::UpdateMemoryBudget() {
+        m_MemoryBudget->Update(m_FrameNumber); // may trim the streamer
+        /* Hand the residency budget back as device local headroom returns --> half of it per frame so usage settles before the next step */
+        if (m_AssetStreamer->GetResidencyBudget() < m_AssetResidencyBudget && m_MemoryBudget->IsSupported()) {
+            uint64_t headroom = m_MemoryBudget->GetHeadroom(VK_MEMORY_HEAP_DEVICE_LOCAL_BIT);
+            m_AssetStreamer->SetResidencyBudget(std::min(m_AssetResidencyBudget, m_AssetStreamer->GetResidencyBudget() + headroom / 2));
+        }
+        for (const HeapBudget& heap : m_MemoryBudget->GetHeaps()) {
+            m_FrameMetrics.HeapUsage[heap.Index]->Set(static_cast<double>(heap.Usage));
+            m_FrameMetrics.HeapBudget[heap.Index]->Set(static_cast<double>(heap.Budget));
+        }
+        if (m_VkAllocator) m_FrameMetrics.HostBytes->Set(static_cast<double>(m_HostAllocator.GetTotalStats().CurrentBytes));
+        m_FrameMetrics.ResidentBytes->Set(static_cast<double>(m_AssetStreamer->GetResidentBytes()));
     }
 
     /* For Swapchain recreation due to resizing or minimizing */
     void Application::CleanupSwapChain() {
         for(size_t i = 0; i < m_MaxFramesInFlight; i++) {
-            vkDestroySemaphore(m_VkDevice, m_VkImageAvailableSemaphores[i], nullptr);
-            vkDestroySemaphore(m_VkDevice, m_VkRenderFinishedSemaphores[i], nullptr);
-            vkDestroyFence(m_VkDevice, m_VkInFlightFences[i], nullptr);
+            vkDestroySemaphore(m_VkDevice, m_VkImageAvailableSemaphores[i], m_VkAllocator);
+            vkDestroySemaphore(m_VkDevice, m_VkRenderFinishedSemaphores[i], m_VkAllocator);
+            vkDestroyFence(m_VkDevice, m_VkInFlightFences[i], m_VkAllocator);
         }
         m_VkImageAvailableSemaphores.clear();
         m_VkRenderFinishedSemaphores.clear();
         m_VkInFlightFences.clear();
+        m_ImagesInFlight.clear();
         for (auto framebuffer : m_VkSwapChainFramebuffers) {
-            vkDestroyFramebuffer(m_VkDevice, framebuffer, nullptr);
+            vkDestroyFramebuffer(m_VkDevice, framebuffer, m_VkAllocator);
         }
         m_VkSwapChainFramebuffers.clear();
+        vkDestroyImageView(m_VkDevice, m_VkDepthImageView, m_VkAllocator);
+        vkDestroyImage(m_VkDevice, m_VkDepthImage, m_VkAllocator);
+        vkFreeMemory(m_VkDevice, m_VkDepthImageMemory, m_VkAllocator);
         for (auto imageView : m_VkSwapChainImageViews) {
-            vkDestroyImageView(m_VkDevice, imageView, nullptr);
+            vkDestroyImageView(m_VkDevice, imageView, m_VkAllocator);
         }
         m_VkSwapChainImageViews.clear();
-        vkDestroySwapchainKHR(m_VkDevice, m_VkSwapchainKHR, nullptr);
+        vkDestroySwapchainKHR(m_VkDevice, m_VkSwapchainKHR, m_VkAllocator);
     }
     void Application::RecreateSwapChain() {
         // Add window size event handler
@@ -756,53 +1338,83 @@ namespace VulkanPractice {
             glfwWaitEvents();
         }
         vkDeviceWaitIdle(m_VkDevice);
+        m_FrameMetrics.SwapchainRecreations->Add();
+#ifdef INCLUDE_DEBUG_INFO
+        m_HeapCheckFrom = m_FrameNumber + s_HeapCheckWarmupFrames; // scratch vectors regrow for the new extent
+#endif
+        HostAllocationStats before = m_HostAllocator.GetTotalStats();
         /* Cleanup */
         CleanupSwapChain(); // Cleanup + Command buffer manual freeing
         /* Recreation */
         CreateSwapChain();
         CreateImageViews();
+        CreateDepthResources();
         CreateFramebuffers();
+        if (m_CommandBufferCache) {
+            m_CommandBufferCache->Resize(static_cast<uint32_t>(m_SwapChainImages.size())); // old buffers reference destroyed framebuffers
+        }
+        if (m_GpuTimer) m_GpuTimer->Resize(static_cast<uint32_t>(m_SwapChainImages.size()));
+        if (m_DynamicResolution) m_DynamicResolution->Resize(m_VkSwapChainExtent);
+        if (m_OcclusionCuller) {
+            VkImageView depthView = m_DynamicResolution ? m_DynamicResolution->GetDepthImageView() : m_VkDepthImageView;
+            VkExtent2D depthExtent = m_DynamicResolution ? m_DynamicResolution->GetTargetExtent() : m_VkSwapChainExtent;
+            m_OcclusionCuller->Resize(static_cast<uint32_t>(m_SwapChainImages.size()), depthView, depthExtent);
+        }
+        if (m_Renderer2D) m_Renderer2D->Resize(static_cast<uint32_t>(m_SwapChainImages.size()));
         CreateSyncObjects();
+        m_FramePacer.MarkDirty(); // the new images hold nothing yet
+#ifdef INCLUDE_DEBUG_INFO
+        if (m_VkAllocator) {
+            HostAllocationStats after = m_HostAllocator.GetTotalStats();
+            LOG_INFO("Swapchain recreation: {} host allocations, {} bytes peak", after.Allocations - before.Allocations, after.PeakBytes);
+        }
+#endif
     }
 
+    /* Every required name somewhere in the driver's list --> a few dozen strcmp instead of a std::set of copied names */
+    template<typename Properties, typename GetName>
+    static bool ContainsAll(const std::vector<Properties>& available, const std::vector<const char*>& required, GetName getName) {
+        return std::all_of(required.begin(), required.end(), [&](const char* name) {
+            return std::any_of(available.begin(), available.end(), [&](const Properties& properties) { return std::strcmp(getName(properties), name) == 0; });
+        });
+    }
     bool Application::CheckInstanceExtensionSupport(const std::vector<const char*>& instanceExtensions) {
         uint32_t extensionCount = 0;
         vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
         std::vector<VkExtensionProperties> availableExtensions(extensionCount);
         vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, availableExtensions.data());
-        std::set<std::string> requiredExtensions(instanceExtensions.begin(), instanceExtensions.end());
-        for (const auto& extension : availableExtensions) requiredExtensions.erase(extension.extensionName);
-        return requiredExtensions.empty();
+        return ContainsAll(availableExtensions, instanceExtensions, [](const VkExtensionProperties& extension) { return extension.extensionName; });
     }
-    bool Application::CheckDeviceExtensionSupport(VkPhysicalDevice device, const std::vector<const char*>& deviceExtensions) {
-        uint32_t extensionCount;
-        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
-        std::vector<VkExtensionProperties> availableExtensions(extensionCount);
-        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
-        std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
-        for (const auto& extension : availableExtensions) requiredExtensions.erase(extension.extensionName);
-        return requiredExtensions.empty();
+    bool Application::CheckDeviceExtensionSupport(const std::vector<VkExtensionProperties>& availableExtensions, const std::vector<const char*>& deviceExtensions) {
+        return ContainsAll(availableExtensions, deviceExtensions, [](const VkExtensionProperties& extension) { return extension.extensionName; });
     }
     bool Application::CheckInstanceLayerSupport(const std::vector<const char*>& instanceLayers) {
         uint32_t layerCount;
         vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
         std::vector<VkLayerProperties> availableLayers(layerCount);
         vkEnumerateInstanceLayerProperties(&layerCount, availableLayers.data());
-        std::set<std::string> requiredLayers(instanceLayers.begin(), instanceLayers.end());
-        for (const auto& layer : availableLayers) requiredLayers.erase(layer.layerName);
-        return requiredLayers.empty();
-    }
-    bool Application::IsPhysicalDeviceSuitable(VkPhysicalDevice device, VkSurfaceKHR surface, const std::vector<const char*>& deviceExtensions) {
-        VkPhysicalDeviceProperties deviceProperties;
-        VkPhysicalDeviceFeatures deviceFeatures;
-        vkGetPhysicalDeviceProperties(device, &deviceProperties);
-        vkGetPhysicalDeviceFeatures(device, &deviceFeatures);
+        return ContainsAll(availableLayers, instanceLayers, [](const VkLayerProperties& layer) { return layer.layerName; });
+    }
+    PhysicalDeviceInfo Application::QueryPhysicalDevice(VkPhysicalDevice device, VkSurfaceKHR surface) {
+        PhysicalDeviceInfo info;
+        info.Device = device;
+        vkGetPhysicalDeviceProperties(device, &info.Properties);
+        vkGetPhysicalDeviceFeatures(device, &info.Features);
+        info.QueueFamilies = FindQueueFamilies(device, surface);
+        uint32_t extensionCount;
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+        info.Extensions.resize(extensionCount);
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, info.Extensions.data());
+        info.SwapChainSupport = QuerySwapChainSupport(device, surface);
+        return info;
+    }
+    bool Application::IsPhysicalDeviceSuitable(const PhysicalDeviceInfo& info, const std::vector<const char*>& deviceExtensions) {
         return (
-            // deviceFeatures.geometryShader &&
-            (deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU || deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU) &&
-            FindQueueFamilies(device, surface).IsComplete() &&
-            CheckDeviceExtensionSupport(device, deviceExtensions) &&
-            QuerySwapChainSupport(device, surface).IsAdequate()
+            // info.Features.geometryShader &&
+            (info.Properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU || info.Properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU) &&
+            info.QueueFamilies.IsComplete() &&
+            CheckDeviceExtensionSupport(info.Extensions, deviceExtensions) &&
+            info.SwapChainSupport.IsAdequate()
         );
     }
     QueueFamilyIndices Application::FindQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface) {
@@ -889,28 +1501,5 @@ namespace VulkanPractice {
 
             return VK_FALSE;
         }
-        VkResult Application::CreateDebugUtilsMessengerEXT(
-            VkInstance instance,
-            const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo,
-            const VkAllocationCallbacks* pAllocator,
-            VkDebugUtilsMessengerEXT* pDebugMessenger
-        ) {
-            auto func = (PFN_vkCreateDebugUtilsMessengerEXT) vkGetInstanceProcAddr(instance, "vkCreateDebugUtilsMessengerEXT");
-            if (func != nullptr) {
-                return func(instance, pCreateInfo, pAllocator, pDebugMessenger);
-            } else {
-                return VK_ERROR_EXTENSION_NOT_PRESENT;
-            }
-        }
-        void Application::DestroyDebugUtilsMessengerEXT(
-            VkInstance instance,
-            VkDebugUtilsMessengerEXT debugMessenger,
-            const VkAllocationCallbacks* pAllocator
-        ) {
-            auto func = (PFN_vkDestroyDebugUtilsMessengerEXT) vkGetInstanceProcAddr(instance, "vkDestroyDebugUtilsMessengerEXT");
-            if (func != nullptr) {
-                func(instance, debugMessenger, pAllocator);
-            }
-        }
 #endif
 }
\ No newline at end of file
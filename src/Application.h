@@ -2,8 +2,41 @@
 #include "pch.h"
 #include "Window.h"
 #include "Log.h"
+#include "DeviceContext.h"
+#include "Mesh.h"
+#include "AssetStreamer.h"
+#include "Texture.h"
+#include "SamplerCache.h"
+#include "PipelineCache.h"
+#include "ShaderLibrary.h"
+#include "UniformRing.h"
+#include "CommandBufferCache.h"
+#include "ShaderTypes.h"
+#include "Profiler.h"
+#include "HostAllocator.h"
+#include "MemoryBudget.h"
+#include "FrameCapture.h"
+#include "GpuTimer.h"
+#include "DynamicResolution.h"
+#include "SceneObjects.h"
+#include "OcclusionCuller.h"
+#include "TransformSystem.h"
+#include "SceneBvh.h"
+#include "Renderer2D.h"
+#include "FramePacer.h"
+#include "SwapchainTarget.h"
+#include "MetricsServer.h"
+#include "FrameArena.h"
+#include "HeapCounter.h"
+#include <future>
 
 namespace VulkanPractice {
+    struct WindowConfig {
+        uint32_t Width = 1280;
+        uint32_t Height = 720;
+        std::string Title = "Vulkan";
+    };
+
     struct ApplicationConfig {
         std::string ApplicationName = "Vulkan Application";
         std::string ApplicationEngineName = "No Engine";
@@ -11,6 +44,23 @@ namespace VulkanPractice {
         uint32_t WindowWidth = 1280;
         uint32_t WindowHeight = 720;
         std::string WindowTitle = "Vulkan";
+
+        std::string MeshPath = std::string(ASSET_DIR) + "/meshes/triangle.vmsh"; // packed by tools/MeshConverter
+        uint64_t AssetResidencyBudget = 256ull << 20; // bytes of streamed GPU data before LRU eviction
+        uint64_t UniformBytesPerFrame = 64ull << 10; // per frame in flight, see UniformRing
+        bool TrackHostAllocations = true; // route driver host allocations through HostAllocator, false for the driver default
+        bool CacheCommandBuffers = true; // replay one prerecorded buffer per swapchain image while the frame content is unchanged
+        std::string CaptureDirectory; // every presented frame is written here, empty disables capture
+        FrameCaptureFormat CaptureFormat = FrameCaptureFormat::Png;
+        DynamicResolutionConfig Resolution; // scene resolution steered by GPU frame time, upscaled into the swapchain
+        bool OcclusionCulling = true; // two phase Hi-Z culling of the scene objects on the GPU, needs drawIndirectFirstInstance
+        uint32_t SceneGridSize = 16; // grid x grid mesh instances behind a few large occluders
+        std::vector<std::string> ShaderFeatures; // scene shader toggles, e.g. "INSTANCE_TINT", "GRAYSCALE", "FLAT_COLOR"
+        std::string ShaderManifestPath = std::string(SHADER_DIR) + "/permutations.txt"; // define permutations compiled at startup
+        bool StatsOverlay = true; // draw call and vertex counts drawn over the frame by the 2D batch
+        FramePacerConfig Pacing; // on demand drawing and throttling while unfocused or iconified
+        std::vector<WindowConfig> ExtraWindows; // more displays on the same device --> the scene from the same camera, presented in one batch with the main window
+        MetricsServerConfig Metrics; // frame, swapchain, pipeline and memory metrics on GET /metrics --> off unless a port or socket path is set
     };
 
     struct QueueFamilyIndices {
@@ -26,23 +76,55 @@ namespace VulkanPractice {
 
         inline bool IsAdequate() const { return !Formats.empty() && !PresentModes.empty(); }
     };
+    /* Queried once per device in PickPhysicalDevice --> later init steps read from here instead of asking the driver again */
+    struct PhysicalDeviceInfo {
+        VkPhysicalDevice Device = VK_NULL_HANDLE;
+        VkPhysicalDeviceProperties Properties{};
+        VkPhysicalDeviceFeatures Features{};
+        QueueFamilyIndices QueueFamilies;
+        std::vector<VkExtensionProperties> Extensions;
+        SwapChainSupportDetails SwapChainSupport; // Capabilities are re-queried per swapchain, formats and present modes never change
+    };
 
     class Application {
     private:
         inline static Application* s_Instance = nullptr;
+        PhaseProfiler m_InitProfiler; // first member --> its origin is the start of construction
+        bool m_FirstFramePresented = false;
+        HostAllocator m_HostAllocator; // outlives every Vulkan object --> CleanupVulkan runs in the destructor body
+        const VkAllocationCallbacks* m_VkAllocator; // m_HostAllocator callbacks or null
+        uint64_t m_FirstFrameAllocations = 0;
+        MetricsRegistry m_Metrics; // before every subsystem that registers into it
 
         std::string m_ApplicationName, m_ApplicationEngineName;
+        std::string m_MeshPath;
+        uint64_t m_AssetResidencyBudget;
+        uint64_t m_UniformBytesPerFrame;
+        bool m_CacheCommandBuffers;
+        FrameCaptureConfig m_FrameCaptureConfig;
+        DynamicResolutionConfig m_ResolutionConfig;
+        bool m_OcclusionCulling;
+        uint32_t m_SceneGridSize;
+        std::vector<std::string> m_ShaderFeatures;
+        std::string m_ShaderManifestPath;
+        bool m_StatsOverlay;
+        FramePacer m_FramePacer;
+        std::vector<WindowConfig> m_ExtraWindowConfigs;
+        MetricsServerConfig m_MetricsServerConfig;
         std::unique_ptr<Window> m_Window;
 
         VkInstance m_VkInstance;
+        InstanceDispatch m_InstanceDispatch;
         VkSurfaceKHR m_VkSurfaceKHR;
 #ifdef INCLUDE_DEBUG_INFO
         VkDebugUtilsMessengerEXT m_VkDebugUtilsMessengerEXT;
 #endif
 
         VkPhysicalDevice m_VkPhysicalDevice;
+        PhysicalDeviceInfo m_PhysicalDeviceInfo; // of m_VkPhysicalDevice
 
         VkDevice m_VkDevice;
+        DeviceDispatch m_DeviceDispatch; // loaded right after vkCreateDevice, shared through m_DeviceContext
         VkQueue m_VkGraphicsQueue, m_VkPresentQueue;
 
         VkSwapchainKHR m_VkSwapchainKHR;
@@ -50,27 +132,110 @@ namespace VulkanPractice {
         VkFormat m_VkSwapChainImageFormat;
         VkExtent2D m_VkSwapChainExtent;
         std::vector<VkImageView> m_VkSwapChainImageViews;
+        VkFormat m_DepthFormat;
+        VkImage m_VkDepthImage; // one for every swapchain framebuffer --> frames use it one after another on the queue
+        VkDeviceMemory m_VkDepthImageMemory;
+        VkImageView m_VkDepthImageView;
         VkRenderPass m_VkRenderPass;
+        VkRenderPass m_VkFirstPhaseRenderPass = VK_NULL_HANDLE, m_VkSecondPhaseRenderPass = VK_NULL_HANDLE; // m_VkRenderPass split for occlusion culling
+        VkRenderPass m_VkOverlayRenderPass = VK_NULL_HANDLE; // continues on a finished culled frame --> 2D overlay after the second phase
         VkPipelineLayout m_VkPipelineLayout;
-        VkPipeline m_VkGraphicsPipeline;
+        VkPipeline m_VkGraphicsPipeline; // owned by m_PipelineCache
+        PipelineDesc m_BasicPipelineDesc;
+        ShaderLibrary m_ShaderLibrary;
+        std::unique_ptr<PipelineCache> m_PipelineCache;
+        std::unique_ptr<UniformRing> m_UniformRing;
         std::vector<VkFramebuffer> m_VkSwapChainFramebuffers;
 
+        inline static constexpr uint32_t s_FramesInFlightLimit = 3;
         uint32_t m_MaxFramesInFlight; // consider changing this to 3 --> and this does not consider GPU needs pathc
         VkCommandPool m_VkCommandPool;
         std::vector<VkCommandBuffer> m_VkCommandBuffers;
+        std::vector<FrameArena> m_FrameArenas; // one per frame in flight like the command buffers, reset once the slot's fence signalled
+        inline static constexpr uint32_t s_MaxCachedImages = 8; // images past this are recorded per frame
+        std::unique_ptr<CommandBufferCache> m_CommandBufferCache; // null when caching is disabled
+        std::vector<UniformRing::Allocation> m_CachedFrameUniforms; // one per cached image --> stays valid while its buffer is replayed
+
+        DeviceContext m_DeviceContext; // handed to subsystems once the command pool exists
+        std::unique_ptr<AssetStreamer> m_AssetStreamer;
+        AssetHandle m_MeshHandle = InvalidAssetHandle;
+        std::unique_ptr<SamplerCache> m_SamplerCache;
+        std::unique_ptr<MemoryBudget> m_MemoryBudget;
+        std::unique_ptr<FrameCapture> m_FrameCapture; // null unless a capture directory is set
+        std::unique_ptr<GpuTimer> m_GpuTimer; // one slot per swapchain image, null without timestamp support
+        std::unique_ptr<DynamicResolution> m_DynamicResolution; // null when disabled or unsupported
+        std::unique_ptr<SceneObjects> m_SceneObjects;
+        /* CPU side of the scene --> world matrices fill m_SceneObjects, the BVH over world bounds culls frames the GPU culler does not see */
+        struct InstanceRange {
+            uint32_t First, Count;
+        };
+        TransformSystem m_SceneTransforms;
+        std::vector<TransformSystem::NodeId> m_SceneNodes; // by object index
+        const Mesh* m_SceneBoundsMesh = nullptr; // mesh whose bounds the scene nodes carry
+        SceneBvh m_SceneBvh; // item id == object index
+        std::vector<SceneBvh::ItemId> m_VisibleObjects; // kept across frames --> no per frame allocation once grown
+        std::vector<InstanceRange> m_VisibleRanges; // of the last GatherFrameContent, read by RecordScene
+        std::unique_ptr<OcclusionCuller> m_OcclusionCuller; // null when disabled or unsupported
+        std::unique_ptr<Renderer2D> m_Renderer2D; // null without the stats overlay
+        /* Handles into m_Metrics --> all the render thread does per frame is a few relaxed atomic updates, the server thread renders the text */
+        struct FrameMetrics {
+            MetricCounter* Frames = nullptr;
+            MetricCounter* SwapchainRecreations = nullptr;
+            MetricHistogram* CpuTime = nullptr; // DrawFrame of a presented frame, waits included
+            MetricHistogram* GpuTime = nullptr;
+            MetricHistogram* FenceWait = nullptr;
+            MetricHistogram* Acquire = nullptr;
+            MetricHistogram* Submit = nullptr;
+            MetricHistogram* Present = nullptr;
+            MetricGauge* HostBytes = nullptr;
+            MetricGauge* ResidentBytes = nullptr;
+            MetricGauge* TimeToFirstFrame = nullptr; // set once the first frame is presented
+            std::vector<MetricGauge*> HeapUsage, HeapBudget; // by heap index
+        };
+        FrameMetrics m_FrameMetrics;
+        std::unique_ptr<MetricsServer> m_MetricsServer; // null when disabled or the socket could not be opened
+        bool m_MemoryBudgetEnabled = false; // VK_EXT_memory_budget and its instance dependency are both on
+        bool m_OcclusionCullingEnabled = false; // indirect first instance is on and depth can be sampled
 
         std::vector<VkSemaphore> m_VkImageAvailableSemaphores;
         std::vector<VkSemaphore> m_VkRenderFinishedSemaphores;
         std::vector<VkFence> m_VkInFlightFences;
+        std::vector<VkFence> m_ImagesInFlight; // fence of the last submission that rendered to each swapchain image
+        /* Extra windows share the frame slot fences above --> one submit and one present per frame cover every window */
+        struct ExtraWindow {
+            std::unique_ptr<SwapchainTarget> Target;
+            std::vector<SceneBvh::ItemId> VisibleObjects; // own frustum, culled on the window's recording thread
+            std::vector<InstanceRange> VisibleRanges;
+            bool Acquired = false; // holds an image this frame
+        };
+        std::vector<std::unique_ptr<ExtraWindow>> m_ExtraWindows; // boxed --> recording threads keep their reference while the list changes
+        /* Kept across frames --> no per frame allocation once grown */
+        std::vector<std::future<void>> m_WindowRecordings;
+        std::vector<VkSubmitInfo> m_SubmitInfos;
+        std::vector<VkSwapchainKHR> m_PresentSwapchains;
+        std::vector<uint32_t> m_PresentImageIndices;
+        std::vector<VkSemaphore> m_PresentWaitSemaphores;
+        std::vector<VkResult> m_PresentResults;
         size_t m_CurrentFrame = 0; // for tracking
+        uint64_t m_FrameNumber = 0; // monotonic --> used for residency tracking
 
         bool m_FramebufferResized = false;
+#ifdef INCLUDE_DEBUG_INFO
+        inline static constexpr uint64_t s_HeapCheckWarmupFrames = 60; // scratch vectors and frame arenas grow during these
+        uint64_t m_HeapCheckFrom = s_HeapCheckWarmupFrames; // first frame number checked for heap allocations
+        uint64_t m_HeapCheckedFrames = 0, m_SteadyHeapAllocations = 0;
+        bool m_HeapCheckWarned = false;
+#endif
 
         // possible add this to app config
         std::vector<const char*> m_InstanceExtensions;
         std::vector<const char*> m_DeviceExtensions = {
             VK_KHR_SWAPCHAIN_EXTENSION_NAME, // required
         };
+        /* Enabled when present, the application runs without them */
+        std::vector<const char*> m_OptionalInstanceExtensions = {
+            VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME, // needed by VK_EXT_memory_budget
+        };
         std::vector<const char*> m_InstanceLayers = {
 #ifdef INCLUDE_DEBUG_INFO
             "VK_LAYER_KHRONOS_validation",
@@ -87,6 +252,19 @@ namespace VulkanPractice {
         inline const std::unique_ptr<Window>& GetWindow() const { return m_Window; }
         inline const std::string& GetApplicationName() const { return m_ApplicationName; }
         inline const std::string& GetApplicationEngineName() const { return m_ApplicationEngineName; }
+
+        /* Util functions */ // stateless --> public so tools/EngineBenchmark can time them against the engine library
+        static bool CheckInstanceExtensionSupport(const std::vector<const char*>& instanceExtensions);
+        static bool CheckDeviceExtensionSupport(const std::vector<VkExtensionProperties>& availableExtensions, const std::vector<const char*>& deviceExtensions);
+        static bool CheckInstanceLayerSupport(const std::vector<const char*>& instanceLayers);
+
+        static PhysicalDeviceInfo QueryPhysicalDevice(VkPhysicalDevice device, VkSurfaceKHR surface);
+        static bool IsPhysicalDeviceSuitable(const PhysicalDeviceInfo& info, const std::vector<const char*>& deviceExtensions);
+        static QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface);
+        static SwapChainSupportDetails QuerySwapChainSupport(VkPhysicalDevice device, VkSurfaceKHR surface);
+
+        static VkSurfaceFormatKHR ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats);
+        static VkPresentModeKHR ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes);
     private:
         void InitVulkan();
         void CleanupVulkan();
@@ -98,35 +276,80 @@ namespace VulkanPractice {
         void CreateSurface();
         void PickPhysicalDevice();
         void CreateLogicalDevice();
+        void CreateMemoryBudget();
+        /* Registers the frame metrics and starts the export thread --> needs the memory heaps */
+        void CreateMetrics();
         void CreateSwapChain();
         void CreateImageViews();
         void CreateRenderPass();
+        void CreateUniformRing();
+        void CreateSceneObjects();
+        /* Declares the toggles of every shader the application owns, then reads which define permutations to prebuild */
+        void LoadShaderLibrary();
         void CreateGraphicsPipeline();
+        void CreateDepthResources();
         void CreateFramebuffers();
         void CreateCommandPool();
+        void LoadMesh();
         void CreateCommandBuffers();
         void CreateSyncObjects();
+        void CreateFrameCapture();
+        void CreateGpuTimer();
+        void CreateDynamicResolution();
+        void CreateOcclusionCuller();
+        void CreateRenderer2D();
+        /* Own surface and swapchain per window --> the device was picked for the main surface, so each extra surface is checked against it */
+        void CreateExtraWindows();
 
         void CleanupSwapChain(); // Handles window size changes etc
         void RecreateSwapChain(); // Handles window size changes etc
 
-        void RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
-        void DrawFrame();
+        /* Everything a recorded frame depends on besides the swapchain --> its hash is the command buffer cache key */
+        struct FrameContent {
+            VkPipeline Pipeline;
+            Mesh* DrawMesh; // not hashed --> a reloaded mesh may land on the same address
+            AssetHandle MeshHandle;
+            uint64_t MeshGeneration; // 0 while DrawMesh is null
+            FrameUniforms Frame;
+            DrawPushConstants Draw;
+            VkExtent2D RenderExtent; // scene resolution, the swapchain extent without dynamic resolution
+            uint64_t Overlay; // Renderer2D::Hash of the batch drawn over the frame, 0 without one
 
-        /* Util functions */
-        static bool CheckInstanceExtensionSupport(const std::vector<const char*>& instanceExtensions);
-        static bool CheckDeviceExtensionSupport(VkPhysicalDevice device, const std::vector<const char*>& deviceExtensions);
-        static bool CheckInstanceLayerSupport(const std::vector<const char*>& instanceLayers);
-
-        static bool IsPhysicalDeviceSuitable(VkPhysicalDevice device, VkSurfaceKHR surface, const std::vector<const char*>& deviceExtensions);
-        static QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface);
-        static SwapChainSupportDetails QuerySwapChainSupport(VkPhysicalDevice device, VkSurfaceKHR surface);
+            uint64_t Hash() const;
+        };
+        FrameContent GatherFrameContent();
+        /* Frustum culls the scene objects through the BVH into m_VisibleRanges --> everything when the GPU culler runs */
+        void CullScene(const FrameContent& content);
+        /* BVH frustum query merged into runs of consecutive objects --> const, safe from several recording threads at once */
+        void CullObjects(const glm::mat4& viewProjection, std::vector<SceneBvh::ItemId>& objects, std::vector<InstanceRange>& ranges) const;
+        /* Fills the 2D batch --> counts of the last recorded frame over a translucent panel */
+        void DrawStatsOverlay();
+        void RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, const FrameContent& content, uint32_t frameUniformOffset);
+        void RecordScene(VkCommandBuffer commandBuffer, const FrameContent& content, uint32_t frameUniformOffset, const std::vector<InstanceRange>& ranges);
+        /* Runs on its own thread next to the main window's recording --> only touches the window and const scene state */
+        void RecordExtraWindow(ExtraWindow& window, uint32_t frame, const FrameContent& content, uint32_t frameUniformOffset);
+        /* Pipeline, viewport, descriptor sets and the mesh --> everything RecordScene does short of the draw */
+        void BindScene(VkCommandBuffer commandBuffer, const FrameContent& content, uint32_t frameUniformOffset);
+        void DrawFrame();
+        /* Background work that can change the next frame without an event --> pipeline compiles, mesh streaming, BVH rebuilds */
+        bool HasPendingWork();
+        void UpdateMemoryBudget();
+#ifdef INCLUDE_DEBUG_INFO
+        /* Steady state frames must not touch the heap on the render thread --> warns on the first one that does */
+        void CheckFrameHeapAllocations(uint64_t allocations);
+#endif
 
-        static VkSurfaceFormatKHR ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats);
-        static VkPresentModeKHR ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes);
         static VkExtent2D ChooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities, const std::unique_ptr<Window>& window);
 
         static void FramebufferResizeCallback(GLFWwindow* window, int width, int height); // glfw frame buffer callback function
+        static void WindowFocusCallback(GLFWwindow* window, int focused);
+        static void WindowIconifyCallback(GLFWwindow* window, int iconified);
+        static void WindowRefreshCallback(GLFWwindow* window); // contents damaged, e.g. uncovered by another window
+        static void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+        static void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+        static void CursorPosCallback(GLFWwindow* window, double x, double y);
+        static void ScrollCallback(GLFWwindow* window, double xOffset, double yOffset);
+        static void ExtraWindowResizeCallback(GLFWwindow* window, int width, int height); // user pointer is the SwapchainTarget
 #ifdef INCLUDE_DEBUG_INFO
         static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(
             VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
@@ -134,17 +357,6 @@ namespace VulkanPractice {
             const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,
             void* pUserData
         );
-        static VkResult CreateDebugUtilsMessengerEXT(
-            VkInstance instance,
-            const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo,
-            const VkAllocationCallbacks* pAllocator,
-            VkDebugUtilsMessengerEXT* pDebugMessenger
-        );
-        static void DestroyDebugUtilsMessengerEXT(
-            VkInstance instance,
-            VkDebugUtilsMessengerEXT debugMessenger,
-            const VkAllocationCallbacks* pAllocator
-        );
 #endif
     };
 }
\ No newline at end of file
@@ -0,0 +1,307 @@
+#include "AssetStreamer.h"
+#include "Log.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+#ifdef HAS_LIBURING
+#include <liburing.h>
+#endif
+
+namespace VulkanPractice {
+    AssetStreamer::AssetStreamer(const AssetStreamerConfig& config)
+        : m_Config(config)
+    {
+        uint32_t threadCount = std::max(1U, m_Config.IoThreadCount);
+        for (uint32_t i = 0; i < threadCount; i++) {
+            m_IoThreads.emplace_back(&AssetStreamer::IoThreadMain, this);
+        }
+    }
+    AssetStreamer::~AssetStreamer() {
+        {
+            std::lock_guard<std::mutex> lock(m_JobMutex);
+            m_Stopping = true;
+        }
+        m_JobCondition.notify_all();
+        for (auto& thread : m_IoThreads) thread.join();
+        /* Resources go before the caller tears the device down */
+        m_Assets.clear();
+    }
+
+    AssetHandle AssetStreamer::Request(const std::string& path, AssetPriority priority, UploadFunction upload, ReadyFunction ready) {
+        AssetHandle handle = m_NextHandle++;
+        Asset& asset = m_Assets[handle];
+        asset.Path = path;
+        asset.Priority = priority;
+        asset.Upload = std::move(upload);
+        asset.Ready = std::move(ready);
+        asset.LruPosition = m_Lru.end();
+        Enqueue(handle, asset);
+        return handle;
+    }
+    void AssetStreamer::Enqueue(AssetHandle handle, const Asset& asset) {
+        {
+            std::lock_guard<std::mutex> lock(m_JobMutex);
+            m_Jobs.push({ handle, asset.Priority, m_JobSequence++, asset.Path });
+        }
+        m_JobCondition.notify_one();
+    }
+
+    void AssetStreamer::Update(uint64_t frameNumber) {
+        m_CurrentFrame = frameNumber;
+        /* Uploads finished by the GPU since the last frame --> never waited on */
+        for (size_t i = 0; i < m_Uploading.size();) {
+            Asset& asset = m_Assets.at(m_Uploading[i]);
+            if (asset.Ready(asset.Resource.get())) {
+                MarkResident(m_Uploading[i], asset);
+                m_Uploading[i] = m_Uploading.back();
+                m_Uploading.pop_back();
+            } else {
+                i++;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_ResultMutex);
+            for (auto& result : m_Results) m_PendingUploads.push_back(std::move(result));
+            m_Results.clear();
+        }
+        /* Highest priority uploads first, bounded per frame to keep frame times flat --> stable_sort takes a heap buffer, idle frames skip it */
+        if (m_PendingUploads.size() > 1) {
+            std::stable_sort(m_PendingUploads.begin(), m_PendingUploads.end(), [this](const ReadResult& a, const ReadResult& b) {
+                return m_Assets.at(a.Handle).Priority > m_Assets.at(b.Handle).Priority;
+            });
+        }
+        uint64_t uploadedBytes = 0;
+        while (!m_PendingUploads.empty() && (uploadedBytes == 0 || uploadedBytes + m_PendingUploads.front().Data.size() <= m_Config.MaxUploadBytesPerFrame)) {
+            ReadResult result = std::move(m_PendingUploads.front());
+            m_PendingUploads.pop_front();
+            Asset& asset = m_Assets.at(result.Handle);
+            if (!result.Success) {
+                asset.State = AssetState::Failed;
+                LOG_ERROR("Failed to stream {}: {}", asset.Path, result.Error);
+                continue;
+            }
+            try {
+                asset.Resource = asset.Upload(result.Data, asset.Path, asset.ResidentBytes);
+            } catch (const std::exception& e) {
+                asset.State = AssetState::Failed;
+                LOG_ERROR("Failed to upload {}: {}", asset.Path, e.what());
+                continue;
+            }
+            uploadedBytes += result.Data.size();
+            m_ResidentBytes += asset.ResidentBytes; // the memory exists from here on, whether or not the copies finished
+            if (asset.Ready) {
+                asset.State = AssetState::Uploading;
+                m_Uploading.push_back(result.Handle);
+            } else {
+                MarkResident(result.Handle, asset);
+            }
+        }
+        EvictOverBudget();
+    }
+    void AssetStreamer::MarkResident(AssetHandle handle, Asset& asset) {
+        asset.State = AssetState::Resident;
+        asset.LastUsedFrame = m_CurrentFrame;
+        asset.Generation = m_NextGeneration++;
+        m_Lru.push_front(handle);
+        asset.LruPosition = m_Lru.begin();
+    }
+    void AssetStreamer::EvictOverBudget() {
+        EvictDownTo(m_Config.ResidencyBudget);
+    }
+    uint64_t AssetStreamer::Trim(uint64_t bytes) {
+        uint64_t before = m_ResidentBytes;
+        EvictDownTo(m_ResidentBytes > bytes ? m_ResidentBytes - bytes : 0);
+        return before - m_ResidentBytes;
+    }
+    void AssetStreamer::EvictDownTo(uint64_t residentBytes) {
+        auto it = m_Lru.end();
+        while (m_ResidentBytes > residentBytes && it != m_Lru.begin()) {
+            --it;
+            Asset& asset = m_Assets.at(*it);
+            /* Anything touched within the frames in flight may still be referenced by the GPU */
+            if (asset.LastUsedFrame + m_Config.FramesInFlight >= m_CurrentFrame) break; // list is ordered, the rest is newer
+            LOG_TRACE("Evicting {} ({} bytes)", asset.Path, asset.ResidentBytes);
+            m_ResidentBytes -= asset.ResidentBytes;
+            asset.Resource.reset();
+            asset.ResidentBytes = 0;
+            asset.Generation = 0;
+            asset.State = AssetState::Evicted;
+            asset.LruPosition = m_Lru.end();
+            it = m_Lru.erase(it);
+        }
+    }
+
+    void* AssetStreamer::Acquire(AssetHandle handle) {
+        auto found = m_Assets.find(handle);
+        if (found == m_Assets.end()) return nullptr;
+        Asset& asset = found->second;
+        if (asset.State == AssetState::Evicted) {
+            asset.State = AssetState::Queued;
+            Enqueue(handle, asset);
+            return nullptr;
+        }
+        if (asset.State != AssetState::Resident) return nullptr;
+        asset.LastUsedFrame = m_CurrentFrame;
+        m_Lru.splice(m_Lru.begin(), m_Lru, asset.LruPosition);
+        return asset.Resource.get();
+    }
+    AssetState AssetStreamer::GetState(AssetHandle handle) const {
+        auto found = m_Assets.find(handle);
+        return found != m_Assets.end() ? found->second.State : AssetState::Failed;
+    }
+    uint64_t AssetStreamer::GetGeneration(AssetHandle handle) const {
+        auto found = m_Assets.find(handle);
+        return found != m_Assets.end() ? found->second.Generation : 0;
+    }
+
+    void AssetStreamer::IoThreadMain() {
+        while (true) {
+            ReadJob job;
+            {
+                std::unique_lock<std::mutex> lock(m_JobMutex);
+                m_JobCondition.wait(lock, [this] { return m_Stopping || !m_Jobs.empty(); });
+                if (m_Stopping) return;
+                job = m_Jobs.top();
+                m_Jobs.pop();
+            }
+            ReadResult result;
+            result.Handle = job.Handle;
+            result.Success = ReadWholeFile(job.Path, result.Data, result.Error);
+            std::lock_guard<std::mutex> lock(m_ResultMutex);
+            m_Results.push_back(std::move(result));
+        }
+    }
+
+#if defined(_WIN32)
+    bool AssetStreamer::ReadWholeFile(const std::string& path, std::vector<uint8_t>& data, std::string& error) {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            error = "cannot open file";
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            error = "cannot query file size";
+            return false;
+        }
+        data.resize(static_cast<size_t>(size.QuadPart));
+        size_t offset = 0;
+        while (offset < data.size()) {
+            DWORD chunk = static_cast<DWORD>(std::min<size_t>(data.size() - offset, 1u << 30));
+            DWORD read = 0;
+            if (!ReadFile(file, data.data() + offset, chunk, &read, nullptr) || read == 0) {
+                CloseHandle(file);
+                error = "read failed";
+                return false;
+            }
+            offset += read;
+        }
+        CloseHandle(file);
+        return true;
+    }
+#else
+    /* Reads size bytes starting at fileOffset into buffer --> retries short reads and EINTR */
+    static bool PreadAll(int fd, uint8_t* buffer, size_t size, size_t fileOffset, std::string& error) {
+        size_t offset = 0;
+        while (offset < size) {
+            ssize_t read = pread(fd, buffer + offset, size - offset, static_cast<off_t>(fileOffset + offset));
+            if (read < 0 && errno == EINTR) continue;
+            if (read <= 0) {
+                error = read < 0 ? std::strerror(errno) : "unexpected end of file";
+                return false;
+            }
+            offset += static_cast<size_t>(read);
+        }
+        return true;
+    }
+#ifdef HAS_LIBURING
+    /* One ring per I/O thread; large files are split into chunks kept in flight together */
+    static bool UringReadAll(int fd, uint8_t* buffer, size_t size, std::string& error) {
+        constexpr unsigned QueueDepth = 8;
+        constexpr size_t ChunkSize = 1u << 20;
+        thread_local struct Ring {
+            io_uring Uring;
+            bool Valid;
+            Ring() { Valid = io_uring_queue_init(QueueDepth, &Uring, 0) == 0; }
+            ~Ring() { if (Valid) io_uring_queue_exit(&Uring); }
+        } ring;
+        if (!ring.Valid) return PreadAll(fd, buffer, size, 0, error); // kernel without io_uring or blocked by policy
+
+        size_t submitted = 0, completed = 0;
+        unsigned inFlight = 0;
+        while (completed < size) {
+            while (inFlight < QueueDepth && submitted < size) {
+                io_uring_sqe* sqe = io_uring_get_sqe(&ring.Uring);
+                if (sqe == nullptr) break;
+                unsigned length = static_cast<unsigned>(std::min(ChunkSize, size - submitted));
+                io_uring_prep_read(sqe, fd, buffer + submitted, length, static_cast<__u64>(submitted));
+                io_uring_sqe_set_data64(sqe, (static_cast<__u64>(submitted) << 24) | length); // chunks are <= 1 MiB
+                submitted += length;
+                inFlight++;
+            }
+            io_uring_submit(&ring.Uring);
+            io_uring_cqe* cqe;
+            if (io_uring_wait_cqe(&ring.Uring, &cqe) < 0) {
+                error = "io_uring wait failed";
+                return false;
+            }
+            __u64 tag = io_uring_cqe_get_data64(cqe);
+            int res = cqe->res;
+            io_uring_cqe_seen(&ring.Uring, cqe);
+            inFlight--;
+            size_t chunkOffset = static_cast<size_t>(tag >> 24), chunkLength = static_cast<size_t>(tag & 0xFFFFFF);
+            if (res < 0) {
+                error = std::strerror(-res);
+                while (inFlight > 0 && io_uring_wait_cqe(&ring.Uring, &cqe) == 0) { io_uring_cqe_seen(&ring.Uring, cqe); inFlight--; }
+                return false;
+            }
+            /* Short reads are finished synchronously --> from where the kernel stopped, not the start of the file */
+            size_t missingOffset = chunkOffset + static_cast<size_t>(res);
+            if (static_cast<size_t>(res) < chunkLength &&
+                !PreadAll(fd, buffer + missingOffset, chunkLength - static_cast<size_t>(res), missingOffset, error)) {
+                while (inFlight > 0 && io_uring_wait_cqe(&ring.Uring, &cqe) == 0) { io_uring_cqe_seen(&ring.Uring, cqe); inFlight--; }
+                return false;
+            }
+            completed += chunkLength;
+        }
+        return true;
+    }
+#endif
+    bool AssetStreamer::ReadWholeFile(const std::string& path, std::vector<uint8_t>& data, std::string& error) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error = std::strerror(errno);
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            error = std::strerror(errno);
+            close(fd);
+            return false;
+        }
+        posix_fadvise(fd, 0, st.st_size, POSIX_FADV_SEQUENTIAL);
+        data.resize(static_cast<size_t>(st.st_size));
+#ifdef HAS_LIBURING
+        bool success = UringReadAll(fd, data.data(), data.size(), error);
+#else
+        bool success = PreadAll(fd, data.data(), data.size(), 0, error);
+#endif
+        close(fd);
+        return success;
+    }
+#endif
+}
\ No newline at end of file
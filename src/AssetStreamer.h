@@ -0,0 +1,121 @@
+#pragma once
+/* This Header handles background asset loading: prioritized I/O thread pool + LRU residency budget */
+#include "pch.h"
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <queue>
+#include <deque>
+#include <list>
+#include <unordered_map>
+
+namespace VulkanPractice {
+    using AssetHandle = uint64_t;
+    constexpr AssetHandle InvalidAssetHandle = 0;
+
+    enum class AssetPriority : uint8_t {
+        Low = 0, Normal, High, Critical
+    };
+    enum class AssetState : uint8_t {
+        Queued, Uploading, Resident, Evicted, Failed
+    };
+
+    struct AssetStreamerConfig {
+        uint32_t IoThreadCount = 2;
+        uint64_t ResidencyBudget = 256ull << 20; // bytes of uploaded data kept alive
+        uint64_t MaxUploadBytesPerFrame = 32ull << 20; // at least one upload per frame regardless
+        uint32_t FramesInFlight = 3; // assets used this recently are never evicted
+    };
+
+    class AssetStreamer {
+    public:
+        /* Runs on the render thread inside Update --> turns file bytes into a GPU resource and reports its size */
+        using UploadFunction = std::function<std::shared_ptr<void>(const std::vector<uint8_t>& data, const std::string& path, uint64_t& residentBytes)>;
+        /* Polled once per Update on the render thread while the upload's GPU work is in flight --> the asset turns resident when it returns true */
+        using ReadyFunction = std::function<bool(void* resource)>;
+    private:
+        struct Asset {
+            std::string Path;
+            AssetPriority Priority;
+            UploadFunction Upload;
+            ReadyFunction Ready; // empty --> resident as soon as Upload returns
+            AssetState State = AssetState::Queued;
+            std::shared_ptr<void> Resource;
+            uint64_t ResidentBytes = 0;
+            uint64_t LastUsedFrame = 0;
+            uint64_t Generation = 0; // unique per residency, 0 while not resident
+            std::list<AssetHandle>::iterator LruPosition;
+        };
+        struct ReadJob {
+            AssetHandle Handle;
+            AssetPriority Priority;
+            uint64_t Sequence; // FIFO among equal priorities
+            std::string Path;
+            bool operator<(const ReadJob& other) const {
+                if (Priority != other.Priority) return Priority < other.Priority;
+                return Sequence > other.Sequence;
+            }
+        };
+        struct ReadResult {
+            AssetHandle Handle;
+            bool Success;
+            std::vector<uint8_t> Data;
+            std::string Error;
+        };
+
+        AssetStreamerConfig m_Config;
+
+        /* Render thread only */
+        std::unordered_map<AssetHandle, Asset> m_Assets;
+        std::list<AssetHandle> m_Lru; // front = most recently used, resident assets only
+        std::deque<ReadResult> m_PendingUploads; // read but not yet uploaded
+        std::vector<AssetHandle> m_Uploading; // uploaded, GPU copies still in flight
+        AssetHandle m_NextHandle = 1;
+        uint64_t m_NextGeneration = 1;
+        uint64_t m_CurrentFrame = 0;
+        uint64_t m_ResidentBytes = 0;
+
+        /* Shared with I/O threads */
+        std::mutex m_JobMutex;
+        std::condition_variable m_JobCondition;
+        std::priority_queue<ReadJob> m_Jobs;
+        uint64_t m_JobSequence = 0;
+        bool m_Stopping = false;
+        std::mutex m_ResultMutex;
+        std::vector<ReadResult> m_Results;
+        std::vector<std::thread> m_IoThreads;
+    public:
+        AssetStreamer(const AssetStreamerConfig& config = AssetStreamerConfig());
+        ~AssetStreamer();
+        AssetStreamer(const AssetStreamer&) = delete;
+        AssetStreamer& operator=(const AssetStreamer&) = delete;
+
+        AssetHandle Request(const std::string& path, AssetPriority priority, UploadFunction upload, ReadyFunction ready = nullptr);
+        /* Call once per frame on the render thread --> uploads finished reads and enforces the budget, never touches disk */
+        void Update(uint64_t frameNumber);
+
+        /* Returns nullptr until resident; marks the asset used this frame and re-streams it if it was evicted */
+        template<typename T>
+        T* Get(AssetHandle handle) { return static_cast<T*>(Acquire(handle)); }
+        AssetState GetState(AssetHandle handle) const;
+        /* Changes every time the asset turns resident again --> handle + generation identify one resource, unlike its address which a reload may reuse */
+        uint64_t GetGeneration(AssetHandle handle) const;
+
+        inline uint64_t GetResidentBytes() const { return m_ResidentBytes; }
+        inline uint64_t GetResidencyBudget() const { return m_Config.ResidencyBudget; }
+        inline void SetResidencyBudget(uint64_t budget) { m_Config.ResidencyBudget = budget; }
+        /* Evicts least recently used assets outside the frames in flight until bytes are released --> returns what was released */
+        uint64_t Trim(uint64_t bytes);
+
+        /* Whole-file read through io_uring where available, pread / ReadFile otherwise --> what every I/O thread runs per asset */
+        static bool ReadWholeFile(const std::string& path, std::vector<uint8_t>& data, std::string& error);
+    private:
+        void* Acquire(AssetHandle handle);
+        void Enqueue(AssetHandle handle, const Asset& asset);
+        void MarkResident(AssetHandle handle, Asset& asset);
+        void EvictOverBudget();
+        void EvictDownTo(uint64_t residentBytes);
+        void IoThreadMain();
+    };
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "CommandBufferCache.h"
+
+namespace VulkanPractice {
+    CommandBufferCache::CommandBufferCache(const DeviceContext& context, uint32_t slotCount)
+        : m_DeviceContext(context)
+    {
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT; // slots are re-recorded one at a time
+        poolInfo.queueFamilyIndex = context.GraphicsQueueFamily;
+        if (vkCreateCommandPool(m_DeviceContext.Device, &poolInfo, m_DeviceContext.Allocator, &m_VkCommandPool) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create cached command pool!");
+        }
+        AllocateSlots(slotCount);
+    }
+    CommandBufferCache::~CommandBufferCache() {
+        vkDestroyCommandPool(m_DeviceContext.Device, m_VkCommandPool, m_DeviceContext.Allocator); // automatically frees command buffers
+    }
+
+    void CommandBufferCache::Resize(uint32_t slotCount) {
+        FreeSlots();
+        AllocateSlots(slotCount);
+    }
+    void CommandBufferCache::Invalidate() {
+        for (auto& slot : m_Slots) {
+            slot.Valid = false;
+        }
+    }
+
+    void CommandBufferCache::AllocateSlots(uint32_t slotCount) {
+        if (slotCount == 0) return;
+        std::vector<VkCommandBuffer> commandBuffers(slotCount);
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = m_VkCommandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = slotCount;
+        if (vkAllocateCommandBuffers(m_DeviceContext.Device, &allocInfo, commandBuffers.data()) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate cached command buffers!");
+        }
+        m_Slots.resize(slotCount);
+        for (uint32_t i = 0; i < slotCount; i++) {
+            m_Slots[i].CommandBuffer = commandBuffers[i];
+        }
+    }
+    void CommandBufferCache::FreeSlots() {
+        std::vector<VkCommandBuffer> commandBuffers;
+        commandBuffers.reserve(m_Slots.size());
+        for (const auto& slot : m_Slots) {
+            commandBuffers.push_back(slot.CommandBuffer);
+        }
+        if (!commandBuffers.empty()) {
+            vkFreeCommandBuffers(m_DeviceContext.Device, m_VkCommandPool, static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+        }
+        m_Slots.clear();
+    }
+}
\ No newline at end of file
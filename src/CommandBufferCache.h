@@ -0,0 +1,55 @@
+#pragma once
+/* This Header keeps prerecorded command buffers per slot (swapchain image or pass) --> re-recorded only when their content key changes */
+#include "pch.h"
+#include "DeviceContext.h"
+
+namespace VulkanPractice {
+    class CommandBufferCache {
+    private:
+        struct Slot {
+            VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+            uint64_t Key = 0;
+            bool Valid = false;
+        };
+
+        DeviceContext m_DeviceContext;
+        VkCommandPool m_VkCommandPool = VK_NULL_HANDLE; // own pool --> cached buffers are never reset with the per frame ones
+        std::vector<Slot> m_Slots;
+        uint64_t m_ReplayCount = 0, m_RecordCount = 0;
+    public:
+        CommandBufferCache(const DeviceContext& context, uint32_t slotCount);
+        ~CommandBufferCache();
+        CommandBufferCache(const CommandBufferCache&) = delete;
+        CommandBufferCache& operator=(const CommandBufferCache&) = delete;
+
+        /* None of the buffers may be pending --> call after vkDeviceWaitIdle, e.g. on swapchain recreation */
+        void Resize(uint32_t slotCount);
+        void Invalidate();
+        inline void Invalidate(uint32_t slot) { m_Slots[slot].Valid = false; }
+
+        /* Replays the slot while key matches, otherwise resets it and calls record(commandBuffer) which does Begin/End itself.
+           The slot must not be pending when it is re-recorded --> wait on the fence that last submitted it first */
+        template<typename RecordFunction>
+        VkCommandBuffer Get(uint32_t slot, uint64_t key, RecordFunction&& record) {
+            Slot& entry = m_Slots[slot];
+            if (entry.Valid && entry.Key == key) {
+                m_ReplayCount++;
+                return entry.CommandBuffer;
+            }
+            entry.Valid = false; // stays dirty if record throws
+            m_DeviceContext.Dispatch->ResetCommandBuffer(entry.CommandBuffer, 0);
+            record(entry.CommandBuffer);
+            entry.Key = key;
+            entry.Valid = true;
+            m_RecordCount++;
+            return entry.CommandBuffer;
+        }
+
+        inline uint32_t GetSlotCount() const { return static_cast<uint32_t>(m_Slots.size()); }
+        inline uint64_t GetReplayCount() const { return m_ReplayCount; }
+        inline uint64_t GetRecordCount() const { return m_RecordCount; }
+    private:
+        void AllocateSlots(uint32_t slotCount);
+        void FreeSlots();
+    };
+}
\ No newline at end of file
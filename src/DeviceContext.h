@@ -0,0 +1,22 @@
+#pragma once
+/* This Header bundles the device handles subsystems need, owned by Application */
+#include "pch.h"
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#endif
+#include <GLFW/glfw3.h>
+#include "VulkanDispatch.h"
+
+namespace VulkanPractice {
+    struct DeviceContext {
+        VkPhysicalDevice PhysicalDevice = VK_NULL_HANDLE;
+        VkDevice Device = VK_NULL_HANDLE;
+        VkQueue GraphicsQueue = VK_NULL_HANDLE;
+        uint32_t GraphicsQueueFamily = 0;
+        VkCommandPool CommandPool = VK_NULL_HANDLE; // transient uploads are allocated from here
+        VkPhysicalDeviceFeatures EnabledFeatures{}; // what CreateLogicalDevice actually turned on
+        VkPhysicalDeviceLimits Limits{}; // alignment and size limits for subsystems that allocate
+        const VkAllocationCallbacks* Allocator = nullptr; // host allocator for every create/destroy on Device, null for the driver default
+        const DeviceDispatch* Dispatch = nullptr; // direct entry points of Device --> used on recording and submit paths
+    };
+}
\ No newline at end of file
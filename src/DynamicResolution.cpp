@@ -0,0 +1,276 @@
+#include "DynamicResolution.h"
+#include "VulkanUtils.h"
+#include "ShaderTypes.h"
+#include "Log.h"
+#include <cmath>
+
+namespace VulkanPractice {
+    DynamicResolution::DynamicResolution(const DeviceContext& context, const DynamicResolutionConfig& config, VkFormat colorFormat, VkFormat depthFormat, bool occlusionPasses,
+        VkRenderPass presentRenderPass, VkExtent2D outputExtent, PipelineCache& pipelineCache, VkSampler sampler)
+        : m_DeviceContext(context), m_Config(config), m_Format(colorFormat), m_DepthFormat(depthFormat), m_OcclusionPasses(occlusionPasses),
+        m_OutputExtent(outputExtent), m_VkSampler(sampler)
+    {
+        m_Config.MaxScale = std::max(m_Config.MaxScale, s_ScaleQuantum);
+        m_Config.MinScale = std::clamp(m_Config.MinScale, s_ScaleQuantum, m_Config.MaxScale);
+        m_Scale = m_Config.MaxScale;
+        m_LowestScale = m_Scale;
+
+        CreateSceneRenderPasses();
+        CreateUpscalePipeline(presentRenderPass, pipelineCache);
+        CreateSceneTarget();
+    }
+    DynamicResolution::~DynamicResolution() {
+#ifdef INCLUDE_DEBUG_INFO
+        LOG_INFO("Dynamic resolution: {} scale changes, lowest scale {:.3f}, final scale {:.3f}", m_ScaleChanges, m_LowestScale, m_Scale);
+#endif
+        DestroySceneTarget();
+        vkDestroyPipelineLayout(m_DeviceContext.Device, m_VkUpscaleLayout, m_DeviceContext.Allocator);
+        vkDestroyDescriptorPool(m_DeviceContext.Device, m_VkDescriptorPool, m_DeviceContext.Allocator); // frees the set
+        vkDestroyDescriptorSetLayout(m_DeviceContext.Device, m_VkDescriptorSetLayout, m_DeviceContext.Allocator);
+        vkDestroyRenderPass(m_DeviceContext.Device, m_VkSecondPhasePass, m_DeviceContext.Allocator);
+        vkDestroyRenderPass(m_DeviceContext.Device, m_VkFirstPhasePass, m_DeviceContext.Allocator);
+        vkDestroyRenderPass(m_DeviceContext.Device, m_VkSceneRenderPass, m_DeviceContext.Allocator);
+    }
+
+    void DynamicResolution::ReportGpuTime(double milliseconds) {
+        if (++m_SamplesSinceChange <= s_IgnoredSamples) return;
+        m_FilteredMilliseconds = m_SamplesSinceChange == s_IgnoredSamples + 1 ? milliseconds
+            : m_FilteredMilliseconds + (milliseconds - m_FilteredMilliseconds) * s_Smoothing;
+        if (m_SamplesSinceChange < s_IgnoredSamples + s_SettleSamples) return;
+
+        double target = m_Config.TargetGpuMilliseconds;
+        if (m_FilteredMilliseconds <= target && m_FilteredMilliseconds >= target * s_Headroom) return;
+        /* GPU time follows the pixel count --> per axis scale goes with the square root of the ratio */
+        float wanted = m_Scale * static_cast<float>(std::sqrt(target / std::max(m_FilteredMilliseconds, 1e-3)));
+        wanted = std::clamp(wanted, m_Scale * (1.0f - s_MaxStep), m_Scale * (1.0f + s_MaxStep));
+        wanted = std::round(wanted / s_ScaleQuantum) * s_ScaleQuantum;
+        wanted = std::clamp(wanted, m_Config.MinScale, m_Config.MaxScale);
+        if (wanted == m_Scale) return;
+#ifdef INCLUDE_DEBUG_INFO
+        LOG_TRACE("Dynamic resolution: {:.2f} ms GPU against {:.2f} ms target --> scale {:.3f} to {:.3f}", m_FilteredMilliseconds, target, m_Scale, wanted);
+#endif
+        m_Scale = wanted;
+        m_LowestScale = std::min(m_LowestScale, m_Scale);
+        m_SamplesSinceChange = 0;
+        m_ScaleChanges++;
+    }
+    void DynamicResolution::Resize(VkExtent2D outputExtent) {
+        m_OutputExtent = outputExtent;
+        DestroySceneTarget();
+        CreateSceneTarget();
+    }
+
+    void DynamicResolution::BeginScene(VkCommandBuffer commandBuffer, VkExtent2D renderExtent) {
+        AcquireScene(commandBuffer);
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = m_VkSceneRenderPass;
+        renderPassInfo.framebuffer = m_VkSceneFramebuffer;
+        renderPassInfo.renderArea.offset = { 0, 0 };
+        renderPassInfo.renderArea.extent = renderExtent;
+        VkClearValue clearValues[2]{};
+        clearValues[0].color = {{ 0.0f, 0.0f, 0.0f, 1.0f }};
+        clearValues[1].depthStencil = { 1.0f, 0 };
+        renderPassInfo.clearValueCount = 2;
+        renderPassInfo.pClearValues = clearValues;
+        m_DeviceContext.Dispatch->CmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    }
+    void DynamicResolution::EndScene(VkCommandBuffer commandBuffer) {
+        m_DeviceContext.Dispatch->CmdEndRenderPass(commandBuffer);
+        ReleaseScene(commandBuffer);
+    }
+    void DynamicResolution::AcquireScene(VkCommandBuffer commandBuffer) {
+        /* One target for every frame in flight --> the previous upscale must finish reading before this frame writes */
+        m_DeviceContext.Dispatch->CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            0, 0, nullptr, 0, nullptr, 0, nullptr);
+    }
+    void DynamicResolution::ReleaseScene(VkCommandBuffer commandBuffer) {
+        const DeviceDispatch& dispatch = *m_DeviceContext.Dispatch;
+        /* Layout is already SHADER_READ_ONLY from the pass --> only the writes need to be visible to the upscale */
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        dispatch.CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+    void DynamicResolution::RecordUpscale(VkCommandBuffer commandBuffer, VkExtent2D renderExtent) {
+        const DeviceDispatch& dispatch = *m_DeviceContext.Dispatch;
+        dispatch.CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_VkUpscalePipeline);
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = static_cast<float>(m_OutputExtent.width);
+        viewport.height = static_cast<float>(m_OutputExtent.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        dispatch.CmdSetViewport(commandBuffer, 0, 1, &viewport);
+        VkRect2D scissor{};
+        scissor.offset = { 0, 0 };
+        scissor.extent = m_OutputExtent;
+        dispatch.CmdSetScissor(commandBuffer, 0, 1, &scissor);
+        dispatch.CmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_VkUpscaleLayout, 0, 1, &m_VkDescriptorSet, 0, nullptr);
+
+        glm::vec2 targetSize(static_cast<float>(m_TargetExtent.width), static_cast<float>(m_TargetExtent.height));
+        glm::vec2 renderSize(static_cast<float>(renderExtent.width), static_cast<float>(renderExtent.height));
+        UpscalePushConstants constants{};
+        constants.UvScale = renderSize / targetSize;
+        constants.UvMax = (renderSize - 0.5f) / targetSize;
+        constants.TexelSize = 1.0f / targetSize;
+        constants.Sharpness = m_Config.Sharpness;
+        dispatch.CmdPushConstants(commandBuffer, m_VkUpscaleLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(constants), &constants);
+        dispatch.CmdDraw(commandBuffer, 3, 1, 0, 0);
+    }
+
+    VkExtent2D DynamicResolution::GetRenderExtent() const {
+        /* Rounded to whole pixels and kept inside the target */
+        VkExtent2D extent;
+        extent.width = std::clamp(static_cast<uint32_t>(std::lround(m_OutputExtent.width * m_Scale)), 1U, m_TargetExtent.width);
+        extent.height = std::clamp(static_cast<uint32_t>(std::lround(m_OutputExtent.height * m_Scale)), 1U, m_TargetExtent.height);
+        return extent;
+    }
+    bool DynamicResolution::IsFormatSupported(VkPhysicalDevice physicalDevice, VkFormat format) {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+        VkFormatFeatureFlags required = VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        return (properties.optimalTilingFeatures & required) == required;
+    }
+
+    void DynamicResolution::CreateSceneRenderPasses() {
+        /* Same formats as the swapchain pass --> only layouts differ, which keeps the passes compatible */
+        RenderPassDesc desc;
+        desc.ColorFormat = m_Format;
+        desc.ColorFinalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL; // sampled by the upscale
+        desc.DepthFormat = m_DepthFormat;
+        m_VkSceneRenderPass = VulkanUtils::CreateRenderPass(m_DeviceContext, desc);
+        if (!m_OcclusionPasses) return;
+        RenderPassDesc firstPhase = desc;
+        firstPhase.ColorFinalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        firstPhase.DepthFinalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        firstPhase.StoreDepth = true;
+        m_VkFirstPhasePass = VulkanUtils::CreateRenderPass(m_DeviceContext, firstPhase);
+        RenderPassDesc secondPhase = desc;
+        secondPhase.ColorInitialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        secondPhase.DepthInitialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        secondPhase.Load = true;
+        m_VkSecondPhasePass = VulkanUtils::CreateRenderPass(m_DeviceContext, secondPhase);
+    }
+    void DynamicResolution::CreateSceneTarget() {
+        uint32_t maxDimension = m_DeviceContext.Limits.maxImageDimension2D;
+        m_TargetExtent.width = std::clamp(static_cast<uint32_t>(std::ceil(m_OutputExtent.width * m_Config.MaxScale)), 1U, maxDimension);
+        m_TargetExtent.height = std::clamp(static_cast<uint32_t>(std::ceil(m_OutputExtent.height * m_Config.MaxScale)), 1U, maxDimension);
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = m_Format;
+        imageInfo.extent = { m_TargetExtent.width, m_TargetExtent.height, 1 };
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VulkanUtils::CreateImage(m_DeviceContext, imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_VkSceneImage, m_VkSceneImageMemory);
+        m_VkSceneImageView = VulkanUtils::CreateImageView(m_DeviceContext, m_VkSceneImage, m_Format, VK_IMAGE_ASPECT_COLOR_BIT, 1);
+        imageInfo.format = m_DepthFormat;
+        imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | (m_OcclusionPasses ? VK_IMAGE_USAGE_SAMPLED_BIT : 0);
+        VulkanUtils::CreateImage(m_DeviceContext, imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_VkDepthImage, m_VkDepthImageMemory);
+        m_VkDepthImageView = VulkanUtils::CreateImageView(m_DeviceContext, m_VkDepthImage, m_DepthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, 1);
+
+        VkFramebufferCreateInfo framebufferInfo{};
+        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInfo.renderPass = m_VkSceneRenderPass;
+        VkImageView attachments[] = { m_VkSceneImageView, m_VkDepthImageView };
+        framebufferInfo.attachmentCount = 2;
+        framebufferInfo.pAttachments = attachments;
+        framebufferInfo.width = m_TargetExtent.width;
+        framebufferInfo.height = m_TargetExtent.height;
+        framebufferInfo.layers = 1;
+        if (vkCreateFramebuffer(m_DeviceContext.Device, &framebufferInfo, m_DeviceContext.Allocator, &m_VkSceneFramebuffer) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create scene framebuffer!");
+        }
+
+        VkDescriptorImageInfo imageDescriptor{};
+        imageDescriptor.sampler = m_VkSampler;
+        imageDescriptor.imageView = m_VkSceneImageView;
+        imageDescriptor.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = m_VkDescriptorSet;
+        write.dstBinding = 0;
+        write.dstArrayElement = 0;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.descriptorCount = 1;
+        write.pImageInfo = &imageDescriptor;
+        vkUpdateDescriptorSets(m_DeviceContext.Device, 1, &write, 0, nullptr);
+    }
+    void DynamicResolution::DestroySceneTarget() {
+        vkDestroyFramebuffer(m_DeviceContext.Device, m_VkSceneFramebuffer, m_DeviceContext.Allocator);
+        vkDestroyImageView(m_DeviceContext.Device, m_VkDepthImageView, m_DeviceContext.Allocator);
+        vkDestroyImage(m_DeviceContext.Device, m_VkDepthImage, m_DeviceContext.Allocator);
+        vkFreeMemory(m_DeviceContext.Device, m_VkDepthImageMemory, m_DeviceContext.Allocator);
+        vkDestroyImageView(m_DeviceContext.Device, m_VkSceneImageView, m_DeviceContext.Allocator);
+        vkDestroyImage(m_DeviceContext.Device, m_VkSceneImage, m_DeviceContext.Allocator);
+        vkFreeMemory(m_DeviceContext.Device, m_VkSceneImageMemory, m_DeviceContext.Allocator);
+    }
+    void DynamicResolution::CreateUpscalePipeline(VkRenderPass presentRenderPass, PipelineCache& pipelineCache) {
+        VkDescriptorSetLayoutBinding binding{};
+        binding.binding = 0;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        binding.descriptorCount = 1;
+        binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = 1;
+        layoutInfo.pBindings = &binding;
+        if (vkCreateDescriptorSetLayout(m_DeviceContext.Device, &layoutInfo, m_DeviceContext.Allocator, &m_VkDescriptorSetLayout) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create upscale descriptor set layout!");
+        }
+        VkDescriptorPoolSize poolSize{};
+        poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        poolSize.descriptorCount = 1;
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        poolInfo.maxSets = 1;
+        if (vkCreateDescriptorPool(m_DeviceContext.Device, &poolInfo, m_DeviceContext.Allocator, &m_VkDescriptorPool) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create upscale descriptor pool!");
+        }
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_VkDescriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &m_VkDescriptorSetLayout;
+        if (vkAllocateDescriptorSets(m_DeviceContext.Device, &allocInfo, &m_VkDescriptorSet) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate upscale descriptor set!");
+        }
+
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(UpscalePushConstants);
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &m_VkDescriptorSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+        if (vkCreatePipelineLayout(m_DeviceContext.Device, &pipelineLayoutInfo, m_DeviceContext.Allocator, &m_VkUpscaleLayout) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create upscale pipeline layout!");
+        }
+
+        PipelineDesc desc;
+        desc.Shaders = {
+            { VK_SHADER_STAGE_VERTEX_BIT, std::string(SHADER_DIR) + "/GLSL/upscale.vert" },
+            { VK_SHADER_STAGE_FRAGMENT_BIT, std::string(SHADER_DIR) + "/GLSL/upscale.frag" }
+        };
+        desc.CullMode = VK_CULL_MODE_NONE; // fullscreen triangle, no vertex input
+        desc.ColorFormats = { m_Format };
+        desc.DepthFormat = m_DepthFormat; // attachment of the swapchain pass, neither tested nor written
+        desc.Layout = m_VkUpscaleLayout;
+        desc.RenderPass = presentRenderPass;
+        m_VkUpscalePipeline = pipelineCache.GetBlocking(desc);
+    }
+}
\ No newline at end of file
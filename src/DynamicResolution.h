@@ -0,0 +1,92 @@
+#pragma once
+/* This Header handles dynamic resolution: the scene renders into an offscreen target at a scale picked from measured GPU time, then an upscale pass fills the swapchain image */
+#include "pch.h"
+#include "DeviceContext.h"
+#include "PipelineCache.h"
+
+namespace VulkanPractice {
+    struct DynamicResolutionConfig {
+        bool Enabled = true;
+        float MinScale = 0.5f; // per axis, of the swapchain extent
+        float MaxScale = 1.0f; // above 1 supersamples
+        float TargetGpuMilliseconds = 12.0f; // GPU time per frame the controller steers towards
+        float Sharpness = 0.25f; // upscale sharpening, 0 = plain bilinear
+    };
+
+    class DynamicResolution {
+    private:
+        inline static constexpr double s_Smoothing = 0.1; // weight of a new sample in the moving average
+        inline static constexpr uint32_t s_IgnoredSamples = 4; // right after a change --> frames recorded at the old scale are still in flight
+        inline static constexpr uint32_t s_SettleSamples = 16; // samples averaged before the next decision
+        inline static constexpr double s_Headroom = 0.85; // scale up only below this fraction of the target --> dead band against oscillation
+        inline static constexpr float s_MaxStep = 0.1f; // largest relative change per decision
+        inline static constexpr float s_ScaleQuantum = 1.0f / 64.0f; // few distinct scales --> cached command buffers stay valid
+
+        DeviceContext m_DeviceContext;
+        DynamicResolutionConfig m_Config;
+        VkFormat m_Format, m_DepthFormat;
+        bool m_OcclusionPasses; // phase passes and a sampleable depth buffer for the OcclusionCuller
+        VkExtent2D m_OutputExtent{}, m_TargetExtent{}; // target is sized for MaxScale --> changing scale never reallocates
+
+        VkImage m_VkSceneImage = VK_NULL_HANDLE;
+        VkDeviceMemory m_VkSceneImageMemory = VK_NULL_HANDLE;
+        VkImageView m_VkSceneImageView = VK_NULL_HANDLE;
+        VkImage m_VkDepthImage = VK_NULL_HANDLE;
+        VkDeviceMemory m_VkDepthImageMemory = VK_NULL_HANDLE;
+        VkImageView m_VkDepthImageView = VK_NULL_HANDLE;
+        VkFramebuffer m_VkSceneFramebuffer = VK_NULL_HANDLE;
+        VkRenderPass m_VkSceneRenderPass = VK_NULL_HANDLE; // compatible with the swapchain pass --> scene pipelines work in both
+        VkRenderPass m_VkFirstPhasePass = VK_NULL_HANDLE, m_VkSecondPhasePass = VK_NULL_HANDLE; // same, split for occlusion culling
+
+        VkSampler m_VkSampler; // owned by the SamplerCache
+        VkDescriptorSetLayout m_VkDescriptorSetLayout = VK_NULL_HANDLE;
+        VkDescriptorPool m_VkDescriptorPool = VK_NULL_HANDLE;
+        VkDescriptorSet m_VkDescriptorSet = VK_NULL_HANDLE;
+        VkPipelineLayout m_VkUpscaleLayout = VK_NULL_HANDLE;
+        VkPipeline m_VkUpscalePipeline = VK_NULL_HANDLE; // owned by the PipelineCache
+
+        /* Controller */
+        float m_Scale;
+        double m_FilteredMilliseconds = 0.0;
+        uint32_t m_SamplesSinceChange = 0;
+        uint64_t m_ScaleChanges = 0;
+        float m_LowestScale;
+    public:
+        /* presentRenderPass is the swapchain pass the upscale draws in --> its attachments must have colorFormat and depthFormat.
+           occlusionPasses also creates the two phase passes and makes the depth buffer sampleable */
+        DynamicResolution(const DeviceContext& context, const DynamicResolutionConfig& config, VkFormat colorFormat, VkFormat depthFormat, bool occlusionPasses,
+            VkRenderPass presentRenderPass, VkExtent2D outputExtent, PipelineCache& pipelineCache, VkSampler sampler);
+        ~DynamicResolution();
+        DynamicResolution(const DynamicResolution&) = delete;
+        DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+        /* Feeds the controller --> may change GetRenderExtent for frames recorded afterwards */
+        void ReportGpuTime(double milliseconds);
+        /* Expects the device to be idle */
+        void Resize(VkExtent2D outputExtent);
+
+        /* Scene pass over the render extent, cleared to black --> the caller sets viewport and scissor to GetRenderExtent */
+        void BeginScene(VkCommandBuffer commandBuffer, VkExtent2D renderExtent);
+        void EndScene(VkCommandBuffer commandBuffer);
+        /* The barriers of BeginScene and EndScene alone --> around scene passes recorded elsewhere, like the OcclusionCuller's */
+        void AcquireScene(VkCommandBuffer commandBuffer);
+        void ReleaseScene(VkCommandBuffer commandBuffer);
+        /* Inside the swapchain render pass --> renderExtent is what BeginScene got */
+        void RecordUpscale(VkCommandBuffer commandBuffer, VkExtent2D renderExtent);
+
+        VkExtent2D GetRenderExtent() const;
+        inline float GetScale() const { return m_Scale; }
+        inline VkRenderPass GetSceneRenderPass() const { return m_VkSceneRenderPass; }
+        inline VkRenderPass GetFirstPhasePass() const { return m_VkFirstPhasePass; }
+        inline VkRenderPass GetSecondPhasePass() const { return m_VkSecondPhasePass; }
+        inline VkFramebuffer GetSceneFramebuffer() const { return m_VkSceneFramebuffer; }
+        inline VkImageView GetDepthImageView() const { return m_VkDepthImageView; }
+        inline VkExtent2D GetTargetExtent() const { return m_TargetExtent; }
+        static bool IsFormatSupported(VkPhysicalDevice physicalDevice, VkFormat format);
+    private:
+        void CreateSceneRenderPasses();
+        void CreateSceneTarget();
+        void DestroySceneTarget();
+        void CreateUpscalePipeline(VkRenderPass presentRenderPass, PipelineCache& pipelineCache);
+    };
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "FrameArena.h"
+
+namespace VulkanPractice {
+    FrameArena::FrameArena(size_t blockSize)
+        : m_BlockSize(blockSize)
+    {
+    }
+
+    void* FrameArena::Allocate(size_t size, size_t alignment) {
+        while (true) {
+            if (m_Block < m_Blocks.size()) {
+                Block& block = m_Blocks[m_Block];
+                uintptr_t base = reinterpret_cast<uintptr_t>(block.Data.get());
+                size_t offset = static_cast<size_t>((base + m_Offset + alignment - 1) / alignment * alignment - base);
+                if (offset + size <= block.Size) {
+                    m_Used += offset - m_Offset + size;
+                    m_PeakUsed = std::max(m_PeakUsed, m_Used);
+                    m_Offset = offset + size;
+                    return block.Data.get() + offset;
+                }
+                /* The rest of a full block is skipped --> counted so the merged block after Reset covers it */
+                m_Used += block.Size - m_Offset;
+                if (m_Block + 1 < m_Blocks.size()) {
+                    m_Block++;
+                    m_Offset = 0;
+                    continue;
+                }
+            }
+            /* Growth --> the only heap allocation, and only until Reset merges the blocks */
+            size_t blockSize = std::max(m_BlockSize, size + alignment);
+            m_Blocks.push_back({ std::make_unique<std::byte[]>(blockSize), blockSize });
+            m_Block = m_Blocks.size() - 1;
+            m_Offset = 0;
+        }
+    }
+
+    void FrameArena::Reset() {
+        if (m_Blocks.size() > 1) {
+            size_t blockSize = std::max(m_BlockSize, m_PeakUsed);
+            m_Blocks.clear();
+            m_Blocks.push_back({ std::make_unique<std::byte[]>(blockSize), blockSize });
+        }
+        m_Block = 0;
+        m_Offset = 0;
+        m_Used = 0;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+/* This Header holds the per frame linear allocator --> transient CPU allocations of one frame in flight, released all at once when its fence signals */
+#include "pch.h"
+#include <cstddef>
+#include <new>
+
+namespace VulkanPractice {
+    class FrameArena {
+    private:
+        struct Block {
+            std::unique_ptr<std::byte[]> Data;
+            size_t Size = 0;
+        };
+        size_t m_BlockSize;
+        std::vector<Block> m_Blocks; // kept across resets --> no heap allocation once grown
+        size_t m_Block = 0, m_Offset = 0; // bump position inside m_Blocks[m_Block]
+        size_t m_Used = 0, m_PeakUsed = 0; // bytes handed out, alignment padding included
+    public:
+        explicit FrameArena(size_t blockSize = 64 * 1024);
+        FrameArena(FrameArena&&) = default;
+        FrameArena& operator=(FrameArena&&) = default;
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        /* Never returns null --> grows by a block when the current one is full */
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+        /* Only once nothing allocated since the last reset is in use --> a frame that needed several blocks gets one block that size instead */
+        void Reset();
+
+        inline size_t GetUsedBytes() const { return m_Used; }
+        inline size_t GetPeakBytes() const { return m_PeakUsed; }
+        inline size_t GetBlockCount() const { return m_Blocks.size(); }
+    };
+
+    /* Standard allocator over a FrameArena --> deallocate is a no-op, containers must not outlive the frame they were filled in */
+    template<typename T>
+    class FrameAllocator {
+    public:
+        using value_type = T;
+        FrameArena* Arena;
+
+        explicit FrameAllocator(FrameArena& arena) noexcept : Arena(&arena) {}
+        template<typename U>
+        FrameAllocator(const FrameAllocator<U>& other) noexcept : Arena(other.Arena) {}
+
+        T* allocate(size_t count) {
+            if (count > std::numeric_limits<size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+            return static_cast<T*>(Arena->Allocate(count * sizeof(T), alignof(T)));
+        }
+        void deallocate(T*, size_t) noexcept {}
+
+        template<typename U>
+        bool operator==(const FrameAllocator<U>& other) const noexcept { return Arena == other.Arena; }
+        template<typename U>
+        bool operator!=(const FrameAllocator<U>& other) const noexcept { return Arena != other.Arena; }
+    };
+
+    template<typename T>
+    using FrameVector = std::vector<T, FrameAllocator<T>>;
+    using FrameString = std::basic_string<char, std::char_traits<char>, FrameAllocator<char>>;
+}
\ No newline at end of file
@@ -0,0 +1,332 @@
+#include "FrameCapture.h"
+#include "VulkanUtils.h"
+#include "Profiler.h"
+#include "Log.h"
+#include <filesystem>
+#include <fstream>
+#include <cstdio>
+
+namespace VulkanPractice {
+    namespace {
+        constexpr VkDeviceSize s_BytesPerPixel = 4; // every supported format is 8 bit RGBA or BGRA
+
+        uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+            static const auto table = [] {
+                std::array<uint32_t, 256> values{};
+                for (uint32_t i = 0; i < 256; i++) {
+                    uint32_t value = i;
+                    for (int bit = 0; bit < 8; bit++) value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+                    values[i] = value;
+                }
+                return values;
+            }();
+            crc = ~crc;
+            for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+            return ~crc;
+        }
+        void AppendBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+            out.push_back(static_cast<uint8_t>(value >> 24));
+            out.push_back(static_cast<uint8_t>(value >> 16));
+            out.push_back(static_cast<uint8_t>(value >> 8));
+            out.push_back(static_cast<uint8_t>(value));
+        }
+        void AppendChunk(std::vector<uint8_t>& out, const char type[4], const std::vector<uint8_t>& data) {
+            AppendBigEndian(out, static_cast<uint32_t>(data.size()));
+            size_t typeBegin = out.size();
+            out.insert(out.end(), type, type + 4);
+            out.insert(out.end(), data.begin(), data.end());
+            AppendBigEndian(out, Crc32(out.data() + typeBegin, out.size() - typeBegin));
+        }
+        /* zlib stream made of stored deflate blocks --> no compression dependency, the cost is file size */
+        std::vector<uint8_t> StoreZlib(const std::vector<uint8_t>& data) {
+            constexpr size_t maxBlock = 65535;
+            std::vector<uint8_t> out;
+            out.reserve(data.size() + data.size() / maxBlock * 5 + 16);
+            out.push_back(0x78);
+            out.push_back(0x01);
+            size_t offset = 0;
+            do {
+                size_t length = std::min(maxBlock, data.size() - offset);
+                bool last = offset + length == data.size();
+                out.push_back(last ? 1 : 0);
+                out.push_back(static_cast<uint8_t>(length));
+                out.push_back(static_cast<uint8_t>(length >> 8));
+                out.push_back(static_cast<uint8_t>(~length));
+                out.push_back(static_cast<uint8_t>(~length >> 8));
+                out.insert(out.end(), data.begin() + offset, data.begin() + offset + length);
+                offset += length;
+            } while (offset < data.size());
+            uint32_t a = 1, b = 0;
+            for (uint8_t byte : data) {
+                a = (a + byte) % 65521;
+                b = (b + a) % 65521;
+            }
+            AppendBigEndian(out, (b << 16) | a);
+            return out;
+        }
+        bool WritePng(const std::string& path, VkExtent2D extent, const uint8_t* pixels, bool bgra) {
+            /* Filter byte per row, alpha forced opaque --> the swapchain alpha is whatever the blend left behind */
+            size_t rowBytes = static_cast<size_t>(extent.width) * s_BytesPerPixel;
+            std::vector<uint8_t> rows(static_cast<size_t>(extent.height) * (rowBytes + 1));
+            for (uint32_t y = 0; y < extent.height; y++) {
+                uint8_t* row = rows.data() + y * (rowBytes + 1);
+                const uint8_t* source = pixels + y * rowBytes;
+                row[0] = 0;
+                for (uint32_t x = 0; x < extent.width; x++) {
+                    const uint8_t* texel = source + x * s_BytesPerPixel;
+                    uint8_t* target = row + 1 + x * s_BytesPerPixel;
+                    target[0] = bgra ? texel[2] : texel[0];
+                    target[1] = texel[1];
+                    target[2] = bgra ? texel[0] : texel[2];
+                    target[3] = 0xFF;
+                }
+            }
+            std::vector<uint8_t> header;
+            AppendBigEndian(header, extent.width);
+            AppendBigEndian(header, extent.height);
+            header.insert(header.end(), { 8, 6, 0, 0, 0 }); // 8 bit, RGBA, deflate, no filter, no interlace
+
+            static const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+            std::vector<uint8_t> file(signature, signature + sizeof(signature));
+            AppendChunk(file, "IHDR", header);
+            AppendChunk(file, "IDAT", StoreZlib(rows));
+            AppendChunk(file, "IEND", {});
+            std::ofstream out(path, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+            return static_cast<bool>(out);
+        }
+        bool WriteRaw(const std::string& path, const uint8_t* pixels, size_t size) {
+            std::ofstream out(path, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(pixels), static_cast<std::streamsize>(size));
+            return static_cast<bool>(out);
+        }
+    }
+
+    FrameCapture::FrameCapture(const DeviceContext& context, const FrameCaptureConfig& config, VkFormat format, VkExtent2D extent, uint32_t framesInFlight)
+        : m_DeviceContext(context), m_Config(config), m_Format(format)
+    {
+        if (!IsFormatSupported(format)) {
+            throw std::runtime_error("Swapchain format is not supported by frame capture!");
+        }
+        std::error_code error;
+        std::filesystem::create_directories(m_Config.Directory, error);
+        if (error) {
+            throw std::runtime_error("Failed to create frame capture directory!");
+        }
+        m_Config.Interval = std::max(1U, m_Config.Interval);
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT; // re-recorded every captured frame
+        poolInfo.queueFamilyIndex = context.GraphicsQueueFamily;
+        if (vkCreateCommandPool(m_DeviceContext.Device, &poolInfo, m_DeviceContext.Allocator, &m_VkCommandPool) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create capture command pool!");
+        }
+        m_CommandBuffers.resize(framesInFlight);
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = m_VkCommandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = framesInFlight;
+        if (vkAllocateCommandBuffers(m_DeviceContext.Device, &allocInfo, m_CommandBuffers.data()) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate capture command buffers!");
+        }
+        m_InFlight.resize(framesInFlight, nullptr);
+
+        /* Allocated up front at the current size --> only a resize to something larger allocates again */
+        VkDeviceSize size = static_cast<VkDeviceSize>(extent.width) * extent.height * s_BytesPerPixel;
+        for (uint32_t i = 0; i < framesInFlight + m_Config.ExtraBuffers; i++) {
+            m_Readbacks.push_back(std::make_unique<Readback>());
+            CreateReadback(*m_Readbacks.back(), size);
+            m_Free.push_back(m_Readbacks.back().get());
+        }
+        uint32_t workerCount = std::max(1U, m_Config.WorkerCount);
+        for (uint32_t i = 0; i < workerCount; i++) {
+            m_Workers.emplace_back(&FrameCapture::WorkerMain, this);
+        }
+    }
+    FrameCapture::~FrameCapture() {
+        for (uint32_t i = 0; i < m_InFlight.size(); i++) Collect(i);
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true; // workers finish the queue first
+        }
+        m_Condition.notify_all();
+        for (auto& worker : m_Workers) worker.join();
+#ifdef INCLUDE_DEBUG_INFO
+        uint64_t calls = m_CapturedCount + m_DroppedCount;
+        LOG_INFO("Frame capture: {} written, {} failed, {} dropped --> {:.3f} ms render thread per frame",
+            m_WrittenCount, m_FailedCount, m_DroppedCount, calls > 0 ? m_RenderThreadMilliseconds / static_cast<double>(calls) : 0.0);
+#endif
+        for (auto& readback : m_Readbacks) DestroyReadback(*readback);
+        vkDestroyCommandPool(m_DeviceContext.Device, m_VkCommandPool, m_DeviceContext.Allocator); // automatically frees command buffers
+    }
+
+    void FrameCapture::Collect(uint32_t frameIndex) {
+        Readback* readback = m_InFlight[frameIndex];
+        if (readback == nullptr) return;
+        Timer timer;
+        m_InFlight[frameIndex] = nullptr;
+        if (readback->NeedsInvalidate) {
+            VkMappedMemoryRange range{};
+            range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+            range.memory = readback->Memory;
+            range.offset = 0;
+            range.size = VK_WHOLE_SIZE;
+            vkInvalidateMappedMemoryRanges(m_DeviceContext.Device, 1, &range);
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Jobs.push_back(readback);
+        }
+        m_Condition.notify_one();
+        m_RenderThreadMilliseconds += timer.GetElapsedMilliseconds();
+    }
+    VkCommandBuffer FrameCapture::Record(uint32_t frameIndex, uint64_t frameNumber, VkImage image, VkExtent2D extent) {
+        if (frameNumber % m_Config.Interval != 0) return VK_NULL_HANDLE;
+        Timer timer;
+        Readback* readback = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (!m_Free.empty()) {
+                readback = m_Free.back();
+                m_Free.pop_back();
+            }
+        }
+        if (readback == nullptr) {
+            /* Workers are behind --> losing a frame beats stalling the render thread */
+            m_DroppedCount++;
+            m_RenderThreadMilliseconds += timer.GetElapsedMilliseconds();
+            return VK_NULL_HANDLE;
+        }
+        VkDeviceSize size = static_cast<VkDeviceSize>(extent.width) * extent.height * s_BytesPerPixel;
+        if (readback->Size < size) {
+            DestroyReadback(*readback);
+            CreateReadback(*readback, size);
+        }
+        readback->FrameNumber = frameNumber;
+        readback->Extent = extent;
+
+        const DeviceDispatch& dispatch = *m_DeviceContext.Dispatch;
+        VkCommandBuffer commandBuffer = m_CommandBuffers[frameIndex];
+        dispatch.ResetCommandBuffer(commandBuffer, 0);
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (dispatch.BeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to begin recording capture command buffer!");
+        }
+        /* Render pass left the image in PRESENT_SRC_KHR --> transfer source for the copy, then back for present */
+        VkImageMemoryBarrier toTransfer{};
+        toTransfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        toTransfer.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        toTransfer.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        toTransfer.oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        toTransfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        toTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        toTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        toTransfer.image = image;
+        toTransfer.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+        dispatch.CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &toTransfer);
+
+        VkBufferImageCopy region{};
+        region.bufferOffset = 0;
+        region.bufferRowLength = 0; // tightly packed
+        region.bufferImageHeight = 0;
+        region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+        region.imageOffset = { 0, 0, 0 };
+        region.imageExtent = { extent.width, extent.height, 1 };
+        dispatch.CmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readback->Buffer, 1, &region);
+
+        VkImageMemoryBarrier toPresent = toTransfer;
+        toPresent.srcAccessMask = 0; // the copy only read it
+        toPresent.dstAccessMask = 0;
+        toPresent.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        toPresent.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        VkBufferMemoryBarrier toHost{};
+        toHost.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        toHost.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        toHost.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        toHost.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        toHost.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        toHost.buffer = readback->Buffer;
+        toHost.offset = 0;
+        toHost.size = VK_WHOLE_SIZE;
+        dispatch.CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &toHost, 1, &toPresent);
+        if (dispatch.EndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to record capture command buffer!");
+        }
+        m_InFlight[frameIndex] = readback;
+        m_CapturedCount++;
+        m_RenderThreadMilliseconds += timer.GetElapsedMilliseconds();
+        return commandBuffer;
+    }
+
+    bool FrameCapture::IsFormatSupported(VkFormat format) {
+        switch (format) {
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_SRGB:
+            case VK_FORMAT_B8G8R8A8_UNORM:
+            case VK_FORMAT_B8G8R8A8_SRGB:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void FrameCapture::CreateReadback(Readback& readback, VkDeviceSize size) {
+        /* Host cached first --> the workers read every byte, uncached reads are several times slower */
+        VkMemoryPropertyFlags properties = VulkanUtils::CreateHostVisibleBuffer(
+            m_DeviceContext, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+            readback.Buffer, readback.Memory
+        );
+        readback.NeedsInvalidate = (properties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) == 0; // coherence is not guaranteed on cached types
+        void* mapped;
+        if (vkMapMemory(m_DeviceContext.Device, readback.Memory, 0, VK_WHOLE_SIZE, 0, &mapped) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to map capture readback buffer!");
+        }
+        readback.Mapped = static_cast<uint8_t*>(mapped);
+        readback.Size = size;
+    }
+    void FrameCapture::DestroyReadback(Readback& readback) {
+        if (readback.Buffer == VK_NULL_HANDLE) return;
+        vkUnmapMemory(m_DeviceContext.Device, readback.Memory);
+        vkDestroyBuffer(m_DeviceContext.Device, readback.Buffer, m_DeviceContext.Allocator);
+        vkFreeMemory(m_DeviceContext.Device, readback.Memory, m_DeviceContext.Allocator);
+        readback = Readback{};
+    }
+
+    void FrameCapture::WorkerMain() {
+        while (true) {
+            Readback* readback;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Condition.wait(lock, [this] { return m_Stopping || !m_Jobs.empty(); });
+                if (m_Jobs.empty()) return; // stopping and drained
+                readback = m_Jobs.front();
+                m_Jobs.pop_front();
+            }
+            bool written = Write(*readback);
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            (written ? m_WrittenCount : m_FailedCount)++;
+            m_Free.push_back(readback);
+        }
+    }
+    bool FrameCapture::Write(const Readback& readback) const {
+        char name[64];
+        bool png = m_Config.Format == FrameCaptureFormat::Png;
+        if (png) {
+            std::snprintf(name, sizeof(name), "frame_%06llu.png", static_cast<unsigned long long>(readback.FrameNumber));
+        } else {
+            std::snprintf(name, sizeof(name), "frame_%06llu_%ux%u.raw", static_cast<unsigned long long>(readback.FrameNumber), readback.Extent.width, readback.Extent.height);
+        }
+        std::string path = (std::filesystem::path(m_Config.Directory) / name).string();
+        bool bgra = m_Format == VK_FORMAT_B8G8R8A8_UNORM || m_Format == VK_FORMAT_B8G8R8A8_SRGB;
+        bool written = png ? WritePng(path, readback.Extent, readback.Mapped, bgra)
+            : WriteRaw(path, readback.Mapped, static_cast<size_t>(readback.Extent.width) * readback.Extent.height * s_BytesPerPixel);
+#ifdef INCLUDE_DEBUG_INFO
+        if (!written) LOG_ERROR("Failed to write captured frame {}", path);
+#endif
+        return written;
+    }
+}
\ No newline at end of file
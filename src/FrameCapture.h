@@ -0,0 +1,79 @@
+#pragma once
+/* This Header handles frame capture: swapchain images are copied into a ring of host readable buffers and written to disk by worker threads once the GPU is done --> the render thread never waits */
+#include "pch.h"
+#include "DeviceContext.h"
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+
+namespace VulkanPractice {
+    enum class FrameCaptureFormat : uint8_t {
+        Png, // 8 bit RGBA, stored without compression so encoding stays cheap
+        Raw // tightly packed rows in the swapchain format, one file per frame
+    };
+
+    struct FrameCaptureConfig {
+        std::string Directory; // created if missing
+        FrameCaptureFormat Format = FrameCaptureFormat::Png;
+        uint32_t WorkerCount = 2;
+        uint32_t ExtraBuffers = 2; // beyond one per frame in flight --> how far the workers may fall behind before frames are dropped
+        uint32_t Interval = 1; // capture every Nth frame
+    };
+
+    class FrameCapture {
+    private:
+        struct Readback {
+            VkBuffer Buffer = VK_NULL_HANDLE;
+            VkDeviceMemory Memory = VK_NULL_HANDLE;
+            uint8_t* Mapped = nullptr; // mapped once for the lifetime of the buffer
+            VkDeviceSize Size = 0;
+            bool NeedsInvalidate = false; // host cached memory that is not coherent
+            uint64_t FrameNumber = 0;
+            VkExtent2D Extent{};
+        };
+
+        DeviceContext m_DeviceContext;
+        FrameCaptureConfig m_Config;
+        VkFormat m_Format;
+        VkCommandPool m_VkCommandPool = VK_NULL_HANDLE;
+
+        /* Render thread only */
+        std::vector<std::unique_ptr<Readback>> m_Readbacks; // owns every buffer
+        std::vector<VkCommandBuffer> m_CommandBuffers; // one per frame in flight
+        std::vector<Readback*> m_InFlight; // per frame in flight, copied but not yet known complete
+        uint64_t m_CapturedCount = 0, m_DroppedCount = 0;
+        double m_RenderThreadMilliseconds = 0.0;
+
+        /* Shared with workers */
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        std::vector<Readback*> m_Free;
+        std::deque<Readback*> m_Jobs;
+        bool m_Stopping = false;
+        uint64_t m_WrittenCount = 0, m_FailedCount = 0;
+        std::vector<std::thread> m_Workers;
+    public:
+        /* format is the swapchain format, see IsFormatSupported --> the swapchain needs VK_IMAGE_USAGE_TRANSFER_SRC_BIT */
+        FrameCapture(const DeviceContext& context, const FrameCaptureConfig& config, VkFormat format, VkExtent2D extent, uint32_t framesInFlight);
+        /* Expects the device to be idle --> outstanding copies are handed to the workers and written before returning */
+        ~FrameCapture();
+        FrameCapture(const FrameCapture&) = delete;
+        FrameCapture& operator=(const FrameCapture&) = delete;
+
+        /* Call after the frame's fence wait --> what this slot copied last time is complete and goes to the workers */
+        void Collect(uint32_t frameIndex);
+        /* Copy of image for the frame's submit, after its draw command buffer --> VK_NULL_HANDLE when this frame is skipped or dropped.
+           image must be in PRESENT_SRC_KHR layout and is left there */
+        VkCommandBuffer Record(uint32_t frameIndex, uint64_t frameNumber, VkImage image, VkExtent2D extent);
+
+        inline uint64_t GetCapturedCount() const { return m_CapturedCount; }
+        inline uint64_t GetDroppedCount() const { return m_DroppedCount; }
+        static bool IsFormatSupported(VkFormat format);
+    private:
+        void CreateReadback(Readback& readback, VkDeviceSize size);
+        void DestroyReadback(Readback& readback);
+        void WorkerMain();
+        bool Write(const Readback& readback) const;
+    };
+}
\ No newline at end of file
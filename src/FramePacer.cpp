@@ -0,0 +1,118 @@
+#include "FramePacer.h"
+#include "Log.h"
+
+namespace VulkanPractice {
+    FramePacer::FramePacer(const FramePacerConfig& config)
+        : m_Config(config)
+    {
+    }
+
+    void FramePacer::SetFocused(bool focused) {
+        if (m_Activity == WindowActivity::Iconified) return; // focus changes of a minimized window do not matter until it is restored
+        Account();
+        m_Activity = focused ? WindowActivity::Focused : WindowActivity::Unfocused;
+        m_Dirty = true;
+    }
+    void FramePacer::SetIconified(bool iconified) {
+        Account();
+        m_Activity = iconified ? WindowActivity::Iconified : WindowActivity::Focused; // restoring usually refocuses, the focus callback follows if not
+        m_Dirty = true;
+    }
+
+    void FramePacer::FrameDrawn(uint64_t contentHash, bool presented) {
+        Account();
+        if (!presented) {
+            m_Dirty = true;
+            return;
+        }
+        m_Stats[static_cast<size_t>(m_Activity)].Frames++;
+        /* Different from the last frame --> what it showed may feed into the next one, draw until two in a row agree */
+        m_Settling = contentHash != m_LastHash;
+        m_LastHash = contentHash;
+    }
+    void FramePacer::ReportGpuTime(double milliseconds) {
+        ActivityStats& stats = m_Stats[static_cast<size_t>(m_Activity)];
+        stats.GpuMilliseconds += milliseconds;
+        stats.GpuSamples++;
+    }
+
+    void FramePacer::Report() {
+        Account();
+        for (size_t activity = 0; activity < m_Stats.size(); activity++) {
+            const ActivityStats& stats = m_Stats[activity];
+            if (stats.WallMilliseconds <= 0.0) continue;
+            double busy = std::max(0.0, stats.WallMilliseconds - stats.WaitMilliseconds) / stats.WallMilliseconds * 100.0;
+            double fps = static_cast<double>(stats.Frames) * 1000.0 / stats.WallMilliseconds;
+            if (stats.GpuSamples > 0) {
+                /* Not every frame is read back --> the sampled average stands in for the rest */
+                double gpu = stats.GpuMilliseconds / static_cast<double>(stats.GpuSamples) * static_cast<double>(stats.Frames) / stats.WallMilliseconds * 100.0;
+                LOG_INFO("Pacing {}: {:.1f} s, {:.1f} fps, render thread {:.1f}% busy, GPU {:.1f}% busy", GetActivityName(static_cast<WindowActivity>(activity)),
+                    stats.WallMilliseconds / 1000.0, fps, busy, std::min(gpu, 100.0));
+            } else {
+                LOG_INFO("Pacing {}: {:.1f} s, {:.1f} fps, render thread {:.1f}% busy, GPU not measured", GetActivityName(static_cast<WindowActivity>(activity)),
+                    stats.WallMilliseconds / 1000.0, fps, busy);
+            }
+        }
+    }
+    const char* FramePacer::GetActivityName(WindowActivity activity) {
+        switch (activity) {
+        case WindowActivity::Focused: return "focused";
+        case WindowActivity::Unfocused: return "unfocused";
+        case WindowActivity::Iconified: return "iconified";
+        default: return "unknown";
+        }
+    }
+
+    bool FramePacer::IsFrameDue(bool pendingWork, double& timeout) {
+        glfwPollEvents(); // callbacks mark the frame dirty or change the activity
+        Account();
+        double now = m_AccountedMilliseconds;
+#ifdef INCLUDE_DEBUG_INFO
+        if (m_Config.ReportInterval > 0.0 && now - m_LastReportMilliseconds >= m_Config.ReportInterval * 1000.0) {
+            m_LastReportMilliseconds = now;
+            Report();
+        }
+#endif
+        /* Nothing is visible --> only wake up to notice restoring or closing */
+        if (m_Activity == WindowActivity::Iconified) {
+            timeout = m_Config.IconifiedWakeInterval;
+            return false;
+        }
+        bool wanted = !m_Config.OnDemand || m_Dirty || m_Settling;
+        double frameRate = 0.0;
+        if (!wanted && pendingWork) {
+            wanted = true;
+            frameRate = m_Config.PendingFrameRate;
+        }
+        if (!wanted) {
+            timeout = -1.0;
+            return false;
+        }
+        if (m_Activity == WindowActivity::Unfocused && m_Config.UnfocusedFrameRate > 0.0) {
+            frameRate = frameRate > 0.0 ? std::min(frameRate, m_Config.UnfocusedFrameRate) : m_Config.UnfocusedFrameRate;
+        }
+        double next = m_LastFrameMilliseconds + (frameRate > 0.0 ? 1000.0 / frameRate : 0.0);
+        if (now < next) {
+            timeout = (next - now) / 1000.0;
+            return false;
+        }
+        /* Events arriving while the frame draws mark the next one */
+        m_LastFrameMilliseconds = now;
+        m_Dirty = false;
+        return true;
+    }
+    void FramePacer::Wait(double timeout) {
+        m_Waiting = true;
+        if (timeout < 0.0) glfwWaitEvents();
+        else glfwWaitEventsTimeout(timeout);
+        Account(); // callbacks during the wait account up to their own change
+        m_Waiting = false;
+    }
+    void FramePacer::Account() {
+        double now = m_Clock.GetElapsedMilliseconds();
+        ActivityStats& stats = m_Stats[static_cast<size_t>(m_Activity)];
+        stats.WallMilliseconds += now - m_AccountedMilliseconds;
+        if (m_Waiting) stats.WaitMilliseconds += now - m_AccountedMilliseconds;
+        m_AccountedMilliseconds = now;
+    }
+}
\ No newline at end of file
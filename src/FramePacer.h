@@ -0,0 +1,73 @@
+#pragma once
+/* This Header decides when the main loop draws --> on demand when the frame is dirty, throttled while the window is unfocused or iconified, with utilization per window state */
+#include "pch.h"
+#include "Window.h"
+#include "Profiler.h"
+#include <array>
+
+namespace VulkanPractice {
+    struct FramePacerConfig {
+        bool OnDemand = true; // draw only when something marked the frame dirty, false --> draw every iteration
+        double UnfocusedFrameRate = 10.0; // cap while another window has focus, 0 --> uncapped
+        double PendingFrameRate = 20.0; // cap while background work (compiles, streaming) can still change the frame
+        double IconifiedWakeInterval = 0.5; // seconds between wake ups while iconified --> nothing is drawn
+        double ReportInterval = 10.0; // seconds between utilization logs in debug builds, 0 disables
+    };
+
+    enum class WindowActivity : uint8_t {
+        Focused, Unfocused, Iconified, Count
+    };
+
+    class FramePacer {
+    private:
+        struct ActivityStats {
+            double WallMilliseconds = 0.0;
+            double WaitMilliseconds = 0.0; // blocked in glfwWaitEventsTimeout --> the render thread's idle time
+            double GpuMilliseconds = 0.0;
+            uint64_t Frames = 0, GpuSamples = 0;
+        };
+
+        FramePacerConfig m_Config;
+        WindowActivity m_Activity = WindowActivity::Focused;
+        bool m_Dirty = true; // the first frame is always drawn
+        bool m_Settling = false; // the last frame differed from the one before --> counters it showed catch up on the next
+        bool m_Waiting = false;
+        uint64_t m_LastHash = 0;
+
+        Timer m_Clock; // every time below is relative to construction
+        double m_LastFrameMilliseconds = -1.0e9; // start of the last drawn frame
+        double m_AccountedMilliseconds = 0.0, m_LastReportMilliseconds = 0.0;
+        std::array<ActivityStats, static_cast<size_t>(WindowActivity::Count)> m_Stats{};
+    public:
+        explicit FramePacer(const FramePacerConfig& config = FramePacerConfig());
+
+        /* Input, resize, animation or reloads --> the next WaitForFrame returns as soon as the rate cap allows */
+        inline void MarkDirty() { m_Dirty = true; }
+        void SetFocused(bool focused);
+        void SetIconified(bool iconified);
+
+        /* Pumps window events until a frame is due --> false once the window should close. pendingWork is asked again after every wake up */
+        template<typename PendingWork>
+        bool WaitForFrame(GLFWwindow* window, PendingWork&& pendingWork) {
+            while (!glfwWindowShouldClose(window)) {
+                double timeout;
+                if (IsFrameDue(pendingWork(), timeout)) return true;
+                Wait(timeout);
+            }
+            return false;
+        }
+        /* contentHash identifies what was drawn --> a change keeps the loop drawing until it settles. presented is false for frames dropped on swapchain recreation */
+        void FrameDrawn(uint64_t contentHash, bool presented);
+        void ReportGpuTime(double milliseconds);
+
+        /* Logs frame rate, render thread and GPU utilization per window activity since construction */
+        void Report();
+        inline WindowActivity GetActivity() const { return m_Activity; }
+        static const char* GetActivityName(WindowActivity activity);
+    private:
+        /* Polls events without blocking --> timeout is how long to block before asking again, negative for until the next event */
+        bool IsFrameDue(bool pendingWork, double& timeout);
+        void Wait(double timeout);
+        void Account();
+    };
+}
\ No newline at end of file
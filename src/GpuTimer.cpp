@@ -0,0 +1,52 @@
+#include "GpuTimer.h"
+
+namespace VulkanPractice {
+    GpuTimer::GpuTimer(const DeviceContext& context, uint32_t slotCount, uint32_t timestampValidBits)
+        : m_DeviceContext(context)
+    {
+        if (!IsSupported(timestampValidBits)) {
+            throw std::runtime_error("Queue does not support timestamp queries!");
+        }
+        m_TicksToMilliseconds = static_cast<double>(context.Limits.timestampPeriod) * 1e-6; // period is nanoseconds per tick
+        m_ValidMask = timestampValidBits >= 64 ? UINT64_MAX : (1ull << timestampValidBits) - 1;
+        CreateQueryPool(slotCount);
+    }
+    GpuTimer::~GpuTimer() {
+        vkDestroyQueryPool(m_DeviceContext.Device, m_VkQueryPool, m_DeviceContext.Allocator);
+    }
+
+    void GpuTimer::Begin(VkCommandBuffer commandBuffer, uint32_t slot) {
+        m_DeviceContext.Dispatch->CmdResetQueryPool(commandBuffer, m_VkQueryPool, slot * 2, 2);
+        m_DeviceContext.Dispatch->CmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_VkQueryPool, slot * 2);
+    }
+    void GpuTimer::End(VkCommandBuffer commandBuffer, uint32_t slot) {
+        m_DeviceContext.Dispatch->CmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_VkQueryPool, slot * 2 + 1);
+        m_Written[slot] = true;
+    }
+    bool GpuTimer::Read(uint32_t slot, double& milliseconds) {
+        if (slot >= m_SlotCount || !m_Written[slot]) return false;
+        uint64_t timestamps[2];
+        VkResult result = m_DeviceContext.Dispatch->GetQueryPoolResults(m_DeviceContext.Device, m_VkQueryPool, slot * 2, 2,
+            sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+        if (result != VK_SUCCESS) return false; // VK_NOT_READY
+        uint64_t ticks = ((timestamps[1] & m_ValidMask) - (timestamps[0] & m_ValidMask)) & m_ValidMask; // survives one wrap
+        milliseconds = static_cast<double>(ticks) * m_TicksToMilliseconds;
+        return true;
+    }
+    void GpuTimer::Resize(uint32_t slotCount) {
+        vkDestroyQueryPool(m_DeviceContext.Device, m_VkQueryPool, m_DeviceContext.Allocator);
+        CreateQueryPool(slotCount);
+    }
+
+    void GpuTimer::CreateQueryPool(uint32_t slotCount) {
+        VkQueryPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        poolInfo.queryCount = slotCount * 2;
+        if (vkCreateQueryPool(m_DeviceContext.Device, &poolInfo, m_DeviceContext.Allocator, &m_VkQueryPool) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create timestamp query pool!");
+        }
+        m_SlotCount = slotCount;
+        m_Written.assign(slotCount, false);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+/* This Header measures GPU time per command buffer with timestamp queries --> two queries per slot, read back without waiting */
+#include "pch.h"
+#include "DeviceContext.h"
+
+namespace VulkanPractice {
+    class GpuTimer {
+    private:
+        DeviceContext m_DeviceContext;
+        VkQueryPool m_VkQueryPool = VK_NULL_HANDLE;
+        uint32_t m_SlotCount = 0;
+        std::vector<bool> m_Written; // slot has been recorded since the last resize --> its queries were reset at least once
+        double m_TicksToMilliseconds;
+        uint64_t m_ValidMask;
+    public:
+        /* timestampValidBits of the queue the command buffers go to --> 0 means timestamps are unsupported, see IsSupported */
+        GpuTimer(const DeviceContext& context, uint32_t slotCount, uint32_t timestampValidBits);
+        ~GpuTimer();
+        GpuTimer(const GpuTimer&) = delete;
+        GpuTimer& operator=(const GpuTimer&) = delete;
+
+        /* Outside a render pass --> Begin at the start of the command buffer, End after its last command */
+        void Begin(VkCommandBuffer commandBuffer, uint32_t slot);
+        void End(VkCommandBuffer commandBuffer, uint32_t slot);
+        /* After the submission that used slot has completed --> false while the result is not available */
+        bool Read(uint32_t slot, double& milliseconds);
+        /* Expects the device to be idle */
+        void Resize(uint32_t slotCount);
+
+        static bool IsSupported(uint32_t timestampValidBits) { return timestampValidBits > 0; }
+    private:
+        void CreateQueryPool(uint32_t slotCount);
+    };
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+/* This Header holds the hashing helpers shared by the caches */
+#include "pch.h"
+#include <type_traits>
+
+namespace VulkanPractice {
+    class Fnv1a {
+    private:
+        uint64_t m_Hash = 0xcbf29ce484222325ULL;
+    public:
+        void Add(const void* data, size_t size) {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; i++) {
+                m_Hash ^= bytes[i];
+                m_Hash *= 0x100000001b3ULL;
+            }
+        }
+        /* Fields are added one by one --> struct padding never reaches the hash */
+        template<typename T>
+        void Add(const T& value) {
+            static_assert(std::is_integral_v<T> || std::is_enum_v<T>, "Hash individual fields");
+            uint64_t widened = static_cast<uint64_t>(value);
+            Add(&widened, sizeof(widened));
+        }
+        void Add(const std::string& value) {
+            Add(static_cast<uint64_t>(value.size()));
+            Add(value.data(), value.size());
+        }
+        inline uint64_t Get() const { return m_Hash; }
+    };
+}
\ No newline at end of file
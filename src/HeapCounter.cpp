@@ -0,0 +1,42 @@
+#include "HeapCounter.h"
+#include <new>
+
+#ifdef INCLUDE_DEBUG_INFO
+/* Replaces the global allocation functions for the whole process --> pulled out of the engine library along with GetThreadAllocations.
+   Array, nothrow and sized forms of the standard library forward here; over-aligned new keeps the library version and is not counted */
+namespace {
+    thread_local uint64_t t_Allocations = 0;
+}
+void* operator new(std::size_t size) {
+    t_Allocations++;
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+#endif
+
+namespace VulkanPractice {
+    namespace HeapCounter {
+        uint64_t GetThreadAllocations() {
+#ifdef INCLUDE_DEBUG_INFO
+            return t_Allocations;
+#else
+            return 0;
+#endif
+        }
+    }
+}
\ No newline at end of file
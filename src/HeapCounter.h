@@ -0,0 +1,10 @@
+#pragma once
+/* This Header counts global operator new calls per thread in debug builds --> steady state frames on the render thread are checked for zero heap allocations */
+#include "pch.h"
+
+namespace VulkanPractice {
+    namespace HeapCounter {
+        /* operator new calls made by the calling thread so far --> always 0 without INCLUDE_DEBUG_INFO */
+        uint64_t GetThreadAllocations();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include "HostAllocator.h"
+#include "Log.h"
+#include <new>
+#include <cstring>
+
+namespace VulkanPractice {
+    namespace {
+        /* Sits right before every returned pointer --> Free and Reallocate only get the pointer back */
+        struct AllocationHeader {
+            void* Block; // what was actually allocated, the pool block or heap allocation
+            uint64_t Size;
+            uint32_t BlockAlignment;
+            uint8_t Scope;
+            uint8_t Pool; // s_HeapPool when not pooled
+        };
+        constexpr uint8_t s_HeapPool = 0xFF;
+
+        size_t AlignUp(size_t value, size_t alignment) {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+        AllocationHeader* GetHeader(void* memory) {
+            return reinterpret_cast<AllocationHeader*>(static_cast<uint8_t*>(memory) - sizeof(AllocationHeader));
+        }
+        void UpdatePeak(std::atomic<uint64_t>& peak, uint64_t value) {
+            uint64_t current = peak.load(std::memory_order_relaxed);
+            while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+        }
+        const char* GetScopeName(uint32_t scope) {
+            switch (scope) {
+                case VK_SYSTEM_ALLOCATION_SCOPE_COMMAND: return "Command";
+                case VK_SYSTEM_ALLOCATION_SCOPE_OBJECT: return "Object";
+                case VK_SYSTEM_ALLOCATION_SCOPE_CACHE: return "Cache";
+                case VK_SYSTEM_ALLOCATION_SCOPE_DEVICE: return "Device";
+                case VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE: return "Instance";
+                default: return "Unknown";
+            }
+        }
+    }
+
+    HostAllocator::HostAllocator() {
+        for (uint32_t i = 0; i < s_PoolCount; i++) {
+            m_Pools[i].BlockSize = s_PoolAlignment << i;
+        }
+        m_Callbacks.pUserData = this;
+        m_Callbacks.pfnAllocation = AllocationCallback;
+        m_Callbacks.pfnReallocation = ReallocationCallback;
+        m_Callbacks.pfnFree = FreeCallback;
+        m_Callbacks.pfnInternalAllocation = InternalAllocationCallback;
+        m_Callbacks.pfnInternalFree = InternalFreeCallback;
+    }
+    HostAllocator::~HostAllocator() {
+        uint64_t leaked = m_Total.CurrentBytes.load();
+        if (leaked != 0) {
+            LOG_WARN("Host allocator destroyed with {} bytes still allocated --> an object outlived its allocator", leaked);
+        }
+        for (auto& pool : m_Pools) {
+            for (void* chunk : pool.Chunks) {
+                ::operator delete(chunk, std::align_val_t(s_PoolAlignment));
+            }
+        }
+    }
+
+    void* HostAllocator::Allocate(size_t size, size_t alignment, VkSystemAllocationScope scope) {
+        if (size == 0) return nullptr;
+        alignment = std::max(alignment, alignof(AllocationHeader));
+        size_t offset = AlignUp(sizeof(AllocationHeader), alignment);
+        size_t total = offset + size;
+
+        void* block = nullptr;
+        uint8_t pool = s_HeapPool;
+        size_t blockAlignment = alignment;
+        /* Command scope is the churn during recording --> small blocks come from the size classes */
+        if (scope == VK_SYSTEM_ALLOCATION_SCOPE_COMMAND && alignment <= s_PoolAlignment && total <= m_Pools[s_PoolCount - 1].BlockSize) {
+            uint32_t index = 0;
+            while (m_Pools[index].BlockSize < total) index++;
+            block = AllocateFromPool(index);
+            if (block) {
+                pool = static_cast<uint8_t>(index);
+                blockAlignment = s_PoolAlignment;
+            }
+        }
+        if (!block) {
+            block = ::operator new(total, std::align_val_t(alignment), std::nothrow);
+            if (!block) return nullptr; // the driver turns this into VK_ERROR_OUT_OF_HOST_MEMORY
+        }
+        void* memory = static_cast<uint8_t*>(block) + offset;
+        AllocationHeader* header = GetHeader(memory);
+        header->Block = block;
+        header->Size = size;
+        header->BlockAlignment = static_cast<uint32_t>(blockAlignment);
+        header->Scope = static_cast<uint8_t>(scope);
+        header->Pool = pool;
+        CountAllocation(scope, size, pool != s_HeapPool);
+        return memory;
+    }
+    void* HostAllocator::Reallocate(void* original, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+        if (!original) return Allocate(size, alignment, scope);
+        if (size == 0) {
+            Free(original);
+            return nullptr;
+        }
+        /* Always moves --> keeps the header and pool bookkeeping in one place, drivers rarely reallocate */
+        void* memory = Allocate(size, alignment, scope);
+        if (!memory) return nullptr; // original stays valid as the spec requires
+        std::memcpy(memory, original, std::min<size_t>(size, GetHeader(original)->Size));
+        Free(original);
+        m_Scopes[scope].Reallocations.fetch_add(1, std::memory_order_relaxed);
+        m_Total.Reallocations.fetch_add(1, std::memory_order_relaxed);
+        return memory;
+    }
+    void HostAllocator::Free(void* memory) {
+        if (!memory) return;
+        AllocationHeader header = *GetHeader(memory);
+        CountFree(static_cast<VkSystemAllocationScope>(header.Scope), header.Size);
+        if (header.Pool != s_HeapPool) {
+            ReturnToPool(header.Pool, header.Block);
+        } else {
+            ::operator delete(header.Block, std::align_val_t(header.BlockAlignment));
+        }
+    }
+
+    void* HostAllocator::AllocateFromPool(uint32_t index) {
+        Pool& pool = m_Pools[index];
+        std::lock_guard<std::mutex> lock(pool.Mutex);
+        if (!pool.FreeList) {
+            void* chunk = ::operator new(s_ChunkSize, std::align_val_t(s_PoolAlignment), std::nothrow);
+            if (!chunk) return nullptr;
+            pool.Chunks.push_back(chunk);
+            /* Thread the new chunk onto the free list, last block first so allocation walks forward */
+            size_t blockCount = s_ChunkSize / pool.BlockSize;
+            for (size_t i = blockCount; i-- > 0;) {
+                void* block = static_cast<uint8_t*>(chunk) + i * pool.BlockSize;
+                *static_cast<void**>(block) = pool.FreeList;
+                pool.FreeList = block;
+            }
+        }
+        void* block = pool.FreeList;
+        pool.FreeList = *static_cast<void**>(block);
+        return block;
+    }
+    void HostAllocator::ReturnToPool(uint32_t index, void* block) {
+        Pool& pool = m_Pools[index];
+        std::lock_guard<std::mutex> lock(pool.Mutex);
+        *static_cast<void**>(block) = pool.FreeList;
+        pool.FreeList = block;
+    }
+
+    void HostAllocator::CountAllocation(VkSystemAllocationScope scope, uint64_t size, bool pooled) {
+        for (Counters* counters : { &m_Scopes[scope], &m_Total }) {
+            counters->Allocations.fetch_add(1, std::memory_order_relaxed);
+            if (pooled) counters->PoolAllocations.fetch_add(1, std::memory_order_relaxed);
+            UpdatePeak(counters->PeakBytes, counters->CurrentBytes.fetch_add(size, std::memory_order_relaxed) + size);
+        }
+    }
+    void HostAllocator::CountFree(VkSystemAllocationScope scope, uint64_t size) {
+        for (Counters* counters : { &m_Scopes[scope], &m_Total }) {
+            counters->Frees.fetch_add(1, std::memory_order_relaxed);
+            counters->CurrentBytes.fetch_sub(size, std::memory_order_relaxed);
+        }
+    }
+
+    HostAllocationStats HostAllocator::Snapshot(const Counters& counters) {
+        HostAllocationStats stats;
+        stats.Allocations = counters.Allocations.load(std::memory_order_relaxed);
+        stats.Reallocations = counters.Reallocations.load(std::memory_order_relaxed);
+        stats.Frees = counters.Frees.load(std::memory_order_relaxed);
+        stats.PoolAllocations = counters.PoolAllocations.load(std::memory_order_relaxed);
+        stats.CurrentBytes = counters.CurrentBytes.load(std::memory_order_relaxed);
+        stats.PeakBytes = counters.PeakBytes.load(std::memory_order_relaxed);
+        stats.InternalBytes = counters.InternalBytes.load(std::memory_order_relaxed);
+        stats.InternalPeakBytes = counters.InternalPeakBytes.load(std::memory_order_relaxed);
+        return stats;
+    }
+    HostAllocationStats HostAllocator::GetStats(VkSystemAllocationScope scope) const {
+        return Snapshot(m_Scopes[scope]);
+    }
+    HostAllocationStats HostAllocator::GetTotalStats() const {
+        return Snapshot(m_Total);
+    }
+    void HostAllocator::Report(const std::string& title) const {
+        HostAllocationStats total = GetTotalStats();
+        LOG_INFO("{}: {} allocations, {} live bytes, {} peak bytes", title, total.Allocations, total.CurrentBytes, total.PeakBytes);
+        for (uint32_t scope = 0; scope < s_ScopeCount; scope++) {
+            HostAllocationStats stats = Snapshot(m_Scopes[scope]);
+            if (stats.Allocations == 0 && stats.InternalPeakBytes == 0) continue;
+            LOG_INFO("  {:<8} {:>8} allocs ({:>8} pooled, {:>6} reallocs) {:>10} live B {:>10} peak B {:>10} internal peak B",
+                GetScopeName(scope), stats.Allocations, stats.PoolAllocations, stats.Reallocations,
+                stats.CurrentBytes, stats.PeakBytes, stats.InternalPeakBytes);
+        }
+    }
+
+    VKAPI_ATTR void* VKAPI_CALL HostAllocator::AllocationCallback(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+        return static_cast<HostAllocator*>(userData)->Allocate(size, alignment, scope);
+    }
+    VKAPI_ATTR void* VKAPI_CALL HostAllocator::ReallocationCallback(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+        return static_cast<HostAllocator*>(userData)->Reallocate(original, size, alignment, scope);
+    }
+    VKAPI_ATTR void VKAPI_CALL HostAllocator::FreeCallback(void* userData, void* memory) {
+        static_cast<HostAllocator*>(userData)->Free(memory);
+    }
+    VKAPI_ATTR void VKAPI_CALL HostAllocator::InternalAllocationCallback(void* userData, size_t size, VkInternalAllocationType, VkSystemAllocationScope scope) {
+        auto* allocator = static_cast<HostAllocator*>(userData);
+        for (Counters* counters : { &allocator->m_Scopes[scope], &allocator->m_Total }) {
+            UpdatePeak(counters->InternalPeakBytes, counters->InternalBytes.fetch_add(size, std::memory_order_relaxed) + size);
+        }
+    }
+    VKAPI_ATTR void VKAPI_CALL HostAllocator::InternalFreeCallback(void* userData, size_t size, VkInternalAllocationType, VkSystemAllocationScope scope) {
+        auto* allocator = static_cast<HostAllocator*>(userData);
+        for (Counters* counters : { &allocator->m_Scopes[scope], &allocator->m_Total }) {
+            counters->InternalBytes.fetch_sub(size, std::memory_order_relaxed);
+        }
+    }
+}
\ No newline at end of file
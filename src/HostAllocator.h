@@ -0,0 +1,69 @@
+#pragma once
+/* This Header implements VkAllocationCallbacks --> driver host allocations are counted per scope, small command scope blocks come from size-classed pools */
+#include "pch.h"
+#include "DeviceContext.h"
+#include <atomic>
+#include <mutex>
+
+namespace VulkanPractice {
+    struct HostAllocationStats {
+        uint64_t Allocations = 0, Reallocations = 0, Frees = 0;
+        uint64_t PoolAllocations = 0; // served from a size class instead of the heap
+        uint64_t CurrentBytes = 0, PeakBytes = 0;
+        uint64_t InternalBytes = 0, InternalPeakBytes = 0; // driver owned, reported through the notification callbacks
+    };
+
+    class HostAllocator {
+    public:
+        inline static constexpr uint32_t s_ScopeCount = VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1;
+    private:
+        struct Counters {
+            std::atomic<uint64_t> Allocations{ 0 }, Reallocations{ 0 }, Frees{ 0 }, PoolAllocations{ 0 };
+            std::atomic<uint64_t> CurrentBytes{ 0 }, PeakBytes{ 0 };
+            std::atomic<uint64_t> InternalBytes{ 0 }, InternalPeakBytes{ 0 };
+        };
+        struct Pool {
+            size_t BlockSize = 0;
+            std::mutex Mutex;
+            void* FreeList = nullptr; // intrusive --> the first bytes of a free block point to the next one
+            std::vector<void*> Chunks;
+        };
+        /* 64 B .. 4 KiB, blocks are 64 byte aligned so any request up to that alignment fits */
+        inline static constexpr uint32_t s_PoolCount = 7;
+        inline static constexpr size_t s_PoolAlignment = 64;
+        inline static constexpr size_t s_ChunkSize = 64 * 1024;
+
+        std::array<Counters, s_ScopeCount> m_Scopes;
+        Counters m_Total;
+        std::array<Pool, s_PoolCount> m_Pools;
+        VkAllocationCallbacks m_Callbacks{};
+    public:
+        HostAllocator();
+        ~HostAllocator();
+        HostAllocator(const HostAllocator&) = delete;
+        HostAllocator& operator=(const HostAllocator&) = delete;
+
+        /* Every object created with these must be destroyed with them and before the allocator */
+        inline const VkAllocationCallbacks* GetCallbacks() const { return &m_Callbacks; }
+
+        HostAllocationStats GetStats(VkSystemAllocationScope scope) const;
+        HostAllocationStats GetTotalStats() const;
+        /* Logs one line per scope with live, peak and pooled counts */
+        void Report(const std::string& title) const;
+    private:
+        void* Allocate(size_t size, size_t alignment, VkSystemAllocationScope scope);
+        void* Reallocate(void* original, size_t size, size_t alignment, VkSystemAllocationScope scope);
+        void Free(void* memory);
+        void* AllocateFromPool(uint32_t pool);
+        void ReturnToPool(uint32_t pool, void* block);
+        void CountAllocation(VkSystemAllocationScope scope, uint64_t size, bool pooled);
+        void CountFree(VkSystemAllocationScope scope, uint64_t size);
+
+        static HostAllocationStats Snapshot(const Counters& counters);
+        static VKAPI_ATTR void* VKAPI_CALL AllocationCallback(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope);
+        static VKAPI_ATTR void* VKAPI_CALL ReallocationCallback(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope);
+        static VKAPI_ATTR void VKAPI_CALL FreeCallback(void* userData, void* memory);
+        static VKAPI_ATTR void VKAPI_CALL InternalAllocationCallback(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope);
+        static VKAPI_ATTR void VKAPI_CALL InternalFreeCallback(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope);
+    };
+}
\ No newline at end of file
@@ -1,11 +1,6 @@
 #include "pch.h"
 #include "Application.h"
 
-#define GLM_FORCE_RADIANS
-#define GLM_FORCE_DEPTH_ZERO_TO_ONE
-#include <glm/vec4.hpp>
-#include <glm/mat4x4.hpp>
-
 using namespace VulkanPractice;
 int main() {
     Application MyApp;
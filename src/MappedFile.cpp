@@ -0,0 +1,77 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace VulkanPractice {
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::string& filepath) {
+        HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Failed to open file for mapping: " + filepath);
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            CloseHandle(file);
+            throw std::runtime_error("Failed to map empty file: " + filepath);
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            CloseHandle(file);
+            throw std::runtime_error("Failed to create file mapping: " + filepath);
+        }
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            throw std::runtime_error("Failed to map view of file: " + filepath);
+        }
+        m_FileHandle = file;
+        m_MappingHandle = mapping;
+        m_Data = static_cast<const uint8_t*>(data);
+        m_Size = static_cast<size_t>(size.QuadPart);
+    }
+    MappedFile::~MappedFile() {
+        UnmapViewOfFile(m_Data);
+        CloseHandle(m_MappingHandle);
+        CloseHandle(m_FileHandle);
+    }
+#else
+    MappedFile::MappedFile(const std::string& filepath) {
+        int fd = open(filepath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open file for mapping: " + filepath);
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            throw std::runtime_error("Failed to map empty file: " + filepath);
+        }
+        void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // the mapping keeps its own reference to the file
+        if (data == MAP_FAILED) {
+            throw std::runtime_error("Failed to map file: " + filepath);
+        }
+        /* Whole file is streamed front to back into staging memory */
+        madvise(data, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+        madvise(data, static_cast<size_t>(st.st_size), MADV_WILLNEED);
+        m_Data = static_cast<const uint8_t*>(data);
+        m_Size = static_cast<size_t>(st.st_size);
+    }
+    MappedFile::~MappedFile() {
+        munmap(const_cast<uint8_t*>(m_Data), m_Size);
+    }
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+/* Read-only memory mapping of a whole file --> mmap on POSIX, file mapping objects on Windows */
+#include "pch.h"
+
+namespace VulkanPractice {
+    class MappedFile {
+    private:
+        const uint8_t* m_Data = nullptr;
+        size_t m_Size = 0;
+#ifdef _WIN32
+        void* m_FileHandle = nullptr;
+        void* m_MappingHandle = nullptr;
+#endif
+    public:
+        MappedFile(const std::string& filepath);
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        inline const uint8_t* GetData() const { return m_Data; }
+        inline size_t GetSize() const { return m_Size; }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "MemoryBudget.h"
+#include "Log.h"
+#include <algorithm>
+
+namespace VulkanPractice {
+    MemoryBudget::MemoryBudget(const DeviceContext& context, PFN_vkGetPhysicalDeviceMemoryProperties2KHR getMemoryProperties2, const MemoryBudgetConfig& config)
+        : m_DeviceContext(context), m_GetMemoryProperties2(getMemoryProperties2), m_Config(config)
+    {
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(m_DeviceContext.PhysicalDevice, &memoryProperties);
+        m_Heaps.resize(memoryProperties.memoryHeapCount);
+        m_CooldownUntil.resize(memoryProperties.memoryHeapCount, 0);
+        for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++) {
+            m_Heaps[i].Index = i;
+            m_Heaps[i].Flags = memoryProperties.memoryHeaps[i].flags;
+            m_Heaps[i].Size = memoryProperties.memoryHeaps[i].size;
+            m_Heaps[i].Budget = memoryProperties.memoryHeaps[i].size; // stays the heap size without the extension
+        }
+#ifdef INCLUDE_DEBUG_INFO
+        if (!IsSupported()) {
+            LOG_WARN("VK_EXT_memory_budget not available --> heap usage is not reported and pressure callbacks never run");
+        }
+#endif
+        Sample();
+    }
+    MemoryBudget::~MemoryBudget() {
+#ifdef INCLUDE_DEBUG_INFO
+        Report("GPU memory budget");
+#endif
+    }
+
+    void MemoryBudget::Update(uint64_t frameNumber) {
+        if (!IsSupported()) return;
+        Sample();
+        for (HeapBudget& heap : m_Heaps) {
+            if (frameNumber < m_CooldownUntil[heap.Index]) continue;
+            if (static_cast<double>(heap.Usage) > static_cast<double>(heap.Budget) * m_Config.HighWatermark) {
+                Relieve(heap, frameNumber);
+            }
+        }
+    }
+
+    MemoryBudget::CallbackId MemoryBudget::AddPressureCallback(int32_t priority, PressureCallback callback) {
+        CallbackId id = m_NextCallbackId++;
+        /* Stable among equal priorities --> registration order breaks ties */
+        auto position = std::upper_bound(m_Listeners.begin(), m_Listeners.end(), priority,
+            [](int32_t value, const Listener& listener) { return value < listener.Priority; });
+        m_Listeners.insert(position, Listener{ id, priority, std::move(callback) });
+        return id;
+    }
+    void MemoryBudget::RemovePressureCallback(CallbackId id) {
+        m_Listeners.erase(std::remove_if(m_Listeners.begin(), m_Listeners.end(),
+            [id](const Listener& listener) { return listener.Id == id; }), m_Listeners.end());
+    }
+
+    VkDeviceSize MemoryBudget::GetHeadroom(VkMemoryHeapFlags requiredFlags) const {
+        VkDeviceSize headroom = UINT64_MAX;
+        for (const HeapBudget& heap : m_Heaps) {
+            if ((heap.Flags & requiredFlags) != requiredFlags) continue;
+            VkDeviceSize target = static_cast<VkDeviceSize>(static_cast<double>(heap.Budget) * m_Config.LowWatermark);
+            headroom = std::min(headroom, target > heap.Usage ? target - heap.Usage : 0);
+        }
+        return headroom == UINT64_MAX ? 0 : headroom;
+    }
+
+    void MemoryBudget::Report(const std::string& title) const {
+        LOG_INFO("{}: {} pressure events{}", title, m_PressureEvents, IsSupported() ? "" : " (VK_EXT_memory_budget not enabled)");
+        for (const HeapBudget& heap : m_Heaps) {
+            LOG_INFO("  Heap {} {:<12} {:>6} MiB size {:>6} MiB budget {:>6} MiB used {:>6} MiB peak",
+                heap.Index, (heap.Flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? "device local" : "host",
+                heap.Size >> 20, heap.Budget >> 20, heap.Usage >> 20, heap.PeakUsage >> 20);
+        }
+    }
+
+    void MemoryBudget::Sample() {
+        if (!IsSupported()) return;
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+        budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+        VkPhysicalDeviceMemoryProperties2 memoryProperties{};
+        memoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        memoryProperties.pNext = &budgetProperties;
+        m_GetMemoryProperties2(m_DeviceContext.PhysicalDevice, &memoryProperties);
+        for (HeapBudget& heap : m_Heaps) {
+            heap.Usage = budgetProperties.heapUsage[heap.Index];
+            heap.Budget = budgetProperties.heapBudget[heap.Index];
+            heap.PeakUsage = std::max(heap.PeakUsage, heap.Usage);
+        }
+    }
+    void MemoryBudget::Relieve(HeapBudget& heap, uint64_t frameNumber) {
+        VkDeviceSize target = static_cast<VkDeviceSize>(static_cast<double>(heap.Budget) * m_Config.LowWatermark);
+        uint64_t bytesOver = heap.Usage - std::min(heap.Usage, target);
+        uint64_t released = 0;
+        for (const Listener& listener : m_Listeners) {
+            if (released >= bytesOver) break;
+            released += listener.Callback(heap, bytesOver - released);
+        }
+        m_PressureEvents++;
+        m_CooldownUntil[heap.Index] = frameNumber + m_Config.CooldownFrames;
+#ifdef INCLUDE_DEBUG_INFO
+        LOG_WARN("Memory heap {} at {} / {} MiB of its budget --> asked for {} KiB, released {} KiB",
+            heap.Index, heap.Usage >> 20, heap.Budget >> 20, bytesOver >> 10, released >> 10);
+#endif
+    }
+}
\ No newline at end of file
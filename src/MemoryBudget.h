@@ -0,0 +1,66 @@
+#pragma once
+/* This Header samples per-heap GPU memory usage against the driver budget (VK_EXT_memory_budget) and asks registered systems to shed memory before a heap is oversubscribed */
+#include "pch.h"
+#include "DeviceContext.h"
+#include <functional>
+
+namespace VulkanPractice {
+    struct HeapBudget {
+        uint32_t Index = 0;
+        VkMemoryHeapFlags Flags = 0;
+        VkDeviceSize Size = 0;
+        VkDeviceSize Usage = 0; // this process, 0 without the extension
+        VkDeviceSize Budget = 0; // what the driver expects this process can use, the heap size without the extension
+        VkDeviceSize PeakUsage = 0;
+    };
+
+    struct MemoryBudgetConfig {
+        float HighWatermark = 0.90f; // fraction of the budget that triggers pressure callbacks
+        float LowWatermark = 0.80f; // callbacks are asked to get usage back down to this --> hysteresis
+        uint32_t CooldownFrames = 8; // frames a heap is left alone after shedding so the driver numbers can catch up
+    };
+
+    class MemoryBudget {
+    public:
+        /* Asked to release up to bytesOver from the given heap --> returns what it actually released, 0 if it holds nothing there */
+        using PressureCallback = std::function<uint64_t(const HeapBudget& heap, uint64_t bytesOver)>;
+        using CallbackId = uint32_t;
+    private:
+        struct Listener {
+            CallbackId Id;
+            int32_t Priority; // lower runs first --> cheapest to rebuild goes first
+            PressureCallback Callback;
+        };
+
+        DeviceContext m_DeviceContext;
+        PFN_vkGetPhysicalDeviceMemoryProperties2KHR m_GetMemoryProperties2; // null when the extension is not enabled
+        MemoryBudgetConfig m_Config;
+        std::vector<HeapBudget> m_Heaps;
+        std::vector<uint64_t> m_CooldownUntil; // per heap frame number
+        std::vector<Listener> m_Listeners; // sorted by priority
+        CallbackId m_NextCallbackId = 1;
+        uint64_t m_PressureEvents = 0;
+    public:
+        /* getMemoryProperties2 comes from the instance dispatch --> pass null to only report heap sizes */
+        MemoryBudget(const DeviceContext& context, PFN_vkGetPhysicalDeviceMemoryProperties2KHR getMemoryProperties2, const MemoryBudgetConfig& config = MemoryBudgetConfig());
+        ~MemoryBudget();
+        MemoryBudget(const MemoryBudget&) = delete;
+        MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+        /* Once per frame --> re-samples every heap and runs the callbacks for heaps above the high watermark */
+        void Update(uint64_t frameNumber);
+
+        CallbackId AddPressureCallback(int32_t priority, PressureCallback callback);
+        void RemovePressureCallback(CallbackId id);
+
+        /* Bytes left below the low watermark on the tightest heap with all of requiredFlags */
+        VkDeviceSize GetHeadroom(VkMemoryHeapFlags requiredFlags) const;
+        inline bool IsSupported() const { return m_GetMemoryProperties2 != nullptr; }
+        inline const std::vector<HeapBudget>& GetHeaps() const { return m_Heaps; }
+        inline uint64_t GetPressureEventCount() const { return m_PressureEvents; }
+        void Report(const std::string& title) const;
+    private:
+        void Sample();
+        void Relieve(HeapBudget& heap, uint64_t frameNumber);
+    };
+}
\ No newline at end of file
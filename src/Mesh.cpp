@@ -0,0 +1,155 @@
+#include "Mesh.h"
+#include "MappedFile.h"
+#include "VulkanUtils.h"
+#include <cstring>
+
+namespace VulkanPractice {
+    Mesh::Mesh(const DeviceContext& context, const std::string& filepath)
+        : m_VkDevice(context.Device), m_Allocator(context.Allocator), m_Dispatch(context.Dispatch)
+    {
+        MappedFile file(filepath);
+        Upload(context, file.GetData(), file.GetSize(), filepath);
+    }
+    Mesh::Mesh(const DeviceContext& context, const uint8_t* data, size_t size, const std::string& name)
+        : m_VkDevice(context.Device), m_Allocator(context.Allocator), m_Dispatch(context.Dispatch)
+    {
+        Upload(context, data, size, name);
+    }
+    Mesh::~Mesh() {
+        VulkanUtils::FinishUpload(m_Upload, true);
+        vkDestroyBuffer(m_VkDevice, m_VkIndexBuffer, m_Allocator);
+        vkFreeMemory(m_VkDevice, m_VkIndexBufferMemory, m_Allocator);
+        vkDestroyBuffer(m_VkDevice, m_VkVertexBuffer, m_Allocator);
+        vkFreeMemory(m_VkDevice, m_VkVertexBufferMemory, m_Allocator);
+    }
+
+    void Mesh::Upload(const DeviceContext& context, const uint8_t* blob, size_t size, const std::string& name) {
+        const MeshFormat::Header& header = ValidateHeader(blob, size, name);
+        m_VertexCount = header.VertexCount;
+        m_IndexCount = header.IndexCount;
+        m_VkIndexType = header.IndexSize == 2 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+        std::copy(header.BoundsMin, header.BoundsMin + 3, m_BoundsMin.begin());
+        std::copy(header.BoundsMax, header.BoundsMax + 3, m_BoundsMax.begin());
+
+        /* One staging buffer for both sections, filled directly from the blob */
+        VkDeviceSize stagingSize = header.VertexBytes + header.IndexBytes;
+        m_ResidentBytes = stagingSize;
+        VkBuffer stagingBuffer;
+        VkDeviceMemory stagingBufferMemory;
+        VulkanUtils::CreateBuffer(
+            context, stagingSize,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            stagingBuffer, stagingBufferMemory
+        );
+        void* data;
+        vkMapMemory(m_VkDevice, stagingBufferMemory, 0, stagingSize, 0, &data);
+        std::memcpy(data, blob + header.VertexOffset, static_cast<size_t>(header.VertexBytes));
+        std::memcpy(static_cast<uint8_t*>(data) + header.VertexBytes, blob + header.IndexOffset, static_cast<size_t>(header.IndexBytes));
+        vkUnmapMemory(m_VkDevice, stagingBufferMemory);
+
+        VulkanUtils::CreateBuffer(
+            context, header.VertexBytes,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            m_VkVertexBuffer, m_VkVertexBufferMemory
+        );
+        VulkanUtils::CreateBuffer(
+            context, header.IndexBytes,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            m_VkIndexBuffer, m_VkIndexBufferMemory
+        );
+
+        VkCommandBuffer commandBuffer = VulkanUtils::BeginSingleTimeCommands(context);
+        {
+            VkBufferCopy vertexRegion{};
+            vertexRegion.srcOffset = 0;
+            vertexRegion.dstOffset = 0;
+            vertexRegion.size = header.VertexBytes;
+            vkCmdCopyBuffer(commandBuffer, stagingBuffer, m_VkVertexBuffer, 1, &vertexRegion);
+            VkBufferCopy indexRegion{};
+            indexRegion.srcOffset = header.VertexBytes;
+            indexRegion.dstOffset = 0;
+            indexRegion.size = header.IndexBytes;
+            vkCmdCopyBuffer(commandBuffer, stagingBuffer, m_VkIndexBuffer, 1, &indexRegion);
+
+            /* Later submissions on the queue read the copies as vertex input --> no queue wait needed for visibility */
+            VkBufferMemoryBarrier barriers[2]{};
+            for (VkBufferMemoryBarrier& barrier : barriers) {
+                barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.offset = 0;
+                barrier.size = VK_WHOLE_SIZE;
+            }
+            barriers[0].dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+            barriers[0].buffer = m_VkVertexBuffer;
+            barriers[1].dstAccessMask = VK_ACCESS_INDEX_READ_BIT;
+            barriers[1].buffer = m_VkIndexBuffer;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 0, nullptr, 2, barriers, 0, nullptr);
+        }
+        m_Upload = VulkanUtils::SubmitUpload(context, commandBuffer, stagingBuffer, stagingBufferMemory);
+    }
+
+    void Mesh::Bind(VkCommandBuffer commandBuffer) const {
+        VkDeviceSize offset = 0;
+        m_Dispatch->CmdBindVertexBuffers(commandBuffer, 0, 1, &m_VkVertexBuffer, &offset);
+        m_Dispatch->CmdBindIndexBuffer(commandBuffer, m_VkIndexBuffer, 0, m_VkIndexType);
+    }
+    void Mesh::Draw(VkCommandBuffer commandBuffer, uint32_t instanceCount, uint32_t firstInstance) const {
+        m_Dispatch->CmdDrawIndexed(commandBuffer, m_IndexCount, instanceCount, 0, 0, firstInstance);
+    }
+
+    VkVertexInputBindingDescription Mesh::GetBindingDescription() {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = 0;
+        bindingDescription.stride = sizeof(MeshFormat::Vertex);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        return bindingDescription;
+    }
+    std::array<VkVertexInputAttributeDescription, 4> Mesh::GetAttributeDescriptions() {
+        std::array<VkVertexInputAttributeDescription, 4> attributeDescriptions{};
+        /* Locations match basic.vert --> unused attributes are simply not fetched */
+        attributeDescriptions[0].binding = 0;
+        attributeDescriptions[0].location = 0;
+        attributeDescriptions[0].format = VK_FORMAT_R16G16B16A16_SFLOAT;
+        attributeDescriptions[0].offset = offsetof(MeshFormat::Vertex, Position);
+        attributeDescriptions[1].binding = 0;
+        attributeDescriptions[1].location = 1;
+        attributeDescriptions[1].format = VK_FORMAT_R8G8B8A8_UNORM;
+        attributeDescriptions[1].offset = offsetof(MeshFormat::Vertex, Color);
+        attributeDescriptions[2].binding = 0;
+        attributeDescriptions[2].location = 2;
+        attributeDescriptions[2].format = VK_FORMAT_R8G8B8A8_SNORM;
+        attributeDescriptions[2].offset = offsetof(MeshFormat::Vertex, Normal);
+        attributeDescriptions[3].binding = 0;
+        attributeDescriptions[3].location = 3;
+        attributeDescriptions[3].format = VK_FORMAT_R16G16_UNORM;
+        attributeDescriptions[3].offset = offsetof(MeshFormat::Vertex, TexCoord);
+        return attributeDescriptions;
+    }
+
+    const MeshFormat::Header& Mesh::ValidateHeader(const uint8_t* blob, size_t size, const std::string& name) {
+        if (size < sizeof(MeshFormat::Header)) {
+            throw std::runtime_error("Mesh file too small: " + name);
+        }
+        /* Mappings and heap blocks are suitably aligned so the header can be read in place */
+        const auto& header = *reinterpret_cast<const MeshFormat::Header*>(blob);
+        if (header.Magic != MeshFormat::Magic || header.Version != MeshFormat::Version) {
+            throw std::runtime_error("Mesh file has an unknown format or version: " + name);
+        }
+        if (header.VertexStride != sizeof(MeshFormat::Vertex) || (header.IndexSize != 2 && header.IndexSize != 4)) {
+            throw std::runtime_error("Mesh file has an unsupported vertex or index layout: " + name);
+        }
+        if (header.VertexCount == 0 || header.IndexCount == 0 ||
+            header.VertexBytes != static_cast<uint64_t>(header.VertexCount) * header.VertexStride ||
+            header.IndexBytes != static_cast<uint64_t>(header.IndexCount) * header.IndexSize ||
+            header.VertexOffset > size || header.VertexBytes > size - header.VertexOffset || // subtraction --> a crafted offset cannot wrap past the check
+            header.IndexOffset > size || header.IndexBytes > size - header.IndexOffset) {
+            throw std::runtime_error("Mesh file is truncated or corrupt: " + name);
+        }
+        return header;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+/* GPU mesh loaded from a packed MeshFormat blob (see tools/MeshConverter) */
+#include "pch.h"
+#include "DeviceContext.h"
+#include "MeshFormat.h"
+#include "VulkanUtils.h"
+
+namespace VulkanPractice {
+    class Mesh {
+    private:
+        VkDevice m_VkDevice;
+        const VkAllocationCallbacks* m_Allocator; // destroy with what created
+        const DeviceDispatch* m_Dispatch; // Bind/Draw run on the recording path
+        VkBuffer m_VkVertexBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory m_VkVertexBufferMemory = VK_NULL_HANDLE;
+        VkBuffer m_VkIndexBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory m_VkIndexBufferMemory = VK_NULL_HANDLE;
+        VkIndexType m_VkIndexType;
+        uint32_t m_VertexCount, m_IndexCount;
+        std::array<float, 3> m_BoundsMin, m_BoundsMax;
+        uint64_t m_ResidentBytes = 0;
+        PendingUpload m_Upload; // copies in flight --> buffers are only drawn from once it finished
+    public:
+        /* Maps the file and copies straight from the mapping into staging memory --> no per-vertex parsing */
+        Mesh(const DeviceContext& context, const std::string& filepath);
+        /* Same format from memory --> used by the AssetStreamer once the I/O threads have read the file */
+        Mesh(const DeviceContext& context, const uint8_t* data, size_t size, const std::string& name);
+        /* Waits for an unfinished upload before freeing the buffers */
+        ~Mesh();
+        Mesh(const Mesh&) = delete;
+        Mesh& operator=(const Mesh&) = delete;
+
+        void Bind(VkCommandBuffer commandBuffer) const;
+        void Draw(VkCommandBuffer commandBuffer, uint32_t instanceCount = 1, uint32_t firstInstance = 0) const;
+
+        inline uint32_t GetVertexCount() const { return m_VertexCount; }
+        inline uint32_t GetIndexCount() const { return m_IndexCount; }
+        inline const std::array<float, 3>& GetBoundsMin() const { return m_BoundsMin; }
+        inline const std::array<float, 3>& GetBoundsMax() const { return m_BoundsMax; }
+        inline uint64_t GetResidentBytes() const { return m_ResidentBytes; }
+        /* Polls the upload fence and frees the staging buffer once it signalled --> on the thread that owns the command pool */
+        inline bool IsUploadComplete() { return VulkanUtils::FinishUpload(m_Upload); }
+
+        static VkVertexInputBindingDescription GetBindingDescription();
+        static std::array<VkVertexInputAttributeDescription, 4> GetAttributeDescriptions();
+    private:
+        void Upload(const DeviceContext& context, const uint8_t* blob, size_t size, const std::string& name);
+        static const MeshFormat::Header& ValidateHeader(const uint8_t* blob, size_t size, const std::string& name);
+    };
+}
\ No newline at end of file
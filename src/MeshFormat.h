@@ -0,0 +1,36 @@
+#pragma once
+/* On-disk layout of packed mesh blobs --> shared by the runtime and tools/MeshConverter, so no Vulkan here */
+#include <stdint.h>
+
+namespace VulkanPractice {
+    namespace MeshFormat {
+        constexpr uint32_t Magic = 0x48534D56; // "VMSH" little endian
+        constexpr uint32_t Version = 1;
+        constexpr uint64_t SectionAlignment = 16; // vertex and index blocks start on this boundary
+
+        /* Interleaved, quantized vertex --> consumed as-is by the vertex input stage */
+        struct Vertex {
+            uint16_t Position[4]; // R16G16B16A16_SFLOAT, w = 1
+            int8_t Normal[4];     // R8G8B8A8_SNORM, w = 0
+            uint16_t TexCoord[2]; // R16G16_UNORM
+            uint8_t Color[4];     // R8G8B8A8_UNORM
+        };
+        static_assert(sizeof(Vertex) == 20, "MeshFormat::Vertex must stay tightly packed");
+
+        struct Header {
+            uint32_t Magic;
+            uint32_t Version;
+            uint32_t VertexStride;
+            uint32_t IndexSize; // bytes per index --> 2 or 4
+            uint32_t VertexCount;
+            uint32_t IndexCount;
+            uint64_t VertexOffset; // from the start of the file
+            uint64_t VertexBytes;
+            uint64_t IndexOffset;
+            uint64_t IndexBytes;
+            float BoundsMin[3];
+            float BoundsMax[3];
+        };
+        static_assert(sizeof(Header) == 80, "MeshFormat::Header layout changed --> bump Version");
+    }
+}
\ No newline at end of file
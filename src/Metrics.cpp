@@ -0,0 +1,135 @@
+#include "Metrics.h"
+#include <cstdio>
+#include <cmath>
+
+namespace VulkanPractice {
+    static void AppendNumber(std::string& out, double value) {
+        if (std::isinf(value)) {
+            out += value > 0.0 ? "+Inf" : "-Inf";
+            return;
+        }
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+        out += buffer;
+    }
+    static void AppendSeriesName(std::string& out, const std::string& name, const char* suffix, const std::string& labels, const char* extraLabel = nullptr) {
+        out += name;
+        out += suffix;
+        if (labels.empty() && !extraLabel) return;
+        out += '{';
+        out += labels;
+        if (extraLabel) {
+            if (!labels.empty()) out += ',';
+            out += extraLabel;
+        }
+        out += '}';
+    }
+
+    MetricHistogram::MetricHistogram(std::vector<double> bounds)
+        : m_Bounds(std::move(bounds)), m_Buckets(new std::atomic<uint64_t>[m_Bounds.size() + 1])
+    {
+        if (!std::is_sorted(m_Bounds.begin(), m_Bounds.end())) {
+            throw std::runtime_error("Histogram bounds must be ascending!");
+        }
+        for (size_t i = 0; i <= m_Bounds.size(); i++) m_Buckets[i].store(0, std::memory_order_relaxed);
+    }
+    void MetricHistogram::Observe(double value) {
+        /* A dozen bounds at most --> a linear scan beats a binary search */
+        size_t bucket = 0;
+        while (bucket < m_Bounds.size() && value > m_Bounds[bucket]) bucket++;
+        m_Buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        m_Count.fetch_add(1, std::memory_order_relaxed);
+        double sum = m_Sum.load(std::memory_order_relaxed);
+        while (!m_Sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {}
+    }
+
+    MetricCounter& MetricsRegistry::Counter(const std::string& name, const std::string& help, const std::string& labels) {
+        return *GetSeries(name, help, MetricType::Counter, labels).Counter;
+    }
+    MetricGauge& MetricsRegistry::Gauge(const std::string& name, const std::string& help, const std::string& labels) {
+        return *GetSeries(name, help, MetricType::Gauge, labels).Gauge;
+    }
+    MetricHistogram& MetricsRegistry::Histogram(const std::string& name, const std::string& help, const std::vector<double>& bounds, const std::string& labels) {
+        return *GetSeries(name, help, MetricType::Histogram, labels, bounds).Histogram;
+    }
+
+    std::string MetricsRegistry::Render() const {
+        static const char* s_TypeNames[] = { "counter", "gauge", "histogram" };
+        std::string out;
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (const Family& family : m_Families) {
+            out += "# HELP " + family.Name + " ";
+            for (char character : family.Help) {
+                if (character == '\\') out += "\\\\";
+                else if (character == '\n') out += "\\n";
+                else out += character;
+            }
+            out += "\n# TYPE " + family.Name + " " + s_TypeNames[static_cast<size_t>(family.Type)] + "\n";
+            for (const Series& series : family.Members) {
+                switch (family.Type) {
+                case MetricType::Counter:
+                    AppendSeriesName(out, family.Name, "", series.Labels);
+                    out += ' ' + std::to_string(series.Counter->Get()) + '\n';
+                    break;
+                case MetricType::Gauge:
+                    AppendSeriesName(out, family.Name, "", series.Labels);
+                    out += ' ';
+                    AppendNumber(out, series.Gauge->Get());
+                    out += '\n';
+                    break;
+                case MetricType::Histogram: {
+                    const MetricHistogram& histogram = *series.Histogram;
+                    uint64_t cumulative = 0;
+                    for (size_t bucket = 0; bucket <= histogram.GetBounds().size(); bucket++) {
+                        cumulative += histogram.GetBucket(bucket);
+                        std::string bound = "le=\"";
+                        AppendNumber(bound, bucket < histogram.GetBounds().size() ? histogram.GetBounds()[bucket] : std::numeric_limits<double>::infinity());
+                        bound += '"';
+                        AppendSeriesName(out, family.Name, "_bucket", series.Labels, bound.c_str());
+                        out += ' ' + std::to_string(cumulative) + '\n';
+                    }
+                    AppendSeriesName(out, family.Name, "_sum", series.Labels);
+                    out += ' ';
+                    AppendNumber(out, histogram.GetSum());
+                    out += '\n';
+                    /* Count from the buckets --> consistent with +Inf even when a scrape races an Observe */
+                    AppendSeriesName(out, family.Name, "_count", series.Labels);
+                    out += ' ' + std::to_string(cumulative) + '\n';
+                    break;
+                }
+                }
+            }
+        }
+        return out;
+    }
+
+    std::vector<double> MetricsRegistry::ExponentialBuckets(double start, double factor, uint32_t count) {
+        std::vector<double> bounds(count);
+        for (uint32_t i = 0; i < count; i++) {
+            bounds[i] = start;
+            start *= factor;
+        }
+        return bounds;
+    }
+
+    MetricsRegistry::Series& MetricsRegistry::GetSeries(const std::string& name, const std::string& help, MetricType type, const std::string& labels, const std::vector<double>& bounds) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto family = std::find_if(m_Families.begin(), m_Families.end(), [&name](const Family& existing) { return existing.Name == name; });
+        if (family == m_Families.end()) {
+            family = m_Families.insert(m_Families.end(), Family{ name, help, type, {} });
+        } else if (family->Type != type) {
+            throw std::runtime_error("Metric " + name + " is registered with another type!");
+        }
+        for (Series& series : family->Members) {
+            if (series.Labels == labels) return series;
+        }
+        Series series;
+        series.Labels = labels;
+        switch (type) {
+            case MetricType::Counter: series.Counter = std::make_unique<MetricCounter>(); break;
+            case MetricType::Gauge: series.Gauge = std::make_unique<MetricGauge>(); break;
+            case MetricType::Histogram: series.Histogram = std::make_unique<MetricHistogram>(bounds); break;
+        }
+        return family->Members.emplace_back(std::move(series));
+    }
+}
\ No newline at end of file
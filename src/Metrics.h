@@ -0,0 +1,81 @@
+#pragma once
+/* This Header holds the metrics registry --> counters, gauges and histograms updated with relaxed atomics from any thread, rendered in the Prometheus text format on demand */
+#include "pch.h"
+#include <atomic>
+#include <mutex>
+#include <deque>
+
+namespace VulkanPractice {
+    /* Only ever grows --> rates are the scraper's job */
+    class MetricCounter {
+    private:
+        std::atomic<uint64_t> m_Value{ 0 };
+    public:
+        inline void Add(uint64_t value = 1) { m_Value.fetch_add(value, std::memory_order_relaxed); }
+        inline uint64_t Get() const { return m_Value.load(std::memory_order_relaxed); }
+    };
+
+    class MetricGauge {
+    private:
+        std::atomic<double> m_Value{ 0.0 };
+    public:
+        inline void Set(double value) { m_Value.store(value, std::memory_order_relaxed); }
+        inline double Get() const { return m_Value.load(std::memory_order_relaxed); }
+    };
+
+    /* Buckets count their own observations only --> Observe touches one bucket, the count and the sum, cumulation happens when rendering */
+    class MetricHistogram {
+    private:
+        std::vector<double> m_Bounds; // ascending upper bounds, +Inf implied
+        std::unique_ptr<std::atomic<uint64_t>[]> m_Buckets; // one per bound plus +Inf
+        std::atomic<uint64_t> m_Count{ 0 };
+        std::atomic<double> m_Sum{ 0.0 };
+    public:
+        explicit MetricHistogram(std::vector<double> bounds);
+
+        void Observe(double value);
+        inline const std::vector<double>& GetBounds() const { return m_Bounds; }
+        inline uint64_t GetBucket(size_t bucket) const { return m_Buckets[bucket].load(std::memory_order_relaxed); }
+        inline uint64_t GetCount() const { return m_Count.load(std::memory_order_relaxed); }
+        inline double GetSum() const { return m_Sum.load(std::memory_order_relaxed); }
+    };
+
+    class MetricsRegistry {
+    private:
+        enum class MetricType : uint8_t {
+            Counter, Gauge, Histogram
+        };
+        struct Series {
+            std::string Labels; // rendered inside the braces as is, e.g. heap="0"
+            std::unique_ptr<MetricCounter> Counter;
+            std::unique_ptr<MetricGauge> Gauge;
+            std::unique_ptr<MetricHistogram> Histogram;
+        };
+        struct Family {
+            std::string Name, Help;
+            MetricType Type;
+            std::deque<Series> Members;
+        };
+
+        mutable std::mutex m_Mutex; // registration and rendering --> updates never take it
+        std::deque<Family> m_Families; // registration order is export order, references stay valid
+    public:
+        MetricsRegistry() = default;
+        MetricsRegistry(const MetricsRegistry&) = delete;
+        MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+        /* Same name and labels return the metric registered first --> throws when the name was registered with another type */
+        MetricCounter& Counter(const std::string& name, const std::string& help, const std::string& labels = "");
+        MetricGauge& Gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+        MetricHistogram& Histogram(const std::string& name, const std::string& help, const std::vector<double>& bounds, const std::string& labels = "");
+
+        /* Text exposition format 0.0.4 --> a scrape reads every metric without stopping writers, so a histogram may be one observation ahead in a bucket */
+        std::string Render() const;
+
+        /* start, start * factor, ... count bounds */
+        static std::vector<double> ExponentialBuckets(double start, double factor, uint32_t count);
+    private:
+        /* Creates the metric while the lock is held --> Render never sees a published series without one, bounds only matter for histograms */
+        Series& GetSeries(const std::string& name, const std::string& help, MetricType type, const std::string& labels, const std::vector<double>& bounds = {});
+    };
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+#include "MetricsServer.h"
+#include "Log.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // Windows has no SIGPIPE to suppress
+#endif
+
+namespace VulkanPractice {
+    MetricsServer::MetricsServer(const MetricsRegistry& registry, const MetricsServerConfig& config)
+        : m_Registry(registry), m_Config(config)
+    {
+#ifdef _WIN32
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+            throw std::runtime_error("Failed to initialize winsock!");
+        }
+#endif
+        try {
+            if (m_Config.Port != 0) OpenTcpListener();
+            if (!m_Config.UnixSocketPath.empty()) OpenUnixListener();
+        } catch (const std::runtime_error&) {
+            for (SocketHandle listener : m_Listeners) CloseSocket(listener);
+#ifdef _WIN32
+            WSACleanup();
+#endif
+            throw;
+        }
+        if (m_Listeners.empty()) {
+#ifdef _WIN32
+            WSACleanup();
+#endif
+            throw std::runtime_error("Metrics server has no port or socket path!");
+        }
+        m_Thread = std::thread(&MetricsServer::ServeLoop, this);
+    }
+    MetricsServer::~MetricsServer() {
+        m_Stopping.store(true, std::memory_order_relaxed);
+        m_Thread.join(); // select wakes up at least every 200 ms to look at the flag
+        for (SocketHandle listener : m_Listeners) CloseSocket(listener);
+#ifdef _WIN32
+        WSACleanup();
+#else
+        if (!m_Config.UnixSocketPath.empty()) unlink(m_Config.UnixSocketPath.c_str());
+#endif
+    }
+
+    void MetricsServer::OpenTcpListener() {
+        SocketHandle listener = static_cast<SocketHandle>(socket(AF_INET, SOCK_STREAM, 0));
+        if (listener == s_InvalidSocket) {
+            throw std::runtime_error("Failed to create metrics socket!");
+        }
+        int reuse = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+        /* Loopback only --> nothing here is meant to leave the machine */
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(m_Config.Port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 4) != 0) {
+            CloseSocket(listener);
+            throw std::runtime_error("Failed to listen on metrics port " + std::to_string(m_Config.Port) + "!");
+        }
+        m_Listeners.push_back(listener);
+        LOG_INFO("Metrics served on http://127.0.0.1:{}/metrics", m_Config.Port);
+    }
+    void MetricsServer::OpenUnixListener() {
+#ifdef _WIN32
+        LOG_WARN("Metrics Unix socket ignored --> not supported on this platform");
+#else
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (m_Config.UnixSocketPath.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Metrics socket path is too long!");
+        }
+        std::memcpy(address.sun_path, m_Config.UnixSocketPath.c_str(), m_Config.UnixSocketPath.size() + 1);
+        /* Only a socket left over from a previous run that did not shut down is replaced --> a mistyped path must not delete a file */
+        struct stat existing;
+        if (lstat(address.sun_path, &existing) == 0) {
+            if (!S_ISSOCK(existing.st_mode)) {
+                throw std::runtime_error("Metrics socket path " + m_Config.UnixSocketPath + " exists and is not a socket!");
+            }
+            unlink(address.sun_path);
+        }
+
+        int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0) {
+            throw std::runtime_error("Failed to create metrics socket!");
+        }
+        if (bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 4) != 0) {
+            close(listener);
+            throw std::runtime_error("Failed to listen on metrics socket " + m_Config.UnixSocketPath + "!");
+        }
+        m_Listeners.push_back(static_cast<SocketHandle>(listener));
+        LOG_INFO("Metrics served on unix:{} /metrics", m_Config.UnixSocketPath);
+#endif
+    }
+
+    void MetricsServer::ServeLoop() {
+        while (!m_Stopping.load(std::memory_order_relaxed)) {
+            fd_set readable;
+            FD_ZERO(&readable);
+            SocketHandle highest = 0;
+            for (SocketHandle listener : m_Listeners) {
+                FD_SET(listener, &readable);
+                highest = std::max(highest, listener);
+            }
+            timeval timeout{ 0, 200000 };
+            int ready = select(static_cast<int>(highest + 1), &readable, nullptr, nullptr, &timeout); // first argument is ignored on Windows
+            if (ready <= 0) continue; // timeout or EINTR --> look at the stop flag again
+
+            for (SocketHandle listener : m_Listeners) {
+                if (!FD_ISSET(listener, &readable)) continue;
+                SocketHandle client = static_cast<SocketHandle>(accept(listener, nullptr, nullptr));
+                if (client == s_InvalidSocket) continue;
+                Serve(client);
+                CloseSocket(client);
+            }
+        }
+    }
+
+    void MetricsServer::Serve(SocketHandle client) {
+        /* A silent client must not hold up shutdown --> bounded wait for the request head */
+#ifdef _WIN32
+        DWORD receiveTimeout = 1000;
+#else
+        timeval receiveTimeout{ 1, 0 };
+#endif
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&receiveTimeout), sizeof(receiveTimeout));
+
+        std::string request;
+        char buffer[1024];
+        while (request.find("\r\n\r\n") == std::string::npos && request.size() < s_MaxRequestBytes) {
+            auto received = recv(client, buffer, sizeof(buffer), 0);
+            if (received <= 0) break;
+            request.append(buffer, static_cast<size_t>(received));
+        }
+
+        /* Request line only --> "GET /metrics HTTP/1.1", headers and query strings are ignored */
+        size_t methodEnd = request.find(' ');
+        size_t pathEnd = methodEnd == std::string::npos ? std::string::npos : request.find_first_of(" ?", methodEnd + 1);
+        std::string method = request.substr(0, methodEnd);
+        std::string path = pathEnd == std::string::npos ? std::string() : request.substr(methodEnd + 1, pathEnd - methodEnd - 1);
+
+        std::string status, contentType, body;
+        if (method == "GET" && path == "/metrics") {
+            status = "200 OK";
+            contentType = "text/plain; version=0.0.4; charset=utf-8";
+            body = m_Registry.Render();
+        } else {
+            status = "404 Not Found";
+            contentType = "text/plain; charset=utf-8";
+            body = "Not Found\n";
+        }
+        std::string response = "HTTP/1.1 " + status + "\r\nContent-Type: " + contentType +
+            "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+
+        size_t sent = 0;
+        while (sent < response.size()) {
+            auto written = send(client, response.data() + sent, static_cast<int>(response.size() - sent), MSG_NOSIGNAL);
+            if (written <= 0) break; // scraper went away
+            sent += static_cast<size_t>(written);
+        }
+    }
+
+    void MetricsServer::CloseSocket(SocketHandle socket) {
+#ifdef _WIN32
+        closesocket(socket);
+#else
+        close(static_cast<int>(socket));
+#endif
+    }
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+/* This Header serves the metrics registry over a local socket --> one background thread answers GET /metrics in the Prometheus text format */
+#include "pch.h"
+#include "Metrics.h"
+#include <atomic>
+#include <thread>
+
+namespace VulkanPractice {
+    struct MetricsServerConfig {
+        uint16_t Port = 0; // HTTP on 127.0.0.1 only --> 0 disables
+        std::string UnixSocketPath; // HTTP over a Unix domain socket, POSIX only --> empty disables
+    };
+
+    class MetricsServer {
+    private:
+        using SocketHandle = uintptr_t; // SOCKET on Windows, file descriptor elsewhere
+        inline static constexpr SocketHandle s_InvalidSocket = ~SocketHandle(0);
+        inline static constexpr size_t s_MaxRequestBytes = 4096;
+
+        const MetricsRegistry& m_Registry;
+        MetricsServerConfig m_Config;
+        std::vector<SocketHandle> m_Listeners;
+        std::atomic<bool> m_Stopping{ false };
+        std::thread m_Thread;
+    public:
+        /* Throws when no listener could be opened --> callers decide whether metrics are optional */
+        MetricsServer(const MetricsRegistry& registry, const MetricsServerConfig& config);
+        ~MetricsServer();
+        MetricsServer(const MetricsServer&) = delete;
+        MetricsServer& operator=(const MetricsServer&) = delete;
+
+        inline static bool IsEnabled(const MetricsServerConfig& config) { return config.Port != 0 || !config.UnixSocketPath.empty(); }
+    private:
+        void OpenTcpListener();
+        void OpenUnixListener();
+        void ServeLoop();
+        /* One request per connection --> a scraper reconnects every interval anyway */
+        void Serve(SocketHandle client);
+        static void CloseSocket(SocketHandle socket);
+    };
+}
\ No newline at end of file
@@ -0,0 +1,363 @@
+#include "OcclusionCuller.h"
+#include "VulkanUtils.h"
+#include "ShaderTypes.h"
+#include "Log.h"
+#include <cstring>
+
+namespace VulkanPractice {
+    static uint32_t PreviousPowerOfTwo(uint32_t value) {
+        uint32_t result = 1;
+        while (result <= value / 2) result *= 2;
+        return result;
+    }
+    static VkExtent2D GetLevelExtent(VkExtent2D extent, uint32_t level) {
+        return { std::max(extent.width >> level, 1U), std::max(extent.height >> level, 1U) };
+    }
+
+    OcclusionCuller::OcclusionCuller(const DeviceContext& context, VkBuffer objectBuffer, VkDeviceSize objectBufferSize, uint32_t objectCount, uint32_t slotCount,
+        VkImageView depthView, VkExtent2D depthExtent, PipelineCache& pipelineCache, VkSampler sampler)
+        : m_DeviceContext(context), m_ObjectCount(objectCount), m_SlotCount(slotCount), m_VkObjectBuffer(objectBuffer), m_ObjectBufferSize(objectBufferSize),
+        m_VkDepthView(depthView), m_VkSampler(sampler)
+    {
+        CreateLayouts(pipelineCache);
+        /* Written and read by the GPU only */
+        VulkanUtils::CreateBuffer(
+            m_DeviceContext, sizeof(VkDrawIndexedIndirectCommand) * m_ObjectCount * 2, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_VkDrawBuffer, m_VkDrawBufferMemory
+        );
+        CreateStatsBuffer();
+        CreatePyramid(depthExtent);
+        WriteDescriptors();
+    }
+    OcclusionCuller::~OcclusionCuller() {
+#ifdef INCLUDE_DEBUG_INFO
+        Report();
+#endif
+        DestroyPyramid();
+        vkUnmapMemory(m_DeviceContext.Device, m_VkStatsBufferMemory);
+        vkDestroyBuffer(m_DeviceContext.Device, m_VkStatsBuffer, m_DeviceContext.Allocator);
+        vkFreeMemory(m_DeviceContext.Device, m_VkStatsBufferMemory, m_DeviceContext.Allocator);
+        vkDestroyBuffer(m_DeviceContext.Device, m_VkDrawBuffer, m_DeviceContext.Allocator);
+        vkFreeMemory(m_DeviceContext.Device, m_VkDrawBufferMemory, m_DeviceContext.Allocator);
+        vkDestroyPipelineLayout(m_DeviceContext.Device, m_VkReduceLayout, m_DeviceContext.Allocator);
+        vkDestroyPipelineLayout(m_DeviceContext.Device, m_VkCullLayout, m_DeviceContext.Allocator);
+        vkDestroyDescriptorSetLayout(m_DeviceContext.Device, m_VkReduceSetLayout, m_DeviceContext.Allocator);
+        vkDestroyDescriptorSetLayout(m_DeviceContext.Device, m_VkCullSetLayout, m_DeviceContext.Allocator);
+    }
+
+    bool OcclusionCuller::ReadCounters(uint32_t slot) {
+        /* Zeroed after every read --> a slot whose buffer did not cull stays at zero */
+        Counters& counters = m_MappedStats[slot];
+        uint32_t total = counters.DrawnFirstPhase + counters.DrawnSecondPhase + counters.FrustumCulled + counters.OcclusionCulled;
+        if (total == 0) return false;
+        m_LastCounters = counters;
+        counters = {};
+        m_FramesCounted++;
+        m_TotalDrawn += m_LastCounters.DrawnFirstPhase + m_LastCounters.DrawnSecondPhase;
+        m_TotalFrustumCulled += m_LastCounters.FrustumCulled;
+        m_TotalOcclusionCulled += m_LastCounters.OcclusionCulled;
+        return true;
+    }
+    void OcclusionCuller::Resize(uint32_t slotCount, VkImageView depthView, VkExtent2D depthExtent) {
+        DestroyPyramid();
+        if (slotCount != m_SlotCount) {
+            vkUnmapMemory(m_DeviceContext.Device, m_VkStatsBufferMemory);
+            vkDestroyBuffer(m_DeviceContext.Device, m_VkStatsBuffer, m_DeviceContext.Allocator);
+            vkFreeMemory(m_DeviceContext.Device, m_VkStatsBufferMemory, m_DeviceContext.Allocator);
+            m_SlotCount = slotCount;
+            CreateStatsBuffer();
+        }
+        m_VkDepthView = depthView;
+        CreatePyramid(depthExtent);
+        WriteDescriptors();
+    }
+    void OcclusionCuller::Report() const {
+        if (m_FramesCounted == 0) return;
+        double frames = static_cast<double>(m_FramesCounted);
+        LOG_INFO("Occlusion culling: {} objects, per frame {:.1f} drawn, {:.1f} frustum culled, {:.1f} occlusion culled over {} frames",
+            m_ObjectCount, m_TotalDrawn / frames, m_TotalFrustumCulled / frames, m_TotalOcclusionCulled / frames, m_FramesCounted);
+    }
+
+    void OcclusionCuller::Cull(VkCommandBuffer commandBuffer, uint32_t slot, const glm::mat4& viewProjection, const Mesh& mesh, uint32_t phase) {
+        const DeviceDispatch& dispatch = *m_DeviceContext.Dispatch;
+        if (phase == 0) {
+            dispatch.CmdFillBuffer(commandBuffer, m_VkStatsBuffer, sizeof(Counters) * slot, sizeof(Counters), 0);
+            /* Counter reset, the previous frame's pyramid and its indirect reads all ordered before this frame's cull */
+            VkMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+            dispatch.CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        }
+        dispatch.CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_VkCullPipeline);
+        dispatch.CmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_VkCullLayout, 0, 1, &m_VkCullSet, 0, nullptr);
+        CullPushConstants constants{};
+        constants.ViewProjection = viewProjection;
+        constants.BoundsMin = glm::vec4(mesh.GetBoundsMin()[0], mesh.GetBoundsMin()[1], mesh.GetBoundsMin()[2], 1.0f);
+        constants.BoundsMax = glm::vec4(mesh.GetBoundsMax()[0], mesh.GetBoundsMax()[1], mesh.GetBoundsMax()[2], 1.0f);
+        constants.PyramidSize = glm::vec2(static_cast<float>(m_PyramidExtent.width), static_cast<float>(m_PyramidExtent.height));
+        constants.ObjectCount = m_ObjectCount;
+        constants.Phase = phase;
+        constants.IndexCount = mesh.GetIndexCount();
+        constants.StatsOffset = slot * 4;
+        dispatch.CmdPushConstants(commandBuffer, m_VkCullLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+        dispatch.CmdDispatch(commandBuffer, (m_ObjectCount + s_CullGroupSize - 1) / s_CullGroupSize, 1, 1);
+
+        /* Commands to the indirect draws and the counters to the host --> also keeps the pass after this from writing depth the pyramid still reads */
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+        dispatch.CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+            0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+    void OcclusionCuller::BeginPass(VkCommandBuffer commandBuffer, const Target& target, VkRenderPass renderPass) {
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = renderPass;
+        renderPassInfo.framebuffer = target.Framebuffer;
+        renderPassInfo.renderArea.offset = { 0, 0 };
+        renderPassInfo.renderArea.extent = target.RenderExtent;
+        VkClearValue clearValues[2]{}; // ignored by the second pass, it loads
+        clearValues[0].color = {{ 0.0f, 0.0f, 0.0f, 1.0f }};
+        clearValues[1].depthStencil = { 1.0f, 0 };
+        renderPassInfo.clearValueCount = 2;
+        renderPassInfo.pClearValues = clearValues;
+        m_DeviceContext.Dispatch->CmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    }
+    void OcclusionCuller::DrawPhase(VkCommandBuffer commandBuffer, uint32_t phase) {
+        const DeviceDispatch& dispatch = *m_DeviceContext.Dispatch;
+        constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+        VkDeviceSize offset = static_cast<VkDeviceSize>(stride) * m_ObjectCount * phase;
+        /* Culled objects stay in the list with no instances --> no count buffer needed, the draws are just empty */
+        if (m_DeviceContext.EnabledFeatures.multiDrawIndirect) {
+            uint32_t maxDrawCount = std::max(m_DeviceContext.Limits.maxDrawIndirectCount, 1U);
+            for (uint32_t first = 0; first < m_ObjectCount; first += maxDrawCount) {
+                uint32_t count = std::min(maxDrawCount, m_ObjectCount - first);
+                dispatch.CmdDrawIndexedIndirect(commandBuffer, m_VkDrawBuffer, offset + static_cast<VkDeviceSize>(stride) * first, count, stride);
+            }
+        } else {
+            for (uint32_t i = 0; i < m_ObjectCount; i++) {
+                dispatch.CmdDrawIndexedIndirect(commandBuffer, m_VkDrawBuffer, offset + static_cast<VkDeviceSize>(stride) * i, 1, stride);
+            }
+        }
+    }
+    void OcclusionCuller::BuildPyramid(VkCommandBuffer commandBuffer, VkExtent2D renderExtent) {
+        /* Depth is visible to compute through the first pass's outgoing dependency */
+        const DeviceDispatch& dispatch = *m_DeviceContext.Dispatch;
+        dispatch.CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_VkReducePipeline);
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        for (uint32_t level = 0; level < m_PyramidLevels; level++) {
+            VkExtent2D source = level == 0 ? renderExtent : GetLevelExtent(m_PyramidExtent, level - 1);
+            VkExtent2D destination = GetLevelExtent(m_PyramidExtent, level);
+            HiZPushConstants constants{ source.width, source.height, destination.width, destination.height };
+            dispatch.CmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_VkReduceLayout, 0, 1, &m_VkReduceSets[level], 0, nullptr);
+            dispatch.CmdPushConstants(commandBuffer, m_VkReduceLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+            dispatch.CmdDispatch(commandBuffer, (destination.width + s_ReduceGroupSize - 1) / s_ReduceGroupSize, (destination.height + s_ReduceGroupSize - 1) / s_ReduceGroupSize, 1);
+            /* Next level reads this one, the last barrier hands the whole pyramid to the cull */
+            dispatch.CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        }
+    }
+
+    void OcclusionCuller::CreateLayouts(PipelineCache& pipelineCache) {
+        /* Cull --> objects, draw commands, counters, pyramid */
+        VkDescriptorSetLayoutBinding cullBindings[4]{};
+        for (uint32_t i = 0; i < 4; i++) {
+            cullBindings[i].binding = i;
+            cullBindings[i].descriptorType = i < 3 ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            cullBindings[i].descriptorCount = 1;
+            cullBindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = 4;
+        layoutInfo.pBindings = cullBindings;
+        if (vkCreateDescriptorSetLayout(m_DeviceContext.Device, &layoutInfo, m_DeviceContext.Allocator, &m_VkCullSetLayout) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create cull descriptor set layout!");
+        }
+        /* Reduce --> source level, destination level */
+        VkDescriptorSetLayoutBinding reduceBindings[2]{};
+        for (uint32_t i = 0; i < 2; i++) {
+            reduceBindings[i].binding = i;
+            reduceBindings[i].descriptorType = i == 0 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            reduceBindings[i].descriptorCount = 1;
+            reduceBindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+        layoutInfo.bindingCount = 2;
+        layoutInfo.pBindings = reduceBindings;
+        if (vkCreateDescriptorSetLayout(m_DeviceContext.Device, &layoutInfo, m_DeviceContext.Allocator, &m_VkReduceSetLayout) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create Hi-Z descriptor set layout!");
+        }
+
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(CullPushConstants);
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &m_VkCullSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+        if (vkCreatePipelineLayout(m_DeviceContext.Device, &pipelineLayoutInfo, m_DeviceContext.Allocator, &m_VkCullLayout) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create cull pipeline layout!");
+        }
+        pushConstantRange.size = sizeof(HiZPushConstants);
+        pipelineLayoutInfo.pSetLayouts = &m_VkReduceSetLayout;
+        if (vkCreatePipelineLayout(m_DeviceContext.Device, &pipelineLayoutInfo, m_DeviceContext.Allocator, &m_VkReduceLayout) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create Hi-Z pipeline layout!");
+        }
+
+        m_VkCullPipeline = pipelineCache.GetComputeBlocking({ VK_SHADER_STAGE_COMPUTE_BIT, std::string(SHADER_DIR) + "/GLSL/cull.comp" }, m_VkCullLayout);
+        m_VkReducePipeline = pipelineCache.GetComputeBlocking({ VK_SHADER_STAGE_COMPUTE_BIT, std::string(SHADER_DIR) + "/GLSL/hiz.comp" }, m_VkReduceLayout);
+    }
+    void OcclusionCuller::CreateStatsBuffer() {
+        VkDeviceSize size = sizeof(Counters) * m_SlotCount;
+        VulkanUtils::CreateBuffer(
+            m_DeviceContext, size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            m_VkStatsBuffer, m_VkStatsBufferMemory
+        );
+        void* mapped;
+        if (vkMapMemory(m_DeviceContext.Device, m_VkStatsBufferMemory, 0, VK_WHOLE_SIZE, 0, &mapped) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to map cull statistics buffer!");
+        }
+        m_MappedStats = static_cast<Counters*>(mapped);
+        std::memset(m_MappedStats, 0, static_cast<size_t>(size));
+    }
+    void OcclusionCuller::CreatePyramid(VkExtent2D depthExtent) {
+        /* Power of two below the depth buffer --> every level halves exactly, only level 0 reduces an uneven footprint */
+        m_PyramidExtent = { PreviousPowerOfTwo(depthExtent.width), PreviousPowerOfTwo(depthExtent.height) };
+        m_PyramidLevels = 1;
+        while ((std::max(m_PyramidExtent.width, m_PyramidExtent.height) >> m_PyramidLevels) > 0) m_PyramidLevels++;
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = VK_FORMAT_R32_SFLOAT;
+        imageInfo.extent = { m_PyramidExtent.width, m_PyramidExtent.height, 1 };
+        imageInfo.mipLevels = m_PyramidLevels;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VulkanUtils::CreateImage(m_DeviceContext, imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_VkPyramidImage, m_VkPyramidImageMemory);
+        m_VkPyramidView = VulkanUtils::CreateImageView(m_DeviceContext, m_VkPyramidImage, VK_FORMAT_R32_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT, m_PyramidLevels);
+        m_VkPyramidLevelViews.resize(m_PyramidLevels);
+        for (uint32_t level = 0; level < m_PyramidLevels; level++) {
+            VkImageViewCreateInfo viewInfo{};
+            viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            viewInfo.image = m_VkPyramidImage;
+            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewInfo.format = VK_FORMAT_R32_SFLOAT;
+            viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, 1 };
+            if (vkCreateImageView(m_DeviceContext.Device, &viewInfo, m_DeviceContext.Allocator, &m_VkPyramidLevelViews[level]) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create Hi-Z level view!");
+            }
+        }
+
+        /* GENERAL for good --> written as storage and sampled every frame. Cleared to the far plane so the first frame culls nothing */
+        VkCommandBuffer commandBuffer = VulkanUtils::BeginSingleTimeCommands(m_DeviceContext);
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = m_VkPyramidImage;
+        barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, m_PyramidLevels, 0, 1 };
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        VkClearColorValue farPlane = {{ 1.0f, 1.0f, 1.0f, 1.0f }};
+        vkCmdClearColorImage(commandBuffer, m_VkPyramidImage, VK_IMAGE_LAYOUT_GENERAL, &farPlane, 1, &barrier.subresourceRange);
+        VulkanUtils::EndSingleTimeCommands(m_DeviceContext, commandBuffer); // waits for the queue --> no barrier to the first cull needed
+
+        VkDescriptorPoolSize poolSizes[3]{};
+        poolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes[0].descriptorCount = 3;
+        poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        poolSizes[1].descriptorCount = 1 + m_PyramidLevels;
+        poolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        poolSizes[2].descriptorCount = m_PyramidLevels;
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.poolSizeCount = 3;
+        poolInfo.pPoolSizes = poolSizes;
+        poolInfo.maxSets = 1 + m_PyramidLevels;
+        if (vkCreateDescriptorPool(m_DeviceContext.Device, &poolInfo, m_DeviceContext.Allocator, &m_VkDescriptorPool) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create cull descriptor pool!");
+        }
+        std::vector<VkDescriptorSetLayout> setLayouts(1 + m_PyramidLevels, m_VkReduceSetLayout);
+        setLayouts[0] = m_VkCullSetLayout;
+        std::vector<VkDescriptorSet> sets(setLayouts.size());
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_VkDescriptorPool;
+        allocInfo.descriptorSetCount = static_cast<uint32_t>(setLayouts.size());
+        allocInfo.pSetLayouts = setLayouts.data();
+        if (vkAllocateDescriptorSets(m_DeviceContext.Device, &allocInfo, sets.data()) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate cull descriptor sets!");
+        }
+        m_VkCullSet = sets[0];
+        m_VkReduceSets.assign(sets.begin() + 1, sets.end());
+    }
+    void OcclusionCuller::DestroyPyramid() {
+        vkDestroyDescriptorPool(m_DeviceContext.Device, m_VkDescriptorPool, m_DeviceContext.Allocator); // frees the sets
+        for (VkImageView view : m_VkPyramidLevelViews) {
+            vkDestroyImageView(m_DeviceContext.Device, view, m_DeviceContext.Allocator);
+        }
+        m_VkPyramidLevelViews.clear();
+        m_VkReduceSets.clear();
+        vkDestroyImageView(m_DeviceContext.Device, m_VkPyramidView, m_DeviceContext.Allocator);
+        vkDestroyImage(m_DeviceContext.Device, m_VkPyramidImage, m_DeviceContext.Allocator);
+        vkFreeMemory(m_DeviceContext.Device, m_VkPyramidImageMemory, m_DeviceContext.Allocator);
+    }
+    void OcclusionCuller::WriteDescriptors() {
+        /* Reserved up front --> pointers into the info vectors stay valid until the update */
+        std::vector<VkDescriptorBufferInfo> bufferInfos = {
+            { m_VkObjectBuffer, 0, m_ObjectBufferSize },
+            { m_VkDrawBuffer, 0, VK_WHOLE_SIZE },
+            { m_VkStatsBuffer, 0, VK_WHOLE_SIZE }
+        };
+        std::vector<VkDescriptorImageInfo> imageInfos;
+        imageInfos.reserve(1 + m_PyramidLevels * 2);
+        imageInfos.push_back({ m_VkSampler, m_VkPyramidView, VK_IMAGE_LAYOUT_GENERAL });
+        std::vector<VkWriteDescriptorSet> writes;
+        auto addWrite = [&writes](VkDescriptorSet set, uint32_t binding, VkDescriptorType type, const VkDescriptorBufferInfo* bufferInfo, const VkDescriptorImageInfo* imageInfo) {
+            VkWriteDescriptorSet write{};
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.dstSet = set;
+            write.dstBinding = binding;
+            write.dstArrayElement = 0;
+            write.descriptorType = type;
+            write.descriptorCount = 1;
+            write.pBufferInfo = bufferInfo;
+            write.pImageInfo = imageInfo;
+            writes.push_back(write);
+        };
+        for (uint32_t i = 0; i < 3; i++) {
+            addWrite(m_VkCullSet, i, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &bufferInfos[i], nullptr);
+        }
+        addWrite(m_VkCullSet, 3, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, nullptr, &imageInfos[0]);
+        for (uint32_t level = 0; level < m_PyramidLevels; level++) {
+            /* Level 0 reads the depth buffer where the first pass left it */
+            if (level == 0) {
+                imageInfos.push_back({ m_VkSampler, m_VkDepthView, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL });
+            } else {
+                imageInfos.push_back({ m_VkSampler, m_VkPyramidLevelViews[level - 1], VK_IMAGE_LAYOUT_GENERAL });
+            }
+            addWrite(m_VkReduceSets[level], 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, nullptr, &imageInfos.back());
+            imageInfos.push_back({ VK_NULL_HANDLE, m_VkPyramidLevelViews[level], VK_IMAGE_LAYOUT_GENERAL });
+            addWrite(m_VkReduceSets[level], 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, nullptr, &imageInfos.back());
+        }
+        vkUpdateDescriptorSets(m_DeviceContext.Device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+/* This Header handles two phase Hi-Z occlusion culling of the scene objects -->
+   phase 0 draws what passes the previous frame's depth pyramid, the pyramid is rebuilt from that depth,
+   phase 1 draws what phase 0 rejected but the new pyramid shows --> nothing visible is lost for a frame when objects move */
+#include "pch.h"
+#include "DeviceContext.h"
+#include "PipelineCache.h"
+#include "Mesh.h"
+#include <glm/mat4x4.hpp>
+
+namespace VulkanPractice {
+    class OcclusionCuller {
+    public:
+        /* Mirrors the counters cull.comp writes per slot --> every object lands in exactly one of them */
+        struct Counters {
+            uint32_t DrawnFirstPhase;
+            uint32_t DrawnSecondPhase;
+            uint32_t FrustumCulled;
+            uint32_t OcclusionCulled;
+        };
+        /* Render passes and framebuffer the scene is drawn in --> both passes compatible with the scene pipelines */
+        struct Target {
+            VkRenderPass FirstPhasePass; // clears, stores depth and leaves it readable for the pyramid
+            VkRenderPass SecondPhasePass; // loads both attachments, ends in the target's usual final layouts
+            VkFramebuffer Framebuffer;
+            VkExtent2D RenderExtent; // drawn area, top left of the framebuffer
+        };
+    private:
+        inline static constexpr uint32_t s_CullGroupSize = 64; // local_size_x of cull.comp
+        inline static constexpr uint32_t s_ReduceGroupSize = 8; // local_size_x/y of hiz.comp
+
+        DeviceContext m_DeviceContext;
+        uint32_t m_ObjectCount;
+        uint32_t m_SlotCount = 0;
+        VkBuffer m_VkObjectBuffer; // owned by SceneObjects
+        VkDeviceSize m_ObjectBufferSize;
+
+        VkBuffer m_VkDrawBuffer = VK_NULL_HANDLE; // phase 0 commands followed by phase 1 commands
+        VkDeviceMemory m_VkDrawBufferMemory = VK_NULL_HANDLE;
+        VkBuffer m_VkStatsBuffer = VK_NULL_HANDLE; // one Counters per slot, host visible
+        VkDeviceMemory m_VkStatsBufferMemory = VK_NULL_HANDLE;
+        Counters* m_MappedStats = nullptr;
+
+        /* Pyramid */
+        VkImageView m_VkDepthView = VK_NULL_HANDLE; // owned by the render target
+        VkExtent2D m_PyramidExtent{};
+        uint32_t m_PyramidLevels = 0;
+        VkImage m_VkPyramidImage = VK_NULL_HANDLE; // stays in GENERAL
+        VkDeviceMemory m_VkPyramidImageMemory = VK_NULL_HANDLE;
+        VkImageView m_VkPyramidView = VK_NULL_HANDLE; // every level, sampled by the cull
+        std::vector<VkImageView> m_VkPyramidLevelViews; // one level each, written by the reduce
+        VkSampler m_VkSampler; // nearest, owned by the SamplerCache
+
+        VkDescriptorSetLayout m_VkCullSetLayout = VK_NULL_HANDLE;
+        VkDescriptorSetLayout m_VkReduceSetLayout = VK_NULL_HANDLE;
+        VkDescriptorPool m_VkDescriptorPool = VK_NULL_HANDLE; // recreated with the pyramid
+        VkDescriptorSet m_VkCullSet = VK_NULL_HANDLE;
+        std::vector<VkDescriptorSet> m_VkReduceSets; // one per level
+        VkPipelineLayout m_VkCullLayout = VK_NULL_HANDLE;
+        VkPipelineLayout m_VkReduceLayout = VK_NULL_HANDLE;
+        VkPipeline m_VkCullPipeline, m_VkReducePipeline; // owned by the PipelineCache
+
+        /* Stats */
+        Counters m_LastCounters{};
+        uint64_t m_FramesCounted = 0;
+        uint64_t m_TotalDrawn = 0, m_TotalFrustumCulled = 0, m_TotalOcclusionCulled = 0;
+    public:
+        /* depthView must be sampleable in DEPTH_STENCIL_READ_ONLY_OPTIMAL --> the first phase pass leaves it there.
+           slotCount counter slots, one per swapchain image like the GpuTimer */
+        OcclusionCuller(const DeviceContext& context, VkBuffer objectBuffer, VkDeviceSize objectBufferSize, uint32_t objectCount, uint32_t slotCount,
+            VkImageView depthView, VkExtent2D depthExtent, PipelineCache& pipelineCache, VkSampler sampler);
+        ~OcclusionCuller();
+        OcclusionCuller(const OcclusionCuller&) = delete;
+        OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+        /* Records both phases --> bind(commandBuffer) sets pipeline, viewport, descriptor sets and the mesh inside each pass, the culler issues the draws */
+        template<typename BindFunction>
+        void Record(VkCommandBuffer commandBuffer, uint32_t slot, const Target& target, const glm::mat4& viewProjection, const Mesh& mesh, BindFunction&& bind) {
+            Cull(commandBuffer, slot, viewProjection, mesh, 0);
+            BeginPass(commandBuffer, target, target.FirstPhasePass);
+            bind(commandBuffer);
+            DrawPhase(commandBuffer, 0);
+            m_DeviceContext.Dispatch->CmdEndRenderPass(commandBuffer);
+            BuildPyramid(commandBuffer, target.RenderExtent);
+            Cull(commandBuffer, slot, viewProjection, mesh, 1);
+            BeginPass(commandBuffer, target, target.SecondPhasePass);
+            bind(commandBuffer);
+            DrawPhase(commandBuffer, 1);
+            m_DeviceContext.Dispatch->CmdEndRenderPass(commandBuffer);
+        }
+        /* Call once the slot's last submission finished --> false when that submission did not cull */
+        bool ReadCounters(uint32_t slot);
+        /* Expects the device to be idle */
+        void Resize(uint32_t slotCount, VkImageView depthView, VkExtent2D depthExtent);
+
+        inline const Counters& GetLastCounters() const { return m_LastCounters; }
+        inline uint32_t GetObjectCount() const { return m_ObjectCount; }
+        void Report() const;
+    private:
+        void Cull(VkCommandBuffer commandBuffer, uint32_t slot, const glm::mat4& viewProjection, const Mesh& mesh, uint32_t phase);
+        void BeginPass(VkCommandBuffer commandBuffer, const Target& target, VkRenderPass renderPass);
+        void DrawPhase(VkCommandBuffer commandBuffer, uint32_t phase);
+        void BuildPyramid(VkCommandBuffer commandBuffer, VkExtent2D renderExtent);
+
+        void CreateLayouts(PipelineCache& pipelineCache);
+        void CreateStatsBuffer();
+        void CreatePyramid(VkExtent2D depthExtent);
+        void DestroyPyramid();
+        void WriteDescriptors();
+    };
+}
\ No newline at end of file
@@ -0,0 +1,347 @@
+#include "PipelineCache.h"
+#include "ShaderCompiler.h"
+#include "Log.h"
+#include "Profiler.h"
+#include <fstream>
+
+namespace VulkanPractice {
+    static shaderc_shader_kind GetShaderKind(VkShaderStageFlagBits stage) {
+        switch (stage) {
+            case VK_SHADER_STAGE_VERTEX_BIT: return shaderc_vertex_shader;
+            case VK_SHADER_STAGE_FRAGMENT_BIT: return shaderc_fragment_shader;
+            case VK_SHADER_STAGE_COMPUTE_BIT: return shaderc_compute_shader;
+            case VK_SHADER_STAGE_GEOMETRY_BIT: return shaderc_geometry_shader;
+            default: throw std::runtime_error("Unsupported shader stage!");
+        }
+    }
+    /* Backing for one stage's VkSpecializationInfo --> must stay put until the create call returns */
+    struct SpecializationStorage {
+        std::vector<VkSpecializationMapEntry> Entries;
+        std::vector<uint32_t> Data;
+        VkSpecializationInfo Info{};
+    };
+    static const VkSpecializationInfo* FillSpecialization(const ShaderStageDesc& stage, SpecializationStorage& storage) {
+        if (stage.Specialization.empty()) return nullptr;
+        for (const auto& constant : stage.Specialization) {
+            VkSpecializationMapEntry entry{};
+            entry.constantID = constant.ConstantId;
+            entry.offset = static_cast<uint32_t>(storage.Data.size() * sizeof(uint32_t));
+            entry.size = sizeof(uint32_t);
+            storage.Entries.push_back(entry);
+            storage.Data.push_back(constant.Value);
+        }
+        storage.Info.mapEntryCount = static_cast<uint32_t>(storage.Entries.size());
+        storage.Info.pMapEntries = storage.Entries.data();
+        storage.Info.dataSize = storage.Data.size() * sizeof(uint32_t);
+        storage.Info.pData = storage.Data.data();
+        return &storage.Info;
+    }
+
+    PipelineCache::PipelineCache(const DeviceContext& context, uint32_t workerCount, MetricsRegistry* metrics)
+        : m_DeviceContext(context)
+    {
+        if (metrics) {
+            m_CompileCounter = &metrics->Counter("pipeline_compiles_total", "Graphics pipelines compiled by the pipeline cache");
+            m_FailureCounter = &metrics->Counter("pipeline_compile_failures_total", "Graphics pipeline compiles that threw");
+            m_CompileTime = &metrics->Histogram("pipeline_compile_milliseconds", "Wall time of one graphics pipeline compile including shader modules", MetricsRegistry::ExponentialBuckets(1.0, 2.0, 12));
+        }
+        VkPipelineCacheCreateInfo cacheInfo{};
+        cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        if (vkCreatePipelineCache(m_DeviceContext.Device, &cacheInfo, m_DeviceContext.Allocator, &m_VkPipelineCache) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create pipeline cache!");
+        }
+        for (uint32_t i = 0; i < workerCount; i++) {
+            m_Workers.emplace_back(&PipelineCache::WorkerMain, this);
+        }
+    }
+    PipelineCache::~PipelineCache() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+        }
+        m_Condition.notify_all();
+        for (auto& worker : m_Workers) worker.join();
+        for (auto& [desc, entry] : m_Entries) {
+            vkDestroyPipeline(m_DeviceContext.Device, entry.Pipeline, m_DeviceContext.Allocator);
+        }
+        for (auto& [key, pipeline] : m_ComputePipelines) {
+            vkDestroyPipeline(m_DeviceContext.Device, pipeline, m_DeviceContext.Allocator);
+        }
+        for (auto& [key, module] : m_ShaderModules) {
+            vkDestroyShaderModule(m_DeviceContext.Device, module, m_DeviceContext.Allocator);
+        }
+        vkDestroyPipelineCache(m_DeviceContext.Device, m_VkPipelineCache, m_DeviceContext.Allocator);
+    }
+
+    VkPipeline PipelineCache::Get(const PipelineDesc& desc, VkPipeline fallback) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto [it, inserted] = m_Entries.try_emplace(desc);
+        if (inserted) {
+            m_Jobs.push_back(&*it);
+            m_Condition.notify_all();
+            return fallback;
+        }
+        return it->second.State == EntryState::Ready ? it->second.Pipeline : fallback;
+    }
+    VkPipeline PipelineCache::GetBlocking(const PipelineDesc& desc) {
+        EntryMap::value_type* node;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            auto [it, inserted] = m_Entries.try_emplace(desc);
+            node = &*it;
+            if (!inserted) {
+                /* Still queued --> take the job over, otherwise a worker owns it and we wait */
+                auto queued = std::find(m_Jobs.begin(), m_Jobs.end(), node);
+                if (queued != m_Jobs.end()) {
+                    m_Jobs.erase(queued);
+                } else {
+                    m_Condition.wait(lock, [node] { return node->second.State != EntryState::Pending; });
+                    if (node->second.State == EntryState::Failed) {
+                        throw std::runtime_error("Failed to create graphics pipeline!");
+                    }
+                    return node->second.Pipeline;
+                }
+            }
+        }
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        try {
+            pipeline = CompileCounted(desc);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            node->second.State = EntryState::Failed;
+            m_Condition.notify_all();
+            throw;
+        }
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        node->second.Pipeline = pipeline;
+        node->second.State = EntryState::Ready;
+        m_Condition.notify_all();
+        return pipeline;
+    }
+    VkPipeline PipelineCache::GetComputeBlocking(const ShaderStageDesc& stage, VkPipelineLayout layout) {
+        std::string key = GetShaderKey(stage) + ":" + std::to_string(reinterpret_cast<uintptr_t>(layout));
+        for (const auto& constant : stage.Specialization) key += ":" + std::to_string(constant.ConstantId) + "=" + std::to_string(constant.Value);
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            auto found = m_ComputePipelines.find(key);
+            if (found != m_ComputePipelines.end()) return found->second;
+        }
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineInfo.stage.module = GetShaderModule(stage);
+        pipelineInfo.stage.pName = stage.EntryPoint.c_str();
+        SpecializationStorage specialization;
+        pipelineInfo.stage.pSpecializationInfo = FillSpecialization(stage, specialization);
+        pipelineInfo.layout = layout;
+        pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineInfo.basePipelineIndex = -1;
+        VkPipeline pipeline;
+        if (vkCreateComputePipelines(m_DeviceContext.Device, m_VkPipelineCache, 1, &pipelineInfo, m_DeviceContext.Allocator, &pipeline) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create compute pipeline!");
+        }
+        /* Same race as the shader modules --> first one wins */
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto [it, inserted] = m_ComputePipelines.emplace(key, pipeline);
+        if (!inserted) vkDestroyPipeline(m_DeviceContext.Device, pipeline, m_DeviceContext.Allocator);
+        return it->second;
+    }
+    size_t PipelineCache::GetPendingCount() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Jobs.size();
+    }
+
+    void PipelineCache::WorkerMain() {
+        while (true) {
+            EntryMap::value_type* node;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Condition.wait(lock, [this] { return m_Stopping || !m_Jobs.empty(); });
+                if (m_Stopping) return;
+                node = m_Jobs.front();
+                m_Jobs.pop_front();
+            }
+            /* Key is immutable inside the map --> safe to read without the lock */
+            VkPipeline pipeline = VK_NULL_HANDLE;
+            EntryState state = EntryState::Ready;
+            try {
+                pipeline = CompileCounted(node->first);
+            } catch (const std::exception& e) {
+                LOG_ERROR("Pipeline {:016x} failed to compile, keeping fallback: {}", node->first.Hash(), e.what());
+                state = EntryState::Failed;
+            }
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            node->second.Pipeline = pipeline;
+            node->second.State = state;
+            m_Condition.notify_all();
+        }
+    }
+
+    VkPipeline PipelineCache::CompileCounted(const PipelineDesc& desc) {
+        if (!m_CompileCounter) return Compile(desc);
+        Timer timer;
+        try {
+            VkPipeline pipeline = Compile(desc);
+            m_CompileCounter->Add();
+            m_CompileTime->Observe(timer.GetElapsedMilliseconds());
+            return pipeline;
+        } catch (...) {
+            m_FailureCounter->Add();
+            throw;
+        }
+    }
+
+    PipelineCache::ShaderCode PipelineCache::CompileShader(const ShaderStageDesc& stage) {
+        std::ifstream file(stage.Path, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open shader " + stage.Path);
+        }
+        std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        return ShaderCompiler::CompileGlsl(source, GetShaderKind(stage.Stage), stage.Path, stage.Defines);
+    }
+    void PipelineCache::AddShaderCode(const ShaderStageDesc& stage, const ShaderCode& code) {
+        CreateShaderModule(GetShaderKey(stage), code);
+    }
+
+    std::string PipelineCache::GetShaderKey(const ShaderStageDesc& stage) {
+        /* Specialization is not part of it --> every value shares the module */
+        std::string key = std::to_string(stage.Stage) + ":" + stage.Path;
+        for (const auto& [name, value] : stage.Defines) key += ":" + name + "=" + value;
+        return key;
+    }
+    VkShaderModule PipelineCache::GetShaderModule(const ShaderStageDesc& stage) {
+        std::string key = GetShaderKey(stage);
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            auto found = m_ShaderModules.find(key);
+            if (found != m_ShaderModules.end()) return found->second;
+        }
+        return CreateShaderModule(key, CompileShader(stage));
+    }
+    VkShaderModule PipelineCache::CreateShaderModule(const std::string& key, const ShaderCode& code) {
+        VkShaderModuleCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        createInfo.codeSize = code.size() * sizeof(uint32_t);
+        createInfo.pCode = code.data();
+        VkShaderModule module;
+        if (vkCreateShaderModule(m_DeviceContext.Device, &createInfo, m_DeviceContext.Allocator, &module) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create shader module!");
+        }
+        /* Two workers may race on the same source --> first one wins */
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto [it, inserted] = m_ShaderModules.emplace(key, module);
+        if (!inserted) vkDestroyShaderModule(m_DeviceContext.Device, module, m_DeviceContext.Allocator);
+        return it->second;
+    }
+
+    VkPipeline PipelineCache::Compile(const PipelineDesc& desc) {
+        std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
+        std::vector<SpecializationStorage> specialization(desc.Shaders.size()); // sized once --> stage infos may point into it
+        for (const auto& shader : desc.Shaders) {
+            VkPipelineShaderStageCreateInfo stageInfo{};
+            stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            stageInfo.stage = shader.Stage;
+            stageInfo.module = GetShaderModule(shader);
+            stageInfo.pName = shader.EntryPoint.c_str();
+            stageInfo.pSpecializationInfo = FillSpecialization(shader, specialization[shaderStages.size()]);
+            shaderStages.push_back(stageInfo);
+        }
+
+        /* Vertex Input */
+        VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(desc.VertexBindings.size());
+        vertexInputInfo.pVertexBindingDescriptions = desc.VertexBindings.data();
+        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(desc.VertexAttributes.size());
+        vertexInputInfo.pVertexAttributeDescriptions = desc.VertexAttributes.data();
+
+        /* Input Assembly */
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology = desc.Topology;
+        inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+        VkPipelineDynamicStateCreateInfo dynamicState{};
+        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicState.dynamicStateCount = static_cast<uint32_t>(desc.DynamicStates.size());
+        dynamicState.pDynamicStates = desc.DynamicStates.data();
+
+        VkPipelineViewportStateCreateInfo viewportState{}; // viewport and scissor are expected to be dynamic
+        viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportState.viewportCount = 1;
+        viewportState.scissorCount = 1;
+
+        /* Raserizer */
+        VkPipelineRasterizationStateCreateInfo rasterizer{};
+        rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterizer.depthClampEnable = VK_FALSE;
+        rasterizer.rasterizerDiscardEnable = VK_FALSE;
+        rasterizer.polygonMode = desc.PolygonMode;
+        rasterizer.lineWidth = 1.0f;
+        rasterizer.cullMode = desc.CullMode;
+        rasterizer.frontFace = desc.FrontFace;
+        rasterizer.depthBiasEnable = desc.DepthBiasEnable ? VK_TRUE : VK_FALSE;
+
+        /* Multisampling */
+        VkPipelineMultisampleStateCreateInfo multisampling{};
+        multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisampling.sampleShadingEnable = VK_FALSE;
+        multisampling.rasterizationSamples = desc.Samples;
+        multisampling.minSampleShading = 1.0f;
+
+        /* Depth */
+        VkPipelineDepthStencilStateCreateInfo depthStencil{};
+        depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depthStencil.depthTestEnable = desc.DepthTestEnable ? VK_TRUE : VK_FALSE;
+        depthStencil.depthWriteEnable = desc.DepthWriteEnable ? VK_TRUE : VK_FALSE;
+        depthStencil.depthCompareOp = desc.DepthCompareOp;
+        depthStencil.minDepthBounds = 0.0f;
+        depthStencil.maxDepthBounds = 1.0f;
+
+        /* Blending */
+        std::vector<VkPipelineColorBlendAttachmentState> blendAttachments;
+        for (const auto& blend : desc.ColorBlend) {
+            VkPipelineColorBlendAttachmentState attachment{};
+            attachment.blendEnable = blend.BlendEnable ? VK_TRUE : VK_FALSE;
+            attachment.srcColorBlendFactor = blend.SrcColorBlendFactor;
+            attachment.dstColorBlendFactor = blend.DstColorBlendFactor;
+            attachment.colorBlendOp = blend.ColorBlendOp;
+            attachment.srcAlphaBlendFactor = blend.SrcAlphaBlendFactor;
+            attachment.dstAlphaBlendFactor = blend.DstAlphaBlendFactor;
+            attachment.alphaBlendOp = blend.AlphaBlendOp;
+            attachment.colorWriteMask = blend.ColorWriteMask;
+            blendAttachments.push_back(attachment);
+        }
+        VkPipelineColorBlendStateCreateInfo colorBlending{};
+        colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colorBlending.logicOpEnable = VK_FALSE;
+        colorBlending.logicOp = VK_LOGIC_OP_COPY;
+        colorBlending.attachmentCount = static_cast<uint32_t>(blendAttachments.size());
+        colorBlending.pAttachments = blendAttachments.data();
+
+        VkGraphicsPipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+        pipelineInfo.pStages = shaderStages.data();
+        pipelineInfo.pVertexInputState = &vertexInputInfo;
+        pipelineInfo.pInputAssemblyState = &inputAssembly;
+        pipelineInfo.pViewportState = &viewportState;
+        pipelineInfo.pRasterizationState = &rasterizer;
+        pipelineInfo.pMultisampleState = &multisampling;
+        pipelineInfo.pDepthStencilState = desc.DepthFormat != VK_FORMAT_UNDEFINED ? &depthStencil : nullptr;
+        pipelineInfo.pColorBlendState = &colorBlending;
+        pipelineInfo.pDynamicState = &dynamicState;
+        pipelineInfo.layout = desc.Layout;
+        pipelineInfo.renderPass = desc.RenderPass;
+        pipelineInfo.subpass = desc.Subpass;
+        pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineInfo.basePipelineIndex = -1;
+
+        VkPipeline pipeline;
+        if (vkCreateGraphicsPipelines(m_DeviceContext.Device, m_VkPipelineCache, 1, &pipelineInfo, m_DeviceContext.Allocator, &pipeline) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create graphics pipeline!");
+        }
+        return pipeline;
+    }
+}
\ No newline at end of file
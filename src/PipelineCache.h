@@ -0,0 +1,71 @@
+#pragma once
+/* This Header caches VkPipelines by PipelineDesc --> misses compile on worker threads while callers draw with a fallback */
+#include "pch.h"
+#include "DeviceContext.h"
+#include "PipelineDesc.h"
+#include "Metrics.h"
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <unordered_map>
+
+namespace VulkanPractice {
+    class PipelineCache {
+    public:
+        using ShaderCode = std::vector<uint32_t>; // SPIR-V words
+    private:
+        enum class EntryState : uint8_t {
+            Pending, Ready, Failed
+        };
+        struct Entry {
+            EntryState State = EntryState::Pending;
+            VkPipeline Pipeline = VK_NULL_HANDLE;
+        };
+        using EntryMap = std::unordered_map<PipelineDesc, Entry, PipelineDescHash>;
+
+        DeviceContext m_DeviceContext;
+        VkPipelineCache m_VkPipelineCache = VK_NULL_HANDLE; // driver side cache shared by every compile
+
+        std::mutex m_Mutex; // guards everything below
+        std::condition_variable m_Condition;
+        EntryMap m_Entries; // node based --> entries stay put while queued
+        std::deque<EntryMap::value_type*> m_Jobs;
+        std::unordered_map<std::string, VkShaderModule> m_ShaderModules; // keyed by stage + path
+        std::unordered_map<std::string, VkPipeline> m_ComputePipelines; // keyed by shader + layout, built on the calling thread
+        bool m_Stopping = false;
+        std::vector<std::thread> m_Workers;
+
+        /* Null without a registry --> counted by whichever thread compiles */
+        MetricCounter* m_CompileCounter = nullptr;
+        MetricCounter* m_FailureCounter = nullptr;
+        MetricHistogram* m_CompileTime = nullptr;
+    public:
+        PipelineCache(const DeviceContext& context, uint32_t workerCount = 1, MetricsRegistry* metrics = nullptr);
+        ~PipelineCache();
+        PipelineCache(const PipelineCache&) = delete;
+        PipelineCache& operator=(const PipelineCache&) = delete;
+
+        /* Never blocks on compilation --> returns fallback while the pipeline is pending or failed */
+        VkPipeline Get(const PipelineDesc& desc, VkPipeline fallback);
+        /* Compiles on the calling thread if needed --> for the fallback itself and init-time pipelines, throws on failure */
+        VkPipeline GetBlocking(const PipelineDesc& desc);
+        /* Compute pipelines are one stage and one layout --> no description, always compiled on the calling thread */
+        VkPipeline GetComputeBlocking(const ShaderStageDesc& stage, VkPipelineLayout layout);
+
+        /* File read + GLSL --> SPIR-V only, needs no device --> can run before the cache exists */
+        static ShaderCode CompileShader(const ShaderStageDesc& stage);
+        /* Hands in SPIR-V compiled ahead of time so pipelines using the stage skip shaderc */
+        void AddShaderCode(const ShaderStageDesc& stage, const ShaderCode& code);
+
+        size_t GetPendingCount();
+    private:
+        void WorkerMain();
+        /* Compile plus the metrics --> rethrows */
+        VkPipeline CompileCounted(const PipelineDesc& desc);
+        VkPipeline Compile(const PipelineDesc& desc);
+        VkShaderModule GetShaderModule(const ShaderStageDesc& stage);
+        VkShaderModule CreateShaderModule(const std::string& key, const ShaderCode& code);
+        static std::string GetShaderKey(const ShaderStageDesc& stage);
+    };
+}
\ No newline at end of file
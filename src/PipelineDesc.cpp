@@ -0,0 +1,92 @@
+#include "PipelineDesc.h"
+#include "Hash.h"
+
+/* Vulkan structs have no comparison --> found by ADL from std::vector::operator== */
+static bool operator==(const VkVertexInputBindingDescription& a, const VkVertexInputBindingDescription& b) {
+    return a.binding == b.binding && a.stride == b.stride && a.inputRate == b.inputRate;
+}
+static bool operator==(const VkVertexInputAttributeDescription& a, const VkVertexInputAttributeDescription& b) {
+    return a.location == b.location && a.binding == b.binding && a.format == b.format && a.offset == b.offset;
+}
+
+namespace VulkanPractice {
+    bool ColorBlendDesc::operator==(const ColorBlendDesc& other) const {
+        return BlendEnable == other.BlendEnable &&
+            SrcColorBlendFactor == other.SrcColorBlendFactor && DstColorBlendFactor == other.DstColorBlendFactor && ColorBlendOp == other.ColorBlendOp &&
+            SrcAlphaBlendFactor == other.SrcAlphaBlendFactor && DstAlphaBlendFactor == other.DstAlphaBlendFactor && AlphaBlendOp == other.AlphaBlendOp &&
+            ColorWriteMask == other.ColorWriteMask;
+    }
+
+    uint64_t PipelineDesc::Hash() const {
+        Fnv1a hasher;
+        hasher.Add(static_cast<uint64_t>(Shaders.size()));
+        for (const auto& shader : Shaders) {
+            hasher.Add(shader.Stage);
+            hasher.Add(shader.Path);
+            hasher.Add(shader.EntryPoint);
+            hasher.Add(static_cast<uint64_t>(shader.Defines.size()));
+            for (const auto& [name, value] : shader.Defines) {
+                hasher.Add(name);
+                hasher.Add(value);
+            }
+            hasher.Add(static_cast<uint64_t>(shader.Specialization.size()));
+            for (const auto& constant : shader.Specialization) {
+                hasher.Add(constant.ConstantId);
+                hasher.Add(constant.Value);
+            }
+        }
+        hasher.Add(static_cast<uint64_t>(VertexBindings.size()));
+        for (const auto& binding : VertexBindings) {
+            hasher.Add(binding.binding);
+            hasher.Add(binding.stride);
+            hasher.Add(binding.inputRate);
+        }
+        hasher.Add(static_cast<uint64_t>(VertexAttributes.size()));
+        for (const auto& attribute : VertexAttributes) {
+            hasher.Add(attribute.location);
+            hasher.Add(attribute.binding);
+            hasher.Add(attribute.format);
+            hasher.Add(attribute.offset);
+        }
+        hasher.Add(Topology);
+        hasher.Add(PolygonMode);
+        hasher.Add(CullMode);
+        hasher.Add(FrontFace);
+        hasher.Add(DepthBiasEnable);
+        hasher.Add(DepthTestEnable);
+        hasher.Add(DepthWriteEnable);
+        hasher.Add(DepthCompareOp);
+        hasher.Add(static_cast<uint64_t>(ColorBlend.size()));
+        for (const auto& blend : ColorBlend) {
+            hasher.Add(blend.BlendEnable);
+            hasher.Add(blend.SrcColorBlendFactor);
+            hasher.Add(blend.DstColorBlendFactor);
+            hasher.Add(blend.ColorBlendOp);
+            hasher.Add(blend.SrcAlphaBlendFactor);
+            hasher.Add(blend.DstAlphaBlendFactor);
+            hasher.Add(blend.AlphaBlendOp);
+            hasher.Add(blend.ColorWriteMask);
+        }
+        hasher.Add(static_cast<uint64_t>(ColorFormats.size()));
+        for (VkFormat format : ColorFormats) hasher.Add(format);
+        hasher.Add(DepthFormat);
+        hasher.Add(Samples);
+        hasher.Add(static_cast<uint64_t>(DynamicStates.size()));
+        for (VkDynamicState state : DynamicStates) hasher.Add(state);
+        hasher.Add(reinterpret_cast<uint64_t>(Layout));
+        hasher.Add(reinterpret_cast<uint64_t>(RenderPass));
+        hasher.Add(Subpass);
+        return hasher.Get();
+    }
+
+    bool PipelineDesc::operator==(const PipelineDesc& other) const {
+        return Shaders == other.Shaders &&
+            VertexBindings == other.VertexBindings && VertexAttributes == other.VertexAttributes && Topology == other.Topology &&
+            PolygonMode == other.PolygonMode && CullMode == other.CullMode && FrontFace == other.FrontFace && DepthBiasEnable == other.DepthBiasEnable &&
+            DepthTestEnable == other.DepthTestEnable && DepthWriteEnable == other.DepthWriteEnable && DepthCompareOp == other.DepthCompareOp &&
+            ColorBlend == other.ColorBlend &&
+            ColorFormats == other.ColorFormats && DepthFormat == other.DepthFormat && Samples == other.Samples &&
+            DynamicStates == other.DynamicStates &&
+            Layout == other.Layout && RenderPass == other.RenderPass && Subpass == other.Subpass;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+/* This Header describes a graphics pipeline as a plain value --> hashable key for the PipelineCache */
+#include "pch.h"
+#include "DeviceContext.h"
+
+namespace VulkanPractice {
+    /* 32 bit constant_id value --> VkBool32, int, uint or the bits of a float */
+    struct SpecializationValue {
+        uint32_t ConstantId;
+        uint32_t Value;
+
+        bool operator==(const SpecializationValue& other) const { return ConstantId == other.ConstantId && Value == other.Value; }
+    };
+    struct ShaderStageDesc {
+        VkShaderStageFlagBits Stage = VK_SHADER_STAGE_VERTEX_BIT;
+        std::string Path; // GLSL source, compiled through ShaderCompiler
+        std::string EntryPoint = "main";
+        std::vector<std::pair<std::string, std::string>> Defines{}; // compile time --> every distinct set is its own SPIR-V module
+        std::vector<SpecializationValue> Specialization{}; // pipeline time --> one module serves every value
+
+        bool operator==(const ShaderStageDesc& other) const {
+            return Stage == other.Stage && Path == other.Path && EntryPoint == other.EntryPoint &&
+                Defines == other.Defines && Specialization == other.Specialization;
+        }
+    };
+    struct ColorBlendDesc {
+        bool BlendEnable = false;
+        VkBlendFactor SrcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        VkBlendFactor DstColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+        VkBlendOp ColorBlendOp = VK_BLEND_OP_ADD;
+        VkBlendFactor SrcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        VkBlendFactor DstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        VkBlendOp AlphaBlendOp = VK_BLEND_OP_ADD;
+        VkColorComponentFlags ColorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+        bool operator==(const ColorBlendDesc& other) const;
+    };
+
+    struct PipelineDesc {
+        std::vector<ShaderStageDesc> Shaders;
+
+        /* Vertex Input */
+        std::vector<VkVertexInputBindingDescription> VertexBindings;
+        std::vector<VkVertexInputAttributeDescription> VertexAttributes;
+        VkPrimitiveTopology Topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        /* Raserizer */
+        VkPolygonMode PolygonMode = VK_POLYGON_MODE_FILL;
+        VkCullModeFlags CullMode = VK_CULL_MODE_BACK_BIT;
+        VkFrontFace FrontFace = VK_FRONT_FACE_CLOCKWISE;
+        bool DepthBiasEnable = false;
+
+        /* Depth */
+        bool DepthTestEnable = false;
+        bool DepthWriteEnable = false;
+        VkCompareOp DepthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+
+        /* Blending --> one entry per color target */
+        std::vector<ColorBlendDesc> ColorBlend = { ColorBlendDesc() };
+
+        /* Render Targets */
+        std::vector<VkFormat> ColorFormats;
+        VkFormat DepthFormat = VK_FORMAT_UNDEFINED;
+        VkSampleCountFlagBits Samples = VK_SAMPLE_COUNT_1_BIT;
+
+        std::vector<VkDynamicState> DynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+
+        /* Handles the pipeline is compatible with --> part of the key by value */
+        VkPipelineLayout Layout = VK_NULL_HANDLE;
+        VkRenderPass RenderPass = VK_NULL_HANDLE;
+        uint32_t Subpass = 0;
+
+        /* FNV-1a over every field --> same description gives the same value on every platform and run */
+        uint64_t Hash() const;
+        bool operator==(const PipelineDesc& other) const;
+    };
+    struct PipelineDescHash {
+        size_t operator()(const PipelineDesc& desc) const { return static_cast<size_t>(desc.Hash()); }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#include "Profiler.h"
+#include "Log.h"
+
+namespace VulkanPractice {
+    void PhaseProfiler::Record(const std::string& name, double startMilliseconds, double durationMilliseconds) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Phases.push_back({ name, startMilliseconds, durationMilliseconds, std::this_thread::get_id() });
+    }
+    void PhaseProfiler::Report(const std::string& title) {
+        std::vector<Phase> phases;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            phases = m_Phases;
+        }
+        std::sort(phases.begin(), phases.end(), [](const Phase& a, const Phase& b) { return a.StartMilliseconds < b.StartMilliseconds; });
+        /* Threads are numbered in order of their first phase --> thread 0 is whoever started first */
+        std::vector<std::thread::id> threads;
+        double end = 0.0, busy = 0.0;
+        for (const auto& phase : phases) {
+            if (std::find(threads.begin(), threads.end(), phase.Thread) == threads.end()) threads.push_back(phase.Thread);
+            end = std::max(end, phase.StartMilliseconds + phase.DurationMilliseconds);
+            busy += phase.DurationMilliseconds;
+        }
+        LOG_INFO("{}: {:.2f} ms wall, {:.2f} ms summed over {} phases", title, end, busy, phases.size());
+        for (const auto& phase : phases) {
+            size_t thread = std::find(threads.begin(), threads.end(), phase.Thread) - threads.begin();
+            LOG_INFO("  [t{}] {:8.2f} -> {:8.2f} ms  {:8.2f} ms  {}", thread, phase.StartMilliseconds,
+                phase.StartMilliseconds + phase.DurationMilliseconds, phase.DurationMilliseconds, phase.Name);
+        }
+    }
+}
\ No newline at end of file
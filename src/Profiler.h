@@ -0,0 +1,50 @@
+#pragma once
+/* This Header handles wall clock timing --> Timer for single measurements, PhaseProfiler for named phases across threads */
+#include "pch.h"
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace VulkanPractice {
+    class Timer {
+    private:
+        std::chrono::steady_clock::time_point m_Start = std::chrono::steady_clock::now();
+    public:
+        inline void Reset() { m_Start = std::chrono::steady_clock::now(); }
+        inline double GetElapsedMilliseconds() const {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_Start).count();
+        }
+    };
+
+    class PhaseProfiler {
+    private:
+        struct Phase {
+            std::string Name;
+            double StartMilliseconds, DurationMilliseconds;
+            std::thread::id Thread;
+        };
+        Timer m_Origin; // every phase start is relative to construction
+        std::mutex m_Mutex; // phases may finish on any thread
+        std::vector<Phase> m_Phases;
+    public:
+        /* Runs function and records it as a phase --> exceptions pass through unrecorded */
+        template<typename Function>
+        decltype(auto) Measure(const std::string& name, Function&& function) {
+            double start = m_Origin.GetElapsedMilliseconds();
+            struct Recorder {
+                PhaseProfiler& Profiler;
+                const std::string& Name;
+                double Start;
+                ~Recorder() {
+                    if (std::uncaught_exceptions() == 0) Profiler.Record(Name, Start, Profiler.m_Origin.GetElapsedMilliseconds() - Start);
+                }
+            } recorder{ *this, name, start };
+            return function();
+        }
+        void Record(const std::string& name, double startMilliseconds, double durationMilliseconds);
+        /* Logs phases in start order with their thread --> overlapping rows ran in parallel */
+        void Report(const std::string& title);
+
+        inline double GetElapsedMilliseconds() const { return m_Origin.GetElapsedMilliseconds(); }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,290 @@
+#include "Renderer2D.h"
+#include "VulkanUtils.h"
+#include "ShaderTypes.h"
+#include "Hash.h"
+#include <cstring>
+
+namespace VulkanPractice {
+    Renderer2D::Renderer2D(const DeviceContext& context, PipelineCache& pipelineCache, VkSampler sampler, VkRenderPass renderPass,
+        VkFormat colorFormat, VkFormat depthFormat, uint32_t regionCount, uint32_t maxQuads)
+        : m_DeviceContext(context), m_MaxQuads(maxQuads), m_RegionCount(regionCount), m_VkSampler(sampler)
+    {
+        m_RegionSize = static_cast<VkDeviceSize>(m_MaxQuads) * 4 * sizeof(Vertex);
+        CreateBuffers();
+        CreatePipeline(pipelineCache, renderPass, colorFormat, depthFormat);
+
+        /* Plain quads sample white --> one shader path for solid and textured */
+        TextureDesc whiteDesc;
+        whiteDesc.Format = VK_FORMAT_R8G8B8A8_UNORM;
+        whiteDesc.GenerateMips = false;
+        const uint8_t white[4] = { 255, 255, 255, 255 };
+        m_WhiteTexture = std::make_unique<Texture>(context, whiteDesc, white, sizeof(white));
+        m_WhiteTexture->WaitForUpload();
+        AddTexture(m_WhiteTexture->GetImageView()); // s_WhiteTexture
+        m_Font = std::make_unique<SdfFont>(context);
+        m_FontTexture = AddTexture(m_Font->GetTexture().GetImageView());
+        m_Quads.reserve(256);
+    }
+    Renderer2D::~Renderer2D() {
+        DestroyVertexBuffer();
+        vkDestroyBuffer(m_DeviceContext.Device, m_VkIndexBuffer, m_DeviceContext.Allocator);
+        vkFreeMemory(m_DeviceContext.Device, m_VkIndexBufferMemory, m_DeviceContext.Allocator);
+        vkDestroyPipelineLayout(m_DeviceContext.Device, m_VkPipelineLayout, m_DeviceContext.Allocator);
+        vkDestroyDescriptorPool(m_DeviceContext.Device, m_VkDescriptorPool, m_DeviceContext.Allocator); // frees the sets
+        vkDestroyDescriptorSetLayout(m_DeviceContext.Device, m_VkDescriptorSetLayout, m_DeviceContext.Allocator);
+    }
+
+    Renderer2D::TextureId Renderer2D::AddTexture(VkImageView imageView) {
+        if (m_TextureSets.size() >= s_MaxTextures) {
+            throw std::runtime_error("Renderer2D has no texture slots left!");
+        }
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_VkDescriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &m_VkDescriptorSetLayout;
+        VkDescriptorSet set;
+        if (vkAllocateDescriptorSets(m_DeviceContext.Device, &allocInfo, &set) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate 2D texture descriptor set!");
+        }
+        VkDescriptorImageInfo imageDescriptor{};
+        imageDescriptor.sampler = m_VkSampler;
+        imageDescriptor.imageView = imageView;
+        imageDescriptor.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = 0;
+        write.dstArrayElement = 0;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.descriptorCount = 1;
+        write.pImageInfo = &imageDescriptor;
+        vkUpdateDescriptorSets(m_DeviceContext.Device, 1, &write, 0, nullptr);
+        m_TextureSets.push_back(set);
+        return static_cast<TextureId>(m_TextureSets.size() - 1);
+    }
+    void Renderer2D::Resize(uint32_t regionCount) {
+        if (regionCount == m_RegionCount) return;
+        DestroyVertexBuffer();
+        m_RegionCount = regionCount;
+        CreateBuffers();
+    }
+
+    void Renderer2D::Begin(VkExtent2D extent) {
+        m_Extent = extent;
+        m_Quads.clear();
+    }
+    void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color, int32_t layer,
+        TextureId texture, const glm::vec2& uvMin, const glm::vec2& uvMax) {
+        uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(layer) ^ 0x80000000u) << 32) | texture; // sign flipped --> negative layers sort first
+        PushQuad(key, position, size, PackColor(color), s_ModeTexture, uvMin, uvMax);
+    }
+    float Renderer2D::DrawText(const glm::vec2& position, std::string_view text, float height, const glm::vec4& color, int32_t layer) {
+        /* Cells are drawn with their distance padding --> the glyph itself lands on position */
+        uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(layer) ^ 0x80000000u) << 32) | m_FontTexture;
+        uint32_t packed = PackColor(color);
+        float cellHeight = height / (1.0f - m_Font->GetSpread());
+        glm::vec2 cellSize(cellHeight * m_Font->GetCellAspect(), cellHeight);
+        glm::vec2 padding(cellHeight * m_Font->GetSpread() * 0.5f);
+        float advance = cellHeight * m_Font->GetAdvance();
+        glm::vec2 pen = position - padding;
+        for (char character : text) {
+            if (character != ' ') {
+                const SdfGlyph& glyph = m_Font->GetGlyph(character);
+                PushQuad(key, pen, cellSize, packed, s_ModeSdf, glm::vec2(glyph.UvMin[0], glyph.UvMin[1]), glm::vec2(glyph.UvMax[0], glyph.UvMax[1]));
+            }
+            pen.x += advance;
+        }
+        return advance * static_cast<float>(text.size());
+    }
+    float Renderer2D::MeasureText(std::string_view text, float height) const {
+        return height / (1.0f - m_Font->GetSpread()) * m_Font->GetAdvance() * static_cast<float>(text.size());
+    }
+
+    void Renderer2D::Record(VkCommandBuffer commandBuffer, uint32_t region) {
+        m_Stats = Renderer2DStats();
+        if (m_Quads.empty()) return;
+        /* Sort keys only --> the vertices move once, straight into mapped memory */
+        m_Order.clear();
+        for (uint32_t i = 0; i < m_Quads.size(); i++) m_Order.push_back({ m_Quads[i].Key, i });
+        std::sort(m_Order.begin(), m_Order.end(), [](const SortEntry& a, const SortEntry& b) { return a.Key != b.Key ? a.Key < b.Key : a.Quad < b.Quad; });
+        auto* vertices = reinterpret_cast<Vertex*>(m_Mapped + m_RegionSize * region);
+        for (size_t i = 0; i < m_Order.size(); i++) std::memcpy(vertices + i * 4, m_Quads[m_Order[i].Quad].Corners, sizeof(Quad::Corners));
+
+        const DeviceDispatch& dispatch = *m_DeviceContext.Dispatch;
+        dispatch.CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_VkPipeline);
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = static_cast<float>(m_Extent.width);
+        viewport.height = static_cast<float>(m_Extent.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        dispatch.CmdSetViewport(commandBuffer, 0, 1, &viewport);
+        VkRect2D scissor{};
+        scissor.offset = { 0, 0 };
+        scissor.extent = m_Extent;
+        dispatch.CmdSetScissor(commandBuffer, 0, 1, &scissor);
+        Batch2DPushConstants constants{};
+        constants.Scale = glm::vec2(2.0f / static_cast<float>(m_Extent.width), 2.0f / static_cast<float>(m_Extent.height));
+        dispatch.CmdPushConstants(commandBuffer, m_VkPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+        VkDeviceSize offset = m_RegionSize * region;
+        dispatch.CmdBindVertexBuffers(commandBuffer, 0, 1, &m_VkVertexBuffer, &offset);
+        dispatch.CmdBindIndexBuffer(commandBuffer, m_VkIndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+
+        /* Layers only order, they never split a run --> one draw per change of texture */
+        uint32_t runStart = 0;
+        TextureId bound = ~0u;
+        for (uint32_t i = 1; i <= m_Order.size(); i++) {
+            TextureId texture = static_cast<TextureId>(m_Order[runStart].Key & 0xffffffffu);
+            if (i < m_Order.size() && static_cast<TextureId>(m_Order[i].Key & 0xffffffffu) == texture) continue;
+            if (texture != bound) {
+                dispatch.CmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_VkPipelineLayout, 0, 1, &m_TextureSets[texture], 0, nullptr);
+                bound = texture;
+                m_Stats.TextureBinds++;
+            }
+            dispatch.CmdDrawIndexed(commandBuffer, (i - runStart) * 6, 1, runStart * 6, 0, 0);
+            m_Stats.DrawCalls++;
+            runStart = i;
+        }
+        m_Stats.Quads = static_cast<uint32_t>(m_Order.size());
+        m_Stats.Vertices = m_Stats.Quads * 4;
+    }
+
+    uint64_t Renderer2D::Hash() const {
+        Fnv1a hasher;
+        hasher.Add(m_Extent.width);
+        hasher.Add(m_Extent.height);
+        hasher.Add(static_cast<uint64_t>(m_Quads.size()));
+        for (const Quad& quad : m_Quads) {
+            hasher.Add(quad.Key);
+            hasher.Add(quad.Corners, sizeof(quad.Corners)); // floats and packed words --> no padding
+        }
+        return hasher.Get();
+    }
+
+    void Renderer2D::CreateBuffers() {
+        /* Written once per recorded frame */
+        VkDeviceSize vertexSize = m_RegionSize * m_RegionCount;
+        VulkanUtils::CreateHostVisibleBuffer(
+            m_DeviceContext, vertexSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            m_VkVertexBuffer, m_VkVertexBufferMemory
+        );
+        void* mapped;
+        if (vkMapMemory(m_DeviceContext.Device, m_VkVertexBufferMemory, 0, VK_WHOLE_SIZE, 0, &mapped) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to map 2D vertex buffer!");
+        }
+        m_Mapped = static_cast<uint8_t*>(mapped);
+        if (m_VkIndexBuffer != VK_NULL_HANDLE) return;
+
+        /* Same pattern for every quad --> written once, shared by every region */
+        VkDeviceSize indexSize = static_cast<VkDeviceSize>(m_MaxQuads) * 6 * sizeof(uint32_t);
+        VulkanUtils::CreateBuffer(
+            m_DeviceContext, indexSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            m_VkIndexBuffer, m_VkIndexBufferMemory
+        );
+        void* indexData;
+        if (vkMapMemory(m_DeviceContext.Device, m_VkIndexBufferMemory, 0, VK_WHOLE_SIZE, 0, &indexData) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to map 2D index buffer!");
+        }
+        auto* indices = static_cast<uint32_t*>(indexData);
+        for (uint32_t quad = 0; quad < m_MaxQuads; quad++) {
+            const uint32_t corners[6] = { 0, 1, 2, 2, 3, 0 };
+            for (uint32_t i = 0; i < 6; i++) indices[quad * 6 + i] = quad * 4 + corners[i];
+        }
+        vkUnmapMemory(m_DeviceContext.Device, m_VkIndexBufferMemory);
+    }
+    void Renderer2D::DestroyVertexBuffer() {
+        vkUnmapMemory(m_DeviceContext.Device, m_VkVertexBufferMemory);
+        vkDestroyBuffer(m_DeviceContext.Device, m_VkVertexBuffer, m_DeviceContext.Allocator);
+        vkFreeMemory(m_DeviceContext.Device, m_VkVertexBufferMemory, m_DeviceContext.Allocator);
+        m_Mapped = nullptr;
+    }
+    void Renderer2D::CreatePipeline(PipelineCache& pipelineCache, VkRenderPass renderPass, VkFormat colorFormat, VkFormat depthFormat) {
+        VkDescriptorSetLayoutBinding binding{};
+        binding.binding = 0;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        binding.descriptorCount = 1;
+        binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = 1;
+        layoutInfo.pBindings = &binding;
+        if (vkCreateDescriptorSetLayout(m_DeviceContext.Device, &layoutInfo, m_DeviceContext.Allocator, &m_VkDescriptorSetLayout) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create 2D descriptor set layout!");
+        }
+        VkDescriptorPoolSize poolSize{};
+        poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        poolSize.descriptorCount = s_MaxTextures;
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        poolInfo.maxSets = s_MaxTextures;
+        if (vkCreateDescriptorPool(m_DeviceContext.Device, &poolInfo, m_DeviceContext.Allocator, &m_VkDescriptorPool) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create 2D descriptor pool!");
+        }
+
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(Batch2DPushConstants);
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &m_VkDescriptorSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+        if (vkCreatePipelineLayout(m_DeviceContext.Device, &pipelineLayoutInfo, m_DeviceContext.Allocator, &m_VkPipelineLayout) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create 2D pipeline layout!");
+        }
+
+        PipelineDesc desc;
+        desc.Shaders = {
+            { VK_SHADER_STAGE_VERTEX_BIT, std::string(SHADER_DIR) + "/GLSL/batch2d.vert" },
+            { VK_SHADER_STAGE_FRAGMENT_BIT, std::string(SHADER_DIR) + "/GLSL/batch2d.frag" }
+        };
+        VkVertexInputBindingDescription vertexBinding{};
+        vertexBinding.binding = 0;
+        vertexBinding.stride = sizeof(Vertex);
+        vertexBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        desc.VertexBindings = { vertexBinding };
+        desc.VertexAttributes = {
+            { 0, 0, VK_FORMAT_R32G32_SFLOAT, static_cast<uint32_t>(offsetof(Vertex, Position)) },
+            { 1, 0, VK_FORMAT_R32G32_SFLOAT, static_cast<uint32_t>(offsetof(Vertex, TexCoord)) },
+            { 2, 0, VK_FORMAT_R8G8B8A8_UNORM, static_cast<uint32_t>(offsetof(Vertex, Color)) },
+            { 3, 0, VK_FORMAT_R32_UINT, static_cast<uint32_t>(offsetof(Vertex, Mode)) }
+        };
+        desc.CullMode = VK_CULL_MODE_NONE; // quads are wound either way once y points down
+        desc.ColorBlend[0].BlendEnable = true;
+        desc.ColorBlend[0].SrcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        desc.ColorBlend[0].DstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        desc.ColorBlend[0].SrcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        desc.ColorBlend[0].DstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        desc.ColorFormats = { colorFormat };
+        desc.DepthFormat = depthFormat; // attachment of the pass, neither tested nor written
+        desc.Layout = m_VkPipelineLayout;
+        desc.RenderPass = renderPass;
+        m_VkPipeline = pipelineCache.GetBlocking(desc);
+    }
+
+    void Renderer2D::PushQuad(uint64_t key, const glm::vec2& position, const glm::vec2& size, uint32_t color, uint32_t mode, const glm::vec2& uvMin, const glm::vec2& uvMax) {
+        if (m_Quads.size() >= m_MaxQuads) {
+            throw std::runtime_error("Renderer2D is out of quads for this frame!");
+        }
+        Quad& quad = m_Quads.emplace_back();
+        quad.Key = key;
+        /* Clockwise from the top left */
+        const glm::vec2 corners[4] = { position, { position.x + size.x, position.y }, position + size, { position.x, position.y + size.y } };
+        const glm::vec2 uvs[4] = { uvMin, { uvMax.x, uvMin.y }, uvMax, { uvMin.x, uvMax.y } };
+        for (int i = 0; i < 4; i++) {
+            quad.Corners[i] = { { corners[i].x, corners[i].y }, { uvs[i].x, uvs[i].y }, color, mode };
+        }
+    }
+    uint32_t Renderer2D::PackColor(const glm::vec4& color) {
+        auto channel = [](float value) { return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f); };
+        return channel(color.x) | (channel(color.y) << 8) | (channel(color.z) << 16) | (channel(color.w) << 24);
+    }
+}
\ No newline at end of file
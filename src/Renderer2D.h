@@ -0,0 +1,101 @@
+#pragma once
+/* This Header handles batched 2D drawing --> quads and SDF text collect per frame, sort by layer then texture, and flush from one persistently mapped vertex stream */
+#include "pch.h"
+#include "DeviceContext.h"
+#include "PipelineCache.h"
+#include "SdfFont.h"
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include <string_view>
+
+namespace VulkanPractice {
+    struct Renderer2DStats {
+        uint32_t Quads = 0;
+        uint32_t Vertices = 0;
+        uint32_t DrawCalls = 0;
+        uint32_t TextureBinds = 0;
+    };
+
+    class Renderer2D {
+    public:
+        using TextureId = uint32_t;
+        inline static constexpr TextureId s_WhiteTexture = 0;
+        struct Vertex {
+            float Position[2]; // pixels, origin top left
+            float TexCoord[2];
+            uint32_t Color; // RGBA8, R in the lowest byte
+            uint32_t Mode; // plain texture or SDF glyph
+        };
+    private:
+        inline static constexpr uint32_t s_ModeTexture = 0, s_ModeSdf = 1;
+        inline static constexpr uint32_t s_MaxTextures = 16;
+        struct Quad {
+            uint64_t Key; // layer then texture --> sort order, quads with equal keys keep submission order
+            Vertex Corners[4];
+        };
+        struct SortEntry {
+            uint64_t Key;
+            uint32_t Quad;
+        };
+
+        DeviceContext m_DeviceContext;
+        uint32_t m_MaxQuads, m_RegionCount;
+        VkDeviceSize m_RegionSize;
+        VkBuffer m_VkVertexBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory m_VkVertexBufferMemory = VK_NULL_HANDLE;
+        uint8_t* m_Mapped = nullptr; // mapped once for the lifetime of the buffer
+        VkBuffer m_VkIndexBuffer = VK_NULL_HANDLE; // 0 1 2 2 3 0 per quad, written once
+        VkDeviceMemory m_VkIndexBufferMemory = VK_NULL_HANDLE;
+
+        VkSampler m_VkSampler; // owned by the SamplerCache
+        VkDescriptorSetLayout m_VkDescriptorSetLayout = VK_NULL_HANDLE;
+        VkDescriptorPool m_VkDescriptorPool = VK_NULL_HANDLE;
+        std::vector<VkDescriptorSet> m_TextureSets; // by TextureId
+        VkPipelineLayout m_VkPipelineLayout = VK_NULL_HANDLE;
+        VkPipeline m_VkPipeline = VK_NULL_HANDLE; // owned by the PipelineCache
+
+        std::unique_ptr<Texture> m_WhiteTexture;
+        std::unique_ptr<SdfFont> m_Font;
+        TextureId m_FontTexture;
+
+        VkExtent2D m_Extent{};
+        std::vector<Quad> m_Quads; // kept across frames --> no per frame allocation once grown
+        std::vector<SortEntry> m_Order;
+        Renderer2DStats m_Stats;
+    public:
+        /* renderPass is the pass the batch draws in --> its attachments must have colorFormat and depthFormat.
+           One vertex region per regionCount --> the caller picks a region no submitted frame still reads */
+        Renderer2D(const DeviceContext& context, PipelineCache& pipelineCache, VkSampler sampler, VkRenderPass renderPass,
+            VkFormat colorFormat, VkFormat depthFormat, uint32_t regionCount, uint32_t maxQuads = 4096);
+        ~Renderer2D();
+        Renderer2D(const Renderer2D&) = delete;
+        Renderer2D& operator=(const Renderer2D&) = delete;
+
+        /* The view must outlive the renderer */
+        TextureId AddTexture(VkImageView imageView);
+        /* Expects the device to be idle */
+        void Resize(uint32_t regionCount);
+
+        /* Drops last frame's quads --> extent is the pixel space of everything drawn until Record */
+        void Begin(VkExtent2D extent);
+        /* Higher layers draw on top, quads within a layer in no particular order across textures */
+        void DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color, int32_t layer = 0,
+            TextureId texture = s_WhiteTexture, const glm::vec2& uvMin = glm::vec2(0.0f), const glm::vec2& uvMax = glm::vec2(1.0f));
+        /* position is the top left of the first glyph, height the glyph height in pixels --> returns the pen advance */
+        float DrawText(const glm::vec2& position, std::string_view text, float height, const glm::vec4& color, int32_t layer = 0);
+        float MeasureText(std::string_view text, float height) const;
+        /* Inside a render pass compatible with the one passed at creation --> sorts, fills the region and draws one call per texture run */
+        void Record(VkCommandBuffer commandBuffer, uint32_t region);
+
+        /* Everything Record depends on --> part of a cached command buffer's key */
+        uint64_t Hash() const;
+        /* Of the last Record */
+        inline const Renderer2DStats& GetStats() const { return m_Stats; }
+    private:
+        void CreateBuffers();
+        void DestroyVertexBuffer();
+        void CreatePipeline(PipelineCache& pipelineCache, VkRenderPass renderPass, VkFormat colorFormat, VkFormat depthFormat);
+        void PushQuad(uint64_t key, const glm::vec2& position, const glm::vec2& size, uint32_t color, uint32_t mode, const glm::vec2& uvMin, const glm::vec2& uvMax);
+        static uint32_t PackColor(const glm::vec4& color);
+    };
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "SamplerCache.h"
+#include <cstring>
+
+namespace VulkanPractice {
+    static void HashCombine(size_t& seed, size_t value) {
+        seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+    static size_t HashFloat(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return std::hash<uint32_t>()(bits);
+    }
+
+    bool SamplerDesc::operator==(const SamplerDesc& other) const {
+        return MagFilter == other.MagFilter && MinFilter == other.MinFilter && MipmapMode == other.MipmapMode &&
+            AddressModeU == other.AddressModeU && AddressModeV == other.AddressModeV && AddressModeW == other.AddressModeW &&
+            MaxAnisotropy == other.MaxAnisotropy && MipLodBias == other.MipLodBias &&
+            MinLod == other.MinLod && MaxLod == other.MaxLod && BorderColor == other.BorderColor &&
+            CompareEnable == other.CompareEnable && CompareOp == other.CompareOp;
+    }
+    size_t SamplerDescHash::operator()(const SamplerDesc& desc) const {
+        size_t seed = 0;
+        HashCombine(seed, static_cast<size_t>(desc.MagFilter) | (static_cast<size_t>(desc.MinFilter) << 4) | (static_cast<size_t>(desc.MipmapMode) << 8));
+        HashCombine(seed, static_cast<size_t>(desc.AddressModeU) | (static_cast<size_t>(desc.AddressModeV) << 4) | (static_cast<size_t>(desc.AddressModeW) << 8));
+        HashCombine(seed, HashFloat(desc.MaxAnisotropy));
+        HashCombine(seed, HashFloat(desc.MipLodBias));
+        HashCombine(seed, HashFloat(desc.MinLod));
+        HashCombine(seed, HashFloat(desc.MaxLod));
+        HashCombine(seed, static_cast<size_t>(desc.BorderColor) | (static_cast<size_t>(desc.CompareEnable) << 4) | (static_cast<size_t>(desc.CompareOp) << 8));
+        return seed;
+    }
+
+    SamplerCache::SamplerCache(const DeviceContext& context)
+        : m_DeviceContext(context)
+    {
+    }
+    SamplerCache::~SamplerCache() {
+        for (auto& [desc, sampler] : m_Samplers) {
+            vkDestroySampler(m_DeviceContext.Device, sampler, m_DeviceContext.Allocator);
+        }
+    }
+
+    VkSampler SamplerCache::Get(const SamplerDesc& requested) {
+        SamplerDesc desc = Normalize(requested);
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto found = m_Samplers.find(desc);
+        if (found != m_Samplers.end()) return found->second;
+
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = desc.MagFilter;
+        samplerInfo.minFilter = desc.MinFilter;
+        samplerInfo.mipmapMode = desc.MipmapMode;
+        samplerInfo.addressModeU = desc.AddressModeU;
+        samplerInfo.addressModeV = desc.AddressModeV;
+        samplerInfo.addressModeW = desc.AddressModeW;
+        samplerInfo.mipLodBias = desc.MipLodBias;
+        samplerInfo.anisotropyEnable = desc.MaxAnisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+        samplerInfo.maxAnisotropy = desc.MaxAnisotropy;
+        samplerInfo.compareEnable = desc.CompareEnable ? VK_TRUE : VK_FALSE;
+        samplerInfo.compareOp = desc.CompareOp;
+        samplerInfo.minLod = desc.MinLod;
+        samplerInfo.maxLod = desc.MaxLod;
+        samplerInfo.borderColor = desc.BorderColor;
+        samplerInfo.unnormalizedCoordinates = VK_FALSE;
+        VkSampler sampler;
+        if (vkCreateSampler(m_DeviceContext.Device, &samplerInfo, m_DeviceContext.Allocator, &sampler) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create texture sampler!");
+        }
+        m_Samplers.emplace(desc, sampler);
+        return sampler;
+    }
+    size_t SamplerCache::GetSamplerCount() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Samplers.size();
+    }
+
+    SamplerDesc SamplerCache::Normalize(const SamplerDesc& requested) const {
+        /* Fold fields that do not change the created sampler so they do not split the cache */
+        SamplerDesc desc = requested;
+        float maxAnisotropy = m_DeviceContext.EnabledFeatures.samplerAnisotropy ? m_DeviceContext.Limits.maxSamplerAnisotropy : 1.0f;
+        desc.MaxAnisotropy = std::min(desc.MaxAnisotropy, maxAnisotropy);
+        if (desc.MaxAnisotropy <= 1.0f) desc.MaxAnisotropy = 1.0f;
+        if (!desc.CompareEnable) desc.CompareOp = VK_COMPARE_OP_ALWAYS;
+        bool usesBorder = desc.AddressModeU == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER ||
+            desc.AddressModeV == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER ||
+            desc.AddressModeW == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+        if (!usesBorder) desc.BorderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+        return desc;
+    }
+}
\ No newline at end of file
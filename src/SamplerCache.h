@@ -0,0 +1,47 @@
+#pragma once
+/* This Header deduplicates VkSampler objects --> identical descriptions share one handle for the device lifetime */
+#include "pch.h"
+#include "DeviceContext.h"
+#include <mutex>
+#include <unordered_map>
+
+namespace VulkanPractice {
+    struct SamplerDesc {
+        VkFilter MagFilter = VK_FILTER_LINEAR;
+        VkFilter MinFilter = VK_FILTER_LINEAR;
+        VkSamplerMipmapMode MipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        VkSamplerAddressMode AddressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        VkSamplerAddressMode AddressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        VkSamplerAddressMode AddressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        float MaxAnisotropy = 16.0f; // clamped to the device limit, <= 1 disables
+        float MipLodBias = 0.0f;
+        float MinLod = 0.0f;
+        float MaxLod = VK_LOD_CLAMP_NONE;
+        VkBorderColor BorderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+        bool CompareEnable = false;
+        VkCompareOp CompareOp = VK_COMPARE_OP_ALWAYS;
+
+        bool operator==(const SamplerDesc& other) const;
+    };
+    struct SamplerDescHash {
+        size_t operator()(const SamplerDesc& desc) const;
+    };
+
+    class SamplerCache {
+    private:
+        DeviceContext m_DeviceContext;
+        std::mutex m_Mutex; // loader threads may ask for samplers too
+        std::unordered_map<SamplerDesc, VkSampler, SamplerDescHash> m_Samplers;
+    public:
+        SamplerCache(const DeviceContext& context);
+        ~SamplerCache();
+        SamplerCache(const SamplerCache&) = delete;
+        SamplerCache& operator=(const SamplerCache&) = delete;
+
+        /* Creates on first use, the cache keeps ownership */
+        VkSampler Get(const SamplerDesc& desc);
+        size_t GetSamplerCount();
+    private:
+        SamplerDesc Normalize(const SamplerDesc& desc) const;
+    };
+}
\ No newline at end of file
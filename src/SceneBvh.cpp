@@ -0,0 +1,409 @@
+#include "SceneBvh.h"
+#include "Profiler.h"
+#include "Log.h"
+#include <glm/common.hpp>
+#include <cassert>
+
+namespace VulkanPractice {
+    /* Inverted box of an empty leaf --> fails every overlap, ray and plane test without special cases */
+    static constexpr float s_EmptyBound = 1e30f;
+
+    static float SurfaceArea(const glm::vec3& min, const glm::vec3& max) {
+        glm::vec3 size = max - min;
+        if (size.x < 0.0f || size.y < 0.0f || size.z < 0.0f) return 0.0f;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+    static void Grow(glm::vec3& min, glm::vec3& max, const glm::vec3& otherMin, const glm::vec3& otherMax) {
+        min = glm::min(min, otherMin);
+        max = glm::max(max, otherMax);
+    }
+    static bool Overlaps(const glm::vec3& aMin, const glm::vec3& aMax, const glm::vec3& bMin, const glm::vec3& bMax) {
+        return aMin.x <= bMax.x && aMax.x >= bMin.x && aMin.y <= bMax.y && aMax.y >= bMin.y && aMin.z <= bMax.z && aMax.z >= bMin.z;
+    }
+    /* Entry distance of a ray into a box, or a value past limit on a miss */
+    static float IntersectRay(const glm::vec3& origin, const glm::vec3& inverseDirection, const glm::vec3& min, const glm::vec3& max, float limit) {
+        glm::vec3 t0 = (min - origin) * inverseDirection;
+        glm::vec3 t1 = (max - origin) * inverseDirection;
+        glm::vec3 nearest = glm::min(t0, t1), farthest = glm::max(t0, t1);
+        float entry = std::max(std::max(nearest.x, nearest.y), std::max(nearest.z, 0.0f));
+        float exit = std::min(std::min(farthest.x, farthest.y), farthest.z);
+        return entry <= exit && entry <= limit ? entry : s_EmptyBound;
+    }
+    enum class PlaneSide : uint8_t {
+        Outside, Intersecting, Inside
+    };
+    /* Box corners furthest along and against each plane normal */
+    static PlaneSide Classify(const FrustumPlanes& frustum, const glm::vec3& min, const glm::vec3& max) {
+        PlaneSide side = PlaneSide::Inside;
+        for (const float* plane : frustum.Planes) {
+            glm::vec3 positive(plane[0] >= 0.0f ? max.x : min.x, plane[1] >= 0.0f ? max.y : min.y, plane[2] >= 0.0f ? max.z : min.z);
+            if (plane[0] * positive.x + plane[1] * positive.y + plane[2] * positive.z + plane[3] < 0.0f) return PlaneSide::Outside;
+            glm::vec3 negative(plane[0] >= 0.0f ? min.x : max.x, plane[1] >= 0.0f ? min.y : max.y, plane[2] >= 0.0f ? min.z : max.z);
+            if (plane[0] * negative.x + plane[1] * negative.y + plane[2] * negative.z + plane[3] < 0.0f) side = PlaneSide::Intersecting;
+        }
+        return side;
+    }
+
+    SceneBvh::SceneBvh(const SceneBvhConfig& config)
+        : m_Config(config)
+    {
+        m_Config.MaxLeafItems = std::max(m_Config.MaxLeafItems, 1u);
+        m_Config.SahBins = std::max(m_Config.SahBins, 2u);
+    }
+    SceneBvh::~SceneBvh() {
+        if (m_Rebuild.valid()) m_Rebuild.wait(); // the worker reads nothing of ours, but its result must not outlive us unobserved
+    }
+
+    SceneBvh::ItemId SceneBvh::Insert(const glm::vec3& min, const glm::vec3& max) {
+        ItemId item = static_cast<ItemId>(m_Items.size());
+        m_Items.push_back({ min, max });
+        m_LooseItems.push_back(item);
+        return item;
+    }
+    void SceneBvh::Remove(ItemId item) {
+        Item& entry = m_Items[item];
+        if (!entry.Alive) return;
+        entry.Alive = false;
+        if (entry.Leaf == s_NoNode) {
+            m_LooseItems.erase(std::find(m_LooseItems.begin(), m_LooseItems.end(), item));
+        } else {
+            m_DeadItems++;
+            m_DirtyLeaves.push_back(entry.Leaf); // shrink around the survivors
+        }
+    }
+    void SceneBvh::Update(ItemId item, const glm::vec3& min, const glm::vec3& max) {
+        Item& entry = m_Items[item];
+        entry.Min = min;
+        entry.Max = max;
+        if (entry.Leaf != s_NoNode) m_DirtyLeaves.push_back(entry.Leaf);
+    }
+
+    void SceneBvh::Maintain() {
+        if (m_Rebuild.valid() && m_Rebuild.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            Adopt(m_Rebuild.get());
+        }
+        Refit();
+        if (m_Rebuild.valid()) return;
+        uint32_t treeItems = static_cast<uint32_t>(m_Tree.LeafItems.size());
+        if (m_LooseItems.size() >= m_Config.RebuildLooseItems || GetCostRatio() > m_Config.RebuildCostRatio || m_DeadItems * 4 > treeItems) {
+            StartRebuild();
+        }
+    }
+    void SceneBvh::Rebuild() {
+        if (m_Rebuild.valid()) m_Rebuild.wait(); // superseded --> dropped below
+        m_Rebuild = {};
+        std::vector<ItemId> alive;
+        for (ItemId item = 0; item < m_Items.size(); item++) {
+            if (m_Items[item].Alive) alive.push_back(item);
+        }
+        Adopt(Build(m_Items, std::move(alive), m_Config));
+    }
+    void SceneBvh::StartRebuild() {
+        /* Snapshot by value --> the tree may keep moving while the worker builds, Adopt refits the difference */
+        std::vector<ItemId> alive;
+        for (ItemId item = 0; item < m_Items.size(); item++) {
+            if (m_Items[item].Alive) alive.push_back(item);
+        }
+        m_Rebuild = std::async(std::launch::async, [items = m_Items, alive = std::move(alive), config = m_Config]() mutable {
+            return Build(items, std::move(alive), config);
+        });
+    }
+    void SceneBvh::Adopt(Tree tree) {
+        for (Item& item : m_Items) item.Leaf = s_NoNode;
+        m_Tree = std::move(tree);
+        m_DeadItems = 0;
+        for (uint32_t node = 0; node < m_Tree.Nodes.size(); node++) {
+            const Node& leaf = m_Tree.Nodes[node];
+            for (uint32_t i = 0; i < leaf.Count; i++) {
+                Item& item = m_Items[m_Tree.LeafItems[leaf.RightOrFirst + i]];
+                item.Leaf = node;
+                if (!item.Alive) m_DeadItems++; // removed while the worker was building
+            }
+        }
+        /* Inserted while the worker was building --> stay loose until the next build */
+        m_LooseItems.clear();
+        for (ItemId item = 0; item < m_Items.size(); item++) {
+            if (m_Items[item].Alive && m_Items[item].Leaf == s_NoNode) m_LooseItems.push_back(item);
+        }
+        m_DirtyLeaves.clear();
+        m_FullRefitPending = true; // items may have moved since the snapshot
+        Refit();
+        m_BuildCost = m_Cost;
+    }
+
+    void SceneBvh::Refit() {
+        if (m_FullRefitPending) {
+            /* Children always follow their parent --> one reverse sweep sees every child before its parent */
+            for (uint32_t node = static_cast<uint32_t>(m_Tree.Nodes.size()); node-- > 0;) RecomputeNode(node);
+            m_FullRefitPending = false;
+            m_DirtyLeaves.clear();
+            m_Cost = ComputeCost(m_Tree.Nodes);
+            return;
+        }
+        if (m_DirtyLeaves.empty()) return;
+        /* Walk up from every moved leaf, stopping where a node's box came out unchanged */
+        for (uint32_t leaf : m_DirtyLeaves) {
+            for (uint32_t node = leaf; node != s_NoNode; node = m_Tree.Parents[node]) {
+                Node before = m_Tree.Nodes[node];
+                RecomputeNode(node);
+                const Node& after = m_Tree.Nodes[node];
+                if (node != leaf && before.Min == after.Min && before.Max == after.Max) break;
+            }
+        }
+        m_DirtyLeaves.clear();
+        m_Cost = ComputeCost(m_Tree.Nodes);
+    }
+    void SceneBvh::RecomputeNode(uint32_t index) {
+        Node& node = m_Tree.Nodes[index];
+        glm::vec3 min(s_EmptyBound), max(-s_EmptyBound);
+        if (node.Count > 0) {
+            for (uint32_t i = 0; i < node.Count; i++) {
+                const Item& item = m_Items[m_Tree.LeafItems[node.RightOrFirst + i]];
+                if (item.Alive) Grow(min, max, item.Min, item.Max);
+            }
+        } else {
+            const Node& left = m_Tree.Nodes[index + 1];
+            const Node& right = m_Tree.Nodes[node.RightOrFirst];
+            Grow(min, max, left.Min, left.Max);
+            Grow(min, max, right.Min, right.Max);
+        }
+        node.Min = min;
+        node.Max = max;
+    }
+
+    /* Contiguous copy of what the build reads --> partitions shuffle these instead of chasing ids into m_Items */
+    struct SceneBvh::BuildRef {
+        glm::vec3 Min, Max, Centroid;
+        ItemId Item;
+    };
+    SceneBvh::Tree SceneBvh::Build(const std::vector<Item>& items, std::vector<ItemId> alive, const SceneBvhConfig& config) {
+#ifdef INCLUDE_DEBUG_INFO
+        Timer timer;
+#endif
+        std::vector<BuildRef> refs;
+        refs.reserve(alive.size());
+        for (ItemId item : alive) refs.push_back({ items[item].Min, items[item].Max, (items[item].Min + items[item].Max) * 0.5f, item });
+        Tree tree;
+        if (!refs.empty()) {
+            tree.Nodes.reserve(refs.size() * 2 / config.MaxLeafItems + 1);
+            BuildRange(tree, refs, 0, static_cast<uint32_t>(refs.size()), s_NoNode, 0, config);
+        }
+        tree.LeafItems = std::move(alive); // same count --> reuse the storage
+        for (size_t i = 0; i < refs.size(); i++) tree.LeafItems[i] = refs[i].Item;
+#ifdef INCLUDE_DEBUG_INFO
+        LOG_INFO("Scene BVH --> {} items, {} nodes, built in {:.2f} ms", tree.LeafItems.size(), tree.Nodes.size(), timer.GetElapsedMilliseconds());
+#endif
+        return tree;
+    }
+    uint32_t SceneBvh::BuildRange(Tree& tree, std::vector<BuildRef>& refs, uint32_t begin, uint32_t end, uint32_t parent, uint32_t depth, const SceneBvhConfig& config) {
+        uint32_t index = static_cast<uint32_t>(tree.Nodes.size());
+        tree.Nodes.push_back({});
+        tree.Parents.push_back(parent);
+
+        glm::vec3 min(s_EmptyBound), max(-s_EmptyBound), centroidMin(s_EmptyBound), centroidMax(-s_EmptyBound);
+        for (uint32_t i = begin; i < end; i++) {
+            Grow(min, max, refs[i].Min, refs[i].Max);
+            Grow(centroidMin, centroidMax, refs[i].Centroid, refs[i].Centroid);
+        }
+        tree.Nodes[index].Min = min;
+        tree.Nodes[index].Max = max;
+        uint32_t count = end - begin;
+        auto makeLeaf = [&] {
+            tree.Nodes[index].RightOrFirst = begin;
+            tree.Nodes[index].Count = count;
+            return index;
+        };
+        /* Degenerate inputs (exponentially spaced items) would keep splitting --> a large leaf is slower, an overrun traversal stack is a crash */
+        if (count <= config.MaxLeafItems || depth >= s_MaxDepth) return makeLeaf();
+
+        /* Binned SAH over centroids, all three axes in one pass --> cost of a split is items times area on each side, against keeping one leaf */
+        struct Bin {
+            glm::vec3 Min{ s_EmptyBound }, Max{ -s_EmptyBound };
+            uint32_t Count = 0;
+        };
+        const uint32_t binCount = config.SahBins;
+        glm::vec3 centroidSize = centroidMax - centroidMin;
+        glm::vec3 scale;
+        for (int axis = 0; axis < 3; axis++) scale[axis] = centroidSize[axis] > 0.0f ? static_cast<float>(binCount) / centroidSize[axis] : 0.0f;
+        auto binOf = [&](const BuildRef& ref, int axis) {
+            return std::min(static_cast<uint32_t>((ref.Centroid[axis] - centroidMin[axis]) * scale[axis]), binCount - 1);
+        };
+
+        float bestCost = static_cast<float>(count) * SurfaceArea(min, max);
+        int bestAxis = -1;
+        uint32_t bestSplit = 0;
+        std::vector<Bin> bins(binCount * 3);
+        for (uint32_t i = begin; i < end; i++) {
+            for (int axis = 0; axis < 3; axis++) {
+                Bin& bin = bins[axis * binCount + binOf(refs[i], axis)];
+                Grow(bin.Min, bin.Max, refs[i].Min, refs[i].Max);
+                bin.Count++;
+            }
+        }
+        std::vector<float> rightCosts(binCount);
+        for (int axis = 0; axis < 3; axis++) {
+            if (scale[axis] == 0.0f) continue;
+            const Bin* axisBins = &bins[axis * binCount];
+            /* Sweep from the right once, then from the left while trying every plane between bins */
+            glm::vec3 sweepMin(s_EmptyBound), sweepMax(-s_EmptyBound);
+            uint32_t sweepCount = 0;
+            for (uint32_t bin = binCount - 1; bin > 0; bin--) {
+                Grow(sweepMin, sweepMax, axisBins[bin].Min, axisBins[bin].Max);
+                sweepCount += axisBins[bin].Count;
+                rightCosts[bin] = static_cast<float>(sweepCount) * SurfaceArea(sweepMin, sweepMax);
+            }
+            sweepMin = glm::vec3(s_EmptyBound);
+            sweepMax = glm::vec3(-s_EmptyBound);
+            sweepCount = 0;
+            for (uint32_t split = 1; split < binCount; split++) {
+                Grow(sweepMin, sweepMax, axisBins[split - 1].Min, axisBins[split - 1].Max);
+                sweepCount += axisBins[split - 1].Count;
+                if (sweepCount == 0 || sweepCount == count) continue;
+                float cost = static_cast<float>(sweepCount) * SurfaceArea(sweepMin, sweepMax) + rightCosts[split];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = split;
+                }
+            }
+        }
+
+        uint32_t middle;
+        auto first = refs.begin();
+        if (bestAxis >= 0) {
+            middle = static_cast<uint32_t>(std::partition(first + begin, first + end, [&](const BuildRef& ref) { return binOf(ref, bestAxis) < bestSplit; }) - first);
+        } else if (count <= config.MaxLeafItems * 4) {
+            return makeLeaf(); // no split beats a leaf and the leaf stays small
+        } else {
+            /* Coincident centroids --> halve by count along the widest axis so depth stays logarithmic */
+            int axis = centroidSize.x >= centroidSize.y && centroidSize.x >= centroidSize.z ? 0 : (centroidSize.y >= centroidSize.z ? 1 : 2);
+            middle = begin + count / 2;
+            std::nth_element(first + begin, first + middle, first + end, [&](const BuildRef& a, const BuildRef& b) { return a.Centroid[axis] < b.Centroid[axis]; });
+        }
+        BuildRange(tree, refs, begin, middle, index, depth + 1, config); // left lands at index + 1
+        uint32_t right = BuildRange(tree, refs, middle, end, index, depth + 1, config);
+        tree.Nodes[index].RightOrFirst = right;
+        tree.Nodes[index].Count = 0;
+        return index;
+    }
+    float SceneBvh::ComputeCost(const std::vector<Node>& nodes) {
+        /* Expected tests per random query --> visits weighted by area relative to the root, leaves pay for every item */
+        if (nodes.empty()) return 0.0f;
+        float rootArea = SurfaceArea(nodes[0].Min, nodes[0].Max);
+        if (rootArea <= 0.0f) return 0.0f;
+        float cost = 0.0f;
+        for (const Node& node : nodes) {
+            cost += SurfaceArea(node.Min, node.Max) * static_cast<float>(node.Count > 0 ? node.Count : 1);
+        }
+        return cost / rootArea;
+    }
+
+    void SceneBvh::QueryFrustum(const FrustumPlanes& frustum, std::vector<ItemId>& results) const {
+        results.clear();
+        /* Entries carry whether their node is already fully inside --> such subtrees are collected without plane tests */
+        uint32_t stack[2 * s_MaxDepth + 2];
+        uint32_t top = 0;
+        if (!m_Tree.Nodes.empty()) stack[top++] = 0;
+        while (top > 0) {
+            uint32_t entry = stack[--top];
+            uint32_t index = entry >> 1;
+            bool inside = (entry & 1u) != 0;
+            const Node& node = m_Tree.Nodes[index];
+            if (!inside) {
+                PlaneSide side = Classify(frustum, node.Min, node.Max);
+                if (side == PlaneSide::Outside) continue;
+                inside = side == PlaneSide::Inside;
+            }
+            if (node.Count == 0) {
+                assert(top + 2 <= std::size(stack) && "SceneBvh deeper than s_MaxDepth");
+                stack[top++] = (node.RightOrFirst << 1) | (inside ? 1u : 0u);
+                stack[top++] = ((index + 1) << 1) | (inside ? 1u : 0u);
+                continue;
+            }
+            for (uint32_t i = 0; i < node.Count; i++) {
+                ItemId item = m_Tree.LeafItems[node.RightOrFirst + i];
+                const Item& data = m_Items[item];
+                if (data.Alive && (inside || Classify(frustum, data.Min, data.Max) != PlaneSide::Outside)) results.push_back(item);
+            }
+        }
+        for (ItemId item : m_LooseItems) {
+            if (Classify(frustum, m_Items[item].Min, m_Items[item].Max) != PlaneSide::Outside) results.push_back(item);
+        }
+    }
+    void SceneBvh::QueryOverlap(const glm::vec3& min, const glm::vec3& max, std::vector<ItemId>& results) const {
+        results.clear();
+        uint32_t stack[s_MaxDepth + 2];
+        uint32_t top = 0;
+        if (!m_Tree.Nodes.empty()) stack[top++] = 0;
+        while (top > 0) {
+            uint32_t index = stack[--top];
+            const Node& node = m_Tree.Nodes[index];
+            if (!Overlaps(node.Min, node.Max, min, max)) continue;
+            if (node.Count == 0) {
+                assert(top + 2 <= std::size(stack) && "SceneBvh deeper than s_MaxDepth");
+                stack[top++] = node.RightOrFirst;
+                stack[top++] = index + 1;
+                continue;
+            }
+            for (uint32_t i = 0; i < node.Count; i++) {
+                ItemId item = m_Tree.LeafItems[node.RightOrFirst + i];
+                const Item& data = m_Items[item];
+                if (data.Alive && Overlaps(data.Min, data.Max, min, max)) results.push_back(item);
+            }
+        }
+        for (ItemId item : m_LooseItems) {
+            if (Overlaps(m_Items[item].Min, m_Items[item].Max, min, max)) results.push_back(item);
+        }
+    }
+    bool SceneBvh::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RayHit& hit) const {
+        /* Axis parallel rays get a huge but finite inverse --> no infinities under -ffast-math */
+        auto inverse = [](float value) { return std::fabs(value) > 1e-20f ? 1.0f / value : (value < 0.0f ? -s_EmptyBound : s_EmptyBound); };
+        glm::vec3 inverseDirection(inverse(direction.x), inverse(direction.y), inverse(direction.z));
+        hit = RayHit{};
+        float closest = maxDistance;
+        auto testItem = [&](ItemId item) {
+            const Item& data = m_Items[item];
+            if (!data.Alive) return;
+            float distance = IntersectRay(origin, inverseDirection, data.Min, data.Max, closest);
+            if (distance <= closest) {
+                closest = distance;
+                hit.Item = item;
+                hit.Distance = distance;
+            }
+        };
+        /* Loose items first --> a close hit among them prunes the tree walk */
+        for (ItemId item : m_LooseItems) testItem(item);
+
+        struct Entry {
+            uint32_t Node;
+            float Distance;
+        };
+        Entry stack[s_MaxDepth + 2];
+        uint32_t top = 0;
+        if (!m_Tree.Nodes.empty()) {
+            float distance = IntersectRay(origin, inverseDirection, m_Tree.Nodes[0].Min, m_Tree.Nodes[0].Max, closest);
+            if (distance <= closest) stack[top++] = { 0, distance };
+        }
+        while (top > 0) {
+            Entry entry = stack[--top];
+            if (entry.Distance > closest) continue; // something nearer was hit since it was pushed
+            const Node& node = m_Tree.Nodes[entry.Node];
+            if (node.Count > 0) {
+                for (uint32_t i = 0; i < node.Count; i++) testItem(m_Tree.LeafItems[node.RightOrFirst + i]);
+                continue;
+            }
+            /* Nearer child on top --> visited first so the farther one is often pruned */
+            uint32_t left = entry.Node + 1, right = node.RightOrFirst;
+            float leftDistance = IntersectRay(origin, inverseDirection, m_Tree.Nodes[left].Min, m_Tree.Nodes[left].Max, closest);
+            float rightDistance = IntersectRay(origin, inverseDirection, m_Tree.Nodes[right].Min, m_Tree.Nodes[right].Max, closest);
+            if (leftDistance > rightDistance) {
+                std::swap(left, right);
+                std::swap(leftDistance, rightDistance);
+            }
+            assert(top + 2 <= std::size(stack) && "SceneBvh deeper than s_MaxDepth");
+            if (rightDistance <= closest) stack[top++] = { right, rightDistance };
+            if (leftDistance <= closest) stack[top++] = { left, leftDistance };
+        }
+        return hit.Item != s_InvalidItem;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+/* This Header handles the spatial index of the scene --> SAH built BVH in one flat array, refit in place, rebuilt on a worker thread when it degrades */
+#include "pch.h"
+#include "SimdKernels.h"
+#include <glm/vec3.hpp>
+#include <future>
+
+namespace VulkanPractice {
+    struct SceneBvhConfig {
+        uint32_t MaxLeafItems = 4;
+        uint32_t SahBins = 12; // candidate split planes per axis
+        float RebuildCostRatio = 1.5f; // SAH cost after refits relative to the last build --> past this a rebuild starts
+        uint32_t RebuildLooseItems = 64; // items inserted since the last build that are tested linearly
+    };
+
+    class SceneBvh {
+    public:
+        using ItemId = uint32_t;
+        inline static constexpr ItemId s_InvalidItem = ~0u;
+        struct RayHit {
+            ItemId Item = s_InvalidItem;
+            float Distance; // along the direction passed in, entry into the item's box
+        };
+    private:
+        /* 32 bytes, two per cache line, depth first --> the left child directly follows its parent */
+        struct Node {
+            glm::vec3 Min;
+            uint32_t RightOrFirst; // right child index for interior nodes, first entry of LeafItems for leaves
+            glm::vec3 Max;
+            uint32_t Count; // 0 for interior nodes
+        };
+        static_assert(sizeof(Node) == 32, "SceneBvh::Node must stay 32 bytes");
+        inline static constexpr uint32_t s_NoNode = ~0u;
+        inline static constexpr uint32_t s_MaxDepth = 64; // ranges reaching it become leaves whatever their size --> bounds the traversal stacks
+        struct Item {
+            glm::vec3 Min, Max;
+            bool Alive = true;
+            uint32_t Leaf = s_NoNode; // s_NoNode --> in m_LooseItems until the next build
+        };
+        struct Tree {
+            std::vector<Node> Nodes;
+            std::vector<uint32_t> Parents; // by node, s_NoNode for the root --> refits walk up from moved leaves
+            std::vector<ItemId> LeafItems;
+        };
+
+        SceneBvhConfig m_Config;
+        std::vector<Item> m_Items; // by id, ids are never reused --> removed items stay as tombstones
+        std::vector<ItemId> m_LooseItems;
+        Tree m_Tree;
+        float m_BuildCost = 0.0f, m_Cost = 0.0f; // SAH cost right after the last build and after the last refit
+        uint32_t m_DeadItems = 0; // removed but still referenced by the tree
+        std::vector<uint32_t> m_DirtyLeaves;
+        bool m_FullRefitPending = false;
+
+        std::future<Tree> m_Rebuild; // valid while a worker builds from a snapshot of m_Items
+    public:
+        explicit SceneBvh(const SceneBvhConfig& config = SceneBvhConfig());
+        ~SceneBvh();
+        SceneBvh(const SceneBvh&) = delete;
+        SceneBvh& operator=(const SceneBvh&) = delete;
+
+        /* Queryable immediately --> linear until the next build takes it into the tree. Ids count up from 0 in insertion order */
+        ItemId Insert(const glm::vec3& min, const glm::vec3& max);
+        void Remove(ItemId item);
+        /* Moves an item --> its leaf and ancestors grow or shrink on the next Maintain */
+        void Update(ItemId item, const glm::vec3& min, const glm::vec3& max);
+        /* Once per frame on the owning thread --> refits, adopts a finished rebuild, starts one when the tree degraded */
+        void Maintain();
+        /* Synchronous build of everything alive --> for load time */
+        void Rebuild();
+
+        void QueryFrustum(const FrustumPlanes& frustum, std::vector<ItemId>& results) const;
+        void QueryOverlap(const glm::vec3& min, const glm::vec3& max, std::vector<ItemId>& results) const;
+        /* Closest item box hit along origin + t * direction for t in [0, maxDistance] --> box precision, callers refine if needed */
+        bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RayHit& hit) const;
+
+        inline size_t GetNodeCount() const { return m_Tree.Nodes.size(); }
+        inline size_t GetLooseCount() const { return m_LooseItems.size(); }
+        inline bool IsRebuilding() const { return m_Rebuild.valid(); }
+        /* SAH cost of the current tree relative to its build --> 1 right after a build */
+        inline float GetCostRatio() const { return m_BuildCost > 0.0f ? m_Cost / m_BuildCost : 1.0f; }
+    private:
+        void Refit();
+        void StartRebuild();
+        void Adopt(Tree tree);
+        void RecomputeNode(uint32_t node);
+        struct BuildRef;
+        /* Runs on the worker --> only touches its arguments */
+        static Tree Build(const std::vector<Item>& items, std::vector<ItemId> alive, const SceneBvhConfig& config);
+        static uint32_t BuildRange(Tree& tree, std::vector<BuildRef>& refs, uint32_t begin, uint32_t end, uint32_t parent, uint32_t depth, const SceneBvhConfig& config);
+        static float ComputeCost(const std::vector<Node>& nodes);
+    };
+}
\ No newline at end of file
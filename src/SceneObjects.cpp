@@ -0,0 +1,81 @@
+#include "SceneObjects.h"
+#include "VulkanUtils.h"
+#include <cstring>
+
+namespace VulkanPractice {
+    SceneObjects::SceneObjects(const DeviceContext& context, const std::vector<ObjectData>& objects)
+        : m_DeviceContext(context), m_Count(static_cast<uint32_t>(objects.size()))
+    {
+        if (objects.empty()) {
+            throw std::runtime_error("Scene needs at least one object!");
+        }
+        VulkanUtils::CreateHostVisibleBuffer(
+            context, GetSize(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            m_VkBuffer, m_VkBufferMemory
+        );
+        void* mapped;
+        if (vkMapMemory(m_DeviceContext.Device, m_VkBufferMemory, 0, GetSize(), 0, &mapped) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to map scene object buffer!");
+        }
+        std::memcpy(mapped, objects.data(), GetSize());
+        vkUnmapMemory(m_DeviceContext.Device, m_VkBufferMemory);
+        CreateDescriptors();
+    }
+    SceneObjects::~SceneObjects() {
+        vkDestroyDescriptorPool(m_DeviceContext.Device, m_VkDescriptorPool, m_DeviceContext.Allocator); // frees the set
+        vkDestroyDescriptorSetLayout(m_DeviceContext.Device, m_VkDescriptorSetLayout, m_DeviceContext.Allocator);
+        vkDestroyBuffer(m_DeviceContext.Device, m_VkBuffer, m_DeviceContext.Allocator);
+        vkFreeMemory(m_DeviceContext.Device, m_VkBufferMemory, m_DeviceContext.Allocator);
+    }
+
+    void SceneObjects::CreateDescriptors() {
+        VkDescriptorSetLayoutBinding binding{};
+        binding.binding = 0;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        binding.descriptorCount = 1;
+        binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = 1;
+        layoutInfo.pBindings = &binding;
+        if (vkCreateDescriptorSetLayout(m_DeviceContext.Device, &layoutInfo, m_DeviceContext.Allocator, &m_VkDescriptorSetLayout) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create scene object descriptor set layout!");
+        }
+
+        VkDescriptorPoolSize poolSize{};
+        poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSize.descriptorCount = 1;
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        poolInfo.maxSets = 1;
+        if (vkCreateDescriptorPool(m_DeviceContext.Device, &poolInfo, m_DeviceContext.Allocator, &m_VkDescriptorPool) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create scene object descriptor pool!");
+        }
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_VkDescriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &m_VkDescriptorSetLayout;
+        if (vkAllocateDescriptorSets(m_DeviceContext.Device, &allocInfo, &m_VkDescriptorSet) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate scene object descriptor set!");
+        }
+
+        VkDescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = m_VkBuffer;
+        bufferInfo.offset = 0;
+        bufferInfo.range = GetSize();
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = m_VkDescriptorSet;
+        write.dstBinding = 0;
+        write.dstArrayElement = 0;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.descriptorCount = 1;
+        write.pBufferInfo = &bufferInfo;
+        vkUpdateDescriptorSets(m_DeviceContext.Device, 1, &write, 0, nullptr);
+    }
+}
\ No newline at end of file
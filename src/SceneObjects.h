@@ -0,0 +1,34 @@
+#pragma once
+/* This Header holds the per-object data of the scene in one storage buffer --> the mesh is drawn instanced and gl_InstanceIndex picks the object */
+#include "pch.h"
+#include "DeviceContext.h"
+#include "ShaderTypes.h"
+
+namespace VulkanPractice {
+    class SceneObjects {
+    private:
+        DeviceContext m_DeviceContext;
+        uint32_t m_Count;
+        VkBuffer m_VkBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory m_VkBufferMemory = VK_NULL_HANDLE;
+
+        VkDescriptorSetLayout m_VkDescriptorSetLayout = VK_NULL_HANDLE;
+        VkDescriptorPool m_VkDescriptorPool = VK_NULL_HANDLE;
+        VkDescriptorSet m_VkDescriptorSet = VK_NULL_HANDLE;
+    public:
+        /* Written once --> the objects are static for the lifetime of the buffer */
+        SceneObjects(const DeviceContext& context, const std::vector<ObjectData>& objects);
+        ~SceneObjects();
+        SceneObjects(const SceneObjects&) = delete;
+        SceneObjects& operator=(const SceneObjects&) = delete;
+
+        inline uint32_t GetCount() const { return m_Count; }
+        inline VkBuffer GetBuffer() const { return m_VkBuffer; }
+        inline VkDeviceSize GetSize() const { return sizeof(ObjectData) * m_Count; }
+        /* Vertex stage only --> compute passes bind the buffer through their own sets */
+        inline VkDescriptorSetLayout GetDescriptorSetLayout() const { return m_VkDescriptorSetLayout; }
+        inline VkDescriptorSet GetDescriptorSet() const { return m_VkDescriptorSet; }
+    private:
+        void CreateDescriptors();
+    };
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "SdfFont.h"
+#include <cmath>
+
+namespace VulkanPractice {
+    /* One byte per row, top row first, bit 4 is the leftmost pixel */
+    static constexpr uint8_t s_BitmapGlyphs[64][7] = {
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // space
+        { 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04 }, // !
+        { 0x0a, 0x0a, 0x0a, 0x00, 0x00, 0x00, 0x00 }, // "
+        { 0x0a, 0x0a, 0x1f, 0x0a, 0x1f, 0x0a, 0x0a }, // #
+        { 0x04, 0x0f, 0x14, 0x0e, 0x05, 0x1e, 0x04 }, // $
+        { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 }, // %
+        { 0x0c, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0d }, // &
+        { 0x04, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00 }, // '
+        { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 }, // (
+        { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 }, // )
+        { 0x00, 0x04, 0x15, 0x0e, 0x15, 0x04, 0x00 }, // *
+        { 0x00, 0x04, 0x04, 0x1f, 0x04, 0x04, 0x00 }, // +
+        { 0x00, 0x00, 0x00, 0x00, 0x0c, 0x04, 0x08 }, // ,
+        { 0x00, 0x00, 0x00, 0x1f, 0x00, 0x00, 0x00 }, // -
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x0c }, // .
+        { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 }, // /
+        { 0x0e, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0e }, // 0
+        { 0x04, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x0e }, // 1
+        { 0x0e, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1f }, // 2
+        { 0x1f, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0e }, // 3
+        { 0x02, 0x06, 0x0a, 0x12, 0x1f, 0x02, 0x02 }, // 4
+        { 0x1f, 0x10, 0x1e, 0x01, 0x01, 0x11, 0x0e }, // 5
+        { 0x06, 0x08, 0x10, 0x1e, 0x11, 0x11, 0x0e }, // 6
+        { 0x1f, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 }, // 7
+        { 0x0e, 0x11, 0x11, 0x0e, 0x11, 0x11, 0x0e }, // 8
+        { 0x0e, 0x11, 0x11, 0x0f, 0x01, 0x02, 0x0c }, // 9
+        { 0x00, 0x0c, 0x0c, 0x00, 0x0c, 0x0c, 0x00 }, // :
+        { 0x00, 0x0c, 0x0c, 0x00, 0x0c, 0x04, 0x08 }, // ;
+        { 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02 }, // <
+        { 0x00, 0x00, 0x1f, 0x00, 0x1f, 0x00, 0x00 }, // =
+        { 0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08 }, // >
+        { 0x0e, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04 }, // ?
+        { 0x0e, 0x11, 0x01, 0x0d, 0x15, 0x15, 0x0e }, // @
+        { 0x0e, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11 }, // A
+        { 0x1e, 0x11, 0x11, 0x1e, 0x11, 0x11, 0x1e }, // B
+        { 0x0e, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0e }, // C
+        { 0x1c, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1c }, // D
+        { 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x1f }, // E
+        { 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x10 }, // F
+        { 0x0e, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0f }, // G
+        { 0x11, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11 }, // H
+        { 0x0e, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e }, // I
+        { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0c }, // J
+        { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 }, // K
+        { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1f }, // L
+        { 0x11, 0x1b, 0x15, 0x15, 0x11, 0x11, 0x11 }, // M
+        { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 }, // N
+        { 0x0e, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e }, // O
+        { 0x1e, 0x11, 0x11, 0x1e, 0x10, 0x10, 0x10 }, // P
+        { 0x0e, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0d }, // Q
+        { 0x1e, 0x11, 0x11, 0x1e, 0x14, 0x12, 0x11 }, // R
+        { 0x0f, 0x10, 0x10, 0x0e, 0x01, 0x01, 0x1e }, // S
+        { 0x1f, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 }, // T
+        { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e }, // U
+        { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0a, 0x04 }, // V
+        { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0a }, // W
+        { 0x11, 0x11, 0x0a, 0x04, 0x0a, 0x11, 0x11 }, // X
+        { 0x11, 0x11, 0x0a, 0x04, 0x04, 0x04, 0x04 }, // Y
+        { 0x1f, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1f }, // Z
+        { 0x0e, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0e }, // [
+        { 0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00 }, // backslash
+        { 0x0e, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0e }, // ]
+        { 0x04, 0x0a, 0x11, 0x00, 0x00, 0x00, 0x00 }, // ^
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f }, // _
+    };
+
+    /* Distance from a point to an axis aligned pixel square, 0 inside it */
+    static float DistanceToPixel(float x, float y, int pixelX, int pixelY) {
+        float dx = std::max({ static_cast<float>(pixelX) - x, 0.0f, x - static_cast<float>(pixelX + 1) });
+        float dy = std::max({ static_cast<float>(pixelY) - y, 0.0f, y - static_cast<float>(pixelY + 1) });
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    SdfFont::SdfFont(const DeviceContext& context) {
+        const uint32_t cellWidth = s_GlyphWidth * s_TexelsPerPixel + 2 * s_Padding;
+        const uint32_t cellHeight = s_GlyphHeight * s_TexelsPerPixel + 2 * s_Padding;
+        const uint32_t rows = (s_GlyphCount + s_AtlasColumns - 1) / s_AtlasColumns;
+        const uint32_t width = cellWidth * s_AtlasColumns, height = cellHeight * rows;
+        const float spread = static_cast<float>(s_Padding) / static_cast<float>(s_TexelsPerPixel); // in bitmap pixels
+        std::vector<uint8_t> atlas(static_cast<size_t>(width) * height, 0);
+
+        /* Exact distances to the pixel squares --> 35 squares per texel is cheaper than a search over the upscaled bitmap */
+        for (uint32_t glyph = 0; glyph < s_GlyphCount; glyph++) {
+            const uint8_t* bitmap = s_BitmapGlyphs[glyph];
+            auto isSet = [bitmap](int x, int y) {
+                return x >= 0 && y >= 0 && x < static_cast<int>(s_GlyphWidth) && y < static_cast<int>(s_GlyphHeight) && (bitmap[y] >> (s_GlyphWidth - 1 - x)) & 1u;
+            };
+            uint32_t originX = (glyph % s_AtlasColumns) * cellWidth, originY = (glyph / s_AtlasColumns) * cellHeight;
+            for (uint32_t ty = 0; ty < cellHeight; ty++) {
+                for (uint32_t tx = 0; tx < cellWidth; tx++) {
+                    float x = (static_cast<float>(tx) + 0.5f - static_cast<float>(s_Padding)) / static_cast<float>(s_TexelsPerPixel);
+                    float y = (static_cast<float>(ty) + 0.5f - static_cast<float>(s_Padding)) / static_cast<float>(s_TexelsPerPixel);
+                    bool inside = isSet(static_cast<int>(std::floor(x)), static_cast<int>(std::floor(y)));
+                    /* Nearest square of the other state --> the ring of empty pixels around the bitmap counts as outside */
+                    float distance = spread;
+                    for (int py = -1; py <= static_cast<int>(s_GlyphHeight); py++) {
+                        for (int px = -1; px <= static_cast<int>(s_GlyphWidth); px++) {
+                            if (isSet(px, py) != inside) distance = std::min(distance, DistanceToPixel(x, y, px, py));
+                        }
+                    }
+                    float value = 0.5f + (inside ? distance : -distance) / (2.0f * spread);
+                    atlas[(originY + ty) * width + originX + tx] = static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+                }
+            }
+            SdfGlyph& entry = m_Glyphs[glyph];
+            entry.UvMin[0] = static_cast<float>(originX) / static_cast<float>(width);
+            entry.UvMin[1] = static_cast<float>(originY) / static_cast<float>(height);
+            entry.UvMax[0] = static_cast<float>(originX + cellWidth) / static_cast<float>(width);
+            entry.UvMax[1] = static_cast<float>(originY + cellHeight) / static_cast<float>(height);
+        }
+
+        TextureDesc desc;
+        desc.Width = width;
+        desc.Height = height;
+        desc.Format = VK_FORMAT_R8_UNORM; // distances are linear --> never sRGB
+        desc.GenerateMips = false;
+        m_Texture = std::make_unique<Texture>(context, desc, atlas.data(), atlas.size());
+        m_Texture->WaitForUpload(); // built once at init --> nobody polls it later
+        m_CellAspect = static_cast<float>(cellWidth) / static_cast<float>(cellHeight);
+        m_Advance = static_cast<float>((s_GlyphWidth + 1) * s_TexelsPerPixel) / static_cast<float>(cellHeight); // one empty pixel column between glyphs
+        m_Spread = static_cast<float>(2 * s_Padding) / static_cast<float>(cellHeight);
+    }
+
+    const SdfGlyph& SdfFont::GetGlyph(char character) const {
+        if (character >= 'a' && character <= 'z') character = static_cast<char>(character - 'a' + 'A');
+        uint32_t index = static_cast<uint32_t>(static_cast<unsigned char>(character)) - static_cast<uint32_t>(s_FirstChar);
+        if (index >= s_GlyphCount) index = static_cast<uint32_t>('?' - s_FirstChar);
+        return m_Glyphs[index];
+    }
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+/* This Header handles signed distance field fonts --> one R8 atlas where 0.5 is the glyph edge, sharp at any size the 2D batch draws it */
+#include "pch.h"
+#include "DeviceContext.h"
+#include "Texture.h"
+
+namespace VulkanPractice {
+    struct SdfGlyph {
+        float UvMin[2], UvMax[2]; // cell including the distance padding
+    };
+
+    class SdfFont {
+    private:
+        /* Built-in face --> 5x7 bitmap glyphs for ' ' to '_', lowercase drawn as uppercase */
+        inline static constexpr char s_FirstChar = ' ';
+        inline static constexpr uint32_t s_GlyphCount = 64;
+        inline static constexpr uint32_t s_GlyphWidth = 5, s_GlyphHeight = 7; // bitmap pixels
+        inline static constexpr uint32_t s_TexelsPerPixel = 6;
+        inline static constexpr uint32_t s_Padding = 6; // texels around each glyph --> the distance spread, one bitmap pixel
+        inline static constexpr uint32_t s_AtlasColumns = 8;
+
+        std::unique_ptr<Texture> m_Texture;
+        std::array<SdfGlyph, s_GlyphCount> m_Glyphs;
+        float m_CellAspect; // cell width / cell height
+        float m_Advance; // pen step per unit of cell height
+        float m_Spread; // distance range of the atlas per unit of cell height --> edge softness in the shader
+    public:
+        /* Bakes the built-in face on the CPU and uploads it */
+        explicit SdfFont(const DeviceContext& context);
+        SdfFont(const SdfFont&) = delete;
+        SdfFont& operator=(const SdfFont&) = delete;
+
+        /* Unknown characters map to '?' */
+        const SdfGlyph& GetGlyph(char character) const;
+        inline const Texture& GetTexture() const { return *m_Texture; }
+        inline float GetCellAspect() const { return m_CellAspect; }
+        inline float GetAdvance() const { return m_Advance; }
+        inline float GetSpread() const { return m_Spread; }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#include "ShaderCompiler.h"
+
+namespace VulkanPractice {
+    std::vector<uint32_t> ShaderCompiler::CompileGlsl(const std::string& source, shaderc_shader_kind kind, const std::string& name,
+        const std::vector<std::pair<std::string, std::string>>& defines) {
+        shaderc::Compiler compiler;
+        shaderc::CompileOptions options;
+        options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_0);
+#ifdef INCLUDE_DEBUG_INFO
+        options.SetGenerateDebugInfo();
+#else
+        options.SetOptimizationLevel(shaderc_optimization_level_performance);
+#endif
+        for (const auto& [define, value] : defines) options.AddMacroDefinition(define, value);
+        shaderc::SpvCompilationResult result = compiler.CompileGlslToSpv(source, kind, name.c_str(), options);
+        if (result.GetCompilationStatus() != shaderc_compilation_status_success) {
+            throw std::runtime_error("Failed to compile shader " + name + ":\n" + result.GetErrorMessage());
+        }
+        return { result.cbegin(), result.cend() };
+    }
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+/* This Header handles runtime GLSL --> SPIR-V compilation through shaderc */
+#include "pch.h"
+#include <shaderc/shaderc.hpp>
+
+namespace VulkanPractice {
+    class ShaderCompiler {
+    public:
+        /* Throws with the shaderc error log on failure; name is only used in diagnostics. defines are #define name value ahead of the source */
+        static std::vector<uint32_t> CompileGlsl(const std::string& source, shaderc_shader_kind kind, const std::string& name,
+            const std::vector<std::pair<std::string, std::string>>& defines = {});
+    };
+}
\ No newline at end of file
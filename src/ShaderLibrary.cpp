@@ -0,0 +1,105 @@
+#include "ShaderLibrary.h"
+#include "Log.h"
+#include <fstream>
+#include <sstream>
+
+namespace VulkanPractice {
+    void ShaderLibrary::Declare(const std::string& name, VkShaderStageFlagBits stage, const std::string& path, const std::vector<ShaderFeature>& features) {
+        if (features.size() > sizeof(FeatureMask) * 8) {
+            throw std::runtime_error("Shader " + name + " declares too many features!");
+        }
+        Shader shader;
+        shader.Stage = stage;
+        shader.Path = path;
+        shader.Features = features;
+        for (size_t i = 0; i < features.size(); i++) {
+            if (features[i].Kind == ShaderFeatureKind::Define) shader.DefineFeatures |= 1u << i;
+        }
+        shader.Permutations = { 0 };
+        m_Shaders[name] = std::move(shader);
+    }
+    void ShaderLibrary::LoadManifest(const std::string& path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+#ifdef INCLUDE_DEBUG_INFO
+            LOG_WARN("No shader permutation manifest at {} --> base permutations only", path);
+#endif
+            return;
+        }
+        std::string line;
+        for (uint32_t lineNumber = 1; std::getline(file, line); lineNumber++) {
+            line = line.substr(0, line.find('#'));
+            std::istringstream words(line);
+            std::string name, feature;
+            if (!(words >> name)) continue;
+            auto found = m_Shaders.find(name);
+            if (found == m_Shaders.end()) {
+                throw std::runtime_error("Shader manifest " + path + ":" + std::to_string(lineNumber) + " names undeclared shader " + name);
+            }
+            Shader& shader = found->second;
+            FeatureMask mask = 0;
+            while (words >> feature) {
+                auto declared = std::find_if(shader.Features.begin(), shader.Features.end(), [&](const ShaderFeature& f) { return f.Name == feature; });
+                if (declared == shader.Features.end()) {
+                    throw std::runtime_error("Shader manifest " + path + ":" + std::to_string(lineNumber) + " names unknown feature " + feature + " of " + name);
+                }
+                mask |= 1u << (declared - shader.Features.begin());
+            }
+            mask &= shader.DefineFeatures;
+            if (std::find(shader.Permutations.begin(), shader.Permutations.end(), mask) == shader.Permutations.end()) shader.Permutations.push_back(mask);
+        }
+    }
+
+    ShaderStageDesc ShaderLibrary::Get(const std::string& name, const std::vector<std::string>& features) const {
+        const Shader& shader = Find(name);
+        FeatureMask requested = 0;
+        for (size_t i = 0; i < shader.Features.size(); i++) {
+            if (std::find(features.begin(), features.end(), shader.Features[i].Name) != features.end()) requested |= 1u << i;
+        }
+        /* Listed combination with the most requested defines and nothing extra */
+        FeatureMask defines = requested & shader.DefineFeatures, chosen = 0;
+        for (FeatureMask permutation : shader.Permutations) {
+            if ((permutation & ~defines) == 0 && CountBits(permutation) > CountBits(chosen)) chosen = permutation;
+        }
+#ifdef INCLUDE_DEBUG_INFO
+        if (chosen != defines) LOG_WARN("Shader {} permutation {:x} is not in the manifest --> using {:x}", name, defines, chosen);
+#endif
+        return MakeStage(shader, (requested & ~shader.DefineFeatures) | chosen);
+    }
+    std::vector<ShaderStageDesc> ShaderLibrary::GetPrebuiltStages() const {
+        std::vector<ShaderStageDesc> stages;
+        for (const auto& [name, shader] : m_Shaders) {
+            for (FeatureMask permutation : shader.Permutations) stages.push_back(MakeStage(shader, permutation));
+        }
+        return stages;
+    }
+
+    const ShaderLibrary::Shader& ShaderLibrary::Find(const std::string& name) const {
+        auto found = m_Shaders.find(name);
+        if (found == m_Shaders.end()) {
+            throw std::runtime_error("Shader " + name + " was never declared!");
+        }
+        return found->second;
+    }
+    ShaderStageDesc ShaderLibrary::MakeStage(const Shader& shader, FeatureMask mask) {
+        ShaderStageDesc stage;
+        stage.Stage = shader.Stage;
+        stage.Path = shader.Path;
+        /* Declaration order for both --> equal masks give equal descriptions and equal cache keys */
+        for (size_t i = 0; i < shader.Features.size(); i++) {
+            const ShaderFeature& feature = shader.Features[i];
+            bool enabled = (mask & (1u << i)) != 0;
+            if (feature.Kind == ShaderFeatureKind::Define) {
+                if (enabled) stage.Defines.push_back({ feature.Name, "1" });
+            } else {
+                stage.Specialization.push_back({ feature.ConstantId, enabled ? VK_TRUE : VK_FALSE }); // written even when off --> never depends on the default in the GLSL
+            }
+        }
+        return stage;
+    }
+    uint32_t ShaderLibrary::CountBits(FeatureMask mask) {
+        uint32_t count = 0;
+        for (; mask != 0; mask &= mask - 1) count++;
+        return count;
+    }
+}
\ No newline at end of file
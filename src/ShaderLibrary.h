@@ -0,0 +1,47 @@
+#pragma once
+/* This Header declares the feature toggles of each shader --> resolves a feature list into a ShaderStageDesc, bounded by a permutation manifest */
+#include "pch.h"
+#include "PipelineDesc.h"
+#include <unordered_map>
+
+namespace VulkanPractice {
+    enum class ShaderFeatureKind : uint8_t {
+        Specialization, // layout(constant_id = ConstantId) const bool --> same module, set per pipeline
+        Define // #ifdef Name --> different code, a module per combination
+    };
+    struct ShaderFeature {
+        std::string Name;
+        ShaderFeatureKind Kind = ShaderFeatureKind::Specialization;
+        uint32_t ConstantId = 0;
+    };
+
+    class ShaderLibrary {
+    public:
+        using FeatureMask = uint32_t; // bit i --> the i-th declared feature of a shader
+    private:
+        struct Shader {
+            VkShaderStageFlagBits Stage;
+            std::string Path;
+            std::vector<ShaderFeature> Features;
+            FeatureMask DefineFeatures = 0;
+            std::vector<FeatureMask> Permutations; // define combinations listed in the manifest, 0 always included
+        };
+        std::unordered_map<std::string, Shader> m_Shaders;
+    public:
+        /* name is what the manifest and Get refer to, usually the file name */
+        void Declare(const std::string& name, VkShaderStageFlagBits stage, const std::string& path, const std::vector<ShaderFeature>& features);
+        /* One permutation per line: shader name, then its enabled features separated by spaces --> # starts a comment.
+           Only define features matter, specialization features are free and accepted anywhere. A missing file leaves only the base permutations */
+        void LoadManifest(const std::string& path);
+
+        /* Features a shader does not declare are ignored --> one list can serve every stage of a pipeline.
+           A define combination the manifest does not list falls back to the largest listed subset, so no unplanned module compiles */
+        ShaderStageDesc Get(const std::string& name, const std::vector<std::string>& features) const;
+        /* One stage per listed define combination --> what to compile ahead of time */
+        std::vector<ShaderStageDesc> GetPrebuiltStages() const;
+    private:
+        const Shader& Find(const std::string& name) const;
+        static ShaderStageDesc MakeStage(const Shader& shader, FeatureMask mask);
+        static uint32_t CountBits(FeatureMask mask);
+    };
+}
\ No newline at end of file
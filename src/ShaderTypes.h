@@ -0,0 +1,61 @@
+#pragma once
+/* This Header mirrors the shader interface blocks --> layouts must match assets/shaders/GLSL */
+#include "pch.h"
+#ifndef GLM_FORCE_RADIANS
+#define GLM_FORCE_RADIANS
+#endif
+#ifndef GLM_FORCE_DEPTH_ZERO_TO_ONE
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#endif
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+namespace VulkanPractice {
+    /* set = 0, binding = 0 --> std140, written once per frame into the UniformRing */
+    struct FrameUniforms {
+        glm::mat4 View;
+        glm::mat4 Projection;
+    };
+    /* push_constant --> per draw, must stay within the guaranteed 128 bytes */
+    struct DrawPushConstants {
+        glm::mat4 Model;
+    };
+    /* push_constant of upscale.frag --> see DynamicResolution */
+    struct UpscalePushConstants {
+        glm::vec2 UvScale;
+        glm::vec2 UvMax;
+        glm::vec2 TexelSize;
+        float Sharpness;
+    };
+    /* set = 1, binding = 0 of basic.vert, binding = 0 of cull.comp --> std430, one per object, indexed by gl_InstanceIndex */
+    struct ObjectData {
+        glm::mat4 Model;
+    };
+    /* push_constant of cull.comp --> see OcclusionCuller */
+    struct CullPushConstants {
+        glm::mat4 ViewProjection; // projection * view * draw model, object models are applied in the shader
+        glm::vec4 BoundsMin; // mesh bounds in model space, w unused
+        glm::vec4 BoundsMax;
+        glm::vec2 PyramidSize; // texels of level 0
+        uint32_t ObjectCount;
+        uint32_t Phase; // 0 --> against the previous frame's pyramid, 1 --> re-test the rejected ones against this frame's
+        uint32_t IndexCount;
+        uint32_t StatsOffset; // first counter of the slot
+    };
+    /* push_constant of hiz.comp */
+    struct HiZPushConstants {
+        uint32_t SourceWidth, SourceHeight; // level 0 reads only the rendered part of the depth buffer
+        uint32_t DestinationWidth, DestinationHeight;
+    };
+    /* push_constant of batch2d.vert --> see Renderer2D */
+    struct Batch2DPushConstants {
+        glm::vec2 Scale; // 2 / extent, pixels --> clip space
+    };
+    static_assert(sizeof(FrameUniforms) == 128, "FrameUniforms must match the std140 block");
+    static_assert(sizeof(DrawPushConstants) <= 128, "Push constants exceed the guaranteed minimum");
+    static_assert(sizeof(UpscalePushConstants) == 28, "UpscalePushConstants must match the std430 block");
+    static_assert(sizeof(ObjectData) == 64, "ObjectData must match the std430 struct");
+    static_assert(sizeof(CullPushConstants) <= 128, "Push constants exceed the guaranteed minimum");
+    static_assert(sizeof(Batch2DPushConstants) == 8, "Batch2DPushConstants must match the push_constant block");
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "SimdKernels.h"
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAS_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#include "SimdKernels.inl"
+
+namespace VulkanPractice {
+    namespace {
+        struct ScalarLane {
+            using Value = float;
+            using Mask = bool;
+            inline static constexpr size_t Width = 1;
+            static inline Value Load(const float* p) { return *p; }
+            static inline Value Gather(const float* base, const uint32_t* indices) { return base[indices[0]]; }
+            static inline void Store(float* p, Value v) { *p = v; }
+            static inline Value Set(float v) { return v; }
+            static inline Value Add(Value a, Value b) { return a + b; }
+            static inline Value Mul(Value a, Value b) { return a * b; }
+            static inline Value MulAdd(Value a, Value b, Value c) { return a * b + c; }
+            static inline Value Abs(Value a) { return std::fabs(a); }
+            static inline Value Min(Value a, Value b) { return std::min(a, b); }
+            static inline Value Max(Value a, Value b) { return std::max(a, b); }
+            static inline Value Sqrt(Value a) { return std::sqrt(a); }
+            static inline Mask GreaterEqual(Value a, Value b) { return a >= b; }
+            static inline Mask And(Mask a, Mask b) { return a && b; }
+            static inline uint32_t Bits(Mask m) { return m ? 1u : 0u; }
+        };
+
+        void MultiplyParentsScalar(const ConstMatrixStreams& parents, const uint32_t* parentIndices, const ConstMatrixStreams& local, const MatrixStreams& out, size_t first, size_t count) {
+            MultiplyParentsLanes<ScalarLane>(parents, parentIndices, local, out, first, first + count);
+        }
+        void TransformBoundsScalar(const ConstMatrixStreams& world, const ConstBoundsStreams& local, const BoundsStreams& out, size_t first, size_t count) {
+            TransformBoundsLanes<ScalarLane>(world, local, out, first, first + count);
+        }
+        size_t CullBoundsScalar(const FrustumPlanes& frustum, const ConstBoundsStreams& bounds, size_t first, size_t count, uint32_t* visible) {
+            return CullBoundsLanes<ScalarLane>(frustum, bounds, first, first + count, visible);
+        }
+        const SimdKernels s_ScalarKernels{ SimdLevel::Scalar, "scalar", MultiplyParentsScalar, TransformBoundsScalar, CullBoundsScalar };
+
+#ifdef HAS_SSE2
+        /* SSE2 is the x86-64 baseline --> no runtime check needed */
+        struct SseLane {
+            using Value = __m128;
+            using Mask = __m128;
+            inline static constexpr size_t Width = 4;
+            static inline Value Load(const float* p) { return _mm_loadu_ps(p); }
+            static inline Value Gather(const float* base, const uint32_t* indices) { return _mm_setr_ps(base[indices[0]], base[indices[1]], base[indices[2]], base[indices[3]]); }
+            static inline void Store(float* p, Value v) { _mm_storeu_ps(p, v); }
+            static inline Value Set(float v) { return _mm_set1_ps(v); }
+            static inline Value Add(Value a, Value b) { return _mm_add_ps(a, b); }
+            static inline Value Mul(Value a, Value b) { return _mm_mul_ps(a, b); }
+            static inline Value MulAdd(Value a, Value b, Value c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+            static inline Value Abs(Value a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+            static inline Value Min(Value a, Value b) { return _mm_min_ps(a, b); }
+            static inline Value Max(Value a, Value b) { return _mm_max_ps(a, b); }
+            static inline Value Sqrt(Value a) { return _mm_sqrt_ps(a); }
+            static inline Mask GreaterEqual(Value a, Value b) { return _mm_cmpge_ps(a, b); }
+            static inline Mask And(Mask a, Mask b) { return _mm_and_ps(a, b); }
+            static inline uint32_t Bits(Mask m) { return static_cast<uint32_t>(_mm_movemask_ps(m)); }
+        };
+
+        void MultiplyParentsSse(const ConstMatrixStreams& parents, const uint32_t* parentIndices, const ConstMatrixStreams& local, const MatrixStreams& out, size_t first, size_t count) {
+            size_t i = first, end = first + count;
+            MultiplyParentsLanes<SseLane>(parents, parentIndices, local, out, i, end);
+            MultiplyParentsLanes<ScalarLane>(parents, parentIndices, local, out, i, end);
+        }
+        void TransformBoundsSse(const ConstMatrixStreams& world, const ConstBoundsStreams& local, const BoundsStreams& out, size_t first, size_t count) {
+            size_t i = first, end = first + count;
+            TransformBoundsLanes<SseLane>(world, local, out, i, end);
+            TransformBoundsLanes<ScalarLane>(world, local, out, i, end);
+        }
+        size_t CullBoundsSse(const FrustumPlanes& frustum, const ConstBoundsStreams& bounds, size_t first, size_t count, uint32_t* visible) {
+            size_t i = first, end = first + count;
+            size_t visibleCount = CullBoundsLanes<SseLane>(frustum, bounds, i, end, visible);
+            return visibleCount + CullBoundsLanes<ScalarLane>(frustum, bounds, i, end, visible + visibleCount);
+        }
+        const SimdKernels s_SseKernels{ SimdLevel::Sse, "sse", MultiplyParentsSse, TransformBoundsSse, CullBoundsSse };
+
+        bool CpuSupportsAvx2() {
+            /* AVX2 + FMA in cpuid and the OS saving ymm registers (XCR0 bits 1 and 2) */
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) return false;
+            __cpuid(info, 1);
+            uint32_t ecx1 = static_cast<uint32_t>(info[2]);
+            __cpuidex(info, 7, 0);
+            uint32_t ebx7 = static_cast<uint32_t>(info[1]);
+#else
+            unsigned int eax, ebx, ecx, edx;
+            if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+            uint32_t ecx1 = ecx;
+            if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+            uint32_t ebx7 = ebx;
+#endif
+            bool fma = (ecx1 & (1u << 12)) != 0, osxsave = (ecx1 & (1u << 27)) != 0, avx = (ecx1 & (1u << 28)) != 0;
+            bool avx2 = (ebx7 & (1u << 5)) != 0;
+            if (!fma || !osxsave || !avx || !avx2) return false;
+#if defined(_MSC_VER)
+            uint64_t xcr0 = _xgetbv(0);
+#else
+            uint32_t xcr0Low, xcr0High;
+            __asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+            uint64_t xcr0 = (static_cast<uint64_t>(xcr0High) << 32) | xcr0Low;
+#endif
+            return (xcr0 & 0x6) == 0x6;
+        }
+#endif
+    }
+
+    SimdLevel DetectSimdLevel() {
+#ifdef HAS_SSE2
+        if (SimdDetail::GetAvx2Kernels() && CpuSupportsAvx2()) return SimdLevel::Avx2;
+        return SimdLevel::Sse;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+    const SimdKernels& GetSimdKernels(SimdLevel level) {
+        static const SimdLevel supported = DetectSimdLevel();
+        level = std::min(level, supported);
+#ifdef HAS_SSE2
+        if (level == SimdLevel::Avx2) return *SimdDetail::GetAvx2Kernels();
+        if (level == SimdLevel::Sse) return s_SseKernels;
+#endif
+        return s_ScalarKernels;
+    }
+    const SimdKernels& GetSimdKernels() {
+        static const SimdKernels& kernels = GetSimdKernels(DetectSimdLevel());
+        return kernels;
+    }
+}
\ No newline at end of file
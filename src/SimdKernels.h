@@ -0,0 +1,56 @@
+#pragma once
+/* This Header declares the batch kernels behind TransformSystem --> plain float streams, no glm or Vulkan, picked once per process by CPU features */
+#include <stddef.h>
+#include <stdint.h>
+
+namespace VulkanPractice {
+    /* One stream per element, column major like glm --> element e is column e / 4, row e % 4 */
+    struct MatrixStreams {
+        float* Elements[16];
+    };
+    struct ConstMatrixStreams {
+        const float* Elements[16];
+    };
+    /* Center + half extents of a box and the radius of a sphere around the same center */
+    struct BoundsStreams {
+        float* CenterX; float* CenterY; float* CenterZ;
+        float* ExtentX; float* ExtentY; float* ExtentZ;
+        float* Radius;
+    };
+    struct ConstBoundsStreams {
+        const float* CenterX; const float* CenterY; const float* CenterZ;
+        const float* ExtentX; const float* ExtentY; const float* ExtentZ;
+        const float* Radius;
+    };
+    /* Normalized planes (x, y, z, w) facing inwards --> a point p is inside when dot(xyz, p) + w >= 0 */
+    struct FrustumPlanes {
+        float Planes[6][4];
+    };
+
+    enum class SimdLevel : uint8_t {
+        Scalar, Sse, Avx2
+    };
+
+    /* Streams are indexed [first, first + count) --> no alignment or padding required, tails run the scalar path */
+    struct SimdKernels {
+        SimdLevel Level;
+        const char* Name;
+        /* out[i] = parents[parentIndices[i]] * local[i] --> parents and out may be the same streams as long as no parent lies in [first, first + count) */
+        void (*MultiplyParents)(const ConstMatrixStreams& parents, const uint32_t* parentIndices, const ConstMatrixStreams& local, const MatrixStreams& out, size_t first, size_t count);
+        /* Local bounds through world matrices --> box stays axis aligned, radius scales by the largest axis */
+        void (*TransformBounds)(const ConstMatrixStreams& world, const ConstBoundsStreams& local, const BoundsStreams& out, size_t first, size_t count);
+        /* Sphere and box against every plane --> writes indices of survivors to visible (room for count entries), returns how many */
+        size_t (*CullBounds)(const FrustumPlanes& frustum, const ConstBoundsStreams& bounds, size_t first, size_t count, uint32_t* visible);
+    };
+
+    SimdLevel DetectSimdLevel();
+    /* Clamped to what the CPU runs --> asking for Avx2 on an SSE-only machine returns the SSE kernels */
+    const SimdKernels& GetSimdKernels(SimdLevel level);
+    /* Best level for this CPU, detected on first use */
+    const SimdKernels& GetSimdKernels();
+
+    namespace SimdDetail {
+        /* Defined in SimdKernelsAvx2.cpp --> the only file built with AVX2 code generation */
+        const SimdKernels* GetAvx2Kernels();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+/* Kernel loops shared by every instruction set --> included by SimdKernels.cpp and SimdKernelsAvx2.cpp, each with its own Lane type.
+ * A Lane provides Value, Mask, Width and Load, Gather, Store, Set, Add, Mul, MulAdd (a * b + c), Abs, Min, Max, Sqrt, GreaterEqual, And, Bits.
+ * Every loop advances i over whole lanes only and leaves the tail [i, end) to the caller.
+ * No standard headers in here --> anything inline would be emitted with the including file's code generation. */
+
+namespace VulkanPractice {
+    namespace {
+        template<typename Lane>
+        void MultiplyParentsLanes(const ConstMatrixStreams& parents, const uint32_t* parentIndices, const ConstMatrixStreams& local, const MatrixStreams& out, size_t& i, size_t end) {
+            using Value = typename Lane::Value;
+            for (; i + Lane::Width <= end; i += Lane::Width) {
+                /* Parents gathered straight into registers --> siblings are neighbours, so most of these hit the same cache lines */
+                Value l[16];
+                for (int e = 0; e < 16; e++) l[e] = Lane::Gather(parents.Elements[e], parentIndices + i);
+                for (int column = 0; column < 4; column++) {
+                    Value r0 = Lane::Load(local.Elements[column * 4 + 0] + i);
+                    Value r1 = Lane::Load(local.Elements[column * 4 + 1] + i);
+                    Value r2 = Lane::Load(local.Elements[column * 4 + 2] + i);
+                    Value r3 = Lane::Load(local.Elements[column * 4 + 3] + i);
+                    for (int row = 0; row < 4; row++) {
+                        Value sum = Lane::Mul(l[row], r0);
+                        sum = Lane::MulAdd(l[4 + row], r1, sum);
+                        sum = Lane::MulAdd(l[8 + row], r2, sum);
+                        sum = Lane::MulAdd(l[12 + row], r3, sum);
+                        Lane::Store(out.Elements[column * 4 + row] + i, sum);
+                    }
+                }
+            }
+        }
+
+        template<typename Lane>
+        void TransformBoundsLanes(const ConstMatrixStreams& world, const ConstBoundsStreams& local, const BoundsStreams& out, size_t& i, size_t end) {
+            using Value = typename Lane::Value;
+            const float* const* m = world.Elements;
+            for (; i + Lane::Width <= end; i += Lane::Width) {
+                Value cx = Lane::Load(local.CenterX + i), cy = Lane::Load(local.CenterY + i), cz = Lane::Load(local.CenterZ + i);
+                Value ex = Lane::Load(local.ExtentX + i), ey = Lane::Load(local.ExtentY + i), ez = Lane::Load(local.ExtentZ + i);
+                Value scaleSquared = Lane::Set(0.0f);
+                Value center[3], extent[3];
+                for (int row = 0; row < 3; row++) {
+                    Value m0 = Lane::Load(m[row] + i), m1 = Lane::Load(m[4 + row] + i), m2 = Lane::Load(m[8 + row] + i);
+                    /* Point through the full matrix, half extents through the absolute 3x3 --> tightest box around the rotated one */
+                    center[row] = Lane::MulAdd(m0, cx, Lane::MulAdd(m1, cy, Lane::MulAdd(m2, cz, Lane::Load(m[12 + row] + i))));
+                    extent[row] = Lane::MulAdd(Lane::Abs(m0), ex, Lane::MulAdd(Lane::Abs(m1), ey, Lane::Mul(Lane::Abs(m2), ez)));
+                }
+                for (int column = 0; column < 3; column++) {
+                    Value a = Lane::Load(m[column * 4] + i), b = Lane::Load(m[column * 4 + 1] + i), c = Lane::Load(m[column * 4 + 2] + i);
+                    scaleSquared = Lane::Max(scaleSquared, Lane::MulAdd(a, a, Lane::MulAdd(b, b, Lane::Mul(c, c))));
+                }
+                Lane::Store(out.CenterX + i, center[0]); Lane::Store(out.CenterY + i, center[1]); Lane::Store(out.CenterZ + i, center[2]);
+                Lane::Store(out.ExtentX + i, extent[0]); Lane::Store(out.ExtentY + i, extent[1]); Lane::Store(out.ExtentZ + i, extent[2]);
+                /* Negative radii mark unbounded nodes --> they pass through unscaled, a zero scale must not turn them into a point */
+                Value radius = Lane::Load(local.Radius + i), zero = Lane::Set(0.0f);
+                Lane::Store(out.Radius + i, Lane::MulAdd(Lane::Max(radius, zero), Lane::Sqrt(scaleSquared), Lane::Min(radius, zero)));
+            }
+        }
+
+        /* Returns how many indices were appended to visible */
+        template<typename Lane>
+        size_t CullBoundsLanes(const FrustumPlanes& frustum, const ConstBoundsStreams& bounds, size_t& i, size_t end, uint32_t* visible) {
+            using Value = typename Lane::Value;
+            using Mask = typename Lane::Mask;
+            /* Planes splat once --> the loop only loads bounds */
+            Value px[6], py[6], pz[6], pw[6], ax[6], ay[6], az[6];
+            for (int p = 0; p < 6; p++) {
+                px[p] = Lane::Set(frustum.Planes[p][0]); py[p] = Lane::Set(frustum.Planes[p][1]);
+                pz[p] = Lane::Set(frustum.Planes[p][2]); pw[p] = Lane::Set(frustum.Planes[p][3]);
+                ax[p] = Lane::Abs(px[p]); ay[p] = Lane::Abs(py[p]); az[p] = Lane::Abs(pz[p]);
+            }
+            Value zero = Lane::Set(0.0f);
+            size_t visibleCount = 0;
+            for (; i + Lane::Width <= end; i += Lane::Width) {
+                Value cx = Lane::Load(bounds.CenterX + i), cy = Lane::Load(bounds.CenterY + i), cz = Lane::Load(bounds.CenterZ + i);
+                Value ex = Lane::Load(bounds.ExtentX + i), ey = Lane::Load(bounds.ExtentY + i), ez = Lane::Load(bounds.ExtentZ + i);
+                Value radius = Lane::Load(bounds.Radius + i);
+                Mask inside = Lane::GreaterEqual(zero, zero);
+                for (int p = 0; p < 6; p++) {
+                    Value distance = Lane::MulAdd(px[p], cx, Lane::MulAdd(py[p], cy, Lane::MulAdd(pz[p], cz, pw[p])));
+                    /* Sphere and box each reject on their own --> an object survives only if neither lies fully behind the plane */
+                    Value reach = Lane::MulAdd(ax[p], ex, Lane::MulAdd(ay[p], ey, Lane::Mul(az[p], ez)));
+                    inside = Lane::And(inside, Lane::GreaterEqual(Lane::Add(distance, radius), zero));
+                    inside = Lane::And(inside, Lane::GreaterEqual(Lane::Add(distance, reach), zero));
+                }
+                /* Branchless compaction --> every lane writes, only survivors advance the cursor */
+                uint32_t bits = Lane::Bits(inside);
+                for (uint32_t lane = 0; lane < Lane::Width; lane++) {
+                    visible[visibleCount] = static_cast<uint32_t>(i + lane);
+                    visibleCount += (bits >> lane) & 1u;
+                }
+            }
+            return visibleCount;
+        }
+    }
+}
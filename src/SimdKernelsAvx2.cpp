@@ -0,0 +1,62 @@
+/* Built with AVX2 + FMA code generation (see CMakeLists.txt) and without the precompiled header --> only reached after DetectSimdLevel confirmed the CPU runs it */
+#include "SimdKernels.h"
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#include <immintrin.h>
+#include "SimdKernels.inl"
+
+namespace VulkanPractice {
+    namespace {
+        struct Avx2Lane {
+            using Value = __m256;
+            using Mask = __m256;
+            inline static constexpr size_t Width = 8;
+            static inline Value Load(const float* p) { return _mm256_loadu_ps(p); }
+            static inline Value Gather(const float* base, const uint32_t* indices) {
+                return _mm256_i32gather_ps(base, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices)), 4);
+            }
+            static inline void Store(float* p, Value v) { _mm256_storeu_ps(p, v); }
+            static inline Value Set(float v) { return _mm256_set1_ps(v); }
+            static inline Value Add(Value a, Value b) { return _mm256_add_ps(a, b); }
+            static inline Value Mul(Value a, Value b) { return _mm256_mul_ps(a, b); }
+            static inline Value MulAdd(Value a, Value b, Value c) { return _mm256_fmadd_ps(a, b, c); }
+            static inline Value Abs(Value a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+            static inline Value Min(Value a, Value b) { return _mm256_min_ps(a, b); }
+            static inline Value Max(Value a, Value b) { return _mm256_max_ps(a, b); }
+            static inline Value Sqrt(Value a) { return _mm256_sqrt_ps(a); }
+            static inline Mask GreaterEqual(Value a, Value b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+            static inline Mask And(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+            static inline uint32_t Bits(Mask m) { return static_cast<uint32_t>(_mm256_movemask_ps(m)); }
+        };
+
+        /* Tails go through the scalar kernels of SimdKernels.cpp --> nothing scalar is compiled in this file */
+        void MultiplyParentsAvx2(const ConstMatrixStreams& parents, const uint32_t* parentIndices, const ConstMatrixStreams& local, const MatrixStreams& out, size_t first, size_t count) {
+            size_t i = first, end = first + count;
+            MultiplyParentsLanes<Avx2Lane>(parents, parentIndices, local, out, i, end);
+            GetSimdKernels(SimdLevel::Scalar).MultiplyParents(parents, parentIndices, local, out, i, end - i);
+        }
+        void TransformBoundsAvx2(const ConstMatrixStreams& world, const ConstBoundsStreams& local, const BoundsStreams& out, size_t first, size_t count) {
+            size_t i = first, end = first + count;
+            TransformBoundsLanes<Avx2Lane>(world, local, out, i, end);
+            GetSimdKernels(SimdLevel::Scalar).TransformBounds(world, local, out, i, end - i);
+        }
+        size_t CullBoundsAvx2(const FrustumPlanes& frustum, const ConstBoundsStreams& bounds, size_t first, size_t count, uint32_t* visible) {
+            size_t i = first, end = first + count;
+            size_t visibleCount = CullBoundsLanes<Avx2Lane>(frustum, bounds, i, end, visible);
+            return visibleCount + GetSimdKernels(SimdLevel::Scalar).CullBounds(frustum, bounds, i, end - i, visible + visibleCount);
+        }
+        const SimdKernels s_Avx2Kernels{ SimdLevel::Avx2, "avx2", MultiplyParentsAvx2, TransformBoundsAvx2, CullBoundsAvx2 };
+    }
+
+    const SimdKernels* SimdDetail::GetAvx2Kernels() {
+        return &s_Avx2Kernels;
+    }
+}
+#else
+namespace VulkanPractice {
+    /* Compiler or target without AVX2 --> DetectSimdLevel stops at SSE */
+    const SimdKernels* SimdDetail::GetAvx2Kernels() {
+        return nullptr;
+    }
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "SwapchainTarget.h"
+#include "VulkanUtils.h"
+
+namespace VulkanPractice {
+    SwapchainTarget::SwapchainTarget(const DeviceContext& context, VkInstance instance, std::unique_ptr<Window> window, VkSurfaceKHR surface, const SwapchainTargetDesc& desc)
+        : m_DeviceContext(context), m_VkInstance(instance), m_Desc(desc), m_Window(std::move(window)), m_VkSurfaceKHR(surface)
+    {
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = m_DeviceContext.GraphicsQueueFamily;
+        if (vkCreateCommandPool(m_DeviceContext.Device, &poolInfo, m_DeviceContext.Allocator, &m_VkCommandPool) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create window command pool!");
+        }
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = m_VkCommandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = m_Desc.FramesInFlight;
+        m_CommandBuffers.resize(m_Desc.FramesInFlight);
+        if (vkAllocateCommandBuffers(m_DeviceContext.Device, &allocInfo, m_CommandBuffers.data()) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate window command buffers!");
+        }
+        /* Frame slot fences belong to the application --> one fence covers every window of a batch */
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        m_ImageAvailableSemaphores.resize(m_Desc.FramesInFlight);
+        m_RenderFinishedSemaphores.resize(m_Desc.FramesInFlight);
+        for (uint32_t i = 0; i < m_Desc.FramesInFlight; i++) {
+            if (vkCreateSemaphore(m_DeviceContext.Device, &semaphoreInfo, m_DeviceContext.Allocator, &m_ImageAvailableSemaphores[i]) != VK_SUCCESS ||
+                vkCreateSemaphore(m_DeviceContext.Device, &semaphoreInfo, m_DeviceContext.Allocator, &m_RenderFinishedSemaphores[i]) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create window semaphores!");
+            }
+        }
+        CreateSwapchain();
+    }
+    SwapchainTarget::~SwapchainTarget() {
+        DestroySwapchain();
+        for (uint32_t i = 0; i < m_Desc.FramesInFlight; i++) {
+            vkDestroySemaphore(m_DeviceContext.Device, m_ImageAvailableSemaphores[i], m_DeviceContext.Allocator);
+            vkDestroySemaphore(m_DeviceContext.Device, m_RenderFinishedSemaphores[i], m_DeviceContext.Allocator);
+        }
+        vkDestroyCommandPool(m_DeviceContext.Device, m_VkCommandPool, m_DeviceContext.Allocator); // frees the command buffers
+        vkDestroySurfaceKHR(m_VkInstance, m_VkSurfaceKHR, m_DeviceContext.Allocator);
+    }
+
+    bool SwapchainTarget::Acquire(uint32_t frame) {
+        if (m_Resized) {
+            m_Resized = false;
+            Recreate();
+        }
+        if (m_VkSwapchainKHR == VK_NULL_HANDLE) return false; // minimized
+        VkResult result = m_DeviceContext.Dispatch->AcquireNextImageKHR(m_DeviceContext.Device, m_VkSwapchainKHR, UINT64_MAX,
+            m_ImageAvailableSemaphores[frame], VK_NULL_HANDLE, &m_ImageIndex);
+        /* Suboptimal still signals the semaphore --> present it and recreate on the present result */
+        if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+            Recreate();
+            return false;
+        } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+            throw std::runtime_error("Failed to acquire window swap chain image!");
+        }
+        return true;
+    }
+    void SwapchainTarget::HandlePresentResult(VkResult result) {
+        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+            m_Resized = true;
+        } else if (result != VK_SUCCESS) {
+            throw std::runtime_error("Failed to present window swap chain image!");
+        }
+    }
+
+    void SwapchainTarget::Recreate() {
+        vkDeviceWaitIdle(m_DeviceContext.Device);
+        DestroySwapchain();
+        CreateSwapchain();
+    }
+    void SwapchainTarget::CreateSwapchain() {
+        VkSurfaceCapabilitiesKHR capabilities;
+        vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_DeviceContext.PhysicalDevice, m_VkSurfaceKHR, &capabilities);
+        m_Extent = capabilities.currentExtent;
+        if (m_Extent.width == std::numeric_limits<uint32_t>::max()) {
+            int width, height;
+            glfwGetFramebufferSize(m_Window->GetNativeWindow(), &width, &height);
+            m_Extent.width = std::clamp(static_cast<uint32_t>(width), capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
+            m_Extent.height = std::clamp(static_cast<uint32_t>(height), capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
+        }
+        /* Unlike the main window a minimized extra window does not block the loop --> it has no swapchain until restored */
+        if (m_Extent.width == 0 || m_Extent.height == 0) return;
+        uint32_t imageCount = capabilities.minImageCount + 1;
+        if (capabilities.maxImageCount > 0 && imageCount > capabilities.maxImageCount) {
+            imageCount = capabilities.maxImageCount;
+        }
+
+        VkSwapchainCreateInfoKHR createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+        createInfo.surface = m_VkSurfaceKHR;
+        createInfo.minImageCount = imageCount;
+        createInfo.imageFormat = m_Desc.SurfaceFormat.format;
+        createInfo.imageColorSpace = m_Desc.SurfaceFormat.colorSpace;
+        createInfo.imageExtent = m_Extent;
+        createInfo.imageArrayLayers = 1;
+        createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        uint32_t queueFamilyIndices[] = { m_DeviceContext.GraphicsQueueFamily, m_Desc.PresentQueueFamily };
+        if (m_DeviceContext.GraphicsQueueFamily != m_Desc.PresentQueueFamily) {
+            createInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
+            createInfo.queueFamilyIndexCount = 2;
+            createInfo.pQueueFamilyIndices = queueFamilyIndices;
+        } else {
+            createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        }
+        createInfo.preTransform = capabilities.currentTransform;
+        createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+        createInfo.presentMode = m_Desc.PresentMode;
+        createInfo.clipped = VK_TRUE;
+        if (vkCreateSwapchainKHR(m_DeviceContext.Device, &createInfo, m_DeviceContext.Allocator, &m_VkSwapchainKHR) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create window swap chain!");
+        }
+        vkGetSwapchainImagesKHR(m_DeviceContext.Device, m_VkSwapchainKHR, &imageCount, nullptr);
+        m_Images.resize(imageCount);
+        vkGetSwapchainImagesKHR(m_DeviceContext.Device, m_VkSwapchainKHR, &imageCount, m_Images.data());
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = m_Desc.DepthFormat;
+        imageInfo.extent = { m_Extent.width, m_Extent.height, 1 };
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VulkanUtils::CreateImage(m_DeviceContext, imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_VkDepthImage, m_VkDepthImageMemory);
+        m_VkDepthImageView = VulkanUtils::CreateImageView(m_DeviceContext, m_VkDepthImage, m_Desc.DepthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, 1);
+
+        m_ImageViews.resize(m_Images.size());
+        m_Framebuffers.resize(m_Images.size());
+        for (size_t i = 0; i < m_Images.size(); i++) {
+            m_ImageViews[i] = VulkanUtils::CreateImageView(m_DeviceContext, m_Images[i], m_Desc.SurfaceFormat.format, VK_IMAGE_ASPECT_COLOR_BIT, 1);
+            VkImageView attachments[] = { m_ImageViews[i], m_VkDepthImageView };
+            VkFramebufferCreateInfo framebufferInfo{};
+            framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            framebufferInfo.renderPass = m_Desc.RenderPass;
+            framebufferInfo.attachmentCount = 2;
+            framebufferInfo.pAttachments = attachments;
+            framebufferInfo.width = m_Extent.width;
+            framebufferInfo.height = m_Extent.height;
+            framebufferInfo.layers = 1;
+            if (vkCreateFramebuffer(m_DeviceContext.Device, &framebufferInfo, m_DeviceContext.Allocator, &m_Framebuffers[i]) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create window framebuffer!");
+            }
+        }
+    }
+    void SwapchainTarget::DestroySwapchain() {
+        if (m_VkSwapchainKHR == VK_NULL_HANDLE) return;
+        for (size_t i = 0; i < m_Framebuffers.size(); i++) {
+            vkDestroyFramebuffer(m_DeviceContext.Device, m_Framebuffers[i], m_DeviceContext.Allocator);
+            vkDestroyImageView(m_DeviceContext.Device, m_ImageViews[i], m_DeviceContext.Allocator);
+        }
+        m_Framebuffers.clear();
+        m_ImageViews.clear();
+        vkDestroyImageView(m_DeviceContext.Device, m_VkDepthImageView, m_DeviceContext.Allocator);
+        vkDestroyImage(m_DeviceContext.Device, m_VkDepthImage, m_DeviceContext.Allocator);
+        vkFreeMemory(m_DeviceContext.Device, m_VkDepthImageMemory, m_DeviceContext.Allocator);
+        vkDestroySwapchainKHR(m_DeviceContext.Device, m_VkSwapchainKHR, m_DeviceContext.Allocator);
+        m_VkSwapchainKHR = VK_NULL_HANDLE;
+    }
+}
\ No newline at end of file
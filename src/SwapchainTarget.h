@@ -0,0 +1,68 @@
+#pragma once
+/* This Header handles one extra window on the shared device --> its own surface, swapchain, depth buffer, framebuffers and command pool, presented in the application's batch */
+#include "pch.h"
+#include "DeviceContext.h"
+#include "Window.h"
+
+namespace VulkanPractice {
+    struct SwapchainTargetDesc {
+        VkSurfaceFormatKHR SurfaceFormat{}; // must match the render pass color attachment
+        VkPresentModeKHR PresentMode = VK_PRESENT_MODE_FIFO_KHR;
+        VkFormat DepthFormat = VK_FORMAT_UNDEFINED;
+        VkRenderPass RenderPass = VK_NULL_HANDLE; // framebuffers are created against it
+        uint32_t FramesInFlight = 1; // one command buffer and semaphore pair per frame slot of the application
+        uint32_t PresentQueueFamily = 0; // differs from the graphics family --> images are shared concurrently
+    };
+
+    class SwapchainTarget {
+    private:
+        DeviceContext m_DeviceContext;
+        VkInstance m_VkInstance;
+        SwapchainTargetDesc m_Desc;
+        std::unique_ptr<Window> m_Window;
+        VkSurfaceKHR m_VkSurfaceKHR;
+
+        VkSwapchainKHR m_VkSwapchainKHR = VK_NULL_HANDLE;
+        std::vector<VkImage> m_Images;
+        std::vector<VkImageView> m_ImageViews;
+        VkExtent2D m_Extent{};
+        VkImage m_VkDepthImage = VK_NULL_HANDLE; // one for every framebuffer, like the main window's
+        VkDeviceMemory m_VkDepthImageMemory = VK_NULL_HANDLE;
+        VkImageView m_VkDepthImageView = VK_NULL_HANDLE;
+        std::vector<VkFramebuffer> m_Framebuffers;
+
+        VkCommandPool m_VkCommandPool = VK_NULL_HANDLE; // own pool --> recorded on its own thread next to the main window
+        std::vector<VkCommandBuffer> m_CommandBuffers; // by frame slot
+        std::vector<VkSemaphore> m_ImageAvailableSemaphores, m_RenderFinishedSemaphores; // by frame slot
+        uint32_t m_ImageIndex = 0; // of the last successful Acquire
+        bool m_Resized = false;
+    public:
+        /* Takes ownership of window and surface --> surface must support the graphics queue family and SurfaceFormat */
+        SwapchainTarget(const DeviceContext& context, VkInstance instance, std::unique_ptr<Window> window, VkSurfaceKHR surface, const SwapchainTargetDesc& desc);
+        ~SwapchainTarget();
+        SwapchainTarget(const SwapchainTarget&) = delete;
+        SwapchainTarget& operator=(const SwapchainTarget&) = delete;
+
+        /* After the frame slot's fence --> false while minimized or when the swapchain was just recreated, the window sits this frame out */
+        bool Acquire(uint32_t frame);
+        /* Entry of the batched present --> recreates on out of date or suboptimal, throws on anything else */
+        void HandlePresentResult(VkResult result);
+        /* From the window's framebuffer size callback --> recreated on the next Acquire */
+        inline void MarkResized() { m_Resized = true; }
+
+        inline bool ShouldClose() const { return glfwWindowShouldClose(m_Window->GetNativeWindow()); }
+        inline GLFWwindow* GetNativeWindow() const { return m_Window->GetNativeWindow(); }
+        inline VkExtent2D GetExtent() const { return m_Extent; }
+        inline VkSwapchainKHR GetSwapchain() const { return m_VkSwapchainKHR; }
+        inline uint32_t GetImageIndex() const { return m_ImageIndex; }
+        inline VkFramebuffer GetFramebuffer() const { return m_Framebuffers[m_ImageIndex]; }
+        inline const VkCommandBuffer& GetCommandBuffer(uint32_t frame) const { return m_CommandBuffers[frame]; }
+        inline const VkSemaphore& GetImageAvailableSemaphore(uint32_t frame) const { return m_ImageAvailableSemaphores[frame]; }
+        inline const VkSemaphore& GetRenderFinishedSemaphore(uint32_t frame) const { return m_RenderFinishedSemaphores[frame]; }
+    private:
+        /* Expects the device to be idle */
+        void Recreate();
+        void CreateSwapchain();
+        void DestroySwapchain();
+    };
+}
\ No newline at end of file
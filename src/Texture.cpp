@@ -0,0 +1,331 @@
+#include "Texture.h"
+#include "MappedFile.h"
+#include "VulkanUtils.h"
+#include <cstring>
+
+namespace VulkanPractice {
+    /* KTX2 layout --> https://registry.khronos.org/KTX/specs/2.0/ktxspec.v2.html */
+    static constexpr uint8_t Ktx2Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+    struct Ktx2Header {
+        uint8_t Identifier[12];
+        uint32_t Format; // VkFormat value, 0 for Basis payloads
+        uint32_t TypeSize;
+        uint32_t PixelWidth, PixelHeight, PixelDepth;
+        uint32_t LayerCount, FaceCount, LevelCount;
+        uint32_t SupercompressionScheme;
+        uint32_t DfdByteOffset, DfdByteLength;
+        uint32_t KvdByteOffset, KvdByteLength;
+        uint64_t SgdByteOffset, SgdByteLength;
+    };
+    struct Ktx2Level {
+        uint64_t ByteOffset, ByteLength, UncompressedByteLength;
+    };
+    static_assert(sizeof(Ktx2Header) == 80, "KTX2 header must match the file layout");
+    static_assert(sizeof(Ktx2Level) == 24, "KTX2 level index must match the file layout");
+
+    static VkDeviceSize GetLevelSize(const Texture::FormatBlockInfo& info, uint32_t width, uint32_t height) {
+        VkDeviceSize blocksX = (width + info.BlockWidth - 1) / info.BlockWidth;
+        VkDeviceSize blocksY = (height + info.BlockHeight - 1) / info.BlockHeight;
+        return blocksX * blocksY * info.BytesPerBlock;
+    }
+
+    Texture::Texture(const DeviceContext& context, const std::string& filepath)
+        : m_VkDevice(context.Device), m_Allocator(context.Allocator)
+    {
+        MappedFile file(filepath);
+        LoadKtx2(context, file.GetData(), file.GetSize(), filepath);
+    }
+    Texture::Texture(const DeviceContext& context, const uint8_t* data, size_t size, const std::string& name)
+        : m_VkDevice(context.Device), m_Allocator(context.Allocator)
+    {
+        LoadKtx2(context, data, size, name);
+    }
+    Texture::Texture(const DeviceContext& context, const TextureDesc& desc, const uint8_t* data, size_t size)
+        : m_VkDevice(context.Device), m_Allocator(context.Allocator)
+    {
+        FormatBlockInfo info = GetFormatBlockInfo(desc.Format);
+        if (info.BytesPerBlock == 0) {
+            throw std::runtime_error("Texture format is not supported by the loader!");
+        }
+        if (desc.Width == 0 || desc.Height == 0 || desc.MipLevels > GetFullMipCount(desc.Width, desc.Height)) {
+            throw std::runtime_error("Texture description has an empty extent or more levels than a full chain!");
+        }
+        std::vector<LevelData> levels;
+        VkDeviceSize offset = 0;
+        for (uint32_t level = 0; level < std::max(1U, desc.MipLevels); level++) {
+            VkDeviceSize levelSize = GetLevelSize(info, std::max(1U, desc.Width >> level), std::max(1U, desc.Height >> level));
+            if (levelSize > size - offset) { // offset never passes size --> the subtraction cannot wrap
+                throw std::runtime_error("Texture data is smaller than its description!");
+            }
+            levels.push_back({ data + offset, levelSize });
+            offset += levelSize;
+        }
+        Upload(context, desc, levels, "raw texture");
+    }
+    Texture::~Texture() {
+        VulkanUtils::FinishUpload(m_Upload, true);
+        vkDestroyImageView(m_VkDevice, m_VkImageView, m_Allocator);
+        vkDestroyImage(m_VkDevice, m_VkImage, m_Allocator);
+        vkFreeMemory(m_VkDevice, m_VkImageMemory, m_Allocator);
+    }
+
+    void Texture::LoadKtx2(const DeviceContext& context, const uint8_t* data, size_t size, const std::string& name) {
+        Ktx2Header header;
+        if (size < sizeof(header)) {
+            throw std::runtime_error("Texture is not a KTX2 file: " + name);
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.Identifier, Ktx2Identifier, sizeof(Ktx2Identifier)) != 0) {
+            throw std::runtime_error("Texture is not a KTX2 file: " + name);
+        }
+        if (header.Format == VK_FORMAT_UNDEFINED || header.SupercompressionScheme != 0) {
+            throw std::runtime_error("Texture uses Basis / supercompression which needs transcoding: " + name);
+        }
+        if (header.PixelWidth == 0 || header.PixelHeight == 0 || header.PixelDepth > 1 || header.LayerCount > 1 || header.FaceCount != 1) {
+            throw std::runtime_error("Texture is not a single 2D image: " + name);
+        }
+        if (header.LevelCount > GetFullMipCount(header.PixelWidth, header.PixelHeight)) {
+            throw std::runtime_error("Texture has more mip levels than its extent allows: " + name);
+        }
+        uint32_t levelCount = std::max(1U, header.LevelCount); // 0 --> loader is asked to generate mips
+        size_t levelIndexOffset = sizeof(Ktx2Header);
+        if (levelIndexOffset + levelCount * sizeof(Ktx2Level) > size) {
+            throw std::runtime_error("Texture is truncated or corrupt: " + name);
+        }
+
+        TextureDesc desc;
+        desc.Width = header.PixelWidth;
+        desc.Height = header.PixelHeight;
+        desc.Format = static_cast<VkFormat>(header.Format);
+        desc.MipLevels = levelCount;
+        desc.GenerateMips = header.LevelCount == 0;
+        std::vector<LevelData> levels(levelCount);
+        for (uint32_t level = 0; level < levelCount; level++) {
+            Ktx2Level entry;
+            std::memcpy(&entry, data + levelIndexOffset + level * sizeof(Ktx2Level), sizeof(entry));
+            if (entry.ByteOffset > size || entry.ByteLength > size - entry.ByteOffset) {
+                throw std::runtime_error("Texture is truncated or corrupt: " + name);
+            }
+            levels[level] = { data + entry.ByteOffset, entry.ByteLength };
+        }
+        Upload(context, desc, levels, name);
+    }
+
+    void Texture::Upload(const DeviceContext& context, const TextureDesc& desc, const std::vector<LevelData>& levels, const std::string& name) {
+        FormatBlockInfo info = GetFormatBlockInfo(desc.Format);
+        if (info.BytesPerBlock == 0 || !IsFormatSupported(context, desc.Format)) {
+            throw std::runtime_error("Texture format is not supported by this device: " + name);
+        }
+        m_VkFormat = desc.Format;
+        m_VkExtent = { desc.Width, desc.Height };
+
+        /* Blit-based generation needs a filterable, blittable, uncompressed format */
+        uint32_t providedLevels = static_cast<uint32_t>(levels.size());
+        bool generate = false;
+        if (desc.GenerateMips && !info.Compressed && providedLevels < GetFullMipCount(desc.Width, desc.Height)) {
+            VkFormatProperties formatProperties;
+            vkGetPhysicalDeviceFormatProperties(context.PhysicalDevice, desc.Format, &formatProperties);
+            constexpr VkFormatFeatureFlags required = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+            generate = (formatProperties.optimalTilingFeatures & required) == required;
+        }
+        m_MipLevels = generate ? GetFullMipCount(desc.Width, desc.Height) : providedLevels;
+
+        /* All provided levels go into one staging buffer --> 16 byte offsets satisfy every block size used here */
+        std::vector<VkBufferImageCopy> regions(providedLevels);
+        VkDeviceSize stagingSize = 0;
+        for (uint32_t level = 0; level < providedLevels; level++) {
+            uint32_t width = std::max(1U, desc.Width >> level), height = std::max(1U, desc.Height >> level);
+            if (levels[level].Size < GetLevelSize(info, width, height)) {
+                throw std::runtime_error("Texture mip level is truncated: " + name);
+            }
+            stagingSize = (stagingSize + 15) & ~VkDeviceSize(15);
+            regions[level] = {};
+            regions[level].bufferOffset = stagingSize;
+            regions[level].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            regions[level].imageSubresource.mipLevel = level;
+            regions[level].imageSubresource.baseArrayLayer = 0;
+            regions[level].imageSubresource.layerCount = 1;
+            regions[level].imageExtent = { width, height, 1 };
+            stagingSize += GetLevelSize(info, width, height);
+        }
+        VkBuffer stagingBuffer;
+        VkDeviceMemory stagingBufferMemory;
+        VulkanUtils::CreateBuffer(
+            context, stagingSize,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            stagingBuffer, stagingBufferMemory
+        );
+        void* mapped;
+        vkMapMemory(m_VkDevice, stagingBufferMemory, 0, stagingSize, 0, &mapped);
+        for (uint32_t level = 0; level < providedLevels; level++) {
+            VkDeviceSize levelSize = GetLevelSize(info, regions[level].imageExtent.width, regions[level].imageExtent.height);
+            std::memcpy(static_cast<uint8_t*>(mapped) + regions[level].bufferOffset, levels[level].Data, static_cast<size_t>(levelSize));
+        }
+        vkUnmapMemory(m_VkDevice, stagingBufferMemory);
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = m_VkFormat;
+        imageInfo.extent = { desc.Width, desc.Height, 1 };
+        imageInfo.mipLevels = m_MipLevels;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | (generate ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0);
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VulkanUtils::CreateImage(context, imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_VkImage, m_VkImageMemory);
+        for (uint32_t level = 0; level < m_MipLevels; level++) {
+            m_ResidentBytes += GetLevelSize(info, std::max(1U, desc.Width >> level), std::max(1U, desc.Height >> level));
+        }
+
+        VkCommandBuffer commandBuffer = VulkanUtils::BeginSingleTimeCommands(context);
+        {
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = m_VkImage;
+            barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, m_MipLevels, 0, 1 };
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+            vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, m_VkImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, providedLevels, regions.data());
+
+            if (generate) {
+                GenerateMips(commandBuffer, providedLevels);
+            } else {
+                barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+                barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+                vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+            }
+        }
+        m_Upload = VulkanUtils::SubmitUpload(context, commandBuffer, stagingBuffer, stagingBufferMemory); // the final barriers release every level to the shaders
+
+        m_VkImageView = VulkanUtils::CreateImageView(context, m_VkImage, m_VkFormat, VK_IMAGE_ASPECT_COLOR_BIT, m_MipLevels);
+    }
+
+    void Texture::GenerateMips(VkCommandBuffer commandBuffer, uint32_t firstLevel) {
+        /* Every level is in TRANSFER_DST here --> each blit source is flipped to TRANSFER_SRC then released to the shader */
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = m_VkImage;
+        barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+        if (firstLevel > 1) {
+            barrier.subresourceRange.baseMipLevel = 0;
+            barrier.subresourceRange.levelCount = firstLevel - 1;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+            barrier.subresourceRange.levelCount = 1;
+        }
+
+        int32_t mipWidth = static_cast<int32_t>(std::max(1U, m_VkExtent.width >> (firstLevel - 1)));
+        int32_t mipHeight = static_cast<int32_t>(std::max(1U, m_VkExtent.height >> (firstLevel - 1)));
+        for (uint32_t level = firstLevel; level < m_MipLevels; level++) {
+            barrier.subresourceRange.baseMipLevel = level - 1;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+            int32_t nextWidth = std::max(1, mipWidth / 2), nextHeight = std::max(1, mipHeight / 2);
+            VkImageBlit blit{};
+            blit.srcOffsets[0] = { 0, 0, 0 };
+            blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
+            blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 1 };
+            blit.dstOffsets[0] = { 0, 0, 0 };
+            blit.dstOffsets[1] = { nextWidth, nextHeight, 1 };
+            blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1 };
+            vkCmdBlitImage(commandBuffer,
+                m_VkImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                m_VkImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                1, &blit, VK_FILTER_LINEAR);
+
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+            mipWidth = nextWidth;
+            mipHeight = nextHeight;
+        }
+        /* Last level was only ever written */
+        barrier.subresourceRange.baseMipLevel = m_MipLevels - 1;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    Texture::FormatBlockInfo Texture::GetFormatBlockInfo(VkFormat format) {
+        switch (format) {
+            case VK_FORMAT_R8_UNORM: case VK_FORMAT_R8_SNORM:
+                return { 1, 1, 1, false };
+            case VK_FORMAT_R8G8_UNORM: case VK_FORMAT_R8G8_SNORM: case VK_FORMAT_R16_UNORM: case VK_FORMAT_R16_SFLOAT:
+                return { 1, 1, 2, false };
+            case VK_FORMAT_R8G8B8A8_UNORM: case VK_FORMAT_R8G8B8A8_SNORM: case VK_FORMAT_R8G8B8A8_SRGB:
+            case VK_FORMAT_B8G8R8A8_UNORM: case VK_FORMAT_B8G8R8A8_SRGB:
+            case VK_FORMAT_A2B10G10R10_UNORM_PACK32: case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+            case VK_FORMAT_R16G16_UNORM: case VK_FORMAT_R16G16_SFLOAT: case VK_FORMAT_R32_SFLOAT:
+                return { 1, 1, 4, false };
+            case VK_FORMAT_R16G16B16A16_UNORM: case VK_FORMAT_R16G16B16A16_SFLOAT: case VK_FORMAT_R32G32_SFLOAT:
+                return { 1, 1, 8, false };
+            case VK_FORMAT_R32G32B32A32_SFLOAT:
+                return { 1, 1, 16, false };
+            default:
+                break;
+        }
+        /* Compressed families are contiguous in VkFormat */
+        if (format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK) {
+            bool eightByte = format <= VK_FORMAT_BC1_RGBA_SRGB_BLOCK || format == VK_FORMAT_BC4_UNORM_BLOCK || format == VK_FORMAT_BC4_SNORM_BLOCK;
+            return { 4, 4, eightByte ? 8U : 16U, true };
+        }
+        if (format >= VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK && format <= VK_FORMAT_EAC_R11G11_SNORM_BLOCK) {
+            bool eightByte = format <= VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK || format == VK_FORMAT_EAC_R11_UNORM_BLOCK || format == VK_FORMAT_EAC_R11_SNORM_BLOCK;
+            return { 4, 4, eightByte ? 8U : 16U, true };
+        }
+        if (format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK) {
+            static constexpr uint32_t footprints[14][2] = {
+                { 4, 4 }, { 5, 4 }, { 5, 5 }, { 6, 5 }, { 6, 6 }, { 8, 5 }, { 8, 6 },
+                { 8, 8 }, { 10, 5 }, { 10, 6 }, { 10, 8 }, { 10, 10 }, { 12, 10 }, { 12, 12 }
+            };
+            const uint32_t* footprint = footprints[(format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK) / 2]; // UNORM / SRGB pairs
+            return { footprint[0], footprint[1], 16, true };
+        }
+        return {};
+    }
+    bool Texture::IsFormatSupported(const DeviceContext& context, VkFormat format) {
+        if (format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK && !context.EnabledFeatures.textureCompressionBC) return false;
+        if (format >= VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK && format <= VK_FORMAT_EAC_R11G11_SNORM_BLOCK && !context.EnabledFeatures.textureCompressionETC2) return false;
+        if (format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK && !context.EnabledFeatures.textureCompressionASTC_LDR) return false;
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(context.PhysicalDevice, format, &formatProperties);
+        return (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+    }
+    VkFormat Texture::ChooseFormat(const DeviceContext& context, const std::vector<VkFormat>& candidates) {
+        for (VkFormat format : candidates) {
+            if (IsFormatSupported(context, format)) return format;
+        }
+        return VK_FORMAT_UNDEFINED;
+    }
+    uint32_t Texture::GetFullMipCount(uint32_t width, uint32_t height) {
+        uint32_t levels = 1;
+        for (uint32_t size = std::max(width, height); size > 1; size >>= 1) levels++;
+        return levels;
+    }
+}
\ No newline at end of file
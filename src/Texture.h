@@ -0,0 +1,72 @@
+#pragma once
+/* Sampled 2D textures: KTX2 or raw level data, block-compressed formats, GPU mip generation */
+#include "pch.h"
+#include "DeviceContext.h"
+#include "VulkanUtils.h"
+
+namespace VulkanPractice {
+    struct TextureDesc {
+        uint32_t Width = 1;
+        uint32_t Height = 1;
+        VkFormat Format = VK_FORMAT_R8G8B8A8_SRGB;
+        uint32_t MipLevels = 1; // levels present in the data, tightly packed from level 0
+        bool GenerateMips = true; // fills the rest of the chain with blits when the format allows it
+    };
+
+    class Texture {
+    public:
+        struct FormatBlockInfo {
+            uint32_t BlockWidth = 1, BlockHeight = 1;
+            uint32_t BytesPerBlock = 0; // 0 --> format unknown to the loader
+            bool Compressed = false;
+        };
+    private:
+        struct LevelData {
+            const uint8_t* Data;
+            VkDeviceSize Size;
+        };
+
+        VkDevice m_VkDevice;
+        const VkAllocationCallbacks* m_Allocator; // destroy with what created
+        VkImage m_VkImage = VK_NULL_HANDLE;
+        VkDeviceMemory m_VkImageMemory = VK_NULL_HANDLE;
+        VkImageView m_VkImageView = VK_NULL_HANDLE;
+        VkFormat m_VkFormat;
+        VkExtent2D m_VkExtent;
+        uint32_t m_MipLevels;
+        uint64_t m_ResidentBytes = 0;
+        PendingUpload m_Upload; // copies and mip blits in flight
+    public:
+        /* KTX2 container (no supercompression) --> BC / ASTC / ETC2 or plain formats with optional prebuilt mips */
+        Texture(const DeviceContext& context, const std::string& filepath);
+        Texture(const DeviceContext& context, const uint8_t* data, size_t size, const std::string& name);
+        /* Raw pixel data described by desc */
+        Texture(const DeviceContext& context, const TextureDesc& desc, const uint8_t* data, size_t size);
+        /* Waits for an unfinished upload before freeing the image */
+        ~Texture();
+        Texture(const Texture&) = delete;
+        Texture& operator=(const Texture&) = delete;
+
+        inline VkImage GetImage() const { return m_VkImage; }
+        inline VkImageView GetImageView() const { return m_VkImageView; }
+        inline VkFormat GetFormat() const { return m_VkFormat; }
+        inline VkExtent2D GetExtent() const { return m_VkExtent; }
+        inline uint32_t GetMipLevels() const { return m_MipLevels; }
+        inline uint64_t GetResidentBytes() const { return m_ResidentBytes; }
+        /* Polls the upload fence and frees the staging buffer once it signalled --> on the thread that owns the command pool */
+        inline bool IsUploadComplete() { return VulkanUtils::FinishUpload(m_Upload); }
+        /* Init time users that never poll --> frees the staging buffer right away */
+        inline void WaitForUpload() { VulkanUtils::FinishUpload(m_Upload, true); }
+
+        static FormatBlockInfo GetFormatBlockInfo(VkFormat format);
+        /* Checks the device feature for compressed families as well as the sampled-image format bit */
+        static bool IsFormatSupported(const DeviceContext& context, VkFormat format);
+        /* First supported candidate, e.g. { BC7, ASTC_4x4, RGBA8 } --> VK_FORMAT_UNDEFINED if none */
+        static VkFormat ChooseFormat(const DeviceContext& context, const std::vector<VkFormat>& candidates);
+        static uint32_t GetFullMipCount(uint32_t width, uint32_t height);
+    private:
+        void LoadKtx2(const DeviceContext& context, const uint8_t* data, size_t size, const std::string& name);
+        void Upload(const DeviceContext& context, const TextureDesc& desc, const std::vector<LevelData>& levels, const std::string& name);
+        void GenerateMips(VkCommandBuffer commandBuffer, uint32_t firstLevel);
+    };
+}
\ No newline at end of file
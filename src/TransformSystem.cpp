@@ -0,0 +1,171 @@
+#include "TransformSystem.h"
+#include <cmath>
+#include <utility>
+#include <glm/vec4.hpp>
+
+namespace VulkanPractice {
+    /* Far below any distance to a plane --> an unbounded node fails the sphere test without relying on infinities (-ffast-math).
+     * The bounds kernels carry negative radii over unscaled, so no ancestor scale can shrink it */
+    static constexpr float s_NoBoundsRadius = -1e30f;
+
+    TransformSystem::TransformSystem(SimdLevel level)
+        : m_Kernels(GetSimdKernels(level))
+    {
+    }
+
+    TransformSystem::NodeId TransformSystem::Add(const glm::mat4& local, NodeId parent) {
+        if (parent != s_NoParent && parent >= m_SlotOfNode.size()) {
+            throw std::runtime_error("Transform parent does not exist!");
+        }
+        NodeId node = static_cast<NodeId>(m_SlotOfNode.size());
+        uint32_t slot = node; // appended --> Sort moves it to its level
+        for (auto& stream : m_Local) stream.push_back(0.0f);
+        for (auto& stream : m_World) stream.push_back(0.0f);
+        for (auto& stream : m_LocalBounds) stream.push_back(0.0f);
+        for (auto& stream : m_WorldBounds) stream.push_back(0.0f);
+        m_LocalBounds[6][slot] = s_NoBoundsRadius;
+        m_ParentSlots.push_back(parent == s_NoParent ? s_NoParent : m_SlotOfNode[parent]);
+        m_ParentNodes.push_back(parent);
+        m_Depths.push_back(parent == s_NoParent ? 0 : m_Depths[parent] + 1);
+        m_SlotOfNode.push_back(slot);
+        m_NodeOfSlot.push_back(node);
+        SetMatrix(m_Local, slot, local);
+        m_TopologyDirty = true;
+        m_TransformsDirty = true;
+        return node;
+    }
+    void TransformSystem::SetLocal(NodeId node, const glm::mat4& local) {
+        SetMatrix(m_Local, m_SlotOfNode[node], local);
+        m_TransformsDirty = true;
+    }
+    void TransformSystem::SetBounds(NodeId node, const glm::vec3& center, const glm::vec3& extent, float radius) {
+        uint32_t slot = m_SlotOfNode[node];
+        const float values[7] = { center.x, center.y, center.z, extent.x, extent.y, extent.z, radius };
+        for (size_t i = 0; i < m_LocalBounds.size(); i++) m_LocalBounds[i][slot] = values[i];
+        m_TransformsDirty = true;
+    }
+    void TransformSystem::ClearBounds(NodeId node) {
+        uint32_t slot = m_SlotOfNode[node];
+        for (auto& stream : m_LocalBounds) stream[slot] = 0.0f;
+        m_LocalBounds[6][slot] = s_NoBoundsRadius;
+        m_TransformsDirty = true;
+    }
+
+    void TransformSystem::Update() {
+        if (m_TopologyDirty) Sort();
+        if (!m_TransformsDirty) return;
+        ConstMatrixStreams local = GetStreams(std::as_const(m_Local));
+        ConstMatrixStreams parents = GetStreams(std::as_const(m_World)); // earlier levels of the same streams
+        MatrixStreams world = GetStreams(m_World);
+        for (const Level& level : m_Levels) {
+            if (level.Begin == 0) {
+                /* Roots --> world is local */
+                for (size_t e = 0; e < 16; e++) {
+                    std::copy(m_Local[e].begin() + level.Begin, m_Local[e].begin() + level.End, m_World[e].begin() + level.Begin);
+                }
+                continue;
+            }
+            m_Kernels.MultiplyParents(parents, m_ParentSlots.data(), local, world, level.Begin, level.End - level.Begin);
+        }
+        m_Kernels.TransformBounds(GetStreams(std::as_const(m_World)),
+            GetStreams(std::as_const(m_LocalBounds)), GetStreams(m_WorldBounds), 0, GetCount());
+        m_TransformsDirty = false;
+    }
+    void TransformSystem::Cull(const FrustumPlanes& frustum, std::vector<NodeId>& visible) const {
+        visible.resize(GetCount());
+        size_t visibleCount = m_Kernels.CullBounds(frustum, GetStreams(m_WorldBounds), 0, GetCount(), visible.data());
+        visible.resize(visibleCount);
+        for (NodeId& entry : visible) entry = m_NodeOfSlot[entry]; // kernels report slots
+    }
+
+    glm::mat4 TransformSystem::GetWorld(NodeId node) const {
+        uint32_t slot = m_SlotOfNode[node];
+        glm::mat4 world;
+        for (int column = 0; column < 4; column++) {
+            for (int row = 0; row < 4; row++) world[column][row] = m_World[column * 4 + row][slot];
+        }
+        return world;
+    }
+    void TransformSystem::GetWorldBounds(NodeId node, glm::vec3& min, glm::vec3& max) const {
+        uint32_t slot = m_SlotOfNode[node];
+        glm::vec3 center(m_WorldBounds[0][slot], m_WorldBounds[1][slot], m_WorldBounds[2][slot]);
+        glm::vec3 extent(m_WorldBounds[3][slot], m_WorldBounds[4][slot], m_WorldBounds[5][slot]);
+        min = center - extent;
+        max = center + extent;
+    }
+
+    FrustumPlanes TransformSystem::ExtractFrustum(const glm::mat4& viewProjection) {
+        auto row = [&](int r) { return glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]); };
+        glm::vec4 planes[6] = {
+            row(3) + row(0), row(3) - row(0), // left, right
+            row(3) + row(1), row(3) - row(1), // bottom, top
+            row(2), row(3) - row(2)           // near (z >= 0), far
+        };
+        FrustumPlanes frustum;
+        for (int p = 0; p < 6; p++) {
+            float length = std::sqrt(planes[p].x * planes[p].x + planes[p].y * planes[p].y + planes[p].z * planes[p].z);
+            float scale = length > 0.0f ? 1.0f / length : 0.0f;
+            frustum.Planes[p][0] = planes[p].x * scale;
+            frustum.Planes[p][1] = planes[p].y * scale;
+            frustum.Planes[p][2] = planes[p].z * scale;
+            frustum.Planes[p][3] = planes[p].w * scale;
+        }
+        return frustum;
+    }
+
+    void TransformSystem::Sort() {
+        /* Counting sort by depth, stable in insertion order --> parents always land in an earlier level than their children */
+        size_t count = GetCount();
+        uint32_t maxDepth = 0;
+        for (uint32_t depth : m_Depths) maxDepth = std::max(maxDepth, depth);
+        std::vector<uint32_t> levelBegin(maxDepth + 2, 0);
+        for (uint32_t depth : m_Depths) levelBegin[depth + 1]++;
+        for (uint32_t depth = 0; depth <= maxDepth; depth++) levelBegin[depth + 1] += levelBegin[depth];
+        m_Levels.clear();
+        for (uint32_t depth = 0; depth <= maxDepth; depth++) {
+            if (levelBegin[depth] != levelBegin[depth + 1]) m_Levels.push_back({ levelBegin[depth], levelBegin[depth + 1] });
+        }
+        std::vector<uint32_t> newSlotOfNode(count);
+        for (NodeId node = 0; node < count; node++) newSlotOfNode[node] = levelBegin[m_Depths[node]]++;
+
+        /* Move every stream to the new order --> world data moves too so an unchanged frame stays valid */
+        auto permute = [&](std::vector<float>& stream) {
+            std::vector<float> sorted(count);
+            for (NodeId node = 0; node < count; node++) sorted[newSlotOfNode[node]] = stream[m_SlotOfNode[node]];
+            stream.swap(sorted);
+        };
+        for (auto& stream : m_Local) permute(stream);
+        for (auto& stream : m_World) permute(stream);
+        for (auto& stream : m_LocalBounds) permute(stream);
+        for (auto& stream : m_WorldBounds) permute(stream);
+        m_SlotOfNode.swap(newSlotOfNode);
+        for (NodeId node = 0; node < count; node++) {
+            uint32_t slot = m_SlotOfNode[node];
+            m_NodeOfSlot[slot] = node;
+            m_ParentSlots[slot] = m_ParentNodes[node] == s_NoParent ? s_NoParent : m_SlotOfNode[m_ParentNodes[node]];
+        }
+        m_TopologyDirty = false;
+    }
+    void TransformSystem::SetMatrix(std::array<std::vector<float>, 16>& streams, uint32_t slot, const glm::mat4& matrix) {
+        for (int column = 0; column < 4; column++) {
+            for (int row = 0; row < 4; row++) streams[column * 4 + row][slot] = matrix[column][row];
+        }
+    }
+
+    MatrixStreams TransformSystem::GetStreams(std::array<std::vector<float>, 16>& streams) {
+        MatrixStreams result;
+        for (size_t e = 0; e < 16; e++) result.Elements[e] = streams[e].data();
+        return result;
+    }
+    ConstMatrixStreams TransformSystem::GetStreams(const std::array<std::vector<float>, 16>& streams) {
+        ConstMatrixStreams result;
+        for (size_t e = 0; e < 16; e++) result.Elements[e] = streams[e].data();
+        return result;
+    }
+    BoundsStreams TransformSystem::GetStreams(std::array<std::vector<float>, 7>& streams) {
+        return { streams[0].data(), streams[1].data(), streams[2].data(), streams[3].data(), streams[4].data(), streams[5].data(), streams[6].data() };
+    }
+    ConstBoundsStreams TransformSystem::GetStreams(const std::array<std::vector<float>, 7>& streams) {
+        return { streams[0].data(), streams[1].data(), streams[2].data(), streams[3].data(), streams[4].data(), streams[5].data(), streams[6].data() };
+    }
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+/* This Header handles the CPU side scene hierarchy --> local and world matrices in structure of arrays, updated level by level through the SIMD kernels */
+#include "pch.h"
+#include "SimdKernels.h"
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+namespace VulkanPractice {
+    class TransformSystem {
+    public:
+        using NodeId = uint32_t;
+        inline static constexpr NodeId s_NoParent = ~0u;
+    private:
+        /* Slots are sorted by depth --> every level is one contiguous range whose parents are all in earlier ranges */
+        struct Level {
+            uint32_t Begin, End;
+        };
+        const SimdKernels& m_Kernels;
+        std::array<std::vector<float>, 16> m_Local, m_World; // one vector per matrix element, indexed by slot
+        std::array<std::vector<float>, 7> m_LocalBounds, m_WorldBounds; // center xyz, extent xyz, radius
+        std::vector<uint32_t> m_ParentSlots; // by slot, s_NoParent for roots
+        std::vector<NodeId> m_ParentNodes; // by node --> survives re-sorting
+        std::vector<uint32_t> m_Depths; // by node
+        std::vector<uint32_t> m_SlotOfNode, m_NodeOfSlot;
+        std::vector<Level> m_Levels;
+        bool m_TopologyDirty = false, m_TransformsDirty = false;
+    public:
+        explicit TransformSystem(SimdLevel level = DetectSimdLevel());
+
+        /* The parent must already exist --> ids are handed out in insertion order */
+        NodeId Add(const glm::mat4& local, NodeId parent = s_NoParent);
+        void SetLocal(NodeId node, const glm::mat4& local);
+        /* Local space box and sphere --> nodes without bounds never come out of Cull */
+        void SetBounds(NodeId node, const glm::vec3& center, const glm::vec3& extent, float radius);
+        void ClearBounds(NodeId node);
+        /* Re-sorts after Add, then recomputes world matrices and bounds --> no work when nothing changed */
+        void Update();
+        /* Nodes whose world bounds touch the frustum, in slot order --> valid after Update */
+        void Cull(const FrustumPlanes& frustum, std::vector<NodeId>& visible) const;
+
+        glm::mat4 GetWorld(NodeId node) const;
+        /* World space box of a node with bounds --> valid after Update */
+        void GetWorldBounds(NodeId node, glm::vec3& min, glm::vec3& max) const;
+        inline size_t GetCount() const { return m_SlotOfNode.size(); }
+        inline const SimdKernels& GetKernels() const { return m_Kernels; }
+
+        /* Gribb/Hartmann planes of a clip space with depth in [0, 1] --> normalized so the sphere test reads distances */
+        static FrustumPlanes ExtractFrustum(const glm::mat4& viewProjection);
+    private:
+        void Sort();
+        void SetMatrix(std::array<std::vector<float>, 16>& streams, uint32_t slot, const glm::mat4& matrix);
+        static MatrixStreams GetStreams(std::array<std::vector<float>, 16>& streams);
+        static ConstMatrixStreams GetStreams(const std::array<std::vector<float>, 16>& streams);
+        static BoundsStreams GetStreams(std::array<std::vector<float>, 7>& streams);
+        static ConstBoundsStreams GetStreams(const std::array<std::vector<float>, 7>& streams);
+    };
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "UniformRing.h"
+#include "VulkanUtils.h"
+
+namespace VulkanPractice {
+    static VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    UniformRing::UniformRing(const DeviceContext& context, VkDeviceSize bytesPerFrame, uint32_t framesInFlight, VkDeviceSize bindingRange, uint32_t persistentBlocks)
+        : m_DeviceContext(context), m_FrameCount(framesInFlight)
+    {
+        m_Alignment = std::max<VkDeviceSize>(context.Limits.minUniformBufferOffsetAlignment, 1);
+        m_BindingRange = std::min<VkDeviceSize>(bindingRange, context.Limits.maxUniformBufferRange);
+        m_FrameSize = AlignUp(bytesPerFrame, m_Alignment);
+        m_PersistentBlockSize = AlignUp(m_BindingRange, m_Alignment);
+        m_PersistentSize = m_PersistentBlockSize * persistentBlocks;
+        /* Tail padding so the last offset plus the fixed binding range stays inside the buffer */
+        VkDeviceSize bufferSize = m_PersistentSize + m_FrameSize * m_FrameCount + m_BindingRange;
+
+        VulkanUtils::CreateHostVisibleBuffer(
+            context, bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            m_VkBuffer, m_VkBufferMemory
+        );
+        void* mapped;
+        if (vkMapMemory(m_DeviceContext.Device, m_VkBufferMemory, 0, VK_WHOLE_SIZE, 0, &mapped) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to map uniform ring buffer!");
+        }
+        m_Mapped = static_cast<uint8_t*>(mapped);
+        CreateDescriptors();
+    }
+    UniformRing::~UniformRing() {
+        vkDestroyDescriptorPool(m_DeviceContext.Device, m_VkDescriptorPool, m_DeviceContext.Allocator); // frees the set
+        vkDestroyDescriptorSetLayout(m_DeviceContext.Device, m_VkDescriptorSetLayout, m_DeviceContext.Allocator);
+        vkUnmapMemory(m_DeviceContext.Device, m_VkBufferMemory);
+        vkDestroyBuffer(m_DeviceContext.Device, m_VkBuffer, m_DeviceContext.Allocator);
+        vkFreeMemory(m_DeviceContext.Device, m_VkBufferMemory, m_DeviceContext.Allocator);
+    }
+
+    void UniformRing::BeginFrame(uint32_t frameIndex) {
+        m_FrameBegin = m_PersistentSize + m_FrameSize * (frameIndex % m_FrameCount);
+        m_Cursor = m_FrameBegin;
+    }
+    UniformRing::Allocation UniformRing::Allocate(VkDeviceSize size) {
+        if (size > m_BindingRange) {
+            throw std::runtime_error("Uniform allocation is larger than the binding range!");
+        }
+        VkDeviceSize offset = AlignUp(m_Cursor, m_Alignment);
+        if (offset + size > m_FrameBegin + m_FrameSize) {
+            throw std::runtime_error("Uniform ring is out of space for this frame!");
+        }
+        m_Cursor = offset + size;
+        return { m_Mapped + offset, static_cast<uint32_t>(offset) };
+    }
+    UniformRing::Allocation UniformRing::AllocatePersistent() {
+        if (m_PersistentCursor + m_PersistentBlockSize > m_PersistentSize) {
+            throw std::runtime_error("Uniform ring has no persistent blocks left!");
+        }
+        VkDeviceSize offset = m_PersistentCursor;
+        m_PersistentCursor += m_PersistentBlockSize;
+        return { m_Mapped + offset, static_cast<uint32_t>(offset) };
+    }
+
+    void UniformRing::CreateDescriptors() {
+        VkDescriptorSetLayoutBinding binding{};
+        binding.binding = 0;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        binding.descriptorCount = 1;
+        binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = 1;
+        layoutInfo.pBindings = &binding;
+        if (vkCreateDescriptorSetLayout(m_DeviceContext.Device, &layoutInfo, m_DeviceContext.Allocator, &m_VkDescriptorSetLayout) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create uniform descriptor set layout!");
+        }
+
+        VkDescriptorPoolSize poolSize{};
+        poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        poolSize.descriptorCount = 1;
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        poolInfo.maxSets = 1;
+        if (vkCreateDescriptorPool(m_DeviceContext.Device, &poolInfo, m_DeviceContext.Allocator, &m_VkDescriptorPool) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create uniform descriptor pool!");
+        }
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_VkDescriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &m_VkDescriptorSetLayout;
+        if (vkAllocateDescriptorSets(m_DeviceContext.Device, &allocInfo, &m_VkDescriptorSet) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate uniform descriptor set!");
+        }
+
+        /* Written once --> every frame only changes the dynamic offset */
+        VkDescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = m_VkBuffer;
+        bufferInfo.offset = 0;
+        bufferInfo.range = m_BindingRange;
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = m_VkDescriptorSet;
+        write.dstBinding = 0;
+        write.dstArrayElement = 0;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        write.descriptorCount = 1;
+        write.pBufferInfo = &bufferInfo;
+        vkUpdateDescriptorSets(m_DeviceContext.Device, 1, &write, 0, nullptr);
+    }
+}
\ No newline at end of file
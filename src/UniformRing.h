@@ -0,0 +1,53 @@
+#pragma once
+/* This Header handles per-frame uniform data: one persistently mapped buffer split per frame in flight, bound with dynamic offsets */
+#include "pch.h"
+#include "DeviceContext.h"
+#include <cstring>
+
+namespace VulkanPractice {
+    class UniformRing {
+    public:
+        struct Allocation {
+            void* Data;
+            uint32_t Offset; // dynamic offset for vkCmdBindDescriptorSets
+        };
+    private:
+        DeviceContext m_DeviceContext;
+        VkBuffer m_VkBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory m_VkBufferMemory = VK_NULL_HANDLE;
+        uint8_t* m_Mapped = nullptr; // mapped once for the lifetime of the buffer
+        VkDeviceSize m_Alignment, m_FrameSize, m_BindingRange;
+        uint32_t m_FrameCount;
+        VkDeviceSize m_FrameBegin = 0, m_Cursor = 0;
+        VkDeviceSize m_PersistentBlockSize, m_PersistentSize, m_PersistentCursor = 0; // blocks ahead of the frame regions
+
+        VkDescriptorSetLayout m_VkDescriptorSetLayout = VK_NULL_HANDLE;
+        VkDescriptorPool m_VkDescriptorPool = VK_NULL_HANDLE;
+        VkDescriptorSet m_VkDescriptorSet = VK_NULL_HANDLE;
+    public:
+        /* bindingRange is the largest block a shader reads through the dynamic binding.
+           persistentBlocks reserves bindingRange sized blocks that BeginFrame never rewinds --> for prerecorded command buffers */
+        UniformRing(const DeviceContext& context, VkDeviceSize bytesPerFrame, uint32_t framesInFlight, VkDeviceSize bindingRange = 256, uint32_t persistentBlocks = 0);
+        ~UniformRing();
+        UniformRing(const UniformRing&) = delete;
+        UniformRing& operator=(const UniformRing&) = delete;
+
+        /* Call after the frame's fence wait --> that region is no longer read by the GPU */
+        void BeginFrame(uint32_t frameIndex);
+        Allocation Allocate(VkDeviceSize size);
+        /* Lives as long as the ring --> the owner must not rewrite it while a submission reading it is pending */
+        Allocation AllocatePersistent();
+        template<typename T>
+        uint32_t Push(const T& value) {
+            Allocation allocation = Allocate(sizeof(T));
+            std::memcpy(allocation.Data, &value, sizeof(T));
+            return allocation.Offset;
+        }
+
+        inline VkDescriptorSetLayout GetDescriptorSetLayout() const { return m_VkDescriptorSetLayout; }
+        inline VkDescriptorSet GetDescriptorSet() const { return m_VkDescriptorSet; }
+        inline VkDeviceSize GetUsedBytes() const { return m_Cursor - m_FrameBegin; }
+    private:
+        void CreateDescriptors();
+    };
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#include "VulkanDispatch.h"
+
+namespace VulkanPractice {
+    void InstanceDispatch::Load(VkInstance instance) {
+        Instance = instance;
+#define VK_INSTANCE_FUNCTION(Name) \
+        Name = reinterpret_cast<PFN_vk##Name>(vkGetInstanceProcAddr(instance, "vk" #Name)); \
+        if (Name == nullptr) throw std::runtime_error("Failed to load instance function vk" #Name "!");
+#define VK_INSTANCE_EXTENSION_FUNCTION(Name) \
+        Name = reinterpret_cast<PFN_vk##Name>(vkGetInstanceProcAddr(instance, "vk" #Name));
+#include "VulkanFunctions.inl"
+    }
+
+    void DeviceDispatch::Load(const InstanceDispatch& instance, VkDevice device) {
+        Device = device;
+        /* vkGetDeviceProcAddr returns the driver entry points for this device --> no per call lookup of the device's dispatch */
+#define VK_DEVICE_FUNCTION(Name) \
+        Name = reinterpret_cast<PFN_vk##Name>(instance.GetDeviceProcAddr(device, "vk" #Name)); \
+        if (Name == nullptr) throw std::runtime_error("Failed to load device function vk" #Name "!");
+#define VK_DEVICE_EXTENSION_FUNCTION(Name) \
+        Name = reinterpret_cast<PFN_vk##Name>(instance.GetDeviceProcAddr(device, "vk" #Name));
+#include "VulkanFunctions.inl"
+    }
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+/* This Header holds per instance / per device function tables generated from VulkanFunctions.inl --> hot paths skip the loader trampolines */
+#include "pch.h"
+#include <vulkan/vulkan.h>
+
+namespace VulkanPractice {
+    struct InstanceDispatch {
+        VkInstance Instance = VK_NULL_HANDLE;
+#define VK_INSTANCE_FUNCTION(Name) PFN_vk##Name Name = nullptr;
+#define VK_INSTANCE_EXTENSION_FUNCTION(Name) PFN_vk##Name Name = nullptr;
+#include "VulkanFunctions.inl"
+
+        /* Throws when a required function is missing --> extension functions may stay null */
+        void Load(VkInstance instance);
+    };
+
+    /* One table per VkDevice --> pointers are only valid for the device they were loaded from */
+    struct DeviceDispatch {
+        VkDevice Device = VK_NULL_HANDLE;
+#define VK_DEVICE_FUNCTION(Name) PFN_vk##Name Name = nullptr;
+#define VK_DEVICE_EXTENSION_FUNCTION(Name) PFN_vk##Name Name = nullptr;
+#include "VulkanFunctions.inl"
+
+        /* Same as the instance table --> WSI functions stay null on devices created without VK_KHR_swapchain */
+        void Load(const InstanceDispatch& instance, VkDevice device);
+    };
+}
\ No newline at end of file
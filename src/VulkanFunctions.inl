@@ -0,0 +1,66 @@
+/* Function list the dispatch tables are generated from --> include with the macros below defined, no include guard on purpose
+ * VK_INSTANCE_FUNCTION(Name)           loaded through vkGetInstanceProcAddr, must exist
+ * VK_INSTANCE_EXTENSION_FUNCTION(Name) loaded through vkGetInstanceProcAddr, null when the extension is not enabled
+ * VK_DEVICE_FUNCTION(Name)             loaded through vkGetDeviceProcAddr --> calls go straight to the driver of that device
+ * VK_DEVICE_EXTENSION_FUNCTION(Name)   loaded through vkGetDeviceProcAddr, null when the extension is not enabled
+ * Names drop the vk prefix; add a line here and the tables, loaders and benchmark pick it up */
+#ifndef VK_INSTANCE_FUNCTION
+#define VK_INSTANCE_FUNCTION(Name)
+#endif
+#ifndef VK_INSTANCE_EXTENSION_FUNCTION
+#define VK_INSTANCE_EXTENSION_FUNCTION(Name)
+#endif
+#ifndef VK_DEVICE_FUNCTION
+#define VK_DEVICE_FUNCTION(Name)
+#endif
+#ifndef VK_DEVICE_EXTENSION_FUNCTION
+#define VK_DEVICE_EXTENSION_FUNCTION(Name)
+#endif
+
+/* Instance */
+VK_INSTANCE_FUNCTION(GetDeviceProcAddr)
+VK_INSTANCE_EXTENSION_FUNCTION(GetPhysicalDeviceSurfaceCapabilitiesKHR)
+VK_INSTANCE_EXTENSION_FUNCTION(CreateDebugUtilsMessengerEXT)
+VK_INSTANCE_EXTENSION_FUNCTION(DestroyDebugUtilsMessengerEXT)
+VK_INSTANCE_EXTENSION_FUNCTION(GetPhysicalDeviceMemoryProperties2KHR)
+
+/* Frame loop */
+VK_DEVICE_FUNCTION(WaitForFences)
+VK_DEVICE_FUNCTION(ResetFences)
+VK_DEVICE_EXTENSION_FUNCTION(AcquireNextImageKHR)
+VK_DEVICE_FUNCTION(QueueSubmit)
+VK_DEVICE_EXTENSION_FUNCTION(QueuePresentKHR)
+VK_DEVICE_FUNCTION(QueueWaitIdle)
+VK_DEVICE_FUNCTION(DeviceWaitIdle)
+VK_DEVICE_FUNCTION(GetQueryPoolResults)
+
+/* Command recording */
+VK_DEVICE_FUNCTION(ResetCommandBuffer)
+VK_DEVICE_FUNCTION(BeginCommandBuffer)
+VK_DEVICE_FUNCTION(EndCommandBuffer)
+VK_DEVICE_FUNCTION(CmdBeginRenderPass)
+VK_DEVICE_FUNCTION(CmdEndRenderPass)
+VK_DEVICE_FUNCTION(CmdBindPipeline)
+VK_DEVICE_FUNCTION(CmdSetViewport)
+VK_DEVICE_FUNCTION(CmdSetScissor)
+VK_DEVICE_FUNCTION(CmdBindDescriptorSets)
+VK_DEVICE_FUNCTION(CmdPushConstants)
+VK_DEVICE_FUNCTION(CmdBindVertexBuffers)
+VK_DEVICE_FUNCTION(CmdBindIndexBuffer)
+VK_DEVICE_FUNCTION(CmdDraw)
+VK_DEVICE_FUNCTION(CmdDrawIndexed)
+VK_DEVICE_FUNCTION(CmdDrawIndexedIndirect)
+VK_DEVICE_FUNCTION(CmdDispatch)
+VK_DEVICE_FUNCTION(CmdPipelineBarrier)
+VK_DEVICE_FUNCTION(CmdCopyBuffer)
+VK_DEVICE_FUNCTION(CmdFillBuffer)
+VK_DEVICE_FUNCTION(CmdCopyBufferToImage)
+VK_DEVICE_FUNCTION(CmdCopyImageToBuffer)
+VK_DEVICE_FUNCTION(CmdBlitImage)
+VK_DEVICE_FUNCTION(CmdResetQueryPool)
+VK_DEVICE_FUNCTION(CmdWriteTimestamp)
+
+#undef VK_INSTANCE_FUNCTION
+#undef VK_INSTANCE_EXTENSION_FUNCTION
+#undef VK_DEVICE_FUNCTION
+#undef VK_DEVICE_EXTENSION_FUNCTION
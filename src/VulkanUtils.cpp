@@ -0,0 +1,285 @@
+#include "VulkanUtils.h"
+
+namespace VulkanPractice {
+    namespace VulkanUtils {
+        uint32_t FindMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties) {
+            std::optional<uint32_t> type = TryFindMemoryType(physicalDevice, typeFilter, properties);
+            if (!type) {
+                throw std::runtime_error("Failed to find suitable memory type!");
+            }
+            return *type;
+        }
+        std::optional<uint32_t> TryFindMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties) {
+            VkPhysicalDeviceMemoryProperties memProperties;
+            vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+            for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+                if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+                    return i;
+                }
+            }
+            return std::nullopt;
+        }
+        void CreateBuffer(
+            const DeviceContext& context,
+            VkDeviceSize size,
+            VkBufferUsageFlags usage,
+            VkMemoryPropertyFlags properties,
+            VkBuffer& buffer,
+            VkDeviceMemory& bufferMemory
+        ) {
+            VkBufferCreateInfo bufferInfo{};
+            bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+            bufferInfo.size = size;
+            bufferInfo.usage = usage;
+            bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            if (vkCreateBuffer(context.Device, &bufferInfo, context.Allocator, &buffer) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create buffer!");
+            }
+            VkMemoryRequirements memRequirements;
+            vkGetBufferMemoryRequirements(context.Device, buffer, &memRequirements);
+
+            std::optional<uint32_t> memoryType = TryFindMemoryType(context.PhysicalDevice, memRequirements.memoryTypeBits, properties);
+            if (!memoryType) {
+                vkDestroyBuffer(context.Device, buffer, context.Allocator);
+                throw std::runtime_error("Failed to find suitable memory type!");
+            }
+            VkMemoryAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocInfo.allocationSize = memRequirements.size;
+            allocInfo.memoryTypeIndex = *memoryType;
+            if (vkAllocateMemory(context.Device, &allocInfo, context.Allocator, &bufferMemory) != VK_SUCCESS) {
+                vkDestroyBuffer(context.Device, buffer, context.Allocator);
+                throw std::runtime_error("Failed to allocate buffer memory!");
+            }
+            vkBindBufferMemory(context.Device, buffer, bufferMemory, 0);
+        }
+        VkMemoryPropertyFlags CreateHostVisibleBuffer(
+            const DeviceContext& context,
+            VkDeviceSize size,
+            VkBufferUsageFlags usage,
+            VkMemoryPropertyFlags preferred,
+            VkBuffer& buffer,
+            VkDeviceMemory& bufferMemory
+        ) {
+            VkBufferCreateInfo bufferInfo{};
+            bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+            bufferInfo.size = size;
+            bufferInfo.usage = usage;
+            bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            if (vkCreateBuffer(context.Device, &bufferInfo, context.Allocator, &buffer) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create buffer!");
+            }
+            VkMemoryRequirements memRequirements;
+            vkGetBufferMemoryRequirements(context.Device, buffer, &memRequirements);
+
+            /* One buffer for every candidate --> the preferred heap may be missing or full (256 MiB BAR without resizable BAR) */
+            const VkMemoryPropertyFlags candidates[] = {
+                preferred | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+            };
+            for (VkMemoryPropertyFlags properties : candidates) {
+                std::optional<uint32_t> memoryType = TryFindMemoryType(context.PhysicalDevice, memRequirements.memoryTypeBits, properties);
+                if (!memoryType) continue;
+                VkMemoryAllocateInfo allocInfo{};
+                allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+                allocInfo.allocationSize = memRequirements.size;
+                allocInfo.memoryTypeIndex = *memoryType;
+                if (vkAllocateMemory(context.Device, &allocInfo, context.Allocator, &bufferMemory) == VK_SUCCESS) {
+                    vkBindBufferMemory(context.Device, buffer, bufferMemory, 0);
+                    return properties;
+                }
+            }
+            vkDestroyBuffer(context.Device, buffer, context.Allocator);
+            throw std::runtime_error("Failed to allocate host visible buffer memory!");
+        }
+        void CreateImage(
+            const DeviceContext& context,
+            const VkImageCreateInfo& imageInfo,
+            VkMemoryPropertyFlags properties,
+            VkImage& image,
+            VkDeviceMemory& imageMemory
+        ) {
+            if (vkCreateImage(context.Device, &imageInfo, context.Allocator, &image) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create image!");
+            }
+            VkMemoryRequirements memRequirements;
+            vkGetImageMemoryRequirements(context.Device, image, &memRequirements);
+
+            std::optional<uint32_t> memoryType = TryFindMemoryType(context.PhysicalDevice, memRequirements.memoryTypeBits, properties);
+            if (!memoryType) {
+                vkDestroyImage(context.Device, image, context.Allocator);
+                throw std::runtime_error("Failed to find suitable memory type!");
+            }
+            VkMemoryAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocInfo.allocationSize = memRequirements.size;
+            allocInfo.memoryTypeIndex = *memoryType;
+            if (vkAllocateMemory(context.Device, &allocInfo, context.Allocator, &imageMemory) != VK_SUCCESS) {
+                vkDestroyImage(context.Device, image, context.Allocator);
+                throw std::runtime_error("Failed to allocate image memory!");
+            }
+            vkBindImageMemory(context.Device, image, imageMemory, 0);
+        }
+        VkImageView CreateImageView(const DeviceContext& context, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels) {
+            VkImageViewCreateInfo viewInfo{};
+            viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            viewInfo.image = image;
+            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewInfo.format = format;
+            viewInfo.subresourceRange.aspectMask = aspectFlags;
+            viewInfo.subresourceRange.baseMipLevel = 0;
+            viewInfo.subresourceRange.levelCount = mipLevels;
+            viewInfo.subresourceRange.baseArrayLayer = 0;
+            viewInfo.subresourceRange.layerCount = 1;
+            VkImageView imageView;
+            if (vkCreateImageView(context.Device, &viewInfo, context.Allocator, &imageView) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create image view!");
+            }
+            return imageView;
+        }
+        VkRenderPass CreateRenderPass(const DeviceContext& context, const RenderPassDesc& desc) {
+            bool hasDepth = desc.DepthFormat != VK_FORMAT_UNDEFINED;
+            VkAttachmentDescription attachments[2]{};
+            attachments[0].format = desc.ColorFormat;
+            attachments[0].samples = VK_SAMPLE_COUNT_1_BIT;
+            attachments[0].loadOp = desc.Load ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+            attachments[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            attachments[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            attachments[0].initialLayout = desc.ColorInitialLayout;
+            attachments[0].finalLayout = desc.ColorFinalLayout;
+            attachments[1].format = desc.DepthFormat;
+            attachments[1].samples = VK_SAMPLE_COUNT_1_BIT;
+            attachments[1].loadOp = desc.Load ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+            attachments[1].storeOp = desc.StoreDepth ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            attachments[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            attachments[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            attachments[1].initialLayout = desc.DepthInitialLayout;
+            attachments[1].finalLayout = desc.DepthFinalLayout;
+
+            VkAttachmentReference colorAttachmentRef{};
+            colorAttachmentRef.attachment = 0;
+            colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            VkAttachmentReference depthAttachmentRef{};
+            depthAttachmentRef.attachment = 1;
+            depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            VkSubpassDescription subpass{};
+            subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+            subpass.colorAttachmentCount = 1;
+            subpass.pColorAttachments = &colorAttachmentRef;
+            subpass.pDepthStencilAttachment = hasDepth ? &depthAttachmentRef : nullptr;
+
+            /* In --> after the previous pass on the same attachments, out --> before sampling, compute and copies that read the result */
+            VkSubpassDependency dependencies[2]{};
+            dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+            dependencies[0].dstSubpass = 0;
+            dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            dependencies[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            dependencies[1].srcSubpass = 0;
+            dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+            dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+            dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+
+            VkRenderPassCreateInfo renderPassInfo{};
+            renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+            renderPassInfo.attachmentCount = hasDepth ? 2 : 1;
+            renderPassInfo.pAttachments = attachments;
+            renderPassInfo.subpassCount = 1;
+            renderPassInfo.pSubpasses = &subpass;
+            renderPassInfo.dependencyCount = 2;
+            renderPassInfo.pDependencies = dependencies;
+            VkRenderPass renderPass;
+            if (vkCreateRenderPass(context.Device, &renderPassInfo, context.Allocator, &renderPass) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create render pass!");
+            }
+            return renderPass;
+        }
+        VkFormat FindDepthFormat(VkPhysicalDevice physicalDevice, VkFormatFeatureFlags features) {
+            /* Depth only formats --> one aspect, so the attachment view can also be sampled */
+            const VkFormat candidates[] = { VK_FORMAT_D32_SFLOAT, VK_FORMAT_D16_UNORM };
+            VkFormatFeatureFlags required = VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | features;
+            for (VkFormat format : candidates) {
+                VkFormatProperties properties;
+                vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+                if ((properties.optimalTilingFeatures & required) == required) return format;
+            }
+            return VK_FORMAT_UNDEFINED;
+        }
+        VkCommandBuffer BeginSingleTimeCommands(const DeviceContext& context) {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandPool = context.CommandPool;
+            allocInfo.commandBufferCount = 1;
+            VkCommandBuffer commandBuffer;
+            if (vkAllocateCommandBuffers(context.Device, &allocInfo, &commandBuffer) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to allocate upload command buffer!");
+            }
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            vkBeginCommandBuffer(commandBuffer, &beginInfo);
+            return commandBuffer;
+        }
+        void EndSingleTimeCommands(const DeviceContext& context, VkCommandBuffer commandBuffer) {
+            vkEndCommandBuffer(commandBuffer);
+            VkSubmitInfo submitInfo{};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &commandBuffer;
+            if (vkQueueSubmit(context.GraphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to submit upload command buffer!");
+            }
+            vkQueueWaitIdle(context.GraphicsQueue);
+            vkFreeCommandBuffers(context.Device, context.CommandPool, 1, &commandBuffer);
+        }
+        PendingUpload SubmitUpload(const DeviceContext& context, VkCommandBuffer commandBuffer, VkBuffer stagingBuffer, VkDeviceMemory stagingMemory) {
+            PendingUpload upload;
+            upload.Device = context.Device;
+            upload.Allocator = context.Allocator;
+            upload.CommandPool = context.CommandPool;
+            upload.CommandBuffer = commandBuffer;
+            upload.StagingBuffer = stagingBuffer;
+            upload.StagingMemory = stagingMemory;
+            vkEndCommandBuffer(commandBuffer);
+            VkFenceCreateInfo fenceInfo{};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            VkResult result = vkCreateFence(context.Device, &fenceInfo, context.Allocator, &upload.Fence);
+            if (result == VK_SUCCESS) {
+                VkSubmitInfo submitInfo{};
+                submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+                submitInfo.commandBufferCount = 1;
+                submitInfo.pCommandBuffers = &commandBuffer;
+                result = vkQueueSubmit(context.GraphicsQueue, 1, &submitInfo, upload.Fence);
+            }
+            if (result != VK_SUCCESS) {
+                /* Nothing reached the queue --> free right away */
+                vkDestroyFence(context.Device, upload.Fence, context.Allocator);
+                vkFreeCommandBuffers(context.Device, context.CommandPool, 1, &commandBuffer);
+                vkDestroyBuffer(context.Device, stagingBuffer, context.Allocator);
+                vkFreeMemory(context.Device, stagingMemory, context.Allocator);
+                throw std::runtime_error("Failed to submit upload command buffer!");
+            }
+            return upload;
+        }
+        bool FinishUpload(PendingUpload& upload, bool wait) {
+            if (upload.Fence == VK_NULL_HANDLE) return true;
+            if (wait) {
+                vkWaitForFences(upload.Device, 1, &upload.Fence, VK_TRUE, UINT64_MAX);
+            } else if (vkGetFenceStatus(upload.Device, upload.Fence) != VK_SUCCESS) {
+                return false;
+            }
+            vkDestroyFence(upload.Device, upload.Fence, upload.Allocator);
+            vkFreeCommandBuffers(upload.Device, upload.CommandPool, 1, &upload.CommandBuffer);
+            vkDestroyBuffer(upload.Device, upload.StagingBuffer, upload.Allocator);
+            vkFreeMemory(upload.Device, upload.StagingMemory, upload.Allocator);
+            upload = PendingUpload();
+            return true;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+/* Small helpers shared by the subsystems that create their own Vulkan objects */
+#include "pch.h"
+#include "DeviceContext.h"
+
+namespace VulkanPractice {
+    /* One subpass, one color target and an optional depth target */
+    struct RenderPassDesc {
+        VkFormat ColorFormat = VK_FORMAT_UNDEFINED;
+        VkImageLayout ColorInitialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkImageLayout ColorFinalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        VkFormat DepthFormat = VK_FORMAT_UNDEFINED; // undefined --> no depth attachment
+        VkImageLayout DepthInitialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkImageLayout DepthFinalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        bool Load = false; // continue on what the attachments hold instead of clearing, needs defined initial layouts
+        bool StoreDepth = false; // depth is read after the pass
+    };
+    /* Upload submitted with a fence instead of a queue wait --> owns its command buffer and staging buffer until the GPU is done with them */
+    struct PendingUpload {
+        VkDevice Device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* Allocator = nullptr;
+        VkCommandPool CommandPool = VK_NULL_HANDLE;
+        VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+        VkFence Fence = VK_NULL_HANDLE; // null once finished
+        VkBuffer StagingBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory StagingMemory = VK_NULL_HANDLE;
+    };
+
+    namespace VulkanUtils {
+        /* Throws when no type matches --> TryFindMemoryType for probing */
+        uint32_t FindMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties);
+        std::optional<uint32_t> TryFindMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties);
+        void CreateBuffer(
+            const DeviceContext& context,
+            VkDeviceSize size,
+            VkBufferUsageFlags usage,
+            VkMemoryPropertyFlags properties,
+            VkBuffer& buffer,
+            VkDeviceMemory& bufferMemory
+        );
+        /* Host visible buffer in preferred memory (resizable BAR / UMA, host cached) when the device has room for it, plain host coherent memory otherwise --> returns the properties it got */
+        VkMemoryPropertyFlags CreateHostVisibleBuffer(
+            const DeviceContext& context,
+            VkDeviceSize size,
+            VkBufferUsageFlags usage,
+            VkMemoryPropertyFlags preferred,
+            VkBuffer& buffer,
+            VkDeviceMemory& bufferMemory
+        );
+        void CreateImage(
+            const DeviceContext& context,
+            const VkImageCreateInfo& imageInfo,
+            VkMemoryPropertyFlags properties,
+            VkImage& image,
+            VkDeviceMemory& imageMemory
+        );
+        /* Every pass built here has the same dependencies --> passes with equal formats stay compatible whatever their layouts and load ops */
+        VkRenderPass CreateRenderPass(const DeviceContext& context, const RenderPassDesc& desc);
+        /* First depth format usable as an attachment with the extra features, VK_FORMAT_UNDEFINED if none */
+        VkFormat FindDepthFormat(VkPhysicalDevice physicalDevice, VkFormatFeatureFlags features = 0);
+        VkImageView CreateImageView(const DeviceContext& context, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels);
+        /* One-off command buffers for uploads --> blocks until the queue is idle */
+        VkCommandBuffer BeginSingleTimeCommands(const DeviceContext& context);
+        void EndSingleTimeCommands(const DeviceContext& context, VkCommandBuffer commandBuffer);
+        /* Ends and submits a BeginSingleTimeCommands buffer without waiting --> the upload takes ownership of the staging buffer */
+        PendingUpload SubmitUpload(const DeviceContext& context, VkCommandBuffer commandBuffer, VkBuffer stagingBuffer, VkDeviceMemory stagingMemory);
+        /* Polls the fence and frees everything once it signalled --> wait blocks instead, for destruction. Same thread as the command pool's other users */
+        bool FinishUpload(PendingUpload& upload, bool wait = false);
+    }
+}
\ No newline at end of file
@@ -4,12 +4,8 @@ namespace VulkanPractice {
     Window::Window(uint32_t width, uint32_t height, const std::string& title)
         : m_Width(width), m_Height(height), m_Title(title)
     {
-        /* Check if an instance already exists */
-        if(s_Instance != nullptr) {
-            throw std::runtime_error("A Window already exists");
-        }
-        /* Initialize GLFW */
-        if(!glfwInit()) {
+        /* Initialize GLFW */ // once for every window alive
+        if(s_WindowCount == 0 && !glfwInit()) {
             throw std::runtime_error("Failed to initialize GLFW");
         }
         /* Hint that we are not using openGL */
@@ -18,14 +14,13 @@ namespace VulkanPractice {
 
         m_Window = glfwCreateWindow(m_Width, m_Height, m_Title.c_str(), nullptr, nullptr);
         if(!m_Window) {
-            glfwTerminate();
+            if (s_WindowCount == 0) glfwTerminate();
             throw std::runtime_error("Failed to create window");
         }
-        s_Instance = this;
+        s_WindowCount++;
     }
     Window::~Window() {
         glfwDestroyWindow(m_Window);
-        glfwTerminate();
-        s_Instance = nullptr;
+        if (--s_WindowCount == 0) glfwTerminate();
     }
 }
\ No newline at end of file
@@ -1,5 +1,5 @@
 #pragma once
-/* This Header handles GLFW; window management */
+/* This Header handles GLFW; window management --> any number of windows, GLFW lives from the first until the last is destroyed */
 #include "pch.h"
 #ifndef GLFW_INCLUDE_VULKAN
 #define GLFW_INCLUDE_VULKAN
@@ -9,7 +9,7 @@
 namespace VulkanPractice {
     class Window {
     private:
-        inline static Window* s_Instance = nullptr;
+        inline static uint32_t s_WindowCount = 0; // main thread only, like every GLFW window call
 
         GLFWwindow* m_Window;
         uint32_t m_Width, m_Height;
@@ -17,8 +17,9 @@ namespace VulkanPractice {
     public:
         Window(uint32_t width, uint32_t height, const std::string& title);
         ~Window();
+        Window(const Window&) = delete;
+        Window& operator=(const Window&) = delete;
 
-        inline static Window* GetInstance() { return s_Instance; }
         inline GLFWwindow* GetNativeWindow() const { return m_Window; }
         inline uint32_t GetWidth() const { return m_Width; }
         inline uint32_t GetHeight() const { return m_Height; }
@@ -0,0 +1,228 @@
+/* Benchmark: per call cost of the loader exports vs the DeviceDispatch table on hot paths
+ * Usage: DispatchBenchmark [iterations]
+ * Runs headless on the first device with a graphics queue. Each case records the same commands
+ * (viewport, scissor, push constants) once through vk* and once through the table, and times
+ * empty queue submits and signaled fence waits the same way. */
+#include "VulkanDispatch.h"
+#include "Profiler.h"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstdlib>
+
+using namespace VulkanPractice;
+
+namespace {
+    void Check(VkResult result, const char* what) {
+        if (result != VK_SUCCESS) throw std::runtime_error(std::string("Failed to ") + what + "!");
+    }
+
+    struct Context {
+        VkInstance Instance = VK_NULL_HANDLE;
+        VkDevice Device = VK_NULL_HANDLE;
+        VkQueue Queue = VK_NULL_HANDLE;
+        VkCommandPool CommandPool = VK_NULL_HANDLE;
+        VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+        VkPipelineLayout PipelineLayout = VK_NULL_HANDLE;
+        VkFence Fence = VK_NULL_HANDLE; // created signaled --> waits return immediately
+        InstanceDispatch InstanceTable;
+        DeviceDispatch DeviceTable;
+
+        Context() {
+            VkApplicationInfo appInfo{};
+            appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+            appInfo.pApplicationName = "DispatchBenchmark";
+            appInfo.apiVersion = VK_API_VERSION_1_0;
+            VkInstanceCreateInfo instanceInfo{};
+            instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+            instanceInfo.pApplicationInfo = &appInfo;
+            Check(vkCreateInstance(&instanceInfo, nullptr, &Instance), "create instance");
+            InstanceTable.Load(Instance);
+
+            uint32_t deviceCount = 0;
+            vkEnumeratePhysicalDevices(Instance, &deviceCount, nullptr);
+            std::vector<VkPhysicalDevice> devices(deviceCount);
+            vkEnumeratePhysicalDevices(Instance, &deviceCount, devices.data());
+            VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+            uint32_t queueFamily = 0;
+            for (auto device : devices) {
+                uint32_t familyCount = 0;
+                vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, nullptr);
+                std::vector<VkQueueFamilyProperties> families(familyCount);
+                vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, families.data());
+                for (uint32_t i = 0; i < familyCount && physicalDevice == VK_NULL_HANDLE; i++) {
+                    if (families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+                        physicalDevice = device;
+                        queueFamily = i;
+                    }
+                }
+                if (physicalDevice != VK_NULL_HANDLE) break;
+            }
+            if (physicalDevice == VK_NULL_HANDLE) throw std::runtime_error("Failed to find a device with a graphics queue!");
+            VkPhysicalDeviceProperties properties;
+            vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+            std::cout << "Device: " << properties.deviceName << "\n";
+
+            float priority = 1.0f;
+            VkDeviceQueueCreateInfo queueInfo{};
+            queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            queueInfo.queueFamilyIndex = queueFamily;
+            queueInfo.queueCount = 1;
+            queueInfo.pQueuePriorities = &priority;
+            VkDeviceCreateInfo deviceInfo{};
+            deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+            deviceInfo.queueCreateInfoCount = 1;
+            deviceInfo.pQueueCreateInfos = &queueInfo;
+            Check(vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &Device), "create device");
+            DeviceTable.Load(InstanceTable, Device);
+            vkGetDeviceQueue(Device, queueFamily, 0, &Queue);
+
+            VkCommandPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+            poolInfo.queueFamilyIndex = queueFamily;
+            Check(vkCreateCommandPool(Device, &poolInfo, nullptr, &CommandPool), "create command pool");
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = CommandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+            Check(vkAllocateCommandBuffers(Device, &allocInfo, &CommandBuffer), "allocate command buffer");
+
+            VkPushConstantRange pushConstantRange{};
+            pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+            pushConstantRange.size = 64;
+            VkPipelineLayoutCreateInfo layoutInfo{};
+            layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+            layoutInfo.pushConstantRangeCount = 1;
+            layoutInfo.pPushConstantRanges = &pushConstantRange;
+            Check(vkCreatePipelineLayout(Device, &layoutInfo, nullptr, &PipelineLayout), "create pipeline layout");
+
+            VkFenceCreateInfo fenceInfo{};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+            Check(vkCreateFence(Device, &fenceInfo, nullptr, &Fence), "create fence");
+        }
+        ~Context() {
+            vkDeviceWaitIdle(Device);
+            vkDestroyFence(Device, Fence, nullptr);
+            vkDestroyPipelineLayout(Device, PipelineLayout, nullptr);
+            vkDestroyCommandPool(Device, CommandPool, nullptr);
+            vkDestroyDevice(Device, nullptr);
+            vkDestroyInstance(Instance, nullptr);
+        }
+        Context(const Context&) = delete;
+        Context& operator=(const Context&) = delete;
+    };
+
+    /* Same call sequence for both paths --> Loader calls the exported vk* symbols, Table goes through DeviceDispatch */
+    struct Loader {
+        const Context& Ctx;
+        void Begin(VkCommandBuffer cb, const VkCommandBufferBeginInfo* info) const { vkBeginCommandBuffer(cb, info); }
+        void End(VkCommandBuffer cb) const { vkEndCommandBuffer(cb); }
+        void Reset(VkCommandBuffer cb) const { vkResetCommandBuffer(cb, 0); }
+        void SetViewport(VkCommandBuffer cb, const VkViewport* viewport) const { vkCmdSetViewport(cb, 0, 1, viewport); }
+        void SetScissor(VkCommandBuffer cb, const VkRect2D* scissor) const { vkCmdSetScissor(cb, 0, 1, scissor); }
+        void PushConstants(VkCommandBuffer cb, const void* data) const { vkCmdPushConstants(cb, Ctx.PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, 64, data); }
+        void Submit() const { vkQueueSubmit(Ctx.Queue, 0, nullptr, VK_NULL_HANDLE); }
+        void WaitFence() const { vkWaitForFences(Ctx.Device, 1, &Ctx.Fence, VK_TRUE, UINT64_MAX); }
+    };
+    struct Table {
+        const Context& Ctx;
+        void Begin(VkCommandBuffer cb, const VkCommandBufferBeginInfo* info) const { Ctx.DeviceTable.BeginCommandBuffer(cb, info); }
+        void End(VkCommandBuffer cb) const { Ctx.DeviceTable.EndCommandBuffer(cb); }
+        void Reset(VkCommandBuffer cb) const { Ctx.DeviceTable.ResetCommandBuffer(cb, 0); }
+        void SetViewport(VkCommandBuffer cb, const VkViewport* viewport) const { Ctx.DeviceTable.CmdSetViewport(cb, 0, 1, viewport); }
+        void SetScissor(VkCommandBuffer cb, const VkRect2D* scissor) const { Ctx.DeviceTable.CmdSetScissor(cb, 0, 1, scissor); }
+        void PushConstants(VkCommandBuffer cb, const void* data) const { Ctx.DeviceTable.CmdPushConstants(cb, Ctx.PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, 64, data); }
+        void Submit() const { Ctx.DeviceTable.QueueSubmit(Ctx.Queue, 0, nullptr, VK_NULL_HANDLE); }
+        void WaitFence() const { Ctx.DeviceTable.WaitForFences(Ctx.Device, 1, &Ctx.Fence, VK_TRUE, UINT64_MAX); }
+    };
+
+    struct Result {
+        double RecordNanoseconds, SubmitNanoseconds, WaitNanoseconds; // per call
+    };
+
+    /* Commands per Begin/End --> keeps the command buffer from growing without bound */
+    constexpr uint32_t s_CommandsPerBatch = 3 * 1024;
+
+    template<typename Path>
+    Result Run(const Path& path, VkCommandBuffer commandBuffer, uint32_t iterations) {
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        VkViewport viewport{ 0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f };
+        VkRect2D scissor{ { 0, 0 }, { 1280, 720 } };
+        float constants[16] = { 1.0f };
+
+        Result result{};
+        /* Recording */
+        uint64_t calls = 0;
+        double recordMilliseconds = 0.0;
+        for (uint32_t done = 0; done < iterations;) {
+            uint32_t batch = std::min(iterations - done, s_CommandsPerBatch / 3);
+            path.Reset(commandBuffer);
+            path.Begin(commandBuffer, &beginInfo);
+            Timer timer;
+            for (uint32_t i = 0; i < batch; i++) {
+                path.SetViewport(commandBuffer, &viewport);
+                path.SetScissor(commandBuffer, &scissor);
+                path.PushConstants(commandBuffer, constants);
+            }
+            recordMilliseconds += timer.GetElapsedMilliseconds();
+            path.End(commandBuffer);
+            calls += 3ull * batch;
+            done += batch;
+        }
+        result.RecordNanoseconds = recordMilliseconds * 1e6 / static_cast<double>(calls);
+        /* Submit and fence paths --> empty submits and an already signaled fence, so only call overhead is left */
+        uint32_t submitIterations = std::max(iterations / 16, 1u);
+        Timer submitTimer;
+        for (uint32_t i = 0; i < submitIterations; i++) path.Submit();
+        result.SubmitNanoseconds = submitTimer.GetElapsedMilliseconds() * 1e6 / submitIterations;
+        Timer waitTimer;
+        for (uint32_t i = 0; i < iterations; i++) path.WaitFence();
+        result.WaitNanoseconds = waitTimer.GetElapsedMilliseconds() * 1e6 / iterations;
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t iterations = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 1000000;
+    if (iterations == 0) {
+        std::cerr << "Usage: DispatchBenchmark [iterations]\n";
+        return EXIT_FAILURE;
+    }
+    try {
+        Context context;
+        Loader loader{ context };
+        Table table{ context };
+        /* Warm up both paths first --> page faults and driver pool growth stay out of the measurement */
+        Run(loader, context.CommandBuffer, iterations / 10 + 1);
+        Run(table, context.CommandBuffer, iterations / 10 + 1);
+        /* Interleaved rounds, best of each --> less sensitive to clock ramps and scheduling noise */
+        Result bestLoader{ 1e30, 1e30, 1e30 }, bestTable{ 1e30, 1e30, 1e30 };
+        for (int round = 0; round < 5; round++) {
+            Result l = Run(loader, context.CommandBuffer, iterations);
+            Result t = Run(table, context.CommandBuffer, iterations);
+            bestLoader = { std::min(bestLoader.RecordNanoseconds, l.RecordNanoseconds), std::min(bestLoader.SubmitNanoseconds, l.SubmitNanoseconds), std::min(bestLoader.WaitNanoseconds, l.WaitNanoseconds) };
+            bestTable = { std::min(bestTable.RecordNanoseconds, t.RecordNanoseconds), std::min(bestTable.SubmitNanoseconds, t.SubmitNanoseconds), std::min(bestTable.WaitNanoseconds, t.WaitNanoseconds) };
+        }
+        auto row = [](const char* name, double loaderNs, double tableNs) {
+            std::cout << std::left << std::setw(30) << name << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(12) << loaderNs << std::setw(12) << tableNs
+                      << std::setw(11) << (loaderNs - tableNs) / loaderNs * 100.0 << "%\n";
+        };
+        std::cout << std::left << std::setw(30) << "ns per call" << std::right << std::setw(12) << "loader" << std::setw(12) << "table" << std::setw(12) << "saved" << "\n";
+        row("vkCmd* recording", bestLoader.RecordNanoseconds, bestTable.RecordNanoseconds);
+        row("vkQueueSubmit (empty)", bestLoader.SubmitNanoseconds, bestTable.SubmitNanoseconds);
+        row("vkWaitForFences (signaled)", bestLoader.WaitNanoseconds, bestTable.WaitNanoseconds);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
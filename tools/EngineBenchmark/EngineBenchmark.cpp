@@ -0,0 +1,431 @@
+/* Benchmark: CPU hot paths of the engine library, written as JSON to stdout
+ * Usage: EngineBenchmark [iterations] > results.json
+ * Runs headless on the first device with a graphics queue --> a software ICD (lavapipe, SwiftShader) gives numbers comparable from commit to commit.
+ * Every case is warmed up once, then timed over s_Rounds rounds; "best" and "median" are nanoseconds per operation.
+ * Surface queries need VK_EXT_headless_surface --> without it those cases are written with "skipped": true.
+ * Device name and progress go to stderr so stdout stays a single JSON document. */
+#include "pch.h"
+#include "Application.h"
+#include "AssetStreamer.h"
+#include "MappedFile.h"
+#include "PipelineCache.h"
+#include "Renderer2D.h"
+#include "VulkanUtils.h"
+#include "Profiler.h"
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+
+using namespace VulkanPractice;
+
+namespace {
+    constexpr uint32_t s_Rounds = 7; // odd --> the median is one of the rounds
+    constexpr uint32_t s_DrawsPerBuffer = 1024;
+    constexpr size_t s_AssetBytes = 4u << 20;
+    constexpr VkFormat s_ColorFormat = VK_FORMAT_R8G8B8A8_UNORM;
+    constexpr VkExtent2D s_TargetExtent = { 64, 64 };
+
+    void Check(VkResult result, const char* what) {
+        if (result != VK_SUCCESS) throw std::runtime_error(std::string("Failed to ") + what + "!");
+    }
+
+    struct Context {
+        VkInstance Instance = VK_NULL_HANDLE;
+        VkSurfaceKHR Surface = VK_NULL_HANDLE; // headless, null without VK_EXT_headless_surface
+        VkPhysicalDevice PhysicalDevice = VK_NULL_HANDLE;
+        VkPhysicalDeviceProperties Properties{};
+        VkDevice Device = VK_NULL_HANDLE;
+        VkQueue Queue = VK_NULL_HANDLE;
+        VkCommandPool CommandPool = VK_NULL_HANDLE;
+        InstanceDispatch InstanceTable;
+        DeviceDispatch DeviceTable;
+        DeviceContext EngineContext;
+
+        Context() {
+            VkApplicationInfo appInfo{};
+            appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+            appInfo.pApplicationName = "EngineBenchmark";
+            appInfo.apiVersion = VK_API_VERSION_1_0;
+            std::vector<const char*> extensions;
+            if (Application::CheckInstanceExtensionSupport({ VK_KHR_SURFACE_EXTENSION_NAME, VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME })) {
+                extensions = { VK_KHR_SURFACE_EXTENSION_NAME, VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME };
+            }
+            VkInstanceCreateInfo instanceInfo{};
+            instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+            instanceInfo.pApplicationInfo = &appInfo;
+            instanceInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+            instanceInfo.ppEnabledExtensionNames = extensions.data();
+            Check(vkCreateInstance(&instanceInfo, nullptr, &Instance), "create instance");
+            InstanceTable.Load(Instance);
+            if (!extensions.empty()) {
+                auto createHeadlessSurface = reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(vkGetInstanceProcAddr(Instance, "vkCreateHeadlessSurfaceEXT"));
+                VkHeadlessSurfaceCreateInfoEXT surfaceInfo{};
+                surfaceInfo.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+                if (createHeadlessSurface) Check(createHeadlessSurface(Instance, &surfaceInfo, nullptr, &Surface), "create headless surface");
+            }
+
+            uint32_t deviceCount = 0;
+            vkEnumeratePhysicalDevices(Instance, &deviceCount, nullptr);
+            std::vector<VkPhysicalDevice> devices(deviceCount);
+            vkEnumeratePhysicalDevices(Instance, &deviceCount, devices.data());
+            uint32_t queueFamily = 0;
+            for (auto device : devices) {
+                uint32_t familyCount = 0;
+                vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, nullptr);
+                std::vector<VkQueueFamilyProperties> families(familyCount);
+                vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, families.data());
+                for (uint32_t i = 0; i < familyCount && PhysicalDevice == VK_NULL_HANDLE; i++) {
+                    if (families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+                        PhysicalDevice = device;
+                        queueFamily = i;
+                    }
+                }
+                if (PhysicalDevice != VK_NULL_HANDLE) break;
+            }
+            if (PhysicalDevice == VK_NULL_HANDLE) throw std::runtime_error("Failed to find a device with a graphics queue!");
+            vkGetPhysicalDeviceProperties(PhysicalDevice, &Properties);
+            std::cerr << "Device: " << Properties.deviceName << "\n";
+
+            float priority = 1.0f;
+            VkDeviceQueueCreateInfo queueInfo{};
+            queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            queueInfo.queueFamilyIndex = queueFamily;
+            queueInfo.queueCount = 1;
+            queueInfo.pQueuePriorities = &priority;
+            VkDeviceCreateInfo deviceInfo{};
+            deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+            deviceInfo.queueCreateInfoCount = 1;
+            deviceInfo.pQueueCreateInfos = &queueInfo;
+            Check(vkCreateDevice(PhysicalDevice, &deviceInfo, nullptr, &Device), "create device");
+            DeviceTable.Load(InstanceTable, Device);
+            vkGetDeviceQueue(Device, queueFamily, 0, &Queue);
+
+            VkCommandPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+            poolInfo.queueFamilyIndex = queueFamily;
+            Check(vkCreateCommandPool(Device, &poolInfo, nullptr, &CommandPool), "create command pool");
+
+            /* What Application hands its subsystems --> lets the benchmark build through the same helpers */
+            EngineContext.PhysicalDevice = PhysicalDevice;
+            EngineContext.Device = Device;
+            EngineContext.GraphicsQueue = Queue;
+            EngineContext.GraphicsQueueFamily = queueFamily;
+            EngineContext.CommandPool = CommandPool;
+            EngineContext.Limits = Properties.limits;
+            EngineContext.Dispatch = &DeviceTable;
+        }
+        ~Context() {
+            vkDeviceWaitIdle(Device);
+            vkDestroyCommandPool(Device, CommandPool, nullptr);
+            vkDestroyDevice(Device, nullptr);
+            if (Surface != VK_NULL_HANDLE) vkDestroySurfaceKHR(Instance, Surface, nullptr);
+            vkDestroyInstance(Instance, nullptr);
+        }
+        Context(const Context&) = delete;
+        Context& operator=(const Context&) = delete;
+    };
+
+    struct CaseResult {
+        std::string Name;
+        bool Skipped = false;
+        uint64_t Operations = 0; // per round
+        uint64_t BytesPerOperation = 0; // 0 for cases that move no data
+        double BestNanoseconds = 0.0, MedianNanoseconds = 0.0; // per operation
+    };
+
+    /* round() runs operations once --> warm-up first so page faults and driver pool growth stay out of the measurement */
+    template<typename Round>
+    CaseResult Measure(const std::string& name, uint64_t operations, Round&& round) {
+        std::cerr << "  " << name << "\n";
+        round();
+        std::vector<double> samples;
+        for (uint32_t i = 0; i < s_Rounds; i++) {
+            Timer timer;
+            round();
+            samples.push_back(timer.GetElapsedMilliseconds() * 1e6 / static_cast<double>(operations));
+        }
+        std::sort(samples.begin(), samples.end());
+        CaseResult result;
+        result.Name = name;
+        result.Operations = operations;
+        result.BestNanoseconds = samples.front();
+        result.MedianNanoseconds = samples[samples.size() / 2];
+        return result;
+    }
+    CaseResult Skip(const std::string& name) {
+        std::cerr << "  " << name << " (skipped)\n";
+        CaseResult result;
+        result.Name = name;
+        result.Skipped = true;
+        return result;
+    }
+
+    volatile uint64_t g_Sink = 0; // results feed into this so the optimizer keeps every call
+
+    /* Lists a driver could plausibly report with the preferred entry last --> the selection loops run to the end */
+    void AddSelectionCases(std::vector<CaseResult>& results, uint64_t iterations) {
+        std::vector<VkSurfaceFormatKHR> formats = {
+            { VK_FORMAT_R8G8B8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR }, { VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+            { VK_FORMAT_R8G8B8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR }, { VK_FORMAT_A2B10G10R10_UNORM_PACK32, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+            { VK_FORMAT_A2R10G10B10_UNORM_PACK32, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR }, { VK_FORMAT_R16G16B16A16_SFLOAT, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+            { VK_FORMAT_R5G6B5_UNORM_PACK16, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR }, { VK_FORMAT_B8G8R8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR }
+        };
+        results.push_back(Measure("swapchain.choose_surface_format", iterations, [&formats, iterations] {
+            for (uint64_t i = 0; i < iterations; i++) g_Sink = g_Sink + Application::ChooseSwapSurfaceFormat(formats).format;
+        }));
+        std::vector<VkPresentModeKHR> presentModes = { VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR, VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_MAILBOX_KHR };
+        results.push_back(Measure("swapchain.choose_present_mode", iterations, [&presentModes, iterations] {
+            for (uint64_t i = 0; i < iterations; i++) g_Sink = g_Sink + Application::ChooseSwapPresentMode(presentModes);
+        }));
+    }
+
+    /* Driver round trips plus the vectors they fill --> what PickPhysicalDevice pays per candidate and CreateSwapChain per resize */
+    void AddQueryCases(std::vector<CaseResult>& results, const Context& context, uint64_t iterations) {
+        if (context.Surface == VK_NULL_HANDLE) {
+            results.push_back(Skip("swapchain.query_support"));
+            results.push_back(Skip("swapchain.find_queue_families"));
+            return;
+        }
+        results.push_back(Measure("swapchain.query_support", iterations, [&context, iterations] {
+            for (uint64_t i = 0; i < iterations; i++) g_Sink = g_Sink + Application::QuerySwapChainSupport(context.PhysicalDevice, context.Surface).Formats.size();
+        }));
+        results.push_back(Measure("swapchain.find_queue_families", iterations, [&context, iterations] {
+            for (uint64_t i = 0; i < iterations; i++) g_Sink = g_Sink + Application::FindQueueFamilies(context.PhysicalDevice, context.Surface).IsComplete();
+        }));
+    }
+
+    /* The per object pattern of RecordScene and the 2D batch --> push constants and an indexed draw, everything else bound once per buffer */
+    void AddRecordingCases(std::vector<CaseResult>& results, const Context& context, uint64_t iterations) {
+        const DeviceContext& device = context.EngineContext;
+        const DeviceDispatch& dispatch = context.DeviceTable;
+        RenderPassDesc passDesc;
+        passDesc.ColorFormat = s_ColorFormat;
+        passDesc.ColorFinalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        VkRenderPass renderPass = VulkanUtils::CreateRenderPass(device, passDesc);
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = s_ColorFormat;
+        imageInfo.extent = { s_TargetExtent.width, s_TargetExtent.height, 1 };
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkImage image;
+        VkDeviceMemory imageMemory;
+        VulkanUtils::CreateImage(device, imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, imageMemory);
+        VkImageView imageView = VulkanUtils::CreateImageView(device, image, s_ColorFormat, VK_IMAGE_ASPECT_COLOR_BIT, 1);
+        VkFramebufferCreateInfo framebufferInfo{};
+        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInfo.renderPass = renderPass;
+        framebufferInfo.attachmentCount = 1;
+        framebufferInfo.pAttachments = &imageView;
+        framebufferInfo.width = s_TargetExtent.width;
+        framebufferInfo.height = s_TargetExtent.height;
+        framebufferInfo.layers = 1;
+        VkFramebuffer framebuffer;
+        Check(vkCreateFramebuffer(device.Device, &framebufferInfo, nullptr, &framebuffer), "create framebuffer");
+
+        /* The 2D batch pipeline --> compiled through the engine's cache, no descriptor set is bound since nothing is submitted */
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        pushConstantRange.size = sizeof(Batch2DPushConstants);
+        VkPipelineLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layoutInfo.pushConstantRangeCount = 1;
+        layoutInfo.pPushConstantRanges = &pushConstantRange;
+        VkPipelineLayout pipelineLayout;
+        Check(vkCreatePipelineLayout(device.Device, &layoutInfo, nullptr, &pipelineLayout), "create pipeline layout");
+        PipelineCache pipelineCache(device);
+        PipelineDesc desc;
+        desc.Shaders = {
+            { VK_SHADER_STAGE_VERTEX_BIT, std::string(SHADER_DIR) + "/GLSL/batch2d.vert" },
+            { VK_SHADER_STAGE_FRAGMENT_BIT, std::string(SHADER_DIR) + "/GLSL/batch2d.frag" }
+        };
+        VkVertexInputBindingDescription vertexBinding{};
+        vertexBinding.stride = sizeof(Renderer2D::Vertex);
+        vertexBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        desc.VertexBindings = { vertexBinding };
+        desc.VertexAttributes = {
+            { 0, 0, VK_FORMAT_R32G32_SFLOAT, static_cast<uint32_t>(offsetof(Renderer2D::Vertex, Position)) },
+            { 1, 0, VK_FORMAT_R32G32_SFLOAT, static_cast<uint32_t>(offsetof(Renderer2D::Vertex, TexCoord)) },
+            { 2, 0, VK_FORMAT_R8G8B8A8_UNORM, static_cast<uint32_t>(offsetof(Renderer2D::Vertex, Color)) },
+            { 3, 0, VK_FORMAT_R32_UINT, static_cast<uint32_t>(offsetof(Renderer2D::Vertex, Mode)) }
+        };
+        desc.CullMode = VK_CULL_MODE_NONE;
+        desc.ColorFormats = { s_ColorFormat };
+        desc.Layout = pipelineLayout;
+        desc.RenderPass = renderPass;
+        VkPipeline pipeline = pipelineCache.GetBlocking(desc);
+
+        VkBuffer vertexBuffer, indexBuffer;
+        VkDeviceMemory vertexMemory, indexMemory;
+        VulkanUtils::CreateBuffer(device, 4 * sizeof(Renderer2D::Vertex), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, vertexBuffer, vertexMemory);
+        VulkanUtils::CreateBuffer(device, 6 * sizeof(uint16_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, indexBuffer, indexMemory);
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = device.CommandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+        VkCommandBuffer commandBuffer;
+        Check(vkAllocateCommandBuffers(device.Device, &allocInfo, &commandBuffer), "allocate command buffer");
+
+        uint64_t buffers = std::max<uint64_t>(iterations / s_DrawsPerBuffer, 1);
+        results.push_back(Measure("record.draw", buffers * s_DrawsPerBuffer, [&, buffers] {
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            VkRenderPassBeginInfo renderPassInfo{};
+            renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            renderPassInfo.renderPass = renderPass;
+            renderPassInfo.framebuffer = framebuffer;
+            renderPassInfo.renderArea.extent = s_TargetExtent;
+            VkClearValue clearValue{};
+            renderPassInfo.clearValueCount = 1;
+            renderPassInfo.pClearValues = &clearValue;
+            VkViewport viewport{ 0.0f, 0.0f, static_cast<float>(s_TargetExtent.width), static_cast<float>(s_TargetExtent.height), 0.0f, 1.0f };
+            VkRect2D scissor{ { 0, 0 }, s_TargetExtent };
+            VkDeviceSize offset = 0;
+            Batch2DPushConstants constants{};
+            for (uint64_t b = 0; b < buffers; b++) {
+                dispatch.ResetCommandBuffer(commandBuffer, 0);
+                dispatch.BeginCommandBuffer(commandBuffer, &beginInfo);
+                dispatch.CmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+                dispatch.CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                dispatch.CmdSetViewport(commandBuffer, 0, 1, &viewport);
+                dispatch.CmdSetScissor(commandBuffer, 0, 1, &scissor);
+                dispatch.CmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+                dispatch.CmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT16);
+                for (uint32_t draw = 0; draw < s_DrawsPerBuffer; draw++) {
+                    constants.Scale.x = static_cast<float>(draw);
+                    dispatch.CmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+                    dispatch.CmdDrawIndexed(commandBuffer, 6, 1, 0, 0, draw);
+                }
+                dispatch.CmdEndRenderPass(commandBuffer);
+                dispatch.EndCommandBuffer(commandBuffer);
+            }
+        }));
+
+        vkFreeCommandBuffers(device.Device, device.CommandPool, 1, &commandBuffer);
+        vkDestroyBuffer(device.Device, indexBuffer, nullptr);
+        vkFreeMemory(device.Device, indexMemory, nullptr);
+        vkDestroyBuffer(device.Device, vertexBuffer, nullptr);
+        vkFreeMemory(device.Device, vertexMemory, nullptr);
+        vkDestroyPipelineLayout(device.Device, pipelineLayout, nullptr);
+        vkDestroyFramebuffer(device.Device, framebuffer, nullptr);
+        vkDestroyImageView(device.Device, imageView, nullptr);
+        vkDestroyImage(device.Device, image, nullptr);
+        vkFreeMemory(device.Device, imageMemory, nullptr);
+        vkDestroyRenderPass(device.Device, renderPass, nullptr);
+    }
+
+    /* One warm file read three ways --> the streamer's path, the mapping meshes and textures use, and a plain ifstream for reference */
+    void AddAssetCases(std::vector<CaseResult>& results, uint64_t iterations) {
+        std::string path = (std::filesystem::temp_directory_path() / "EngineBenchmark.bin").string();
+        {
+            std::vector<uint8_t> contents(s_AssetBytes);
+            for (size_t i = 0; i < contents.size(); i++) contents[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+            std::ofstream file(path, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+            if (!file) throw std::runtime_error("Failed to write " + path + "!");
+        }
+        uint64_t reads = std::max<uint64_t>(iterations / 1000, 1);
+        std::vector<uint8_t> data;
+        std::string error;
+        results.push_back(Measure("asset.read_whole_file", reads, [&] {
+            for (uint64_t i = 0; i < reads; i++) {
+                if (!AssetStreamer::ReadWholeFile(path, data, error)) throw std::runtime_error("Failed to read " + path + ": " + error);
+                g_Sink = g_Sink + data[data.size() / 2];
+            }
+        }));
+        results.push_back(Measure("asset.mapped_file_copy", reads, [&] {
+            for (uint64_t i = 0; i < reads; i++) {
+                MappedFile file(path);
+                data.assign(file.GetData(), file.GetData() + file.GetSize());
+                g_Sink = g_Sink + data[data.size() / 2];
+            }
+        }));
+        results.push_back(Measure("asset.ifstream", reads, [&] {
+            for (uint64_t i = 0; i < reads; i++) {
+                std::ifstream file(path, std::ios::binary | std::ios::ate);
+                data.resize(static_cast<size_t>(file.tellg()));
+                file.seekg(0);
+                file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+                g_Sink = g_Sink + data[data.size() / 2];
+            }
+        }));
+        for (size_t i = results.size() - 3; i < results.size(); i++) results[i].BytesPerOperation = s_AssetBytes;
+        std::filesystem::remove(path);
+    }
+
+    std::string EscapeJson(const std::string& text) {
+        std::string escaped;
+        for (char character : text) {
+            if (character == '"' || character == '\\') escaped += '\\';
+            if (static_cast<unsigned char>(character) < 0x20) continue;
+            escaped += character;
+        }
+        return escaped;
+    }
+    void WriteJson(std::ostream& out, const Context& context, uint64_t iterations, const std::vector<CaseResult>& results) {
+        const VkPhysicalDeviceProperties& properties = context.Properties;
+        out << "{\n";
+        out << "  \"benchmark\": \"EngineBenchmark\",\n";
+        out << "  \"device\": \"" << EscapeJson(properties.deviceName) << "\",\n";
+        out << "  \"device_type\": " << properties.deviceType << ",\n";
+        out << "  \"driver_version\": " << properties.driverVersion << ",\n";
+        out << "  \"api_version\": \"" << VK_API_VERSION_MAJOR(properties.apiVersion) << "." << VK_API_VERSION_MINOR(properties.apiVersion) << "." << VK_API_VERSION_PATCH(properties.apiVersion) << "\",\n";
+        out << "  \"iterations\": " << iterations << ",\n";
+        out << "  \"rounds\": " << s_Rounds << ",\n";
+        out << "  \"results\": [\n";
+        char number[32];
+        for (size_t i = 0; i < results.size(); i++) {
+            const CaseResult& result = results[i];
+            out << "    { \"name\": \"" << result.Name << "\"";
+            if (result.Skipped) {
+                out << ", \"skipped\": true";
+            } else {
+                out << ", \"unit\": \"ns/op\", \"operations\": " << result.Operations;
+                std::snprintf(number, sizeof(number), "%.3f", result.BestNanoseconds);
+                out << ", \"best\": " << number;
+                std::snprintf(number, sizeof(number), "%.3f", result.MedianNanoseconds);
+                out << ", \"median\": " << number;
+                if (result.BytesPerOperation) out << ", \"bytes_per_op\": " << result.BytesPerOperation;
+            }
+            out << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    if (iterations == 0) {
+        std::cerr << "Usage: EngineBenchmark [iterations] > results.json\n";
+        return EXIT_FAILURE;
+    }
+    try {
+        Context context;
+        std::vector<CaseResult> results;
+        AddSelectionCases(results, iterations);
+        AddQueryCases(results, context, std::max<uint64_t>(iterations / 100, 1)); // every query is several driver calls
+        AddRecordingCases(results, context, iterations);
+        AddAssetCases(results, iterations);
+        WriteJson(std::cout, context, iterations, results);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,459 @@
+/* Offline converter: Wavefront OBJ --> packed MeshFormat blob
+ * Usage: MeshConverter <input.obj> <output.vmsh>
+ * Output is deduplicated, vertex cache ordered (Forsyth), overdraw ordered (cluster sort),
+ * vertex fetch ordered and quantized so the runtime can copy it into staging memory untouched. */
+#include "MeshFormat.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <cstdlib>
+
+using namespace VulkanPractice;
+
+namespace {
+    struct Vec3 {
+        float x = 0.0f, y = 0.0f, z = 0.0f;
+    };
+    inline Vec3 operator+(const Vec3& a, const Vec3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+    inline Vec3 operator-(const Vec3& a, const Vec3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+    inline Vec3 operator*(const Vec3& a, float s) { return { a.x * s, a.y * s, a.z * s }; }
+    inline float Dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    inline Vec3 Cross(const Vec3& a, const Vec3& b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+    inline Vec3 Normalize(const Vec3& v) {
+        float length = std::sqrt(Dot(v, v));
+        return length > 0.0f ? v * (1.0f / length) : Vec3{ 0.0f, 0.0f, 1.0f };
+    }
+
+    struct SourceVertex {
+        Vec3 Position;
+        Vec3 Normal;
+        float TexCoord[2] = { 0.0f, 0.0f };
+        Vec3 Color = { 1.0f, 1.0f, 1.0f };
+    };
+    struct SourceMesh {
+        std::vector<SourceVertex> Vertices;
+        std::vector<uint32_t> Indices;
+    };
+
+    /* ------------------------------------------------------------- */
+    /* OBJ parsing                                                    */
+    /* ------------------------------------------------------------- */
+    struct ObjKey {
+        int Position, TexCoord, Normal;
+        bool operator==(const ObjKey& other) const { return Position == other.Position && TexCoord == other.TexCoord && Normal == other.Normal; }
+    };
+    struct ObjKeyHash {
+        size_t operator()(const ObjKey& key) const {
+            size_t h = std::hash<int>()(key.Position);
+            h ^= std::hash<int>()(key.TexCoord) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            h ^= std::hash<int>()(key.Normal) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+    int ResolveObjIndex(int index, size_t count) {
+        /* OBJ is 1-based, negative values are relative to the end */
+        int resolved = index > 0 ? index - 1 : static_cast<int>(count) + index;
+        if (resolved < 0 || resolved >= static_cast<int>(count)) {
+            throw std::runtime_error("OBJ face references an out of range element");
+        }
+        return resolved;
+    }
+    SourceMesh LoadObj(const std::string& filepath) {
+        std::ifstream file(filepath);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open " + filepath);
+        }
+        std::vector<Vec3> positions, normals, colors;
+        std::vector<std::array<float, 2>> texCoords;
+        std::unordered_map<ObjKey, uint32_t, ObjKeyHash> uniqueVertices;
+        SourceMesh mesh;
+        bool hasNormals = false;
+
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream stream(line);
+            std::string tag;
+            stream >> tag;
+            if (tag == "v") {
+                Vec3 p, c{ 1.0f, 1.0f, 1.0f };
+                stream >> p.x >> p.y >> p.z;
+                if (!(stream >> c.x >> c.y >> c.z)) c = { 1.0f, 1.0f, 1.0f }; // optional per-vertex color extension
+                positions.push_back(p);
+                colors.push_back(c);
+            } else if (tag == "vt") {
+                std::array<float, 2> t{};
+                stream >> t[0] >> t[1];
+                texCoords.push_back(t);
+            } else if (tag == "vn") {
+                Vec3 n;
+                stream >> n.x >> n.y >> n.z;
+                normals.push_back(n);
+            } else if (tag == "f") {
+                std::vector<uint32_t> polygon;
+                std::string corner;
+                while (stream >> corner) {
+                    ObjKey key{ 0, 0, 0 };
+                    int* fields[3] = { &key.Position, &key.TexCoord, &key.Normal };
+                    size_t start = 0;
+                    for (int field = 0; field < 3 && start <= corner.size(); field++) {
+                        size_t slash = corner.find('/', start);
+                        std::string token = corner.substr(start, slash == std::string::npos ? std::string::npos : slash - start);
+                        if (!token.empty()) *fields[field] = std::stoi(token);
+                        if (slash == std::string::npos) break;
+                        start = slash + 1;
+                    }
+                    key.Position = ResolveObjIndex(key.Position, positions.size());
+                    key.TexCoord = key.TexCoord != 0 ? ResolveObjIndex(key.TexCoord, texCoords.size()) : -1;
+                    key.Normal = key.Normal != 0 ? ResolveObjIndex(key.Normal, normals.size()) : -1;
+                    hasNormals = hasNormals || key.Normal >= 0;
+
+                    auto it = uniqueVertices.find(key);
+                    if (it == uniqueVertices.end()) {
+                        SourceVertex vertex;
+                        vertex.Position = positions[key.Position];
+                        vertex.Color = colors[key.Position];
+                        if (key.TexCoord >= 0) {
+                            vertex.TexCoord[0] = texCoords[key.TexCoord][0];
+                            vertex.TexCoord[1] = 1.0f - texCoords[key.TexCoord][1]; // OBJ origin is bottom left
+                        }
+                        if (key.Normal >= 0) vertex.Normal = normals[key.Normal];
+                        it = uniqueVertices.emplace(key, static_cast<uint32_t>(mesh.Vertices.size())).first;
+                        mesh.Vertices.push_back(vertex);
+                    }
+                    polygon.push_back(it->second);
+                }
+                /* Fan triangulation of convex polygons */
+                for (size_t i = 2; i < polygon.size(); i++) {
+                    mesh.Indices.push_back(polygon[0]);
+                    mesh.Indices.push_back(polygon[i - 1]);
+                    mesh.Indices.push_back(polygon[i]);
+                }
+            }
+        }
+        if (mesh.Indices.empty()) {
+            throw std::runtime_error("OBJ contains no faces: " + filepath);
+        }
+        if (!hasNormals) {
+            /* Area weighted face normals accumulated per vertex */
+            for (size_t i = 0; i < mesh.Indices.size(); i += 3) {
+                SourceVertex& a = mesh.Vertices[mesh.Indices[i + 0]];
+                SourceVertex& b = mesh.Vertices[mesh.Indices[i + 1]];
+                SourceVertex& c = mesh.Vertices[mesh.Indices[i + 2]];
+                Vec3 faceNormal = Cross(b.Position - a.Position, c.Position - a.Position);
+                a.Normal = a.Normal + faceNormal;
+                b.Normal = b.Normal + faceNormal;
+                c.Normal = c.Normal + faceNormal;
+            }
+        }
+        for (auto& vertex : mesh.Vertices) vertex.Normal = Normalize(vertex.Normal);
+        return mesh;
+    }
+
+    /* ------------------------------------------------------------- */
+    /* Vertex cache optimization (Tom Forsyth, linear-speed)          */
+    /* ------------------------------------------------------------- */
+    constexpr int CacheSize = 32;
+    float ForsythVertexScore(int cachePosition, uint32_t remainingTriangles) {
+        if (remainingTriangles == 0) return -1.0f;
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            if (cachePosition < 3) {
+                score = 0.75f; // the last triangle's vertices get a fixed score so it is not simply repeated
+            } else {
+                score = std::pow(1.0f - static_cast<float>(cachePosition - 3) / (CacheSize - 3), 1.5f);
+            }
+        }
+        score += 2.0f / std::sqrt(static_cast<float>(remainingTriangles)); // valence boost --> finish off lonely vertices
+        return score;
+    }
+    std::vector<uint32_t> OptimizeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount) {
+        size_t triangleCount = indices.size() / 3;
+        std::vector<uint32_t> remaining(vertexCount, 0), adjacencyOffset(vertexCount + 1, 0);
+        for (uint32_t index : indices) remaining[index]++;
+        for (size_t v = 0; v < vertexCount; v++) adjacencyOffset[v + 1] = adjacencyOffset[v] + remaining[v];
+        std::vector<uint32_t> adjacency(indices.size()), fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+        for (size_t t = 0; t < triangleCount; t++) {
+            for (int k = 0; k < 3; k++) adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+        }
+
+        std::vector<int> cachePosition(vertexCount, -1);
+        std::vector<float> vertexScore(vertexCount), triangleScore(triangleCount);
+        std::vector<bool> emitted(triangleCount, false);
+        for (size_t v = 0; v < vertexCount; v++) vertexScore[v] = ForsythVertexScore(-1, remaining[v]);
+        for (size_t t = 0; t < triangleCount; t++) {
+            triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+        }
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        std::vector<uint32_t> cache, nextCache;
+        size_t scanCursor = 0;
+        int64_t best = static_cast<int64_t>(std::max_element(triangleScore.begin(), triangleScore.end()) - triangleScore.begin());
+        while (best >= 0) {
+            emitted[best] = true;
+            nextCache.clear();
+            for (int k = 0; k < 3; k++) {
+                uint32_t v = indices[best * 3 + k];
+                result.push_back(v);
+                nextCache.push_back(v);
+                /* Detach the triangle from its vertices */
+                uint32_t* begin = adjacency.data() + adjacencyOffset[v];
+                uint32_t* end = begin + remaining[v];
+                *std::find(begin, end, static_cast<uint32_t>(best)) = *(end - 1);
+                remaining[v]--;
+            }
+            for (uint32_t v : cache) {
+                if (std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end()) nextCache.push_back(v);
+            }
+            for (size_t i = CacheSize; i < nextCache.size(); i++) {
+                uint32_t evicted = nextCache[i];
+                cachePosition[evicted] = -1;
+                vertexScore[evicted] = ForsythVertexScore(-1, remaining[evicted]);
+            }
+            if (nextCache.size() > CacheSize) nextCache.resize(CacheSize);
+            cache.swap(nextCache);
+
+            /* Rescore only what the cache touched, then pick the best neighbour */
+            best = -1;
+            float bestScore = -1.0f;
+            for (size_t i = 0; i < cache.size(); i++) {
+                uint32_t v = cache[i];
+                cachePosition[v] = static_cast<int>(i);
+                vertexScore[v] = ForsythVertexScore(cachePosition[v], remaining[v]);
+            }
+            for (uint32_t v : cache) {
+                for (uint32_t a = 0; a < remaining[v]; a++) {
+                    uint32_t t = adjacency[adjacencyOffset[v] + a];
+                    triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+                    if (triangleScore[t] > bestScore) {
+                        bestScore = triangleScore[t];
+                        best = t;
+                    }
+                }
+            }
+            if (best < 0) {
+                while (scanCursor < triangleCount && emitted[scanCursor]) scanCursor++;
+                if (scanCursor < triangleCount) best = static_cast<int64_t>(scanCursor);
+            }
+        }
+        return result;
+    }
+
+    /* ------------------------------------------------------------- */
+    /* Overdraw ordering: cluster on cache flushes, sort front first  */
+    /* ------------------------------------------------------------- */
+    float SimulateAcmr(const std::vector<uint32_t>& indices, size_t vertexCount, std::vector<uint32_t>* clusterStarts) {
+        /* FIFO cache simulation --> a triangle missing all three vertices starts a new cluster */
+        constexpr uint32_t FifoSize = 16;
+        std::vector<uint32_t> timestamp(vertexCount, 0);
+        uint32_t time = FifoSize + 1, misses = 0;
+        for (size_t t = 0; t < indices.size() / 3; t++) {
+            uint32_t triangleMisses = 0;
+            for (int k = 0; k < 3; k++) {
+                uint32_t v = indices[t * 3 + k];
+                if (time - timestamp[v] > FifoSize) {
+                    timestamp[v] = time++;
+                    triangleMisses++;
+                }
+            }
+            if (clusterStarts && (t == 0 || triangleMisses == 3)) clusterStarts->push_back(static_cast<uint32_t>(t));
+            misses += triangleMisses;
+        }
+        return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+    }
+    std::vector<uint32_t> OptimizeOverdraw(const std::vector<uint32_t>& indices, const std::vector<SourceVertex>& vertices) {
+        std::vector<uint32_t> clusterStarts;
+        SimulateAcmr(indices, vertices.size(), &clusterStarts);
+        size_t triangleCount = indices.size() / 3;
+        clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+
+        Vec3 meshCentroid;
+        for (const auto& vertex : vertices) meshCentroid = meshCentroid + vertex.Position;
+        meshCentroid = meshCentroid * (1.0f / static_cast<float>(vertices.size()));
+
+        size_t clusterCount = clusterStarts.size() - 1;
+        std::vector<float> sortKey(clusterCount);
+        for (size_t c = 0; c < clusterCount; c++) {
+            Vec3 centroid, normal;
+            float area = 0.0f;
+            for (uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; t++) {
+                const Vec3& a = vertices[indices[t * 3 + 0]].Position;
+                const Vec3& b = vertices[indices[t * 3 + 1]].Position;
+                const Vec3& p = vertices[indices[t * 3 + 2]].Position;
+                Vec3 faceNormal = Cross(b - a, p - a);
+                float faceArea = std::sqrt(Dot(faceNormal, faceNormal));
+                centroid = centroid + (a + b + p) * (faceArea / 3.0f);
+                normal = normal + faceNormal;
+                area += faceArea;
+            }
+            if (area > 0.0f) centroid = centroid * (1.0f / area);
+            /* Outward facing clusters far from the centre occlude the rest --> draw them first */
+            sortKey[c] = Dot(centroid - meshCentroid, Normalize(normal));
+        }
+        std::vector<uint32_t> order(clusterCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKey[a] > sortKey[b]; });
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        for (uint32_t c : order) {
+            result.insert(result.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+        }
+        return result;
+    }
+
+    /* ------------------------------------------------------------- */
+    /* Vertex fetch ordering: vertices in first-use order             */
+    /* ------------------------------------------------------------- */
+    void OptimizeVertexFetch(std::vector<uint32_t>& indices, std::vector<SourceVertex>& vertices) {
+        std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+        std::vector<SourceVertex> reordered;
+        reordered.reserve(vertices.size());
+        for (uint32_t& index : indices) {
+            if (remap[index] == UINT32_MAX) {
+                remap[index] = static_cast<uint32_t>(reordered.size());
+                reordered.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+        vertices.swap(reordered); // unreferenced vertices are dropped here
+    }
+
+    /* ------------------------------------------------------------- */
+    /* Quantization                                                   */
+    /* ------------------------------------------------------------- */
+    uint16_t FloatToHalf(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        uint32_t sign = (bits >> 16) & 0x8000;
+        int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+        uint32_t mantissa = bits & 0x007FFFFF;
+        if (((bits >> 23) & 0xFF) == 0xFF) return static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0)); // inf / nan
+        if (exponent >= 31) return static_cast<uint16_t>(sign | 0x7C00); // overflow --> inf
+        if (exponent <= 0) {
+            if (exponent < -10) return static_cast<uint16_t>(sign); // underflow --> signed zero
+            mantissa |= 0x00800000;
+            uint32_t shift = static_cast<uint32_t>(14 - exponent);
+            uint32_t half = mantissa >> shift;
+            uint32_t rest = mantissa & ((1u << shift) - 1);
+            uint32_t halfway = 1u << (shift - 1);
+            if (rest > halfway || (rest == halfway && (half & 1))) half++;
+            return static_cast<uint16_t>(sign | half);
+        }
+        uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+        uint32_t rest = mantissa & 0x1FFF;
+        if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) half++; // round to nearest even, may carry into exponent
+        return static_cast<uint16_t>(half);
+    }
+    int8_t QuantizeSnorm8(float value) {
+        return static_cast<int8_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 127.0f));
+    }
+    uint8_t QuantizeUnorm8(float value) {
+        return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+    }
+    uint16_t QuantizeUnorm16(float value) {
+        /* Repeating texture coordinates are wrapped into [0, 1] */
+        float wrapped = value - std::floor(value);
+        if (wrapped == 0.0f && value != 0.0f) wrapped = 1.0f;
+        return static_cast<uint16_t>(std::lround(wrapped * 65535.0f));
+    }
+
+    void WritePadding(std::ofstream& file, uint64_t& offset) {
+        static const char zeros[MeshFormat::SectionAlignment] = {};
+        uint64_t aligned = (offset + MeshFormat::SectionAlignment - 1) & ~(MeshFormat::SectionAlignment - 1);
+        file.write(zeros, static_cast<std::streamsize>(aligned - offset));
+        offset = aligned;
+    }
+    void WriteMesh(const std::string& filepath, const SourceMesh& mesh) {
+        std::vector<MeshFormat::Vertex> packed(mesh.Vertices.size());
+        MeshFormat::Header header{};
+        header.Magic = MeshFormat::Magic;
+        header.Version = MeshFormat::Version;
+        header.VertexStride = sizeof(MeshFormat::Vertex);
+        header.IndexSize = mesh.Vertices.size() <= UINT16_MAX + 1u ? 2 : 4;
+        header.VertexCount = static_cast<uint32_t>(mesh.Vertices.size());
+        header.IndexCount = static_cast<uint32_t>(mesh.Indices.size());
+        std::fill(header.BoundsMin, header.BoundsMin + 3, std::numeric_limits<float>::max());
+        std::fill(header.BoundsMax, header.BoundsMax + 3, std::numeric_limits<float>::lowest());
+        for (size_t i = 0; i < mesh.Vertices.size(); i++) {
+            const SourceVertex& source = mesh.Vertices[i];
+            MeshFormat::Vertex& vertex = packed[i];
+            const float position[3] = { source.Position.x, source.Position.y, source.Position.z };
+            for (int k = 0; k < 3; k++) {
+                vertex.Position[k] = FloatToHalf(position[k]);
+                header.BoundsMin[k] = std::min(header.BoundsMin[k], position[k]);
+                header.BoundsMax[k] = std::max(header.BoundsMax[k], position[k]);
+            }
+            vertex.Position[3] = FloatToHalf(1.0f);
+            vertex.Normal[0] = QuantizeSnorm8(source.Normal.x);
+            vertex.Normal[1] = QuantizeSnorm8(source.Normal.y);
+            vertex.Normal[2] = QuantizeSnorm8(source.Normal.z);
+            vertex.Normal[3] = 0;
+            vertex.TexCoord[0] = QuantizeUnorm16(source.TexCoord[0]);
+            vertex.TexCoord[1] = QuantizeUnorm16(source.TexCoord[1]);
+            vertex.Color[0] = QuantizeUnorm8(source.Color.x);
+            vertex.Color[1] = QuantizeUnorm8(source.Color.y);
+            vertex.Color[2] = QuantizeUnorm8(source.Color.z);
+            vertex.Color[3] = 255;
+        }
+        header.VertexBytes = static_cast<uint64_t>(packed.size()) * sizeof(MeshFormat::Vertex);
+        header.IndexBytes = static_cast<uint64_t>(mesh.Indices.size()) * header.IndexSize;
+
+        std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open " + filepath + " for writing");
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header)); // placeholder, rewritten once offsets are known
+        uint64_t offset = sizeof(header);
+        WritePadding(file, offset);
+        header.VertexOffset = offset;
+        file.write(reinterpret_cast<const char*>(packed.data()), static_cast<std::streamsize>(header.VertexBytes));
+        offset += header.VertexBytes;
+        WritePadding(file, offset);
+        header.IndexOffset = offset;
+        if (header.IndexSize == 2) {
+            std::vector<uint16_t> narrow(mesh.Indices.begin(), mesh.Indices.end());
+            file.write(reinterpret_cast<const char*>(narrow.data()), static_cast<std::streamsize>(header.IndexBytes));
+        } else {
+            file.write(reinterpret_cast<const char*>(mesh.Indices.data()), static_cast<std::streamsize>(header.IndexBytes));
+        }
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!file) {
+            throw std::runtime_error("Failed to write " + filepath);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: MeshConverter <input.obj> <output.vmsh>\n";
+        return EXIT_FAILURE;
+    }
+    try {
+        SourceMesh mesh = LoadObj(argv[1]);
+        float acmrBefore = SimulateAcmr(mesh.Indices, mesh.Vertices.size(), nullptr);
+        mesh.Indices = OptimizeVertexCache(mesh.Indices, mesh.Vertices.size());
+        mesh.Indices = OptimizeOverdraw(mesh.Indices, mesh.Vertices);
+        OptimizeVertexFetch(mesh.Indices, mesh.Vertices);
+        float acmrAfter = SimulateAcmr(mesh.Indices, mesh.Vertices.size(), nullptr);
+        WriteMesh(argv[2], mesh);
+        std::cout << argv[2] << ": " << mesh.Vertices.size() << " vertices, " << mesh.Indices.size() / 3 << " triangles, "
+                  << "ACMR " << acmrBefore << " -> " << acmrAfter << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,176 @@
+/* Benchmark: objects per millisecond for hierarchy updates and frustum culling
+ * Usage: TransformBenchmark [objects]
+ * Runs a naive glm loop over an array of nodes against TransformSystem at every SIMD level this CPU supports.
+ * Both sides get the same fanout 8 hierarchy and frustum, and their results are compared before anything is timed.
+ * "update" is world matrices + world bounds after a root moved, "cull" is sphere + box against the six planes.
+ * The SceneBvh line builds a BVH over the same world boxes and culls by walking it --> box test only, so it may keep a few more. */
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "TransformSystem.h"
+#include "SceneBvh.h"
+#include "Profiler.h"
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace VulkanPractice;
+
+namespace {
+    constexpr uint32_t s_Fanout = 8;
+    constexpr uint32_t s_Rounds = 5; // best of --> less sensitive to clock ramps and scheduling noise
+
+    /* Array of structures in id order, parents first --> what the scene looked like before TransformSystem */
+    struct NaiveNode {
+        glm::mat4 Local, World;
+        uint32_t Parent;
+        glm::vec3 Center, Extent, WorldCenter, WorldExtent;
+        float Radius, WorldRadius;
+    };
+
+    void NaiveUpdate(std::vector<NaiveNode>& nodes) {
+        for (NaiveNode& node : nodes) {
+            node.World = node.Parent == TransformSystem::s_NoParent ? node.Local : nodes[node.Parent].World * node.Local;
+            const glm::mat4& m = node.World;
+            glm::vec4 center = m * glm::vec4(node.Center, 1.0f);
+            node.WorldCenter = glm::vec3(center.x, center.y, center.z);
+            float scaleSquared = 0.0f;
+            for (int row = 0; row < 3; row++) {
+                node.WorldExtent[row] = std::fabs(m[0][row]) * node.Extent.x + std::fabs(m[1][row]) * node.Extent.y + std::fabs(m[2][row]) * node.Extent.z;
+                glm::vec3 axis(m[row][0], m[row][1], m[row][2]);
+                scaleSquared = std::max(scaleSquared, glm::dot(axis, axis));
+            }
+            node.WorldRadius = node.Radius * std::sqrt(scaleSquared);
+        }
+    }
+    void NaiveCull(const std::vector<NaiveNode>& nodes, const FrustumPlanes& frustum, std::vector<uint32_t>& visible) {
+        visible.clear();
+        for (uint32_t i = 0; i < nodes.size(); i++) {
+            const NaiveNode& node = nodes[i];
+            bool inside = true;
+            for (int p = 0; p < 6 && inside; p++) {
+                glm::vec3 normal(frustum.Planes[p][0], frustum.Planes[p][1], frustum.Planes[p][2]);
+                float distance = glm::dot(normal, node.WorldCenter) + frustum.Planes[p][3];
+                float reach = std::fabs(normal.x) * node.WorldExtent.x + std::fabs(normal.y) * node.WorldExtent.y + std::fabs(normal.z) * node.WorldExtent.z;
+                inside = distance + node.WorldRadius >= 0.0f && distance + reach >= 0.0f;
+            }
+            if (inside) visible.push_back(i);
+        }
+    }
+
+    /* Runs body iterations times per round, returns the best objects per millisecond */
+    template<typename Body>
+    double Measure(size_t objects, uint32_t iterations, Body&& body) {
+        double best = 0.0;
+        for (uint32_t round = 0; round < s_Rounds; round++) {
+            Timer timer;
+            for (uint32_t i = 0; i < iterations; i++) body();
+            best = std::max(best, static_cast<double>(objects) * iterations / timer.GetElapsedMilliseconds());
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t objects = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 100000;
+    if (objects == 0) {
+        std::cerr << "Usage: TransformBenchmark [objects]\n";
+        return EXIT_FAILURE;
+    }
+    /* Fanout 8 tree --> the first 8 nodes are roots, node i hangs off node i / 8 - 1 */
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<NaiveNode> nodes(objects);
+    for (uint32_t i = 0; i < objects; i++) {
+        NaiveNode& node = nodes[i];
+        node.Parent = i < s_Fanout ? TransformSystem::s_NoParent : i / s_Fanout - 1;
+        float spread = i < s_Fanout ? 24.0f : 4.0f; // roots wide enough that part of the scene leaves the frustum
+        glm::mat4 local = glm::translate(glm::mat4(1.0f), glm::vec3(unit(random), unit(random), unit(random)) * spread);
+        local = glm::rotate(local, unit(random) * 3.14159265f, glm::normalize(glm::vec3(unit(random), unit(random), unit(random) + 2.0f)));
+        node.Local = glm::scale(local, glm::vec3(0.5f + 0.25f * unit(random)));
+        node.Center = glm::vec3(unit(random), unit(random), unit(random)) * 0.1f;
+        node.Extent = glm::vec3(0.5f, 0.25f, 0.75f);
+        node.Radius = glm::length(node.Extent);
+    }
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 20.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    FrustumPlanes frustum = TransformSystem::ExtractFrustum(projection * view);
+
+    NaiveUpdate(nodes);
+    std::vector<uint32_t> naiveVisible;
+    NaiveCull(nodes, frustum, naiveVisible);
+    uint32_t iterations = std::max(1u, 2000000u / objects);
+
+    std::vector<std::pair<std::string, std::pair<double, double>>> rows;
+    rows.push_back({ "glm (naive)", {
+        Measure(objects, iterations, [&] { NaiveUpdate(nodes); }),
+        Measure(objects, iterations, [&] { NaiveCull(nodes, frustum, naiveVisible); })
+    } });
+
+    SimdLevel best = DetectSimdLevel();
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse, SimdLevel::Avx2 }) {
+        if (level > best) break;
+        TransformSystem transforms(level);
+        for (const NaiveNode& node : nodes) {
+            TransformSystem::NodeId id = transforms.Add(node.Local, node.Parent);
+            transforms.SetBounds(id, node.Center, node.Extent, node.Radius);
+        }
+        transforms.Update();
+
+        /* Same answers first --> a fast wrong kernel is not a result */
+        float maxError = 0.0f;
+        for (uint32_t i = 0; i < objects; i++) {
+            glm::mat4 world = transforms.GetWorld(i);
+            for (int column = 0; column < 4; column++) {
+                for (int row = 0; row < 4; row++) maxError = std::max(maxError, std::fabs(world[column][row] - nodes[i].World[column][row]));
+            }
+        }
+        std::vector<TransformSystem::NodeId> visible;
+        transforms.Cull(frustum, visible);
+        std::sort(visible.begin(), visible.end());
+        const char* name = transforms.GetKernels().Name;
+        if (maxError > 1e-3f || visible != naiveVisible) {
+            std::cerr << name << " disagrees with glm --> max matrix error " << maxError << ", "
+                      << visible.size() << " visible vs " << naiveVisible.size() << "\n";
+            return EXIT_FAILURE;
+        }
+
+        double update = Measure(objects, iterations, [&] {
+            transforms.SetLocal(0, nodes[0].Local); // dirty --> Update recomputes everything
+            transforms.Update();
+        });
+        double cull = Measure(objects, iterations, [&] { transforms.Cull(frustum, visible); });
+        rows.push_back({ name, { update, cull } });
+    }
+
+    std::cout << objects << " objects, " << naiveVisible.size() << " visible, depth " << static_cast<uint32_t>(std::log(static_cast<double>(objects)) / std::log(8.0)) + 1 << "\n";
+    std::cout << std::left << std::setw(16) << "objects per ms" << std::right << std::setw(14) << "update" << std::setw(10) << "x glm"
+              << std::setw(14) << "cull" << std::setw(10) << "x glm" << "\n";
+    for (const auto& [name, result] : rows) {
+        std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(14) << result.first << std::setprecision(2) << std::setw(9) << result.first / rows[0].second.first << "x"
+                  << std::setprecision(0) << std::setw(14) << result.second << std::setprecision(2) << std::setw(9) << result.second / rows[0].second.second << "x\n";
+    }
+
+    SceneBvh bvh;
+    for (const NaiveNode& node : nodes) bvh.Insert(node.WorldCenter - node.WorldExtent, node.WorldCenter + node.WorldExtent);
+    Timer buildTimer;
+    bvh.Rebuild();
+    double buildMilliseconds = buildTimer.GetElapsedMilliseconds();
+    std::vector<SceneBvh::ItemId> bvhVisible;
+    bvh.QueryFrustum(frustum, bvhVisible);
+    std::sort(bvhVisible.begin(), bvhVisible.end());
+    if (!std::includes(bvhVisible.begin(), bvhVisible.end(), naiveVisible.begin(), naiveVisible.end())) {
+        std::cerr << "SceneBvh misses objects glm keeps --> " << bvhVisible.size() << " visible vs " << naiveVisible.size() << "\n";
+        return EXIT_FAILURE;
+    }
+    double bvhCull = Measure(objects, iterations, [&] { bvh.QueryFrustum(frustum, bvhVisible); });
+    std::cout << std::left << std::setw(16) << "SceneBvh" << std::right << std::setprecision(2) << std::setw(11) << buildMilliseconds << " ms"
+              << std::setw(10) << "build" << std::setprecision(0) << std::setw(14) << bvhCull << std::setprecision(2) << std::setw(9) << bvhCull / rows[0].second.second << "x"
+              << "  " << bvhVisible.size() << " visible, " << bvh.GetNodeCount() << " nodes\n";
+    return EXIT_SUCCESS;
+}
\ No newline at end of file